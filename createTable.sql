@@ -55,8 +55,40 @@ CREATE TABLE photos (
     id TEXT PRIMARY KEY,
     eksponat_id TEXT NOT NULL,
     photo BLOB NOT NULL,
+    blob_hash TEXT,
     FOREIGN KEY (eksponat_id) REFERENCES eksponaty(id) ON DELETE CASCADE ON UPDATE CASCADE
 );
 
+-- Treść zdjęć adresowana SHA-256 (deduplikacja); photos.photo pusty, gdy blob_hash ustawiony
+CREATE TABLE photo_blobs (
+    hash TEXT PRIMARY KEY,
+    data BLOB NOT NULL,
+    ref_count INTEGER NOT NULL DEFAULT 0,
+    external INTEGER NOT NULL DEFAULT 0,
+    width INTEGER,
+    height INTEGER
+);
+
+CREATE INDEX idx_photos_blob_hash ON photos(blob_hash);
+
+-- Miniatury zdjęć (stałe rozmiary, dłuższa krawędź w px)
+CREATE TABLE photo_thumbnails (
+    photo_id TEXT NOT NULL,
+    size_px INTEGER NOT NULL,
+    thumbnail BLOB NOT NULL,
+    PRIMARY KEY (photo_id, size_px),
+    FOREIGN KEY (photo_id) REFERENCES photos(id) ON DELETE CASCADE
+);
+
 -- Indeks po numerze seryjnym
 CREATE INDEX idx_serial_number ON eksponaty(serial_number);
+
+-- Indeksy z katalogu w DatabaseSchemaUtils.cpp (ensureDatabaseSchema tworzy brakujące)
+CREATE INDEX idx_photos_eksponat_id ON photos(eksponat_id);
+CREATE INDEX idx_eksponaty_type_id ON eksponaty(type_id);
+CREATE INDEX idx_eksponaty_vendor_model ON eksponaty(vendor_id, model_id);
+CREATE INDEX idx_eksponaty_model_id ON eksponaty(model_id);
+CREATE INDEX idx_eksponaty_status_storage ON eksponaty(status_id, storage_place_id);
+CREATE INDEX idx_eksponaty_storage_place_id ON eksponaty(storage_place_id);
+CREATE INDEX idx_eksponaty_name_id ON eksponaty(name, id);
+CREATE INDEX idx_models_vendor_id ON models(vendor_id);
@@ -0,0 +1,129 @@
+#ifndef DATABASECONNECTIONPOOL_H
+#define DATABASECONNECTIONPOOL_H
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMetaObject>
+#include <QMutex>
+#include <QSqlDatabase>
+#include <QString>
+
+class DatabaseConnectionPool;
+class QThread;
+
+/// Połączenie wypożyczone z DatabaseConnectionPool.
+///
+/// Tylko przenoszalne; ważne wyłącznie w wątku, który je pobrał, i tam też musi
+/// zostać zniszczone. Destruktor oddaje połączenie do puli (nie zamyka go).
+class PooledConnection
+{
+public:
+    PooledConnection() = default;
+    ~PooledConnection();
+
+    PooledConnection(PooledConnection &&other) noexcept;
+    PooledConnection &operator=(PooledConnection &&other) noexcept;
+    PooledConnection(const PooledConnection &) = delete;
+    PooledConnection &operator=(const PooledConnection &) = delete;
+
+    bool isValid() const { return m_pool != nullptr; }
+    QString connectionName() const { return m_connectionName; }
+    QSqlDatabase database() const;
+
+private:
+    friend class DatabaseConnectionPool;
+    PooledConnection(DatabaseConnectionPool *pool, const QString &connectionName);
+    void release();
+
+    DatabaseConnectionPool *m_pool = nullptr;
+    QString m_connectionName;
+};
+
+/**
+ * @class DatabaseConnectionPool
+ * @brief Połączenia z bazą dla dowolnego wątku, z ustawieniami połączenia źródłowego.
+ *
+ * @section ClassOverview
+ * Połączenia Qt SQL są przypisane do wątku, więc wcześniej wszystko (model listy,
+ * repozytoria, timer keep-alive) szło przez jedno `default_connection`, a każdy worker
+ * klonował je i zamykał sam. acquire() daje połączenie właściwe dla bieżącego wątku:
+ * w wątku GUI samo połączenie źródłowe, w innym wątku jego klon (openWorkerConnection:
+ * ten sam sterownik, dane logowania, opcje i PRAGMA). Klon powstaje przy pierwszym
+ * acquire(), służy kolejnym zadaniom tego wątku i jest zamykany, gdy wątek się kończy,
+ * albo wcześniej przez closeThreadConnection().
+ *
+ * @section Notes
+ * - Przy wypożyczeniu zamknięte połączenie jest otwierane ponownie, a połączenie
+ *   z serwerem (MySQL) bezczynne dłużej niż kValidationIdleMs jest sprawdzane
+ *   `SELECT 1` i w razie błędu zestawiane od nowa.
+ * - Po invalidate() (nowa konfiguracja bazy w setupDatabase) klony są otwierane od nowa.
+ * - Jedna pula na połączenie źródłowe; instance() bez argumentu to pula `default_connection`.
+ */
+class DatabaseConnectionPool
+{
+    Q_DECLARE_TR_FUNCTIONS(DatabaseConnectionPool)
+
+public:
+    struct Stats
+    {
+        quint64 checkouts = 0;
+        /// Otwarte klony (połączenia wątków innych niż GUI).
+        quint64 createdConnections = 0;
+        /// Nieudane walidacje przy wypożyczeniu (zamknięte połączenie, błąd SELECT 1).
+        quint64 validationFailures = 0;
+        quint64 reconnects = 0;
+        /// Wątki, które mają połączenie w puli (łącznie z wątkiem GUI).
+        int connections = 0;
+        int peakConnections = 0;
+        /// Wątki, które mają teraz wypożyczone połączenie.
+        int inUse = 0;
+    };
+
+    static constexpr int kValidationIdleMs = 15000;
+
+    explicit DatabaseConnectionPool(const QString &sourceConnectionName = QStringLiteral("default_connection"));
+    ~DatabaseConnectionPool();
+
+    static DatabaseConnectionPool &instance(const QString &sourceConnectionName = QStringLiteral("default_connection"));
+
+    /// Połączenie dla bieżącego wątku; przy błędzie pusty PooledConnection i komunikat.
+    PooledConnection acquire(QString *errorMessage);
+    /// Zamyka klon bieżącego wątku (jeśli nie jest wypożyczony) — np. przed dłuższą bezczynnością.
+    void closeThreadConnection();
+    /// Klony otwarte wcześniej zostaną przy najbliższym acquire() otwarte od nowa;
+    /// czyści też budżety INSERT-ów PhotoService (max_allowed_packet nowego serwera).
+    void invalidate();
+
+    QString sourceConnectionName() const { return m_sourceConnectionName; }
+    Stats stats() const;
+    void resetStats();
+
+private:
+    Q_DISABLE_COPY(DatabaseConnectionPool)
+    friend class PooledConnection;
+
+    struct ThreadConnection
+    {
+        QString connectionName;
+        /// false — wątek GUI korzysta z samego połączenia źródłowego.
+        bool ownsConnection = false;
+        quint64 generation = 0;
+        int borrowCount = 0;
+        QElapsedTimer idleTimer;
+        QMetaObject::Connection threadFinished;
+    };
+
+    void release(const QString &connectionName);
+    bool validate(const QString &connectionName, bool ping, QString *errorMessage);
+    void removeThreadConnection(QThread *thread);
+    static void closeConnection(const QString &connectionName);
+
+    const QString m_sourceConnectionName;
+    mutable QMutex m_mutex;
+    QHash<QThread *, ThreadConnection> m_connections;
+    quint64 m_generation = 0;
+    Stats m_stats;
+};
+
+#endif // DATABASECONNECTIONPOOL_H
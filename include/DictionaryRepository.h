@@ -13,7 +13,8 @@ public:
                   const QString &name,
                   QString *errorMessage,
                   const QString &parentColumn = QString(),
-                  const QString &parentId = QString());
+                  const QString &parentId = QString(),
+                  QString *entryId = nullptr);
 
     bool renameEntry(const QString &tableName,
                      const QString &currentName,
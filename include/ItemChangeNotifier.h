@@ -0,0 +1,33 @@
+#ifndef ITEMCHANGENOTIFIER_H
+#define ITEMCHANGENOTIFIER_H
+
+#include <QObject>
+#include <QStringList>
+
+/// v1.5: powiadomienia o zmianach w tabeli eksponaty, emitowane przez ItemRepository
+/// po udanym COMMIT. ItemTableModel dociąga wtedy tylko wskazane wiersze
+/// (ItemTableModel::refreshItems / removeItems) zamiast czytać całą tabelę od nowa.
+///
+/// Sygnały są emitowane w wątku, który wykonał zapis — odbiorcy w wątku GUI
+/// dostają je przez połączenie kolejkowane. Identyfikatory nie niosą nazwy połączenia:
+/// model sprawdza je we własnej bazie, więc obce ID zostaną po prostu pominięte.
+class ItemChangeNotifier : public QObject
+{
+    Q_OBJECT
+
+public:
+    static ItemChangeNotifier &instance();
+
+    void notifyItemsChanged(const QStringList &itemIds);
+    void notifyItemsRemoved(const QStringList &itemIds);
+
+signals:
+    /// Rekordy dodane albo zmienione.
+    void itemsChanged(const QStringList &itemIds);
+    void itemsRemoved(const QStringList &itemIds);
+
+private:
+    ItemChangeNotifier() = default;
+};
+
+#endif // ITEMCHANGENOTIFIER_H
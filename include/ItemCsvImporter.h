@@ -0,0 +1,81 @@
+#ifndef ITEMCSVIMPORTER_H
+#define ITEMCSVIMPORTER_H
+
+#include <QCoreApplication>
+#include <QHash>
+#include <QList>
+#include <QSqlDatabase>
+#include <QString>
+#include <QStringList>
+
+#include <functional>
+
+class QIODevice;
+class QTextStream;
+
+/// Błąd jednego wiersza pliku — wiersz jest pomijany, import trwa dalej.
+struct ItemImportRowError
+{
+    /// Numer linii w pliku (1 = nagłówek).
+    int line = 0;
+    QString message;
+};
+
+struct ItemImportResult
+{
+    int importedCount = 0;
+    /// Nowe wpisy słowników (typy, producenci, modele, statusy, miejsca przechowywania).
+    int createdDictionaryEntries = 0;
+    QList<ItemImportRowError> rowErrors;
+};
+
+/// v1.5: import eksponatów z pliku CSV (eksport z arkusza kalkulacyjnego).
+///
+/// **Format:** pierwszy wiersz to nagłówek; kolumny rozpoznawane po nazwie (polskiej
+/// albo angielskiej, bez względu na wielkość liter i znaki diakrytyczne — np. „Nazwa”,
+/// „Producent”, „Rok produkcji”, „serial_number”). Separator `;`, `,` albo tabulator
+/// wykrywany z nagłówka; pola w cudzysłowach mogą zawierać separator i nowe linie.
+///
+/// **Słowniki:** nazwy typów, producentów, modeli, statusów i miejsc przechowywania są
+/// zamieniane na ID z mapy w pamięci (wczytanej raz); brakujące wpisy są dodawane.
+///
+/// **Zapis:** plik jest czytany strumieniowo, paczkami po kImportBatchSize wierszy
+/// zapisywanymi przez ItemRepository::saveItems.
+class ItemCsvImporter
+{
+    Q_DECLARE_TR_FUNCTIONS(ItemCsvImporter)
+
+public:
+    explicit ItemCsvImporter(QSqlDatabase database = QSqlDatabase::database("default_connection"));
+
+    /// `progressCallback(przeczytaneBajty, rozmiarPliku)` po każdej paczce; false przerywa
+    /// import — zapisane wcześniej paczki zostają w bazie.
+    bool importFile(const QString &filePath,
+                    ItemImportResult *result,
+                    QString *errorMessage,
+                    const std::function<bool(qint64, qint64)> &progressCallback = {});
+    bool importCsv(QIODevice *device,
+                   ItemImportResult *result,
+                   QString *errorMessage,
+                   const std::function<bool(qint64, qint64)> &progressCallback = {});
+
+private:
+    bool loadDictionaries(QString *errorMessage);
+    /// ID wpisu słownika o nazwie `name` (model — o nazwie `name` producenta `vendorId`);
+    /// brakujący wpis jest dodawany do bazy.
+    bool resolveDictionaryId(int dictionary,
+                             const QString &name,
+                             const QString &vendorId,
+                             QString *id,
+                             ItemImportResult *result,
+                             QString *errorMessage);
+
+    QSqlDatabase m_db;
+    /// Nazwa po toCaseFolded() → ID, osobno dla każdej tabeli słownika; klucz modelu
+    /// zawiera też ID producenta (dictionaryKey).
+    QHash<QString, QString> m_dictionaryIds[5];
+    /// Nazwa modelu po toCaseFolded() → ID producenta (models.name jest UNIQUE).
+    QHash<QString, QString> m_modelVendorIds;
+};
+
+#endif // ITEMCSVIMPORTER_H
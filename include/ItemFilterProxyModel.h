@@ -36,7 +36,15 @@
 #ifndef ITEMFILTERPROXYMODEL_H
 #define ITEMFILTERPROXYMODEL_H
 
+#include "ItemFilterState.h"
+#include "ItemRowFilter.h"
+
+#include <QBitArray>
+#include <QHash>
 #include <QSortFilterProxyModel>
+#include <QVector>
+
+class ItemTableModel;
 
 /**
  * @class ItemFilterProxyModel
@@ -127,6 +135,10 @@ public:
      */
     void setNameFilter(const QString &name);
 
+    /// true, gdy filtr nazwy rozwiązał indeks pełnotekstowy bazy (applyFilterState
+    /// z rankingiem); widok jest wtedy sortowany wg trafności.
+    bool hasFullTextMatches() const { return m_fullTextActive; }
+
     /**
      * @brief Ustawia filtr dla oryginalnego pakowania eksponatu.
      * @param show bool czy pokazywać eksponaty z oryginalnym pakowaniem.
@@ -141,6 +153,35 @@ public:
     void setWithoutModelFilter(bool show);
     void setWithoutVendorFilter(bool show);
 
+    /// Wszystkie filtry naraz — jedno invalidateFilter() zamiast jednego na setter.
+    ItemFilterState filterState() const;
+    void setFilterState(const ItemFilterState &state);
+    /// Jak setFilterState, z wynikiem policzonym w tle przez ItemFilterScheduler:
+    /// `acceptedRows` — bit na wiersz ItemTableModel w wersji `revision` (gdy model
+    /// zmienił się od tego czasu, wynik jest pomijany), `fullTextRanks` — ranking
+    /// indeksu pełnotekstowego albo nullptr (szukanie w pamięci).
+    void applyFilterState(const ItemFilterState &state,
+                          const ItemRowFilter::FullTextRanks *fullTextRanks,
+                          const QBitArray &acceptedRows,
+                          quint64 revision);
+
+    /// Dla ItemTableModel filtry słownikowe są zamieniane na nameId przy każdym
+    /// resecie modelu, a filterAcceptsRow porównuje liczby zamiast tekstów z data().
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
+    /// Dla ItemTableModel sortowanie kolumny przekazywane jest do modelu źródłowego
+    /// (porównania liczb zamiast QString w lessThan); proxy nie sortuje samo.
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    /// Liczba wierszy na nameId, osobno dla każdego słownika (indeks = ItemTableModel::Dictionary).
+    using FacetCounts = ItemRowFilter::FacetCounts;
+
+    /// Opcje kaskadowych combo boxów liczone w pamięci, jednym przebiegiem po
+    /// ItemTableModel. Wiersz jest liczony w słowniku D, gdy spełnia wszystkie filtry
+    /// poza filtrem samego D — combo pokazuje wartości, na które można się przełączyć.
+    /// Dla innego modelu źródłowego zwraca puste wektory.
+    FacetCounts facetCounts() const;
+
 protected:
     /**
      * @brief Decyduje, czy dany wiersz modelu źródłowego powinien być widoczny.
@@ -155,9 +196,23 @@ protected:
      * dla danego atrybutu oznacza, że wszystkie wartości dla tej kolumny są akceptowane.
      */
     bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+    /// Przy aktywnym wyniku pełnotekstowym — kolejność trafności, w pozostałych przypadkach bez zmian.
+    bool lessThan(const QModelIndex &sourceLeft, const QModelIndex &sourceRight) const override;
 
 private:
     bool matchesSearchText(int sourceRow, const QModelIndex &sourceParent) const;
+    /// Przenosi bieżące filtry do m_rowFilter; wynik policzony w tle przestaje obowiązywać.
+    void updateRowFilter();
+
+    /// Model źródłowy, gdy jest nim ItemTableModel (szybka ścieżka filtrowania).
+    const ItemTableModel *m_itemModel = nullptr;
+    QMetaObject::Connection m_itemModelResetConnection;
+    QMetaObject::Connection m_itemModelDictionaryConnection;
+    /// Filtry rozwiązane względem m_itemModel (nameId, tekst po fold()).
+    ItemRowFilter m_rowFilter;
+    /// Wynik z applyFilterState (bit = wiersz źródła), ważny dla ItemTableModel::revision().
+    QBitArray m_acceptedRows;
+    quint64 m_acceptedRowsRevision = 0;
     /// Filtr dla typu eksponatu (pusty oznacza brak filtru).
     QString m_type;
     /// Filtr dla producenta eksponatu (pusty oznacza brak filtru).
@@ -170,6 +225,9 @@ private:
     QString m_storage;
     /// Filtr dla nazwy eksponatu (pusty oznacza brak filtru).
     QString m_nameFilter;
+    /// v1.5: wynik indeksu pełnotekstowego: ID eksponatu → pozycja w rankingu.
+    ItemRowFilter::FullTextRanks m_fullTextRanks;
+    bool m_fullTextActive = false;
     /// Filtr dla oryginalnego pakowania eksponatu.
     bool m_showOriginalPackaging;
     /// Flaga czy filtr oryginalnego pakowania jest aktywny.
@@ -0,0 +1,87 @@
+#ifndef ITEMFILTERSCHEDULER_H
+#define ITEMFILTERSCHEDULER_H
+
+#include "ItemFilterProxyModel.h"
+#include "ItemFilterState.h"
+
+#include <QObject>
+#include <QThreadPool>
+
+#include <atomic>
+#include <functional>
+#include <utility>
+
+class ItemTableModel;
+class QTimer;
+
+/**
+ * @class ItemFilterScheduler
+ * @brief Jedno miejsce, przez które itemList zmienia filtry listy eksponatów.
+ *
+ * @section ClassOverview
+ * schedule() tylko zapamiętuje stan i (re)startuje krótki timer, więc kilka zmian
+ * w jednym obiegu pętli zdarzeń (czyszczenie filtrów, przywracanie zapisanych, szybkie
+ * klikanie) daje jedno filtrowanie dla ostatniego stanu. Stan równy już zastosowanemu,
+ * przy niezmienionym modelu, nie filtruje wcale.
+ *
+ * @section Notes
+ * W wątku GUI zostaje to, co wymaga bazy: sygnał aboutToFilter (filtry SQL) i zapytanie
+ * do indeksu pełnotekstowego. Dopasowanie wierszy i liczniki combo boxów liczy
+ * ItemRowFilter w puli wątków na kopii modelu (ItemTableModel::createSnapshot). Nowszy
+ * stan przerywa liczenie starszego, a wynik dla modelu zmienionego w międzyczasie jest
+ * liczony od nowa.
+ */
+class ItemFilterScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// Zwraca true i ranking ID eksponatów, gdy tekst obsłużył indeks pełnotekstowy bazy.
+    using FullTextSearch = std::function<bool(const QString &text, QStringList *rankedItemIds)>;
+
+    ItemFilterScheduler(ItemTableModel *model, ItemFilterProxyModel *proxyModel, QObject *parent = nullptr);
+    ~ItemFilterScheduler() override;
+
+    void setFullTextSearch(FullTextSearch search) { m_fullTextSearch = std::move(search); }
+
+    /// Filtrowanie ruszy po `delayMs` od ostatniego wywołania (0 — w następnym obiegu pętli zdarzeń).
+    void schedule(const ItemFilterState &state, int delayMs = 0);
+    /// Filtruje od razu, w tym wątku, stan czekający w schedule() (albo bieżący).
+    void flush();
+    /// Ostatni stan przekazany do schedule().
+    ItemFilterState pendingState() const { return m_pendingState; }
+    /// Czeka na timer albo na wynik z puli wątków.
+    bool isBusy() const;
+
+signals:
+    /// W wątku GUI, przed dopasowaniem wierszy — tu można przeładować model (filtry SQL).
+    void aboutToFilter(const ItemFilterState &state);
+    /// Proxy ma już nowy stan; liczniki wartości słowników dla combo boxów.
+    void filtered(const ItemFilterState &state, const ItemFilterProxyModel::FacetCounts &facets);
+
+private:
+    /// Filtry SQL (aboutToFilter) i zapytanie do indeksu pełnotekstowego. Zwraca true,
+    /// gdy tekst obsłużył indeks — ranking jest wtedy w `fullTextRanks`.
+    bool prepare(const ItemFilterState &state, ItemRowFilter::FullTextRanks *fullTextRanks);
+    void start();
+    void finish(quint64 generation, const ItemFilterState &state, bool fullText,
+                const ItemRowFilter::FullTextRanks &fullTextRanks, const QBitArray &acceptedRows,
+                const ItemFilterProxyModel::FacetCounts &facets, quint64 revision);
+
+    ItemTableModel *m_model;
+    ItemFilterProxyModel *m_proxyModel;
+    FullTextSearch m_fullTextSearch;
+    QTimer *m_timer;
+    /// Jeden wątek — kolejne zadania i tak unieważniają poprzednie.
+    QThreadPool m_pool;
+    /// Numer ostatnio uruchomionego filtrowania; zadanie o innym numerze przerywa pracę.
+    std::atomic<quint64> m_generation{0};
+    bool m_running = false;
+
+    ItemFilterState m_pendingState;
+    bool m_hasApplied = false;
+    ItemFilterState m_appliedState;
+    quint64 m_appliedRevision = 0;
+};
+
+#endif // ITEMFILTERSCHEDULER_H
@@ -0,0 +1,41 @@
+#ifndef ITEMFILTERSTATE_H
+#define ITEMFILTERSTATE_H
+
+#include <QString>
+
+#include <array>
+
+/**
+ * @struct ItemFilterState
+ * @brief Komplet filtrów listy eksponatów jako jedna wartość.
+ *
+ * itemList składa go z kontrolek, a ItemFilterScheduler porównuje kolejne stany
+ * i filtruje raz na zmianę.
+ */
+struct ItemFilterState
+{
+    /// Nazwy wpisów słowników, indeks = ItemTableModel::Dictionary; pusta — bez filtru.
+    std::array<QString, 5> dictionaryNames;
+    /// Tekst pola „Szukaj”.
+    QString searchText;
+    bool originalPackagingOnly = false;
+    bool withoutDescriptionOnly = false;
+    bool withoutSerialNumberOnly = false;
+    /// Tylko rekordy z modelem/producentem „zastępczym” (ItemTableModel::isPlaceholderName).
+    bool withoutModelOnly = false;
+    bool withoutVendorOnly = false;
+
+    bool operator==(const ItemFilterState &other) const
+    {
+        return dictionaryNames == other.dictionaryNames
+               && searchText == other.searchText
+               && originalPackagingOnly == other.originalPackagingOnly
+               && withoutDescriptionOnly == other.withoutDescriptionOnly
+               && withoutSerialNumberOnly == other.withoutSerialNumberOnly
+               && withoutModelOnly == other.withoutModelOnly
+               && withoutVendorOnly == other.withoutVendorOnly;
+    }
+    bool operator!=(const ItemFilterState &other) const { return !(*this == other); }
+};
+
+#endif // ITEMFILTERSTATE_H
@@ -0,0 +1,64 @@
+#ifndef ITEMQUERYBUILDER_H
+#define ITEMQUERYBUILDER_H
+
+#include "ItemTableModel.h"
+
+#include <QString>
+#include <QStringList>
+#include <QVariantList>
+#include <QVector>
+
+/// v1.5: filtry listy eksponatów jako parametryzowany warunek SQL na tabeli
+/// eksponaty (dla ItemTableModel::setRowFilter). Słowniki są filtrowane po UUID,
+/// nie po nazwach — zapytanie korzysta z indeksów na type_id, vendor_id itd.,
+/// a baza wysyła tylko pasujące rekordy.
+///
+/// Filtr tekstowy „Szukaj” obsługuje ItemFilterProxyModel (indeks pełnotekstowy albo
+/// indeks trigramów w pamięci); setSearchText jest dla trybu stronicowanego, w którym
+/// model nie ma wszystkich rekordów.
+///
+/// facetCountSql liczy wartości jednego słownika przy pozostałych filtrach — dla
+/// combo boxów, gdy model ma tylko rekordy spełniające wszystkie filtry.
+class ItemQueryBuilder
+{
+public:
+    /// Tylko rekordy z jednym z podanych UUID w kolumnie słownika; pusta lista — żaden rekord.
+    /// Filtr combo boxa: facetCountSql tego słownika go pomija.
+    void restrictDictionary(ItemTableModel::Dictionary dictionary, const QStringList &uuids);
+    /// Jak restrictDictionary, dla filtrów „bez modelu/producenta” — obowiązuje też
+    /// w licznikach tego słownika (jak flagi w ItemRowFilter::facetCounts).
+    void restrictToPlaceholders(ItemTableModel::Dictionary dictionary, const QStringList &placeholderUuids);
+    void setOriginalPackagingOnly(bool enabled);
+    void setWithoutDescriptionOnly(bool enabled);
+    void setWithoutSerialNumberOnly(bool enabled);
+    /// Rekordy, w których `text` jest podciągiem nazwy, numeru seryjnego, part numbera,
+    /// opisu albo nazwy producenta lub modelu — jak „Szukaj” w pamięci, ale wielkość
+    /// liter i polskie znaki porównuje collation bazy. Pusty tekst — bez warunku.
+    void setSearchText(const QString &text);
+
+    /// Warunki połączone AND, bez słowa WHERE; pusty, gdy żaden filtr nie jest aktywny.
+    QString whereSql() const;
+    /// Parametry „?” w kolejności z whereSql().
+    QVariantList bindValues() const;
+
+    /// `SELECT <kolumna>, COUNT(*) FROM eksponaty WHERE … GROUP BY <kolumna>` ze wszystkimi
+    /// warunkami poza restrictDictionary(`dictionary`) — combo pokazuje wartości, na które
+    /// można się przełączyć. Parametry trafiają do `bindValues`.
+    QString facetCountSql(ItemTableModel::Dictionary dictionary, QVariantList *bindValues) const;
+
+private:
+    struct Condition
+    {
+        QString sql;
+        QVariantList bindValues;
+        /// Słownik filtru combo boxa albo -1 (warunek obowiązuje we wszystkich licznikach).
+        int dictionary = -1;
+    };
+
+    void addDictionaryCondition(ItemTableModel::Dictionary dictionary, const QStringList &uuids, int owner);
+    QString joinConditions(int skippedDictionary, QVariantList *bindValues) const;
+
+    QVector<Condition> m_conditions;
+};
+
+#endif // ITEMQUERYBUILDER_H
@@ -8,8 +8,15 @@
 #include <QString>
 #include <QStringList>
 
+#include <functional>
+
+struct IngestedPhoto;
+
 struct ItemRecordData
 {
+    /// Najdłuższa nazwa eksponatu — w MySQL kolumna name to VARCHAR(255) (indeks stron).
+    static constexpr int kMaxNameLength = 255;
+
     QString id;
     QString name;
     QString serialNumber;
@@ -27,6 +34,14 @@ struct ItemRecordData
     bool editMode = false;
 };
 
+/// v1.5: błąd zapisu jednego rekordu w ItemRepository::saveItems — pozostałe rekordy są zapisywane.
+struct ItemSaveError
+{
+    /// Indeks rekordu w liście przekazanej do saveItems.
+    int index = -1;
+    QString message;
+};
+
 /// O-5 (audit 2026-04-26): m_db jest QSqlDatabase HANDLE — refcounted reference
 /// do globalnego connection pool Qt. Repository NIE OWNS connection.
 ///
@@ -40,6 +55,9 @@ struct ItemRecordData
 ///
 /// Sygnatury metod używają `m_db.isOpen()` jako runtime check, ale `isValid()`
 /// (handle wskazuje na żywy connection) NIE jest sprawdzany. Trust caller contract.
+///
+/// v1.5: po każdym udanym zapisie/usunięciu ID zmienionych rekordów trafiają do
+/// ItemChangeNotifier — lista eksponatów łata tylko te wiersze.
 class ItemRepository
 {
     // O-6 (audit 2026-04-26): translation context = "ItemRepository" zamiast
@@ -54,14 +72,37 @@ public:
                   const QList<QByteArray> &newPhotos,
                   QString *savedItemId,
                   QString *errorMessage);
+    /// Jak saveItem, ale ze zdjęciami przygotowanymi przez PhotoService::ingestFiles —
+    /// skróty i miniatury policzone w tle nie są liczone drugi raz w wątku GUI.
+    bool saveItemWithIngestedPhotos(const ItemRecordData &item,
+                                    const QList<IngestedPhoto> &newPhotos,
+                                    QString *savedItemId,
+                                    QString *errorMessage);
+
+    /// v1.5: zapis wielu NOWYCH rekordów (bez zdjęć) — import CSV. Wielowierszowe
+    /// INSERT-y, transakcja na kBulkInsertTransactionSize rekordów. Rekord odrzucony
+    /// przez bazę trafia do `rowErrors` i nie przerywa zapisu pozostałych.
+    /// `progressCallback(zapisane, wszystkie)` po każdej transakcji; false przerywa
+    /// zapis — zatwierdzone wcześniej transakcje zostają w bazie.
+    /// Zwraca false tylko dla błędu całej operacji (połączenie, transakcja, przerwanie).
+    bool saveItems(const QList<ItemRecordData> &items,
+                   QStringList *savedItemIds,
+                   QList<ItemSaveError> *rowErrors,
+                   QString *errorMessage,
+                   const std::function<bool(int, int)> &progressCallback = {});
 
     bool deleteItem(const QString &itemId, QString *errorMessage);
+    /// v1.5: zmiana zbiorcza w jednej transakcji, paczkami ID (UPDATE ... WHERE id IN (...)).
+    /// `progressCallback` dostaje (zmienione, wszystkie) po każdej paczce; zwrócenie
+    /// false przerywa operację i wycofuje transakcję.
     bool updateStatusForItems(const QStringList &itemIds,
                               const QString &statusId,
-                              QString *errorMessage);
+                              QString *errorMessage,
+                              const std::function<bool(int, int)> &progressCallback = {});
     bool updateStoragePlaceForItems(const QStringList &itemIds,
                                     const QString &storagePlaceId,
-                                    QString *errorMessage);
+                                    QString *errorMessage,
+                                    const std::function<bool(int, int)> &progressCallback = {});
 
     /// v1.5 (AI enrichment): UPDATE eksponaty SET description = :desc WHERE id = :id.
     /// Używane przez "Wzbogać opis AI" w PreviewDialog po accept.
@@ -70,11 +111,19 @@ public:
                            QString *errorMessage);
 
 private:
+    /// Jeden wielowierszowy INSERT dla items[begin, end); gdy baza go odrzuci,
+    /// rekordy są wstawiane pojedynczo, a odrzucone trafiają do `rowErrors`.
+    void insertItemBatch(const QList<ItemRecordData> &items,
+                         int begin,
+                         int end,
+                         QStringList *savedItemIds,
+                         QList<ItemSaveError> *rowErrors);
     bool updateItemsColumn(const QStringList &itemIds,
                            const QString &columnName,
                            const QString &valueId,
                            const QString &operationLabel,
-                           QString *errorMessage);
+                           QString *errorMessage,
+                           const std::function<bool(int, int)> &progressCallback);
 
     QSqlDatabase m_db;
 };
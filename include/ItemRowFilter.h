@@ -0,0 +1,84 @@
+#ifndef ITEMROWFILTER_H
+#define ITEMROWFILTER_H
+
+#include "ItemFilterState.h"
+
+#include <QBitArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <array>
+#include <functional>
+
+class ItemTableModel;
+
+/**
+ * @class ItemRowFilter
+ * @brief Dopasowanie wierszy ItemTableModel do ItemFilterState.
+ *
+ * @section ClassOverview
+ * Porównuje nameId i flagi wiersza, a tekst tylko dla pola „Szukaj”. Używa go
+ * ItemFilterProxyModel (w wątku GUI, na żywym modelu) i ItemFilterScheduler (w tle,
+ * na kopii modelu).
+ *
+ * @section Notes
+ * Obiekt jest używany naraz tylko w jednym wątku, bo kandydaci z indeksu trigramów są
+ * liczeni leniwie. Model nie może się zmieniać w trakcie acceptedRows/facetCounts.
+ */
+class ItemRowFilter
+{
+public:
+    /// ID eksponatu → pozycja w rankingu indeksu pełnotekstowego.
+    using FullTextRanks = QHash<QString, int>;
+    /// Liczba wierszy na nameId, osobno dla każdego słownika (indeks = ItemTableModel::Dictionary).
+    using FacetCounts = std::array<QVector<int>, 5>;
+
+    /// Rozwiązuje `state` względem `model`: nazwy słowników → nameId, tekst → fold().
+    /// Z `fullTextRanks` filtr tekstu przepuszcza wiersze z rankingu oraz te, w których
+    /// każde słowo tekstu występuje w nazwie producenta, modelu albo w pozostałych polach,
+    /// a co najmniej jedno w nazwie producenta lub modelu (tych nie ma w indeksie bazy).
+    void reset(const ItemTableModel *model, const ItemFilterState &state,
+               const FullTextRanks *fullTextRanks = nullptr);
+    /// Ponownie rozwiązuje nazwy — po reload() albo gdy do słownika doszła nowa nazwa.
+    void resolve();
+
+    const ItemFilterState &state() const { return m_state; }
+    bool hasFullTextRanks() const { return m_fullTextActive; }
+    /// Pozycja w rankingu; wiersze spoza rankingu dostają liczbę jego pozycji.
+    int fullTextRank(const QString &itemId) const;
+
+    bool acceptsRow(int row) const;
+    /// Bit na wiersz modelu. `cancelled` jest sprawdzane co kilka tysięcy wierszy —
+    /// po przerwaniu zwraca false i `rows` jest niepełne.
+    bool acceptedRows(QBitArray *rows, const std::function<bool()> &cancelled = {}) const;
+    /// Wiersz jest liczony w słowniku D, gdy spełnia wszystkie filtry poza filtrem
+    /// samego D — combo pokazuje wartości, na które można się przełączyć.
+    bool facetCounts(FacetCounts *facets, const std::function<bool()> &cancelled = {}) const;
+
+private:
+    bool acceptsFlagsAndText(int row) const;
+    bool matchesSearchText(int row) const;
+
+    const ItemTableModel *m_model = nullptr;
+    ItemFilterState m_state;
+    /// nameId filtrów słownikowych: typ, producent, model, status, miejsce przechowywania.
+    int m_dictionaryFilterIds[5] = {-1, -1, -1, -1, -1};
+    /// m_state.searchText po ItemSearchIndex::fold().
+    QString m_foldedSearchText;
+    /// m_foldedSearchText podzielony na słowa jak w ItemSearchService (tylko przy m_fullTextActive).
+    QStringList m_foldedSearchTokens;
+    /// Kandydaci z indeksu trigramów (bit = searchDocumentId), liczeni leniwie
+    /// i ponownie po każdej zmianie indeksu (searchGeneration).
+    mutable QBitArray m_searchCandidates;
+    mutable quint64 m_searchCandidatesGeneration = 0;
+    mutable bool m_searchUsesIndex = false;
+    FullTextRanks m_fullTextRanks;
+    bool m_fullTextActive = false;
+    /// nameId producentów i modeli, których nazwa zawiera któreś słowo (tylko przy m_fullTextActive).
+    QBitArray m_fullTextVendorIds;
+    QBitArray m_fullTextModelIds;
+};
+
+#endif // ITEMROWFILTER_H
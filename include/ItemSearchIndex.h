@@ -0,0 +1,46 @@
+#ifndef ITEMSEARCHINDEX_H
+#define ITEMSEARCHINDEX_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+/// v1.5: odwrócony indeks trigramów dla pola „Szukaj” listy eksponatów.
+///
+/// **Dokumenty:** każdy eksponat to jeden dokument o stałym docId (ItemTableModel
+/// nadaje je rosnąco i nie używa ponownie). Tekst dokumentu to nazwa, producent,
+/// model, numer seryjny, part number i opis — rozdzielone '\n', po fold().
+///
+/// **Zapytanie:** listy docId trigramów zapytania są przecinane od najkrótszej.
+/// Wynik to nadzbiór trafień (trigramy mogą wystąpić w innej kolejności), więc
+/// wywołujący i tak sprawdza contains() — ale tylko dla kandydatów.
+///
+/// **Wątki:** brak synchronizacji; indeks żyje w wątku modelu.
+class ItemSearchIndex
+{
+public:
+    /// Wielkość liter i polskie znaki sprowadzone do ASCII: „Łódź” → „lodz”.
+    static QString fold(const QString &text);
+
+    void clear();
+    /// Zastępuje trigramy dokumentu trigramami tekstu już złożonego przez fold().
+    void setDocument(int docId, const QString &foldedText);
+    void removeDocument(int docId);
+
+    /// docId (rosnąco) dokumentów zawierających wszystkie trigramy zapytania.
+    /// Zwraca false, gdy zapytanie jest krótsze niż trigram — indeks nie zawęża wtedy
+    /// wyników i trzeba sprawdzić wszystkie dokumenty.
+    bool candidates(const QString &foldedQuery, QVector<int> *docIds) const;
+
+private:
+    using Trigram = quint64;
+
+    static QVector<Trigram> trigrams(const QString &foldedText);
+
+    /// trigram → posortowane docId.
+    QHash<Trigram, QVector<int>> m_postings;
+    /// docId → trigramy dokumentu (do usuwania przy edycji).
+    QHash<int, QVector<Trigram>> m_documentTrigrams;
+};
+
+#endif // ITEMSEARCHINDEX_H
@@ -0,0 +1,43 @@
+#ifndef ITEMSEARCHSERVICE_H
+#define ITEMSEARCHSERVICE_H
+
+#include <QCoreApplication>
+#include <QSqlDatabase>
+#include <QString>
+#include <QStringList>
+
+/// v1.5: pole „Szukaj” listy eksponatów odpytujące indeks pełnotekstowy bazy
+/// (SQLite FTS5 `eksponaty_fts`, MySQL FULLTEXT `ft_eksponaty_text`) zamiast
+/// przeglądać opisy w pamięci.
+///
+/// **Zapytanie:** tekst jest dzielony na słowa; każde słowo musi wystąpić jako
+/// prefiks słowa w nazwie, numerze seryjnym, part numberze albo opisie. Wynik jest
+/// posortowany wg trafności (bm25 / MATCH ... AGAINST).
+///
+/// **Fallback:** search() zwraca false bez komunikatu błędu, gdy indeksu nie ma,
+/// jest wyłączony (`search/fulltext` w inwentaryzacja.ini) albo zapytania nie da się
+/// wyrazić w indeksie (np. słowa krótsze niż innodb_ft_min_token_size w MySQL).
+/// Wywołujący szuka wtedy jak dotąd — w ItemTableModel.
+///
+/// **Domyślnie wyłączony:** indeks dopasowuje prefiksy słów, a pole „Szukaj”
+/// dotąd szukało podciągów („64” znajduje „C64”). Włącza się go świadomie,
+/// ustawiając `search/fulltext=true`.
+class ItemSearchService
+{
+    Q_DECLARE_TR_FUNCTIONS(ItemSearchService)
+
+public:
+    explicit ItemSearchService(QSqlDatabase database = QSqlDatabase::database("default_connection"));
+
+    /// true, gdy indeks pełnotekstowy istnieje i jest włączony w ustawieniach.
+    /// Sprawdzane raz na połączenie — zmiana ustawienia działa po ponownym połączeniu.
+    bool isAvailable() const;
+
+    /// ID pasujących eksponatów, od najlepiej dopasowanych.
+    bool search(const QString &text, QStringList *itemIds, QString *errorMessage) const;
+
+private:
+    QSqlDatabase m_db;
+};
+
+#endif // ITEMSEARCHSERVICE_H
@@ -0,0 +1,294 @@
+#ifndef ITEMTABLEMODEL_H
+#define ITEMTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QSqlDatabase>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVariantList>
+#include <QVector>
+
+#include "ItemSearchIndex.h"
+
+class QCollator;
+class QSqlQuery;
+
+#include <array>
+#include <limits>
+#include <memory>
+
+/**
+ * @class ItemTableModel
+ * @brief Tabela eksponatów wczytywana jednym SELECT-em do pamięci, w układzie kolumnowym.
+ *
+ * @section ClassOverview
+ * Zastępuje QSqlRelationalTableModel z pięcioma QSqlRelation. Każda kolumna to osobny
+ * wektor indeksowany numerem wiersza. Słowniki (typ, producent, model, status, miejsce)
+ * są internowane po nazwie — wiersz trzyma tylko nameId, a nazwy leżą raz
+ * w DictionaryColumn::names. Kilka UUID o tej samej nazwie dostaje to samo nameId, więc
+ * filtr po nazwie z combo boxa zachowuje się jak porównanie tekstów. Układ kolumn jest
+ * taki sam jak w tabeli eksponaty, a wiersze z odwołaniem do nieistniejącego wpisu
+ * słownika są pomijane (jak INNER JOIN w QSqlRelation).
+ *
+ * @section Responsibilities
+ * - Filtrowanie: ItemFilterProxyModel porównuje nameId i flagi wiersza zamiast wołać
+ *   data() dla każdej kolumny.
+ * - Aktualizacje: refreshItems/removeItems łatają pojedyncze wiersze (dataChanged,
+ *   rowsInserted, rowsRemoved), więc zaznaczenie i przewinięcie widoku zostają.
+ *   itemList podłącza je do ItemChangeNotifier.
+ * - Szukanie: tekst pól „Szukaj” jest trzymany po ItemSearchIndex::fold() i indeksowany
+ *   trigramami razem z wierszem (appendRow/assignRow/removeItems).
+ * - Sortowanie: sort() przestawia wiersze w samym modelu. Kolumny słownikowe porównują
+ *   rangi nazw (QCollator raz na słownik), liczbowe — wartości; duże tabele są sortowane
+ *   równolegle. Wiersze z refreshItems() trafiają na swoje miejsce w aktywnym porządku.
+ *
+ * @section Notes
+ * Przy setPageSize(n) reload() czyta tylko COUNT(*) i pierwszą stronę, a kolejne dociąga
+ * fetchMore(). Strony są wyznaczane kluczem (kolumna sortowania, id) bez OFFSET (pageSql),
+ * sort() ustawia wtedy ORDER BY w bazie i wczytuje listę od początku (porządek tekstów wg
+ * collation bazy). Filtry i „Szukaj” idą do bazy przez setRowFilter (ItemQueryBuilder).
+ */
+class ItemTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        IdColumn = 0,
+        NameColumn,
+        TypeColumn,
+        VendorColumn,
+        ModelColumn,
+        SerialNumberColumn,
+        PartNumberColumn,
+        RevisionColumn,
+        ProductionYearColumn,
+        StatusColumn,
+        StorageColumn,
+        DescriptionColumn,
+        ValueColumn,
+        PackagingColumn,
+        ColumnCount
+    };
+
+    enum Dictionary {
+        TypeDictionary = 0,
+        VendorDictionary,
+        ModelDictionary,
+        StatusDictionary,
+        StorageDictionary,
+        DictionaryCount
+    };
+
+    explicit ItemTableModel(QSqlDatabase db = QSqlDatabase::database("default_connection"),
+                            QObject *parent = nullptr);
+
+    /// Wczytuje słowniki i eksponaty od nowa (beginResetModel/endResetModel).
+    bool reload(QString *errorMessage = nullptr);
+
+    /// v1.5: 0 — cała tabela jednym SELECT-em (domyślnie); n > 0 — strony po n wierszy.
+    /// Zmiana działa od następnego reload().
+    void setPageSize(int pageSize) { m_pageSize = qMax(0, pageSize); }
+    int pageSize() const { return m_pageSize; }
+    /// Zapytanie strony w bieżącym porządku sortowania. `afterKey` — z warunkiem
+    /// `(klucz, id) > (?, ?)` (dwa ostatnie parametry dopisuje wywołujący).
+    QString pageSql(bool afterKey, QVariantList *bindValues) const;
+    /// Warunek SQL na kolumny tabeli eksponaty (bez słowa WHERE, parametry „?”),
+    /// nakładany na reload(), strony i refreshItems(). Pusty — wszystkie rekordy.
+    /// Zmiana działa od następnego reload().
+    void setRowFilter(const QString &whereSql, const QVariantList &bindValues);
+    QString rowFilterSql() const { return m_rowFilterSql; }
+    QVariantList rowFilterBindValues() const { return m_rowFilterBindValues; }
+    /// Liczba rekordów spełniających setRowFilter — w trybie stronicowanym także niewczytanych.
+    int totalRowCount() const { return m_totalRowCount; }
+
+    /// Sortowanie stabilne — przy równych kluczach zostaje dotychczasowa kolejność.
+    /// column < 0 tylko zapamiętuje brak sortowania (kolejność zostaje). W trybie
+    /// stronicowanym sortuje baza: reload() od pierwszej strony w nowym porządku.
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+    int sortColumn() const { return m_sortColumn; }
+    Qt::SortOrder sortOrder() const { return m_sortOrder; }
+
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+    /// Zmienia się przy każdej zmianie wierszy (także kolejności) — wynik liczony
+    /// dla starszej wersji modelu jest nieaktualny.
+    quint64 revision() const { return m_revision; }
+    /// Kopia danych do czytania w innym wątku (kontenery Qt są współdzielone, więc kopia
+    /// jest tania). Bez połączenia z bazą i bez przynależności do wątku — można ją
+    /// usunąć w dowolnym wątku.
+    std::unique_ptr<ItemTableModel> createSnapshot() const;
+
+    /// Dociąga z bazy tylko podane rekordy: zmienione → dataChanged, nowe → rowsInserted,
+    /// nieobecne już w bazie → rowsRemoved. Przy aktywnym sortowaniu zmienione i nowe
+    /// wiersze są przesuwane na swoje miejsce (bez sortowania — nowe na końcu).
+    bool refreshItems(const QStringList &itemIds, QString *errorMessage = nullptr);
+    /// Usuwa wiersze podanych rekordów bez odpytywania bazy.
+    void removeItems(const QStringList &itemIds);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    QString itemId(int row) const { return m_ids.value(row); }
+    QString itemName(int row) const { return m_names.value(row); }
+    /// -1, gdy eksponatu nie ma w modelu.
+    int rowForItemId(const QString &itemId) const { return m_rowById.value(itemId, -1); }
+
+    /// nameId wiersza w danym słowniku.
+    int dictionaryId(Dictionary dictionary, int row) const { return m_dictionaries[dictionary].rows[row]; }
+    /// nameId dla nazwy albo -1, gdy żaden eksponat nie ma takiej wartości w słowniku.
+    int findDictionaryName(Dictionary dictionary, const QString &name) const;
+    QString dictionaryName(Dictionary dictionary, int nameId) const;
+    int dictionarySize(Dictionary dictionary) const { return m_dictionaries[dictionary].names.size(); }
+    /// Nazwa pusta albo „unknown” / „brak” / „nieznany” — filtry „bez modelu/producenta”.
+    bool isPlaceholderName(Dictionary dictionary, int nameId) const;
+    /// UUID wpisów słownika o danej nazwie (kilka wpisów może mieć tę samą nazwę).
+    QStringList dictionaryUuids(Dictionary dictionary, const QString &name) const;
+    /// nameId wpisu słownika o danym UUID albo -1, gdy go nie wczytano.
+    int dictionaryNameId(Dictionary dictionary, const QString &uuid) const
+    {
+        return m_dictionaries[dictionary].nameIdByUuid.value(uuid, -1);
+    }
+    /// UUID wpisów z nazwą „zastępczą” (patrz isPlaceholderName).
+    QStringList placeholderUuids(Dictionary dictionary) const;
+
+    bool hasOriginalPackaging(int row) const { return m_flags[row] & OriginalPackagingFlag; }
+    bool hasEmptyDescription(int row) const { return m_flags[row] & EmptyDescriptionFlag; }
+    bool hasEmptySerialNumber(int row) const { return m_flags[row] & EmptySerialNumberFlag; }
+
+    /// Szukanie pełnotekstowe listy: nazwa, producent, model, numer seryjny, part number, opis.
+    /// Bez rozróżniania wielkości liter i polskich znaków.
+    bool rowContainsText(int row, const QString &text) const;
+    /// Jak rowContainsText, dla zapytania już złożonego przez ItemSearchIndex::fold().
+    bool rowContainsFoldedText(int row, const QString &foldedText) const
+    {
+        return m_searchTexts[row].contains(foldedText);
+    }
+
+    /// Stały identyfikator wiersza w indeksie wyszukiwania (nie zmienia się po usunięciu innych wierszy).
+    int searchDocumentId(int row) const { return m_searchDocIds[row]; }
+    /// Górna granica searchDocumentId.
+    int searchDocumentLimit() const { return m_nextSearchDocId; }
+    /// Zmienia się przy każdej zmianie indeksu — kandydaci policzeni wcześniej są nieaktualni.
+    quint64 searchGeneration() const { return m_searchGeneration; }
+    /// Patrz ItemSearchIndex::candidates — wynik to searchDocumentId.
+    bool searchCandidates(const QString &foldedText, QVector<int> *documentIds) const
+    {
+        return m_searchIndex.candidates(foldedText, documentIds);
+    }
+
+signals:
+    /// Do słownika doszła nazwa spoza ostatniego reload() — filtry po nazwie trzeba
+    /// rozwiązać ponownie. Emitowany przed zmianą wierszy.
+    void dictionaryNamesAdded();
+
+private:
+    enum RowFlag : quint8 {
+        OriginalPackagingFlag = 0x01,
+        EmptyDescriptionFlag = 0x02,
+        EmptySerialNumberFlag = 0x04
+    };
+
+    struct DictionaryColumn
+    {
+        /// nameId → nazwa.
+        QStringList names;
+        /// nameId → 1, gdy nazwa jest „zastępcza” (patrz isPlaceholderName).
+        QVector<quint8> placeholders;
+        /// wiersz → nameId.
+        QVector<int> rows;
+        QHash<QString, int> nameIdByName;
+        QHash<QString, int> nameIdByUuid;
+        /// nameId → pozycja nazwy w porządku QCollator (równe nazwy — ta sama ranga).
+        /// Liczone w sort(), gdy słownik urósł od ostatniego liczenia.
+        QVector<int> sortRanks;
+
+        int intern(const QString &name);
+        void updateSortRanks(const QCollator &collator);
+    };
+
+    /// Jeden rekord odczytany z zapytania, przed wpisaniem do kolumn.
+    struct RowValues
+    {
+        QString id;
+        QString name;
+        QString serialNumber;
+        QString partNumber;
+        QString revision;
+        QString description;
+        int productionYear = 0;
+        int value = 0;
+        quint8 flags = 0;
+        int nameIds[DictionaryCount] = {};
+    };
+
+    /// `fetchMissing` — UUID spoza wczytanych słowników jest dociągany z bazy
+    /// (nowy wpis słownika); `extended` = true, gdy dodano nową nazwę.
+    bool readRow(const QSqlQuery &query, bool fetchMissing, RowValues *values, bool *extended);
+    int resolveDictionaryUuid(Dictionary dictionary, const QString &uuid, bool fetchMissing, bool *extended);
+    void appendRow(const RowValues &values);
+    void assignRow(int row, const RowValues &values);
+    QString searchText(const RowValues &values) const;
+    /// Bazowy SELECT z setRowFilter i dodatkowymi warunkami; parametry filtru są
+    /// dopisywane do `bindValues` przed parametrami `conditions`. `extraColumn` —
+    /// wyrażenie dopisane za kolumnami tabeli (indeks ColumnCount w wyniku).
+    QString selectSql(const QStringList &conditions, QVariantList *bindValues,
+                      const QString &extraColumn = QString()) const;
+    bool countRows(QString *errorMessage);
+    /// Następna strona po kluczu (m_lastPageKey, m_lastPageId) w porządku m_sortColumn.
+    bool readPage(QVector<RowValues> *rows, bool *extended, QString *errorMessage);
+    /// Kolejność wierszy po sortowaniu: pozycja → dotychczasowy numer wiersza.
+    QVector<int> sortedRowOrder(int column, Qt::SortOrder order);
+    /// Przestawia wszystkie kolumny wg `order` (bez sygnałów modelu).
+    void permuteRows(const QVector<int> &order);
+    /// Porównanie wierszy wg m_sortColumn (rosnąco); dla kolumn słownikowych
+    /// sortRanks muszą być aktualne.
+    int compareRows(int left, int right, const QCollator &collator) const;
+    /// Przesuwa wiersz na miejsce wg aktywnego sortowania; pozostałe wiersze muszą być posortowane.
+    void moveToSortedPosition(int row, const QCollator &collator);
+
+    /// Brak wartości w kolumnach liczbowych (NULL w bazie).
+    static constexpr int kNullNumber = std::numeric_limits<int>::min();
+
+    QSqlDatabase m_db;
+
+    QVector<QString> m_ids;
+    QVector<QString> m_names;
+    QVector<QString> m_serialNumbers;
+    QVector<QString> m_partNumbers;
+    QVector<QString> m_revisions;
+    QVector<QString> m_descriptions;
+    QVector<int> m_productionYears;
+    QVector<int> m_values;
+    QVector<quint8> m_flags;
+    std::array<DictionaryColumn, DictionaryCount> m_dictionaries;
+    QHash<QString, int> m_rowById;
+
+    /// wiersz → tekst pól wyszukiwania po fold(), pola rozdzielone '\n'.
+    QVector<QString> m_searchTexts;
+    /// wiersz → docId w m_searchIndex.
+    QVector<int> m_searchDocIds;
+    ItemSearchIndex m_searchIndex;
+    int m_nextSearchDocId = 0;
+    quint64 m_searchGeneration = 1;
+
+    int m_pageSize = 0;
+    QString m_rowFilterSql;
+    QVariantList m_rowFilterBindValues;
+    int m_totalRowCount = 0;
+    bool m_hasMorePages = false;
+    /// Klucz ostatniego wiersza wczytanej strony: wartość kolumny sortowania i id.
+    QVariant m_lastPageKey;
+    QString m_lastPageId;
+
+    quint64 m_revision = 1;
+    int m_sortColumn = -1;
+    Qt::SortOrder m_sortOrder = Qt::AscendingOrder;
+};
+
+#endif // ITEMTABLEMODEL_H
@@ -0,0 +1,45 @@
+#ifndef PHOTOBLOBSTORE_H
+#define PHOTOBLOBSTORE_H
+
+#include <QByteArray>
+#include <QString>
+
+#include <functional>
+
+/// v1.5: magazyn treści zdjęć w systemie plików zamiast kolumn BLOB.
+///
+/// Pliki są adresowane skrótem SHA-256 (ten sam klucz co photo_blobs.hash)
+/// i rozkładane na dwa poziomy katalogów: `<root>/ab/cd/abcd…`, żeby żaden
+/// katalog nie miał setek tysięcy wpisów. Katalog może leżeć lokalnie albo na
+/// zamontowanym udziale — wtedy wszystkie stanowiska muszą widzieć tę samą ścieżkę.
+/// Włączany ustawieniem `photos/blob_store_dir` w inwentaryzacja.ini (pusty = BLOB w bazie).
+/// Zdjęcia już zapisane w bazie przenosi tylko jawna akcja na liście eksponatów
+/// (PhotoService::migrateBlobsToFileStore) — nigdy automatycznie przy starcie.
+class PhotoBlobStore
+{
+public:
+    explicit PhotoBlobStore(const QString &rootDirectory = QString());
+
+    static QString directoryFromSettings();
+
+    bool isEnabled() const { return !m_rootDirectory.isEmpty(); }
+    QString rootDirectory() const { return m_rootDirectory; }
+    QString pathForHash(const QString &hash) const;
+
+    /// Zapis atomowy (QSaveFile); istniejący plik jest zapisywany od nowa.
+    bool write(const QString &hash, const QByteArray &data, QString *errorMessage) const;
+    QByteArray read(const QString &hash, QString *errorMessage) const;
+
+    /// Mapuje plik do pamięci (QFile::map) i przekazuje go jako QByteArray::fromRawData —
+    /// bez kopiowania. Dane są ważne tylko wewnątrz `consumer`.
+    bool readMapped(const QString &hash,
+                    const std::function<void(const QByteArray &)> &consumer,
+                    QString *errorMessage) const;
+
+    bool remove(const QString &hash) const;
+
+private:
+    QString m_rootDirectory;
+};
+
+#endif // PHOTOBLOBSTORE_H
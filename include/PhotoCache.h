@@ -0,0 +1,83 @@
+#ifndef PHOTOCACHE_H
+#define PHOTOCACHE_H
+
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+
+/// v1.5: wspólny dla całego procesu LRU cache zdekodowanych zdjęć.
+///
+/// **Klucz:** (ID zdjęcia, rozmiar docelowy). `QSize()` oznacza oryginał,
+/// `QSize(160, 160)` miniaturę listy itd. — ten sam obraz w różnych rozmiarach
+/// to osobne wpisy. Dodatkowo cache pamięta ostatnio odczytaną listę ID zdjęć
+/// eksponatu — tylko do unieważniania jego obrazów. PhotoLoader nie serwuje jej
+/// bez zapytania: lista zawsze przychodzi z bazy (inne stanowiska), z cache idą obrazy.
+///
+/// **Koszt wpisu** = `QImage::sizeInBytes()`, więc budżet jest realnym limitem
+/// pamięci bitmap (zdjęcie 24 Mpx ≈ 96 MB). Po przekroczeniu budżetu QCache
+/// usuwa najdawniej używane wpisy; obraz większy niż cały budżet nie jest
+/// cache'owany wcale. Budżet: inwentaryzacja.ini, klucz `photos/cache_mb`
+/// (domyślnie 256 MB, 0 = cache wyłączony).
+///
+/// **Unieważnianie:** PhotoService::deletePhoto (usunięcie zdjęcia z UI),
+/// PhotoService::insertPhoto (nowe zdjęcie → lista eksponatu nieaktualna)
+/// oraz ItemRepository::deleteItem.
+///
+/// **Wątki:** wszystkie metody są chronione muteksem — PhotoLoader wstawia
+/// zdekodowane miniatury z wątków puli.
+class PhotoCache
+{
+public:
+    struct Stats
+    {
+        quint64 hits = 0;
+        quint64 misses = 0;
+        qint64 usedBytes = 0;
+        qint64 budgetBytes = 0;
+        int entries = 0;
+    };
+
+    static constexpr int kDefaultBudgetMb = 256;
+
+    explicit PhotoCache(qint64 budgetBytes = budgetFromSettings());
+
+    /// Instancja współdzielona przez itemList, MainWindow (PhotoLoader) i PreviewDialog.
+    static PhotoCache &instance();
+    static qint64 budgetFromSettings();
+
+    /// Zwraca obraz z cache (i odświeża jego pozycję LRU) albo pusty QImage.
+    QImage find(const QString &photoId, const QSize &size = QSize());
+    bool insert(const QString &photoId, const QImage &image, const QSize &size = QSize());
+
+    bool findItemPhotos(const QString &itemId, QStringList *photoIds);
+    void setItemPhotos(const QString &itemId, const QStringList &photoIds);
+
+    /// Usuwa wszystkie rozmiary zdjęcia oraz listy eksponatów, które je zawierają.
+    void invalidatePhoto(const QString &photoId);
+    /// Usuwa listę zdjęć eksponatu oraz obrazy jego zdjęć (znanych z listy lub podanych).
+    void invalidateItem(const QString &itemId, const QStringList &photoIds = QStringList());
+    void clear();
+
+    Stats stats() const;
+    void resetStats();
+
+    qint64 budgetBytes() const;
+    qint64 usedBytes() const;
+    int count() const;
+
+private:
+    static QString cacheKey(const QString &photoId, const QSize &size);
+    void removePhotoLocked(const QString &photoId);
+
+    mutable QMutex m_mutex;
+    QCache<QString, QImage> m_cache;
+    QHash<QString, QStringList> m_itemPhotos;
+    quint64 m_hits = 0;
+    quint64 m_misses = 0;
+};
+
+#endif // PHOTOCACHE_H
@@ -0,0 +1,62 @@
+#ifndef PHOTOLOADER_H
+#define PHOTOLOADER_H
+
+#include <QImage>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <QThreadPool>
+
+#include <atomic>
+#include <memory>
+
+/**
+ * @class PhotoLoader
+ * @brief Ładuje miniatury zdjęć eksponatu poza wątkiem GUI.
+ *
+ * @section ClassOverview
+ * Zapytanie SQL idzie na osobnym wątku z własnym połączeniem (DatabaseConnectionPool
+ * dla `connectionName`), a dekodowanie JPEG/PNG do QImage — na prywatnej QThreadPool.
+ * Wyniki wracają sygnałami w wątku GUI: najpierw photosListed (lista ID, UI rysuje
+ * placeholdery), potem photoReady dla każdego zdjęcia. Miniatury obecne w PhotoCache
+ * nie są ani pobierane, ani dekodowane.
+ *
+ * @section Notes
+ * - Każde requestThumbnails dostaje nowy requestId; starsze żądania są porzucane przed
+ *   zapytaniem, przed dekodowaniem i przed emisją, więc szybkie klikanie po tabeli
+ *   nie kolejkuje pracy.
+ * - Destruktor czeka na wątek SQL i pulę dekodującą oraz usuwa połączenie robocze.
+ *   Połączenie źródłowe musi żyć dłużej niż loader.
+ */
+class PhotoLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PhotoLoader(const QString &connectionName = QStringLiteral("default_connection"),
+                         QObject *parent = nullptr);
+    ~PhotoLoader() override;
+
+    /// Anuluje poprzednie żądanie i zleca pobranie miniatur eksponatu.
+    /// @return requestId, którym oznaczone będą sygnały tego żądania.
+    quint64 requestThumbnails(const QString &itemId, int size);
+
+    /// Porzuca bieżące żądanie (np. gdy zaznaczenie w tabeli zostało wyczyszczone).
+    void cancel();
+
+    quint64 currentRequestId() const;
+
+signals:
+    void photosListed(quint64 requestId, const QString &itemId, const QStringList &photoIds);
+    void photoReady(quint64 requestId, const QString &photoId, const QImage &image);
+    void loadFailed(quint64 requestId, const QString &errorMessage);
+
+private:
+    std::shared_ptr<std::atomic<quint64>> m_generation;
+    QThreadPool m_decodePool;
+    QThread m_dbThread;
+    QObject *m_worker = nullptr;
+};
+
+#endif // PHOTOLOADER_H
@@ -1,29 +1,228 @@
 #ifndef PHOTOSERVICE_H
 #define PHOTOSERVICE_H
 
+#include <QByteArray>
+#include <QHash>
+#include <QImage>
 #include <QList>
 #include <QPixmap>
+#include <QRect>
+#include <QSize>
 #include <QSqlDatabase>
 #include <QString>
 #include <QStringList>
 
+#include "PhotoBlobStore.h"
+
+#include <functional>
+
 struct StoredPhoto
 {
     QString id;
     QPixmap pixmap;
 };
 
+/// Zakodowane (JPEG/PNG) dane zdjęcia lub miniatury — bez dekodowania,
+/// więc bezpieczne do użycia poza wątkiem GUI (QPixmap tam nie wolno).
+struct StoredPhotoData
+{
+    QString id;
+    QByteArray data;
+};
+
+/// v1.5: normalizacja zdjęć przy dodawaniu — aparat daje 6–12 MB, a w bazie
+/// wystarcza dłuższa krawędź ~2560 px. Ustawienia z inwentaryzacja.ini (photos/ingest_*).
+/// Domyślnie wyłączona: ponowne kodowanie jest stratne, więc włącza je użytkownik.
+struct PhotoIngestOptions
+{
+    bool enabled = false;
+    int maxLongEdge = 2560;
+    /// "JPG" lub "WEBP" (gdy brak wtyczki WebP — JPG). Obrazy z kanałem alfa zawsze jako PNG.
+    QByteArray format = "JPG";
+    int quality = 85;
+    /// Katalog na kopie oryginałów; pusty = oryginały nie są archiwizowane.
+    QString archiveDirectory;
+
+    static PhotoIngestOptions fromSettings();
+};
+
+/// Wynik przygotowania jednego pliku do zapisu w photos.photo.
+struct IngestedPhoto
+{
+    QString sourcePath;
+    QByteArray data;
+    qint64 originalBytes = 0;
+    /// false = zapisujemy oryginał (normalizacja wyłączona albo nic nie dawała).
+    bool normalized = false;
+    /// Niepusty = pliku nie udało się odczytać, `data` jest puste.
+    QString errorMessage;
+    /// Policzone w wątku puli — insertPhoto(IngestedPhoto) nie dekoduje już obrazu.
+    QString contentHash;
+    QHash<int, QByteArray> thumbnails;
+};
+
 class PhotoService
 {
 public:
-    explicit PhotoService(QSqlDatabase database = QSqlDatabase::database("default_connection"));
+    /// v1.5: stałe rozmiary miniatur (dłuższa krawędź w px) zapisywanych
+    /// w tabeli photo_thumbnails. Okno edycji i siatka zdjęć na liście eksponatów
+    /// czytają kListThumbnailSize; kPreviewThumbnailSize jest pobierana pojedynczo
+    /// (loadPhotoThumbnail) jako tymczasowy podgląd pełnego ekranu, zanim zdekoduje się oryginał.
+    static constexpr int kListThumbnailSize = 160;
+    static constexpr int kPreviewThumbnailSize = 480;
+
+    /// Domyślny magazyn plików pochodzi z ustawień (photos/blob_store_dir); wyłączony = BLOB w bazie.
+    explicit PhotoService(QSqlDatabase database = QSqlDatabase::database("default_connection"),
+                          const PhotoBlobStore &blobStore = PhotoBlobStore(PhotoBlobStore::directoryFromSettings()));
+
+    static QList<int> thumbnailSizes();
+
+    /// Skaluje obraz do dłuższej krawędzi `size` (bez powiększania) i koduje
+    /// do JPEG (PNG gdy obraz ma kanał alfa). Pusta tablica = nie da się zdekodować.
+    static QByteArray createThumbnail(const QByteArray &photoData, int size);
+
+    /// Dekoduje obraz od razu w rozmiarze mieszczącym się w `bounds` (QImageReader::setScaledSize,
+    /// dla JPEG skalowanie w dziedzinie DCT), z uwzględnieniem orientacji EXIF. Pełna bitmapa
+    /// nie jest materializowana; mniejsze obrazy nie są powiększane. Nieprawidłowe `bounds`
+    /// = pełna rozdzielczość. Bezpieczne poza wątkiem GUI.
+    static QImage decodeScaled(const QByteArray &photoData, const QSize &bounds);
+
+    /// Wymiary z nagłówka (bez dekodowania), po nałożeniu orientacji EXIF.
+    /// `transformed` = true, gdy plik ma orientację inną niż domyślna.
+    static QSize imageSize(const QByteArray &photoData, bool *transformed = nullptr);
+
+    /// Dekoduje tylko fragment `region` (współrzędne obrazu zapisanego w pliku, bez
+    /// orientacji EXIF) w rozmiarze `targetSize` — kafle podglądu przy powiększeniu.
+    static QImage decodeRegion(const QByteArray &photoData, const QRect &region, const QSize &targetSize);
+
+    /// Jak decodeRegion, ale `region` i `targetSize` są we współrzędnych obrazu po
+    /// orientacji EXIF (jak imageSize). Fragment jest przeliczany na współrzędne pliku,
+    /// dekodowany i dopiero wtedy obracany — pełny obraz nie jest dekodowany.
+    static QImage decodeOrientedRegion(const QByteArray &photoData, const QRect &region, const QSize &targetSize);
+
+    /// Skaluje do `options.maxLongEdge`, nakłada orientację EXIF i koduje od nowa —
+    /// metadane (EXIF, GPS, miniatura aparatu) nie są przepisywane. Gdy wynik nie
+    /// jest mniejszy od pliku źródłowego, a oryginał mieści się w maxLongEdge, zwraca oryginał.
+    static QByteArray normalizePhoto(const QByteArray &photoData,
+                                     const PhotoIngestOptions &options,
+                                     bool *normalized = nullptr);
+
+    /// Czyta i normalizuje pliki równolegle (QThreadPool); kolejność wyniku = kolejność `paths`.
+    /// `bytesSaved` = suma (oryginał − zapisywane dane) dla wszystkich plików.
+    /// `progressCallback(gotowe, wszystkie, przeczytaneBajty)` jest wołany z wątków puli
+    /// (musi być thread-safe); false = pozostałe pliki są pomijane (puste `data`).
+    static QList<IngestedPhoto> ingestFiles(const QStringList &paths,
+                                            const PhotoIngestOptions &options,
+                                            qint64 *bytesSaved = nullptr,
+                                            const std::function<bool(int, int, qint64)> &progressCallback = {});
+
+    /// Kopiuje oryginały do `archiveDirectory` (nazwy kolidujące dostają sufiks _1, _2…).
+    /// Zwraca nazwy plików, których nie udało się skopiować.
+    static QStringList archiveOriginals(const QStringList &photoPaths, const QString &archiveDirectory);
 
     QList<StoredPhoto> loadStoredPhotos(const QString &itemId, QString *errorMessage) const;
-    QList<QPixmap> loadPixmapsFromBuffer(const QList<QByteArray> &photoBuffer) const;
+
+    /// Czyta wyłącznie miniatury rozmiaru `size` dla eksponatu. Brakujące
+    /// miniatury (stare wiersze sprzed v1.5) są generowane i zapisywane w locie.
+    QList<StoredPhoto> loadThumbnails(const QString &itemId, int size, QString *errorMessage) const;
+
+    /// Jak loadThumbnails, ale zwraca zakodowane bajty miniatur — do użycia w wątkach roboczych.
+    QList<StoredPhotoData> loadThumbnailData(const QString &itemId, int size, QString *errorMessage) const;
+
+    /// ID zdjęć eksponatu — tanie zapytanie bez treści i miniatur.
+    QStringList loadPhotoIds(const QString &itemId, QString *errorMessage) const;
+
+    /// Zakodowana miniatura rozmiaru `size` jednego zdjęcia; pusta, gdy jej nie ma (bez generowania).
+    QByteArray loadPhotoThumbnail(const QString &photoId, int size, QString *errorMessage) const;
+
+    /// Zakodowana treść zdjęcia (z bazy albo z magazynu plików) — do dekodowania w wątku roboczym.
+    QByteArray loadPhotoData(const QString &photoId, QString *errorMessage) const;
+
+    /// Pełny oryginał jednego zdjęcia — ładowany leniwie (podgląd, pełny ekran).
+    QPixmap loadOriginalPhoto(const QString &photoId, QString *errorMessage) const;
+
+    /// Oryginał jednego zdjęcia zdekodowany od razu do rozmiaru `bounds` (np. podgląd na hover).
+    QImage loadScaledPhoto(const QString &photoId, const QSize &bounds, QString *errorMessage) const;
+
+    /// Skrót SHA-256 (hex) — klucz tabeli photo_blobs.
+    static QString contentHash(const QByteArray &photoData);
+
+    /// INSERT do photos + miniatury wszystkich rozmiarów. Treść trafia do photo_blobs
+    /// po SHA-256: gdy blob już istnieje, zwiększany jest tylko ref_count, a miniatury
+    /// kopiowane z istniejącego zdjęcia. Nie otwiera własnej transakcji —
+    /// wywołujący (np. ItemRepository::saveItem) decyduje o granicach.
+    bool insertPhoto(const QString &itemId,
+                     const QByteArray &photoData,
+                     QString *photoId,
+                     QString *errorMessage) const;
+    /// Jak wyżej, ale z miniaturami i skrótem policzonymi przez ingestFiles.
+    bool insertPhoto(const QString &itemId,
+                     const IngestedPhoto &photo,
+                     QString *photoId,
+                     QString *errorMessage) const;
+    /// v1.5: jak insertPhoto dla wielu zdjęć naraz — nowe bloby, wiersze photos i miniatury
+    /// idą wielowierszowymi INSERT-ami, których rozmiar wynika z max_allowed_packet serwera
+    /// MySQL. `photoIds` w kolejności `photos`. Nie otwiera własnej transakcji.
+    bool insertPhotos(const QString &itemId,
+                      const QList<QByteArray> &photos,
+                      QStringList *photoIds,
+                      QString *errorMessage) const;
+    /// Jak wyżej, ale ze skrótami i miniaturami policzonymi przez ingestFiles.
+    bool insertPhotos(const QString &itemId,
+                      const QList<IngestedPhoto> &photos,
+                      QStringList *photoIds,
+                      QString *errorMessage) const;
+    /// Zapomina max_allowed_packet odczytany dla połączenia — wołać razem z
+    /// PreparedStatementCache::release, gdy połączenie jest zamykane albo otwierane od nowa.
+    static void releaseStatementBudget(const QString &connectionName);
+    /// Zapomina budżety wszystkich połączeń (DatabaseConnectionPool::invalidate).
+    static void clearStatementBudgets();
+
+    bool storeThumbnails(const QString &photoId, const QByteArray &photoData, QString *errorMessage) const;
+    /// Usuwa zdjęcie z miniaturami, zmniejsza ref_count bloba i sprząta nieużywane bloby.
+    /// Nie otwiera własnej transakcji — wywołujący obejmuje nią wszystkie trzy kroki,
+    /// a po COMMIT przekazuje `releasedFileHashes` do removeBlobFiles.
+    bool deletePhoto(const QString &photoId, QStringList *releasedFileHashes, QString *errorMessage) const;
+
+    /// Zmniejsza ref_count blobów wszystkich zdjęć eksponatu — wołane przed DELETE FROM photos.
+    bool releaseItemBlobs(const QString &itemId, QString *errorMessage) const;
+    /// DELETE bloby z ref_count <= 0. `releasedFileHashes` dostaje skróty blobów
+    /// z magazynu plików — pliki usuwa removeBlobFiles, dopiero po zatwierdzeniu transakcji.
+    bool collectUnreferencedBlobs(QStringList *releasedFileHashes, QString *errorMessage) const;
+    /// Usuwa pliki zwolnionych blobów we własnej, blokującej transakcji (wołać po COMMIT
+    /// transakcji, która je zwolniła). Pomija skróty, które w międzyczasie znów mają wiersz
+    /// w photo_blobs; blokada trzymana do usunięcia plików wstrzymuje cudze INSERT-y tych skrótów.
+    void removeBlobFiles(const QStringList &hashes) const;
+
+    /// Przenosi treść zdjęć z bazy (photos.photo i photo_blobs.data) do PhotoBlobStore —
+    /// po jednym BLOB-ie, z transakcją na wiersz; można przerwać i wznowić.
+    /// `progressCallback` jak w backfillThumbnails.
+    bool migrateBlobsToFileStore(int *movedCount,
+                                 QString *errorMessage,
+                                 const std::function<bool(int, int)> &progressCallback = {}) const;
+
+    const PhotoBlobStore &blobStore() const { return m_blobStore; }
+
+    /// Uzupełnia miniatury dla zdjęć, które ich nie mają. `progressCallback`
+    /// dostaje (przetworzone, wszystkie); zwrócenie false przerywa backfill.
+    bool backfillThumbnails(int *generatedCount,
+                            QString *errorMessage,
+                            const std::function<bool(int, int)> &progressCallback = {}) const;
+
+    QList<QPixmap> loadPixmapsFromBuffer(const QList<QByteArray> &photoBuffer,
+                                         const QSize &bounds = QSize()) const;
     QStringList movePhotosToDone(const QStringList &photoPaths, bool shouldMove) const;
 
 private:
+    bool insertPhotoData(const QString &itemId,
+                         const QByteArray &photoData,
+                         const QString &hash,
+                         const QHash<int, QByteArray> *thumbnails,
+                         QString *photoId,
+                         QString *errorMessage) const;
+
     QSqlDatabase m_db;
+    PhotoBlobStore m_blobStore;
 };
 
 #endif // PHOTOSERVICE_H
@@ -0,0 +1,140 @@
+#ifndef PREPAREDSTATEMENTCACHE_H
+#define PREPAREDSTATEMENTCACHE_H
+
+#include <QCache>
+#include <QHash>
+#include <QMutex>
+#include <QPointer>
+#include <QSqlDatabase>
+#include <QSqlDriver>
+#include <QSqlQuery>
+#include <QString>
+
+#include <memory>
+#include <utility>
+
+/// Przygotowane zapytanie wypożyczone z PreparedStatementCache.
+///
+/// Tylko przenoszalne; destruktor woła QSqlQuery::finish(), więc zapytanie wraca do
+/// cache bez otwartego kursora (MySQL trzyma wynik, SQLite blokadę odczytu).
+class PreparedStatement
+{
+public:
+    PreparedStatement() = default;
+    explicit PreparedStatement(std::shared_ptr<QSqlQuery> query)
+        : m_query(std::move(query))
+    {}
+    ~PreparedStatement() { release(); }
+
+    PreparedStatement(PreparedStatement &&other) noexcept = default;
+    PreparedStatement &operator=(PreparedStatement &&other) noexcept
+    {
+        if (this != &other) {
+            release();
+            m_query = std::move(other.m_query);
+        }
+        return *this;
+    }
+    PreparedStatement(const PreparedStatement &) = delete;
+    PreparedStatement &operator=(const PreparedStatement &) = delete;
+
+    QSqlQuery *operator->() const { return m_query.get(); }
+    QSqlQuery &operator*() const { return *m_query; }
+    QSqlQuery *get() const { return m_query.get(); }
+
+private:
+    void release()
+    {
+        if (m_query)
+            m_query->finish();
+        m_query.reset();
+    }
+
+    std::shared_ptr<QSqlQuery> m_query;
+};
+
+/// v1.5: przygotowane zapytania o stałym tekście SQL, osobno dla każdego połączenia.
+///
+/// **Po co:** repozytoria tworzyły QSqlQuery i prepare() przy każdym wywołaniu —
+/// przy MySQL to dodatkowa podróż do serwera (COM_STMT_PREPARE/CLOSE) na każdy zapis.
+/// Tu zapytanie przygotowane raz jest używane ponownie (nowe bindValue + exec).
+///
+/// **Limit:** najwyżej kDefaultCapacity zapytań na połączenie, nadmiar usuwa LRU
+/// (QCache) — daleko poniżej `max_prepared_stmt_count` serwera (domyślnie 16382),
+/// także przy kilku połączeniach roboczych naraz. Rozmiar: inwentaryzacja.ini, klucz
+/// `database/statement_cache_size` (0 = cache wyłączony, każde prepare() od nowa).
+///
+/// **Czego nie cache'ować:** SQL o zmiennym tekście (listy `IN (...)`, wielowierszowe
+/// INSERT-y) — każdy wariant zająłby osobny uchwyt na serwerze.
+///
+/// **Wątki:** połączenie Qt należy do jednego wątku, więc zapytania jednego połączenia
+/// nie są współdzielone między wątkami; muteks chroni tylko mapę połączeń. Zapytanie
+/// wypożyczone i jeszcze żywe (zagnieżdżone użycie tego samego SQL) nie jest wydawane
+/// drugi raz — wywołujący dostaje wtedy zwykłe, niecache'owane QSqlQuery.
+///
+/// **Zamykanie połączenia:** przed `db.close()` i QSqlDatabase::removeDatabase trzeba
+/// wywołać release(nazwa) — uchwyty zamkniętego połączenia są nieważne. Wpis pamięta
+/// sterownik i natywny uchwyt połączenia z chwili otwarcia; gdy przy wyszukaniu któryś
+/// się różni, zaczyna od pustego cache. Nowy uchwyt może jednak trafić pod adres starego
+/// (zwolniona pamięć), więc release() pozostaje obowiązkowe — w buildzie debug close()
+/// i open() tego samego połączenia bez release() kończy się asercją.
+class PreparedStatementCache
+{
+public:
+    struct Stats
+    {
+        quint64 hits = 0;
+        quint64 misses = 0;
+        int entries = 0;
+        int connections = 0;
+    };
+
+    static constexpr int kDefaultCapacity = 64;
+
+    explicit PreparedStatementCache(int capacity = capacityFromSettings());
+
+    static PreparedStatementCache &instance();
+    static int capacityFromSettings();
+
+    /// Przygotowane zapytanie dla `sql` na połączeniu `db`. Gdy prepare() się nie uda,
+    /// zapytanie nie trafia do cache, a błąd jest w `->lastError()` (jak przy QSqlQuery).
+    PreparedStatement prepare(const QSqlDatabase &db, const QString &sql);
+    /// Zapytanie spoza cache (SQL o zmiennym tekście) — uchwyt zwalniany razem z obiektem.
+    static PreparedStatement prepareUncached(const QSqlDatabase &db, const QString &sql);
+
+    /// Usuwa zapytania połączenia — wywoływać przed jego zamknięciem.
+    void release(const QString &connectionName);
+    void clear();
+
+    Stats stats() const;
+    void resetStats();
+
+    int capacity() const { return m_capacity; }
+    int count(const QString &connectionName) const;
+
+private:
+    Q_DISABLE_COPY(PreparedStatementCache)
+
+    using QueryPointer = std::shared_ptr<QSqlQuery>;
+
+    struct ConnectionEntry
+    {
+        explicit ConnectionEntry(int capacity) { queries.setMaxCost(capacity); }
+
+        QPointer<QSqlDriver> driver;
+        /// Natywny uchwyt (sqlite3*, MYSQL*) z chwili otwarcia — inny oznacza ponowne open().
+        const void *handle = nullptr;
+        QCache<QString, QueryPointer> queries;
+    };
+
+    static const void *nativeHandle(const QSqlDatabase &db);
+    static bool matches(const ConnectionEntry &entry, const QSqlDatabase &db, const void *handle);
+
+    const int m_capacity;
+    mutable QMutex m_mutex;
+    QHash<QString, std::shared_ptr<ConnectionEntry>> m_connections;
+    quint64 m_hits = 0;
+    quint64 m_misses = 0;
+};
+
+#endif // PREPAREDSTATEMENTCACHE_H
@@ -15,7 +15,9 @@
  * Plik nagłówkowy zawiera:
  * 1. **Deklarację klasy ZoomableGraphicsView** – dziedziczy po QGraphicsView, implementuje powiększanie i przesuwanie.
  * 2. **Deklarację klasy FullScreenPhotoViewer** – dziedziczy po QMainWindow, zarządza pełnoekranowym wyświetlaniem zdjęcia.
- * 3. **Metody inline** – wszystkie metody są zdefiniowane w pliku nagłówkowym, eliminując potrzebę osobnego pliku .cpp.
+ * 3. **Metody inline** – widok i podgląd gotowego QPixmap są zdefiniowane w pliku nagłówkowym.
+ * 4. **Podgląd progresywny** – konstruktor przyjmujący ID zdjęcia (implementacja w fullscreenphotoviewer.cpp)
+ *    pokazuje od razu powiększoną miniaturę, a oryginał dekoduje w wątku w tle.
  *
  * @section Dependencies
  * - **Qt Framework**: Używa klas QMainWindow, QGraphicsView, QGraphicsScene, QKeyEvent, QWheelEvent.
@@ -25,6 +27,8 @@
  * - Kod nie został zmodyfikowany, zgodnie z wymaganiami użytkownika. Dodano jedynie komentarze i dokumentację.
  * - Obie klasy są zoptymalizowane pod kątem prostoty i wydajności, z implementacją inline w pliku nagłówkowym.
  * - FullScreenPhotoViewer jest modalny i automatycznie usuwa się po zamknięciu, co zapobiega wyciekom pamięci.
+ * - v1.5: przy powiększeniu ponad rozdzielczość obrazu dopasowanego do ekranu dekodowany jest tylko
+ *   widoczny fragment oryginału (kafel) — duże zdjęcia nie są trzymane w pamięci w całości.
  */
 
 #ifndef FULLSCREENPHOTOVIEWER_H
@@ -32,10 +36,21 @@
 
 #include <QGraphicsScene>
 #include <QGraphicsView>
+#include <QImage>
 #include <QKeyEvent>
 #include <QMainWindow>
+#include <QRect>
+#include <QScrollBar>
+#include <QThread>
 #include <QWheelEvent>
 
+#include <atomic>
+#include <memory>
+
+class QGraphicsPixmapItem;
+class QResizeEvent;
+class QTimer;
+
 /**
  * @class ZoomableGraphicsView
  * @brief Widok graficzny umożliwiający powiększanie i przesuwanie obrazu.
@@ -70,8 +85,24 @@ public:
     {
         setTransformationAnchor(QGraphicsView::AnchorUnderMouse);
         setDragMode(QGraphicsView::ScrollHandDrag);
+        connect(horizontalScrollBar(), &QScrollBar::valueChanged, this, &ZoomableGraphicsView::viewportChanged);
+        connect(verticalScrollBar(), &QScrollBar::valueChanged, this, &ZoomableGraphicsView::viewportChanged);
     }
 
+    /// true, gdy użytkownik zmienił skalę kółkiem myszy.
+    bool isZoomed() const { return !qFuzzyCompare(m_scaleFactor, 1.0); }
+
+    /// Kasuje transformację widoku i licznik powiększenia (dopasowanie do okna).
+    void resetZoom()
+    {
+        resetTransform();
+        m_scaleFactor = 1.0;
+    }
+
+signals:
+    /// Zmieniła się widoczna część sceny (powiększenie albo przewinięcie).
+    void viewportChanged();
+
 protected:
     /**
      * @brief Obsługuje zdarzenia kółka myszy do powiększania/pomniejszania obrazu.
@@ -96,6 +127,7 @@ protected:
             m_scaleFactor *= zoomOutFactor;
         }
         event->accept();
+        emit viewportChanged();
     }
 
 private:
@@ -117,6 +149,7 @@ private:
  * - Wyświetlanie zdjęcia w trybie pełnoekranowym.
  * - Obsługa zamykania okna klawiszem Escape.
  * - Zarządzanie sceną graficzną i widokiem ZoomableGraphicsView.
+ * - Podgląd progresywny: miniatura → obraz dopasowany do ekranu → kafle oryginału przy powiększeniu.
  */
 class FullScreenPhotoViewer : public QMainWindow
 {
@@ -154,6 +187,30 @@ public:
         showFullScreen();
     }
 
+    /**
+     * @brief Konstruktor podglądu progresywnego.
+     * @param photoId ID zdjęcia w tabeli photos.
+     * @param preview Obraz wyświetlany natychmiast (miniatura z cache lub sceny), skalowany do ekranu.
+     * @param connectionName Połączenie, którego klon otwiera wątek dekodujący.
+     * @param parent Wskaźnik na nadrzędny widget. Domyślnie nullptr.
+     *
+     * @section ConstructorOverview
+     * Scena pracuje we współrzędnych pikseli oryginału. Gdy `preview` jest mniejszy niż
+     * miniatura PhotoService::kPreviewThumbnailSize, wątek w tle najpierw podmienia go na nią.
+     * Potem pobiera treść zdjęcia raz, dekoduje wersję dopasowaną do ekranu (podmieniana w miejsce miniatury i zapisywana
+     * w PhotoCache), a przy powiększeniu — tylko widoczny fragment oryginału w rozdzielczości ekranu.
+     */
+    FullScreenPhotoViewer(const QString &photoId,
+                          const QImage &preview,
+                          const QString &connectionName = QStringLiteral("default_connection"),
+                          QWidget *parent = nullptr);
+
+    /// Przerywa dekodowanie bez czekania na wątek — wątek i worker usuwają się po zakończeniu.
+    ~FullScreenPhotoViewer() override;
+
+    /// Rozmiar obrazu dopasowanego do ekranu widżetu (w pikselach fizycznych) — klucz w PhotoCache.
+    static QSize fitBounds(const QWidget *widget);
+
 protected:
     /**
      * @brief Obsługuje zdarzenia naciśnięcia klawiszy.
@@ -172,11 +229,37 @@ protected:
         }
     }
 
+    /// Dopasowuje obraz do nowego rozmiaru okna, o ile użytkownik go nie powiększył.
+    void resizeEvent(QResizeEvent *event) override;
+
 private:
+    void fitToWindow();
+    void setOriginalSize(const QSize &size);
+    void showPreviewImage(const QImage &image);
+    void showDecodedImage(const QImage &image);
+    void requestTile();
+    void showTile(quint64 requestId, const QRect &region, const QImage &tile);
+
     /// Wskaźnik na scenę graficzną zawierającą zdjęcie.
     QGraphicsScene *m_scene;
     /// Wskaźnik na widok graficzny obsługujący powiększanie i przesuwanie.
     ZoomableGraphicsView *m_view;
+
+    /// Podgląd progresywny — puste dla konstruktora z QPixmap.
+    QGraphicsPixmapItem *m_baseItem = nullptr;
+    QGraphicsPixmapItem *m_tileItem = nullptr;
+    QRect m_tileRegion;
+    /// Piksele kafla na piksel oryginału.
+    qreal m_tileResolution = 0.0;
+    QSize m_originalSize;
+    QTimer *m_tileTimer = nullptr;
+    /// Usuwany po zakończeniu (QThread::finished → deleteLater), także po zamknięciu okna.
+    QThread *m_decodeThread = nullptr;
+    QObject *m_decoder = nullptr;
+    /// Numer najnowszego żądania kafla — starsze są pomijane w wątku dekodującym.
+    std::shared_ptr<std::atomic<quint64>> m_latestTile;
+    /// Ustawiana w destruktorze — worker pomija kolejne kroki.
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
 };
 
 #endif // FULLSCREENPHOTOVIEWER_H
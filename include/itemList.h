@@ -20,8 +20,8 @@
  * 5. **Zmienne prywatne** – przechowują model danych, filtry, timery i stan interfejsu.
  *
  * @section Dependencies
- * - **Qt Framework**: Używa klas QWidget, QComboBox, QSqlRelationalTableModel, QSettings, QLabel, QItemSelection.
- * - **Nagłówki aplikacji**: ItemFilterProxyModel.h, photoitem.h.
+ * - **Qt Framework**: Używa klas QWidget, QComboBox, QSettings, QLabel, QItemSelection.
+ * - **Nagłówki aplikacji**: ItemFilterProxyModel.h, ItemTableModel.h, photoitem.h.
  * - **Namespace Ui**: Zawiera definicję interfejsu użytkownika (ui_itemList.h).
  *
  * @section Notes
@@ -34,16 +34,20 @@
 #define ITEMLIST_H
 
 #include <QComboBox>
+#include <QImage>
 #include <QItemSelection>
 #include <QLabel>
+#include <QPointer>
 #include <QSettings>
-#include <QSqlRelationalTableModel>
+#include <QThread>
 #include <QWidget>
 #include "ItemFilterProxyModel.h"
 #include <QCloseEvent>
 #include "photoitem.h"
 
-struct StoredPhoto;
+class ItemFilterScheduler;
+class ItemTableModel;
+class PhotoLoader;
 
 namespace Ui {
 class itemList;
@@ -75,7 +79,7 @@ public:
      * @param parent Wskaźnik na nadrzędny widget. Domyślnie nullptr.
      *
      * @section ConstructorOverview
-     * Inicjalizuje interfejs użytkownika, model danych (QSqlRelationalTableModel), model proxy
+     * Inicjalizuje interfejs użytkownika, model danych (ItemTableModel), model proxy
      * (ItemFilterProxyModel), filtry combo boxów oraz połączenia sygnałów i slotów dla interakcji
      * użytkownika.
      */
@@ -128,6 +132,11 @@ private slots:
      */
     void onDeleteButtonClicked();
     void onBackupButtonClicked();
+    /// v1.5: przenosi treść zdjęć z bazy do magazynu plików (photos/blob_store_dir) —
+    /// jawna akcja administratora, nie uruchamiana automatycznie.
+    void onMigrateBlobsButtonClicked();
+    /// v1.5: import eksponatów z pliku CSV (ItemCsvImporter) z oknem postępu.
+    void onImportCsvButtonClicked();
 
     /**
      * @brief Wyświetla okno "O programie" z informacjami o aplikacji.
@@ -154,7 +163,8 @@ private slots:
      * @param recordId ID zapisanego rekordu.
      *
      * @section SlotOverview
-     * Wywołuje refreshList z podanym ID rekordu, aby odświeżyć widok i zaznaczyć zapisany rekord.
+     * Wiersz jest już zaktualizowany przez ItemChangeNotifier — odświeża combo boxy filtrów
+     * i zaznacza zapisany rekord bez pełnego przeładowania modelu.
      */
     void onRecordSaved(const QString &recordId);
 
@@ -196,6 +206,10 @@ private slots:
      */
     void onPhotoClicked(PhotoItem *item);
 
+    /// Odpowiedzi PhotoLoader — placeholdery, a potem kolejne miniatury.
+    void onPhotosListed(quint64 requestId, const QString &itemId, const QStringList &photoIds);
+    void onPhotoReady(quint64 requestId, const QString &photoId, const QImage &image);
+
     /**
      * @brief Otwiera okno klonowania wybranego eksponatu.
      *
@@ -247,15 +261,26 @@ private:
      * jeśli nadal istnieją.
      */
     void refreshFilters();
+    void selectRecord(const QString &recordId);
+    /// Stan wszystkich kontrolek filtrów.
+    ItemFilterState currentFilterState() const;
+    /// Przekazuje currentFilterState() do ItemFilterScheduler — zmiany z jednego
+    /// obiegu pętli zdarzeń (albo z okna `delayMs`) dają jedno filtrowanie.
+    void scheduleFilter(int delayMs = 0);
+    /// v1.5: w trybie filtrów SQL przenosi filtry słownikowe i flagi do ItemTableModel::setRowFilter
+    /// i przeładowuje model, gdy warunek się zmienił.
+    void applySqlRowFilter(const ItemFilterState &state);
+    bool sqlFacetCounts(const ItemFilterState &state, ItemFilterProxyModel::FacetCounts *facets) const;
 
     /**
      * @brief Odbudowuje listy w combo boxach filtrów.
+     * @param facets Liczniki wartości słowników policzone przez ItemFilterScheduler.
      *
      * @section MethodOverview
      * Aktualizuje zawartość combo boxów z uwzględnieniem kaskadowego filtrowania,
      * zachowując wybrane wartości.
      */
-    void updateFilterComboBoxes();
+    void updateFilterComboBoxes(const ItemFilterProxyModel::FacetCounts &facets);
 
     QString selectedRecordIdOrWarn(const QString &message) const;
     QString selectedSingleRecordIdOrWarn(const QString &emptyMessage,
@@ -269,7 +294,7 @@ private:
     void openRecordWindowForNew();
     void openRecordWindowForEdit(const QString &recordId);
     void openRecordWindowForClone(const QString &recordId);
-    void showStoredPhotos(const QList<StoredPhoto> &photos);
+    void startThumbnailBackfill();
     void updateHeaderSummary();
     void restoreSavedFilters();
     void saveCurrentFilters() const;
@@ -288,12 +313,15 @@ private:
     /// Wskaźnik na obiekt interfejsu użytkownika.
     Ui::itemList *ui;
 
-    /// Model źródłowy danych (relacyjna tabela eksponatów).
-    QSqlRelationalTableModel *m_sourceModel;
+    /// Model źródłowy danych (kolumnowa tabela eksponatów w pamięci).
+    ItemTableModel *m_sourceModel;
 
     /// Model proxy do filtrowania danych.
     ItemFilterProxyModel *m_proxyModel;
 
+    /// v1.5: filtry wykonywane w bazie (ItemQueryBuilder) — model trzyma tylko pasujące rekordy.
+    bool m_sqlFilters = false;
+
     /// Combo box dla filtru typu eksponatu.
     QComboBox *filterTypeComboBox;
 
@@ -330,11 +358,17 @@ private:
     /// Timer do utrzymywania aktywności połączenia z bazą danych.
     QTimer *m_keepAliveTimer;
 
-    /// Timer do filtrowania.
-    QTimer *m_nameFilterTimer; // Nowy timer dla opóźnienia filtrowania
+    /// Łączy zmiany filtrów i filtruje w tle.
+    ItemFilterScheduler *m_filterScheduler = nullptr;
 
     /// Flaga chroniąca przed zapisem filtrów podczas inicjalizacji widoku.
     bool m_filtersInitialized = false;
+
+    /// Asynchroniczny loader miniatur dla panelu zdjęć.
+    PhotoLoader *m_photoLoader = nullptr;
+
+    /// Wątek uzupełniający brakujące miniatury (photo_thumbnails); nullptr po zakończeniu.
+    QPointer<QThread> m_thumbnailBackfillThread;
 };
 
 #endif // ITEMLIST_H
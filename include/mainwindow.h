@@ -35,12 +35,19 @@
 #ifndef MAINWINDOW_H
 #define MAINWINDOW_H
 
+#include "PhotoService.h"
+
 #include <QComboBox>
+#include <QImage>
 #include <QList>
 #include <QMainWindow>
+#include <QPointer>
 #include <QSqlDatabase>
 #include <QCloseEvent>
 
+#include <atomic>
+#include <memory>
+
 namespace Ui
 {
     class MainWindow;
@@ -48,10 +55,12 @@ namespace Ui
 
 // Forward-deklaracja klasy PhotoItem (używana w slotach)
 class PhotoItem;
+class PhotoLoader;
 class QPixmap;
+class QProgressDialog;
+class QThread;
 struct ItemRecordData;
 struct ItemValidationResult;
-struct StoredPhoto;
 
 /**
  * @class MainWindow
@@ -240,6 +249,10 @@ private slots:
      */
     void onPhotoClicked(PhotoItem *item);
 
+    /// Odpowiedzi PhotoLoader — placeholdery 80x80, a potem kolejne miniatury.
+    void onPhotosListed(quint64 requestId, const QString &itemId, const QStringList &photoIds);
+    void onPhotoReady(quint64 requestId, const QString &photoId, const QImage &image);
+
     /**
      * @brief Otwiera okno dodawania nowego typu.
      *
@@ -320,8 +333,12 @@ private:
     bool collectValidatedItemData(ItemRecordData *itemData);
     void showValidationError(const ItemValidationResult &result);
     void setPhotoItemsEditMode(bool enabled);
-    void showStoredPhotos(const QList<StoredPhoto> &photos);
     void showBufferPhotos(const QList<QPixmap> &pixmaps);
+    void finishPhotoImport(const QList<IngestedPhoto> &ingested,
+                           qint64 bytesSaved,
+                           bool shouldMovePhotos,
+                           const PhotoIngestOptions &options,
+                           QProgressDialog *progressDialog);
 
     QString validateUuid(const QString &uuid, const QString &defaultValue);
 
@@ -340,11 +357,19 @@ private:
     /// Indeks aktualnie wybranej miniatury zdjęcia.
     int m_selectedPhotoIndex;
 
-    /// Bufor przechowujący zdjęcia dla rekordów jeszcze niezapisanych w bazie.
-    QList<QByteArray> m_photoBuffer;
+    /// Asynchroniczny loader miniatur (tworzony przy pierwszym loadPhotos).
+    PhotoLoader *m_photoLoader;
+
+    /// Bufor zdjęć dla rekordów jeszcze niezapisanych w bazie — razem ze skrótem
+    /// i miniaturami policzonymi przy wczytywaniu (zapis ich nie liczy drugi raz).
+    QList<IngestedPhoto> m_photoBuffer;
 
     /// Bufor przechowujący ścieżki do zdjęć przed zapisaniem do bazy.
     QStringList m_photoPathsBuffer;
+
+    /// Wątek trwającego importu zdjęć (null = brak importu) i jego flaga anulowania.
+    QPointer<QThread> m_photoImportThread;
+    std::shared_ptr<std::atomic<bool>> m_photoImportCancelled;
 };
 
 #endif // MAINWINDOW_H
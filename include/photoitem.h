@@ -38,6 +38,7 @@
 #include <QGraphicsSceneHoverEvent>
 #include <QGraphicsSceneMouseEvent>
 #include <QObject>
+#include <QString>
 
 /**
  * @class PhotoItem
@@ -92,6 +93,16 @@ public:
     //// do uzupełnienia dokumentacja
     void setEditMode(bool editMode);
 
+    /**
+     * @brief Ustawia ID zdjęcia (photos.id) reprezentowanego przez miniaturę.
+     *
+     * @section MethodOverview
+     * v1.5: PhotoItem trzyma tylko miniaturę i ID — oryginał jest pobierany na żądanie
+     * (podgląd, pełny ekran) przez PhotoService/PhotoCache, a nie przypięty do sceny.
+     */
+    void setPhotoId(const QString &photoId);
+    QString photoId() const;
+
 signals:
     /**
      * @brief Sygnał emitowany po jednokrotnym kliknięciu lewym przyciskiem myszy.
@@ -208,6 +219,9 @@ private:
     */
     bool m_isEditMode = false;
 
+    /// ID zdjęcia w tabeli photos; pusty dla zdjęć z bufora (niezapisanych).
+    QString m_photoId;
+
     /**
      * @brief Aktualizuje wygląd ramki zaznaczenia w zależności od stanu.
      *
@@ -31,6 +31,7 @@
 #define UTILS_H
 
 #include <QString>
+#include <QStringList>
 
 class QSqlDatabase;
 
@@ -60,4 +61,31 @@ bool setupDatabase(const QString &dbType,
 
 bool ensureDatabaseSchema(QSqlDatabase &db);
 
+/// v1.5: porównanie indeksów w bazie z katalogiem indeksów (DatabaseSchemaUtils.cpp).
+struct DatabaseIndexReport
+{
+    /// Indeksy z katalogu, których nie ma w bazie.
+    QStringList missing;
+    /// Indeksy na tabelach aplikacji spoza katalogu — kandydaci do usunięcia.
+    QStringList undeclared;
+};
+
+bool verifyDatabaseIndexes(QSqlDatabase &db, DatabaseIndexReport *report);
+
+/**
+ * @brief Otwiera połączenie robocze dla wątku w tle jako klon istniejącego połączenia.
+ *
+ * QSqlDatabase nie może być współdzielony między wątkami, więc workery (miniatury,
+ * ładowanie zdjęć) pracują na klonie `sourceConnectionName`. Dla SQLite ustawiany jest
+ * busy timeout oraz PRAGMA foreign_keys, tak jak w `setupDatabase`. Funkcję trzeba
+ * wywołać w wątku, który będzie używał połączenia; ten sam wątek zamyka je i wywołuje
+ * `QSqlDatabase::removeDatabase(connectionName)`. Workery pobierają takie połączenia
+ * przez DatabaseConnectionPool, który otwiera je i zamyka za nie.
+ *
+ * @return true, jeśli połączenie zostało otwarte.
+ */
+bool openWorkerConnection(const QString &sourceConnectionName,
+                          const QString &connectionName,
+                          QString *errorMessage);
+
 #endif // UTILS_H
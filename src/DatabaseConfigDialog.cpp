@@ -40,6 +40,7 @@
 #include <QFontDatabase>
 #include <QFormLayout>
 #include <QGroupBox>
+#include <QHBoxLayout>
 #include <QLabel>
 #include <QPushButton>
 #include <QSettings>
@@ -218,6 +219,45 @@ DatabaseConfigDialog::DatabaseConfigDialog(QWidget *parent)
         }
     }
 
+    // ============================================================
+    // v1.5: Sekcja Zdjęcia — opcjonalny magazyn plików zamiast BLOB w bazie
+    // ============================================================
+    {
+        auto *photoGroup = new QGroupBox(tr("Zdjęcia — magazyn plików"), this);
+        auto *photoLayout = new QFormLayout(photoGroup);
+
+        auto *storeDirEdit = new QLineEdit(photoGroup);
+        storeDirEdit->setObjectName(QStringLiteral("photoBlobStoreDirEdit"));
+        storeDirEdit->setPlaceholderText(tr("(puste = zdjęcia w bazie danych)"));
+        storeDirEdit->setText(settings.value(QStringLiteral("photos/blob_store_dir")).toString());
+        auto *browseButton = new QPushButton(tr("Wybierz..."), photoGroup);
+        connect(browseButton, &QPushButton::clicked, this, [this, storeDirEdit]()
+                {
+            const QString dir = QFileDialog::getExistingDirectory(this,
+                                                                  tr("Katalog magazynu zdjęć"),
+                                                                  storeDirEdit->text());
+            if (!dir.isEmpty())
+                storeDirEdit->setText(dir); });
+        auto *storeDirRow = new QHBoxLayout;
+        storeDirRow->addWidget(storeDirEdit);
+        storeDirRow->addWidget(browseButton);
+        photoLayout->addRow(tr("Katalog:"), storeDirRow);
+
+        auto *storeHint = new QLabel(
+            tr("Nowe zdjęcia trafiają do plików, a istniejące są przenoszone z bazy w tle. "
+               "Przy bazie MySQL wszystkie stanowiska muszą widzieć ten sam katalog (udział sieciowy)."),
+            photoGroup);
+        storeHint->setStyleSheet(QStringLiteral("color: #888; font-size: 11px; padding: 4px;"));
+        storeHint->setWordWrap(true);
+        photoLayout->addRow(QString(), storeHint);
+
+        if (auto *mainLayout = qobject_cast<QVBoxLayout *>(this->layout()))
+        {
+            const int insertIdx = mainLayout->count() - 1;  // przed ostatnim (buttonBox)
+            mainLayout->insertWidget(insertIdx, photoGroup);
+        }
+    }
+
     // Pacman easter egg (usuń lub ogranicz do pól tekstowych)
     QTimer *pacmanTimer = new QTimer(this);
     pacmanTimer->setSingleShot(true);
@@ -280,6 +320,8 @@ void DatabaseConfigDialog::accept()
         settings.setValue(QStringLiteral("ai/model"), modelCombo->currentData().toString());
     if (auto *skipCost = findChild<QCheckBox *>(QStringLiteral("aiSkipCostCheckbox")))
         settings.setValue(QStringLiteral("ai/skip_cost_confirm"), skipCost->isChecked());
+    if (auto *storeDir = findChild<QLineEdit *>(QStringLiteral("photoBlobStoreDirEdit")))
+        settings.setValue(QStringLiteral("photos/blob_store_dir"), storeDir->text().trimmed());
 
     QDialog::accept();
 }
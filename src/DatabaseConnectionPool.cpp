@@ -0,0 +1,295 @@
+#include "DatabaseConnectionPool.h"
+
+#include "PhotoService.h"
+#include "PreparedStatementCache.h"
+#include "utils.h"
+
+#include <QDebug>
+#include <QMutexLocker>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QThread>
+
+#include <memory>
+#include <utility>
+
+namespace {
+
+bool isGuiThread(QThread *thread)
+{
+    const QCoreApplication *application = QCoreApplication::instance();
+    return application && application->thread() == thread;
+}
+
+QString formatDbError(const QString &context, const QString &details)
+{
+    return DatabaseConnectionPool::tr("%1\n%2").arg(context, details);
+}
+
+}
+
+PooledConnection::PooledConnection(DatabaseConnectionPool *pool, const QString &connectionName)
+    : m_pool(pool)
+    , m_connectionName(connectionName)
+{
+}
+
+PooledConnection::~PooledConnection()
+{
+    release();
+}
+
+PooledConnection::PooledConnection(PooledConnection &&other) noexcept
+    : m_pool(std::exchange(other.m_pool, nullptr))
+    , m_connectionName(std::move(other.m_connectionName))
+{
+}
+
+PooledConnection &PooledConnection::operator=(PooledConnection &&other) noexcept
+{
+    if (this != &other) {
+        release();
+        m_pool = std::exchange(other.m_pool, nullptr);
+        m_connectionName = std::move(other.m_connectionName);
+    }
+    return *this;
+}
+
+QSqlDatabase PooledConnection::database() const
+{
+    return m_pool ? QSqlDatabase::database(m_connectionName, false) : QSqlDatabase();
+}
+
+void PooledConnection::release()
+{
+    if (m_pool)
+        m_pool->release(m_connectionName);
+    m_pool = nullptr;
+}
+
+DatabaseConnectionPool::DatabaseConnectionPool(const QString &sourceConnectionName)
+    : m_sourceConnectionName(sourceConnectionName)
+{
+}
+
+DatabaseConnectionPool::~DatabaseConnectionPool()
+{
+    // Klony innych wątków zamykają się same przy końcu wątku — tu tylko odpinamy
+    // sygnały finished, żeby nie wołały zniszczonej puli.
+    QMutexLocker locker(&m_mutex);
+    for (auto it = m_connections.begin(); it != m_connections.end(); ++it)
+        QObject::disconnect(it->threadFinished);
+    const auto current = m_connections.constFind(QThread::currentThread());
+    const bool closeCurrent = current != m_connections.constEnd() && current->ownsConnection;
+    const QString currentName = closeCurrent ? current->connectionName : QString();
+    m_connections.clear();
+    locker.unlock();
+
+    if (closeCurrent)
+        closeConnection(currentName);
+}
+
+DatabaseConnectionPool &DatabaseConnectionPool::instance(const QString &sourceConnectionName)
+{
+    static QMutex mutex;
+    static QHash<QString, std::shared_ptr<DatabaseConnectionPool>> pools;
+    const QMutexLocker locker(&mutex);
+    std::shared_ptr<DatabaseConnectionPool> &pool = pools[sourceConnectionName];
+    if (!pool)
+        pool = std::make_shared<DatabaseConnectionPool>(sourceConnectionName);
+    return *pool;
+}
+
+PooledConnection DatabaseConnectionPool::acquire(QString *errorMessage)
+{
+    QThread *thread = QThread::currentThread();
+    QString connectionName;
+    QString staleConnectionName;
+    bool needsOpen = false;
+    bool needsPing = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        ++m_stats.checkouts;
+        auto it = m_connections.find(thread);
+        if (it == m_connections.end()) {
+            ThreadConnection entry;
+            entry.ownsConnection = !isGuiThread(thread);
+            entry.connectionName = entry.ownsConnection
+                                       ? QStringLiteral("pool-%1-%2")
+                                             .arg(m_sourceConnectionName)
+                                             .arg(reinterpret_cast<quintptr>(thread), 0, 16)
+                                       : m_sourceConnectionName;
+            entry.generation = m_generation;
+            if (entry.ownsConnection) {
+                // Emitowany w kończącym się wątku — tam, gdzie połączenie wolno zamknąć.
+                entry.threadFinished = QObject::connect(
+                    thread, &QThread::finished, thread,
+                    [this, thread]() { removeThreadConnection(thread); }, Qt::DirectConnection);
+                needsOpen = true;
+            } else {
+                // Połączenie źródłowe mogło już długo leżeć bezczynnie.
+                needsPing = true;
+            }
+            entry.idleTimer.start();
+            it = m_connections.insert(thread, entry);
+            m_stats.peakConnections = qMax(m_stats.peakConnections, int(m_connections.size()));
+        } else if (it->ownsConnection && it->generation != m_generation && it->borrowCount == 0) {
+            staleConnectionName = it->connectionName;
+            it->generation = m_generation;
+            needsOpen = true;
+        } else if (it->borrowCount == 0 && it->idleTimer.elapsed() >= kValidationIdleMs) {
+            needsPing = true;
+        }
+        ++it->borrowCount;
+        connectionName = it->connectionName;
+    }
+
+    // Otwieranie i SELECT 1 poza muteksem — inne wątki nie czekają na serwer.
+    if (!staleConnectionName.isEmpty())
+        closeConnection(staleConnectionName);
+
+    bool ok = false;
+    if (needsOpen) {
+        ok = openWorkerConnection(m_sourceConnectionName, connectionName, errorMessage);
+        if (ok) {
+            const QMutexLocker locker(&m_mutex);
+            ++m_stats.createdConnections;
+        }
+    } else {
+        ok = validate(connectionName, needsPing, errorMessage);
+    }
+
+    if (!ok) {
+        if (needsOpen)
+            removeThreadConnection(thread);
+        else
+            release(connectionName);
+        return PooledConnection();
+    }
+
+    if (errorMessage)
+        errorMessage->clear();
+    return PooledConnection(this, connectionName);
+}
+
+bool DatabaseConnectionPool::validate(const QString &connectionName, bool ping, QString *errorMessage)
+{
+    QSqlDatabase db = QSqlDatabase::database(connectionName, false);
+    if (!db.isValid()) {
+        if (errorMessage)
+            *errorMessage = tr("Brak połączenia z bazą danych (%1).").arg(connectionName);
+        return false;
+    }
+
+    bool alive = db.isOpen();
+    // SQLite to plik lokalny — sprawdzać trzeba tylko połączenie z serwerem.
+    if (alive && ping && db.driverName() != "QSQLITE") {
+        QSqlQuery query(db);
+        alive = query.exec("SELECT 1");
+    }
+    if (alive)
+        return true;
+
+    {
+        const QMutexLocker locker(&m_mutex);
+        ++m_stats.validationFailures;
+        ++m_stats.reconnects;
+    }
+    qDebug() << "DatabaseConnectionPool: ponowne łączenie" << connectionName << db.lastError().text();
+
+    // Uchwyty zapytań zamkniętego połączenia są nieważne, a serwer mógł się zmienić.
+    PreparedStatementCache::instance().release(connectionName);
+    PhotoService::releaseStatementBudget(connectionName);
+    db.close();
+    if (!db.open()) {
+        if (errorMessage)
+            *errorMessage = formatDbError(tr("Nie udało się ponownie połączyć z bazą danych."),
+                                          db.lastError().text());
+        return false;
+    }
+    if (db.driverName() == "QSQLITE") {
+        QSqlQuery pragmaQuery(db);
+        pragmaQuery.exec("PRAGMA foreign_keys = ON");
+    }
+    return true;
+}
+
+void DatabaseConnectionPool::release(const QString &connectionName)
+{
+    const QMutexLocker locker(&m_mutex);
+    const auto it = m_connections.find(QThread::currentThread());
+    if (it == m_connections.end() || it->connectionName != connectionName) {
+        qWarning() << "DatabaseConnectionPool: połączenie" << connectionName << "oddane w innym wątku";
+        return;
+    }
+    if (--it->borrowCount == 0)
+        it->idleTimer.start();
+}
+
+void DatabaseConnectionPool::closeThreadConnection()
+{
+    {
+        const QMutexLocker locker(&m_mutex);
+        const auto it = m_connections.constFind(QThread::currentThread());
+        if (it == m_connections.constEnd() || !it->ownsConnection || it->borrowCount > 0)
+            return;
+    }
+    removeThreadConnection(QThread::currentThread());
+}
+
+void DatabaseConnectionPool::removeThreadConnection(QThread *thread)
+{
+    ThreadConnection entry;
+    {
+        const QMutexLocker locker(&m_mutex);
+        const auto it = m_connections.find(thread);
+        if (it == m_connections.end())
+            return;
+        entry = it.value();
+        m_connections.erase(it);
+    }
+    QObject::disconnect(entry.threadFinished);
+    if (entry.ownsConnection)
+        closeConnection(entry.connectionName);
+}
+
+void DatabaseConnectionPool::closeConnection(const QString &connectionName)
+{
+    PreparedStatementCache::instance().release(connectionName);
+    PhotoService::releaseStatementBudget(connectionName);
+    {
+        QSqlDatabase db = QSqlDatabase::database(connectionName, false);
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
+void DatabaseConnectionPool::invalidate()
+{
+    {
+        const QMutexLocker locker(&m_mutex);
+        ++m_generation;
+    }
+    // Nowe ustawienia mogą wskazywać inny serwer — max_allowed_packet trzeba odczytać od nowa.
+    PhotoService::clearStatementBudgets();
+}
+
+DatabaseConnectionPool::Stats DatabaseConnectionPool::stats() const
+{
+    const QMutexLocker locker(&m_mutex);
+    Stats result = m_stats;
+    result.connections = int(m_connections.size());
+    result.inUse = 0;
+    for (const ThreadConnection &entry : m_connections) {
+        if (entry.borrowCount > 0)
+            ++result.inUse;
+    }
+    return result;
+}
+
+void DatabaseConnectionPool::resetStats()
+{
+    const QMutexLocker locker(&m_mutex);
+    m_stats = Stats();
+    m_stats.peakConnections = int(m_connections.size());
+}
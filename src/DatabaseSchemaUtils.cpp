@@ -3,12 +3,15 @@
  * @brief Implementacja przygotowania i doszczelniania schematu bazy danych.
  */
 
+#include "ItemRepository.h"
 #include "utils.h"
 
 #include <QDebug>
 #include <QSqlDatabase>
 #include <QSqlError>
+#include <QSettings>
 #include <QSqlQuery>
+#include <QStandardPaths>
 #include <QUuid>
 
 namespace {
@@ -58,30 +61,408 @@ bool ensureHasOriginalPackagingColumn(QSqlDatabase &db)
                            "Błąd dodawania kolumny has_original_packaging w MySQL:");
 }
 
-bool ensurePhotoIndex(QSqlDatabase &db)
+/// v1.5: katalog indeksów pomocniczych — jedno miejsce, w którym widać, jakie zapytania
+/// aplikacji mają wsparcie indeksu. ensureDatabaseSchema tworzy brakujące pozycje,
+/// a verifyDatabaseIndexes porównuje katalog z bazą (testy sprawdzają plany EXPLAIN).
+struct IndexSpec
+{
+    const char *name;
+    const char *table;
+    const char *sqliteColumns;
+    /// nullptr — indeks nie ma sensu w MySQL.
+    const char *mysqlColumns;
+};
+
+constexpr IndexSpec kIndexCatalog[] = {
+    // Zdjęcia eksponatu: lista, podgląd, usuwanie rekordu.
+    {"idx_photos_eksponat_id", "photos", "eksponat_id", "eksponat_id"},
+    // Deduplikacja treści (photo_blobs.ref_count, odśmiecanie).
+    {"idx_photos_blob_hash", "photos", "blob_hash", "blob_hash"},
+    {"idx_serial_number", "eksponaty", "serial_number", "serial_number(64)"},
+    // Filtry listy w SQL (ItemQueryBuilder) i sprawdzanie kluczy obcych przy
+    // usuwaniu wpisu słownika. Producent + model to najczęstsza para filtrów.
+    {"idx_eksponaty_type_id", "eksponaty", "type_id", "type_id"},
+    {"idx_eksponaty_vendor_model", "eksponaty", "vendor_id, model_id", "vendor_id, model_id"},
+    {"idx_eksponaty_model_id", "eksponaty", "model_id", "model_id"},
+    {"idx_eksponaty_status_storage", "eksponaty", "status_id, storage_place_id", "status_id, storage_place_id"},
+    {"idx_eksponaty_storage_place_id", "eksponaty", "storage_place_id", "storage_place_id"},
+    // Stronicowanie listy po kluczu (name, id) — ItemTableModel::pageSql. W MySQL
+    // wymaga name VARCHAR (ensureItemNameColumnType).
+    {"idx_eksponaty_name_id", "eksponaty", "name, id", "name, id"},
+    // Modele producenta (formularz rekordu, kaskadowe usuwanie producenta).
+    {"idx_models_vendor_id", "models", "vendor_id", "vendor_id"},
+};
+
+bool indexExists(QSqlDatabase &db, const QString &table, const QString &indexName, bool *exists)
 {
     QSqlQuery query(db);
-
     if (db.driverName() == "QSQLITE") {
-        return execSchemaQuery(query,
-                               "CREATE INDEX IF NOT EXISTS idx_photos_eksponat_id ON photos(eksponat_id)",
-                               "Błąd tworzenia indeksu zdjęć (SQLite):");
+        query.prepare("SELECT COUNT(*) FROM sqlite_master WHERE type = 'index' AND name = :name");
+    } else {
+        query.prepare("SELECT COUNT(*) FROM information_schema.statistics "
+                      "WHERE table_schema = DATABASE() "
+                      "AND table_name = :table "
+                      "AND index_name = :name");
+        query.bindValue(":table", table);
     }
+    query.bindValue(":name", indexName);
+    if (!query.exec()) {
+        qDebug() << "Błąd sprawdzania indeksu" << indexName << query.lastError().text();
+        return false;
+    }
+    *exists = query.next() && query.value(0).toInt() > 0;
+    return true;
+}
 
-    if (!query.exec("SELECT COUNT(*) FROM information_schema.statistics "
+/// Starsze bazy MySQL mają eksponaty.name jako TEXT, którego nie da się indeksować
+/// w całości (a indeks prefiksu nie obsłuży ORDER BY name, id). Kolumna przechodzi
+/// na VARCHAR(ItemRecordData::kMaxNameLength), o ile żadna nazwa nie jest dłuższa —
+/// wtedy `indexable` = false, a indeks stron zostaje pominięty.
+bool ensureItemNameColumnType(QSqlDatabase &db, bool *indexable)
+{
+    *indexable = true;
+    QSqlQuery query(db);
+    if (!query.exec("SELECT data_type FROM information_schema.columns "
                     "WHERE table_schema = DATABASE() "
-                    "AND table_name = 'photos' "
-                    "AND index_name = 'idx_photos_eksponat_id'")) {
-        qDebug() << "Błąd sprawdzania indeksu zdjęć w MySQL:" << query.lastError().text();
+                    "AND table_name = 'eksponaty' "
+                    "AND column_name = 'name'")) {
+        qDebug() << "Błąd sprawdzania typu kolumny eksponaty.name w MySQL:" << query.lastError().text();
         return false;
     }
+    if (!query.next() || query.value(0).toString().compare("varchar", Qt::CaseInsensitive) == 0)
+        return true;
 
-    if (query.next() && query.value(0).toInt() > 0)
+    if (!query.exec(QString("SELECT COUNT(*) FROM eksponaty WHERE CHAR_LENGTH(name) > %1")
+                        .arg(ItemRecordData::kMaxNameLength))
+        || !query.next()) {
+        qDebug() << "Błąd sprawdzania długości nazw eksponatów w MySQL:" << query.lastError().text();
+        return false;
+    }
+    if (query.value(0).toInt() > 0) {
+        qDebug() << "Nazwy dłuższe niż" << ItemRecordData::kMaxNameLength
+                 << "znaków — eksponaty.name zostaje TEXT, bez indeksu idx_eksponaty_name_id.";
+        *indexable = false;
         return true;
+    }
 
     return execSchemaQuery(query,
-                           "CREATE INDEX idx_photos_eksponat_id ON photos (eksponat_id)",
-                           "Błąd tworzenia indeksu zdjęć (MySQL):");
+                           QString("ALTER TABLE eksponaty MODIFY name VARCHAR(%1) NOT NULL")
+                               .arg(ItemRecordData::kMaxNameLength),
+                           "Błąd zmiany typu kolumny eksponaty.name w MySQL:");
+}
+
+bool ensureIndexCatalog(QSqlDatabase &db)
+{
+    const bool sqlite = db.driverName() == "QSQLITE";
+    bool nameIndexable = true;
+    if (!sqlite && !ensureItemNameColumnType(db, &nameIndexable))
+        return false;
+
+    QSqlQuery query(db);
+    for (const IndexSpec &index : kIndexCatalog) {
+        const char *columns = sqlite ? index.sqliteColumns : index.mysqlColumns;
+        if (!columns)
+            continue;
+        if (!nameIndexable && qstrcmp(index.name, "idx_eksponaty_name_id") == 0)
+            continue;
+
+        if (sqlite) {
+            if (!execSchemaQuery(query,
+                                 QString("CREATE INDEX IF NOT EXISTS %1 ON %2(%3)")
+                                     .arg(QLatin1String(index.name), QLatin1String(index.table),
+                                          QLatin1String(columns)),
+                                 "Błąd tworzenia indeksu (SQLite):"))
+                return false;
+            continue;
+        }
+
+        bool exists = false;
+        if (!indexExists(db, QLatin1String(index.table), QLatin1String(index.name), &exists))
+            return false;
+        if (!exists
+            && !execSchemaQuery(query,
+                                QString("CREATE INDEX %1 ON %2 (%3)")
+                                    .arg(QLatin1String(index.name), QLatin1String(index.table),
+                                         QLatin1String(columns)),
+                                "Błąd tworzenia indeksu (MySQL):"))
+            return false;
+    }
+    return true;
+}
+
+/// v1.5: miniatury zdjęć trzymamy w osobnej tabeli, żeby lista eksponatów
+/// nigdy nie musiała ściągać i dekodować pełnych BLOB-ów z `photos`.
+/// Tabela jest tworzona także dla istniejących baz (CREATE TABLE IF NOT EXISTS),
+/// dlatego nie należy do listy `requiredTables` wyzwalającej seed słowników.
+bool ensurePhotoThumbnailTable(QSqlDatabase &db)
+{
+    QSqlQuery query(db);
+
+    if (db.driverName() == "QSQLITE") {
+        return execSchemaQuery(query, R"(
+            CREATE TABLE IF NOT EXISTS photo_thumbnails (
+              photo_id TEXT NOT NULL,
+              size_px INTEGER NOT NULL,
+              thumbnail BLOB NOT NULL,
+              PRIMARY KEY (photo_id, size_px),
+              FOREIGN KEY (photo_id) REFERENCES photos(id) ON DELETE CASCADE
+            )
+        )",
+                               "Błąd tworzenia tabeli photo_thumbnails (SQLite):");
+    }
+
+    return execSchemaQuery(query, R"(
+        CREATE TABLE IF NOT EXISTS photo_thumbnails (
+            photo_id VARCHAR(36) NOT NULL,
+            size_px INT NOT NULL,
+            thumbnail MEDIUMBLOB NOT NULL,
+            PRIMARY KEY (photo_id, size_px),
+            CONSTRAINT fk_photo_thumbnails_photo
+                FOREIGN KEY (photo_id) REFERENCES photos(id)
+                ON DELETE CASCADE
+        )
+    )",
+                           "Błąd tworzenia tabeli photo_thumbnails (MySQL):");
+}
+
+bool columnExists(QSqlDatabase &db, const QString &table, const QString &column, bool *exists)
+{
+    QSqlQuery query(db);
+    *exists = false;
+
+    if (db.driverName() == "QSQLITE") {
+        if (!query.exec(QString("PRAGMA table_info(%1)").arg(table))) {
+            qDebug() << "Błąd sprawdzania kolumn SQLite dla" << table << query.lastError().text();
+            return false;
+        }
+        while (query.next()) {
+            if (query.value("name").toString() == column)
+                *exists = true;
+        }
+        return true;
+    }
+
+    query.prepare("SELECT COUNT(*) FROM information_schema.columns "
+                  "WHERE table_schema = DATABASE() "
+                  "AND table_name = :table "
+                  "AND column_name = :column");
+    query.bindValue(":table", table);
+    query.bindValue(":column", column);
+    if (!query.exec()) {
+        qDebug() << "Błąd sprawdzania kolumny" << column << "w MySQL:" << query.lastError().text();
+        return false;
+    }
+    *exists = query.next() && query.value(0).toInt() > 0;
+    return true;
+}
+
+bool ensureColumn(QSqlDatabase &db, const QString &table, const QString &column, const QString &definition)
+{
+    bool exists = false;
+    if (!columnExists(db, table, column, &exists))
+        return false;
+    if (exists)
+        return true;
+
+    QSqlQuery query(db);
+    return execSchemaQuery(query,
+                           QString("ALTER TABLE %1 ADD COLUMN %2 %3").arg(table, column, definition),
+                           "Błąd dodawania kolumny:");
+}
+
+/// v1.5: treść zdjęć adresowana skrótem SHA-256 — ten sam plik dodany dwa razy
+/// (albo sklonowany razem z eksponatem) leży w photo_blobs raz, a wiersze `photos`
+/// wskazują go przez blob_hash. ref_count liczy wiersze `photos`; blob z licznikiem
+/// 0 jest usuwany przez PhotoService::collectUnreferencedBlobs. Stare wiersze
+/// (blob_hash NULL) nadal trzymają dane w photos.photo.
+/// external = 1: treść leży w PhotoBlobStore (pliki), a `data` jest puste;
+/// width/height pozwalają znać wymiary bez czytania pliku.
+bool ensurePhotoBlobStorage(QSqlDatabase &db)
+{
+    QSqlQuery query(db);
+    const bool sqlite = db.driverName() == "QSQLITE";
+
+    if (sqlite) {
+        if (!execSchemaQuery(query, R"(
+            CREATE TABLE IF NOT EXISTS photo_blobs (
+              hash TEXT PRIMARY KEY,
+              data BLOB NOT NULL,
+              ref_count INTEGER NOT NULL DEFAULT 0,
+              external INTEGER NOT NULL DEFAULT 0,
+              width INTEGER,
+              height INTEGER
+            )
+        )",
+                             "Błąd tworzenia tabeli photo_blobs (SQLite):"))
+            return false;
+    } else if (!execSchemaQuery(query, R"(
+        CREATE TABLE IF NOT EXISTS photo_blobs (
+            hash CHAR(64) PRIMARY KEY,
+            data LONGBLOB NOT NULL,
+            ref_count INT NOT NULL DEFAULT 0,
+            external BOOLEAN NOT NULL DEFAULT 0,
+            width INT NULL,
+            height INT NULL
+        )
+    )",
+                                "Błąd tworzenia tabeli photo_blobs (MySQL):")) {
+        return false;
+    }
+
+    if (!ensureColumn(db, "photo_blobs", "external", sqlite ? "INTEGER NOT NULL DEFAULT 0" : "BOOLEAN NOT NULL DEFAULT 0")
+        || !ensureColumn(db, "photo_blobs", "width", sqlite ? "INTEGER" : "INT NULL")
+        || !ensureColumn(db, "photo_blobs", "height", sqlite ? "INTEGER" : "INT NULL"))
+        return false;
+
+    bool hasBlobHash = false;
+    if (!columnExists(db, "photos", "blob_hash", &hasBlobHash))
+        return false;
+    if (sqlite) {
+        if (!hasBlobHash
+            && !execSchemaQuery(query,
+                                "ALTER TABLE photos ADD COLUMN blob_hash TEXT",
+                                "Błąd dodawania kolumny blob_hash w SQLite:"))
+            return false;
+
+        return execSchemaQuery(query,
+                               "CREATE INDEX IF NOT EXISTS idx_photos_blob_hash ON photos(blob_hash)",
+                               "Błąd tworzenia indeksu blob_hash (SQLite):");
+    }
+
+    if (hasBlobHash)
+        return true;
+
+    return execSchemaQuery(query,
+                           "ALTER TABLE photos ADD COLUMN blob_hash CHAR(64) NULL, "
+                           "ADD INDEX idx_photos_blob_hash (blob_hash)",
+                           "Błąd dodawania kolumny blob_hash w MySQL:");
+}
+
+/// Kolumny tekstowe eksponaty_fts z ł → l; `prefix` to np. "new." w triggerze.
+QString fullTextColumns(const QString &prefix)
+{
+    QStringList columns;
+    for (const char *column : {"name", "serial_number", "part_number", "description"})
+        columns.append(QStringLiteral("replace(replace(%1%2, 'ł', 'l'), 'Ł', 'L')")
+                           .arg(prefix, QLatin1String(column)));
+    return columns.join(QStringLiteral(", "));
+}
+
+/// Usuwa triggery i tabelę eksponaty_fts (SQLite) — bez nich zapis eksponatu nie
+/// zależy od modułu FTS5. Błędy tylko w logu: tabeli FTS5 nie da się usunąć w SQLite
+/// bez tego modułu, a triggery zniknęły już wcześniej.
+void dropFullTextIndex(QSqlQuery &query, bool dropTable)
+{
+    for (const char *trigger : {"eksponaty_fts_insert", "eksponaty_fts_delete", "eksponaty_fts_update"})
+        execSchemaQuery(query,
+                        QStringLiteral("DROP TRIGGER IF EXISTS %1").arg(QLatin1String(trigger)),
+                        "Błąd usuwania triggera indeksu pełnotekstowego:");
+    if (dropTable)
+        execSchemaQuery(query,
+                        "DROP TABLE IF EXISTS eksponaty_fts",
+                        "Błąd usuwania indeksu pełnotekstowego (SQLite):");
+}
+
+/// v1.5: indeks pełnotekstowy pola „Szukaj” (ItemSearchService). Opcjonalny —
+/// inwentaryzacja.ini, klucz `search/fulltext` (domyślnie wyłączony — indeks dopasowuje
+/// prefiksy słów, a nie podciągi jak wyszukiwanie w pamięci). Brak FTS5
+/// w SQLite albo błąd FULLTEXT w MySQL nie blokuje startu: lista szuka wtedy w pamięci.
+///
+/// Wyłączenie opcji usuwa w SQLite triggery i tabelę (włączenie buduje indeks od nowa),
+/// tak samo gdy tabela jest, ale SQLite nie ma modułu FTS5 — inaczej triggery
+/// blokowałyby każdy zapis eksponatu. Indeks FULLTEXT w MySQL utrzymuje InnoDB, więc
+/// po wyłączeniu opcji zostaje (ALTER TABLE … DROP INDEX ft_eksponaty_text usuwa go ręcznie).
+///
+/// SQLite: tabela FTS5 z własną treścią i kolumną item_id, utrzymywana triggerami.
+/// Nie używamy `content='eksponaty'` — eksponaty nie ma INTEGER PRIMARY KEY, a VACUUM
+/// (także VACUUM INTO w backupie) może przenumerować rowid i rozspójnić indeks.
+/// Tokenizer unicode61 nie zdejmuje ogonka z „ł” (litera bez rozkładu NFD) — indeks
+/// dostaje tekst z ł → l, tak jak zapytania w ItemSearchService::search().
+void ensureFullTextIndex(QSqlDatabase &db)
+{
+    QSettings settings(QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation)
+                           + "/inwentaryzacja.ini",
+                       QSettings::IniFormat);
+    const bool enabled = settings.value("search/fulltext", false).toBool();
+
+    QSqlQuery query(db);
+    if (!enabled) {
+        if (db.driverName() == "QSQLITE")
+            dropFullTextIndex(query, true);
+        return;
+    }
+
+    if (db.driverName() == "QSQLITE") {
+        if (!query.exec("SELECT COUNT(*) FROM sqlite_master WHERE name = 'eksponaty_fts'")) {
+            qDebug() << "Błąd sprawdzania indeksu pełnotekstowego (SQLite):" << query.lastError().text();
+            return;
+        }
+        const bool exists = query.next() && query.value(0).toInt() > 0;
+        query.finish();
+
+        if (!exists) {
+            if (!execSchemaQuery(query,
+                                 "CREATE VIRTUAL TABLE eksponaty_fts USING fts5("
+                                 "item_id UNINDEXED, name, serial_number, part_number, description, "
+                                 "tokenize = 'unicode61 remove_diacritics 2')",
+                                 "Indeks pełnotekstowy niedostępny (SQLite bez FTS5?):"))
+                return;
+            execSchemaQuery(query,
+                            "INSERT INTO eksponaty_fts(item_id, name, serial_number, part_number, description) "
+                            "SELECT id, " + fullTextColumns(QString()) + " FROM eksponaty",
+                            "Błąd wypełniania indeksu pełnotekstowego (SQLite):");
+        }
+
+        // Tabela utworzona wcześniej (np. inną biblioteką SQLite) bez modułu FTS5 jest
+        // bezużyteczna, a triggery na niej psułyby zapis eksponatów.
+        if (!query.exec("SELECT 1 FROM eksponaty_fts LIMIT 0")) {
+            qDebug() << "Indeks pełnotekstowy niedostępny (SQLite bez FTS5?):" << query.lastError().text();
+            dropFullTextIndex(query, false);
+            return;
+        }
+        query.finish();
+
+        execSchemaQuery(query, QStringLiteral(R"(
+            CREATE TRIGGER IF NOT EXISTS eksponaty_fts_insert AFTER INSERT ON eksponaty BEGIN
+              INSERT INTO eksponaty_fts(item_id, name, serial_number, part_number, description)
+              VALUES (new.id, %1);
+            END
+        )").arg(fullTextColumns("new.")),
+                        "Błąd tworzenia triggera eksponaty_fts_insert:");
+        execSchemaQuery(query, R"(
+            CREATE TRIGGER IF NOT EXISTS eksponaty_fts_delete AFTER DELETE ON eksponaty BEGIN
+              DELETE FROM eksponaty_fts WHERE item_id = old.id;
+            END
+        )",
+                        "Błąd tworzenia triggera eksponaty_fts_delete:");
+        // Tylko kolumny tekstowe — masowa zmiana statusu/miejsca nie przepisuje indeksu.
+        execSchemaQuery(query, QStringLiteral(R"(
+            CREATE TRIGGER IF NOT EXISTS eksponaty_fts_update
+            AFTER UPDATE OF id, name, serial_number, part_number, description ON eksponaty BEGIN
+              DELETE FROM eksponaty_fts WHERE item_id = old.id;
+              INSERT INTO eksponaty_fts(item_id, name, serial_number, part_number, description)
+              VALUES (new.id, %1);
+            END
+        )").arg(fullTextColumns("new.")),
+                        "Błąd tworzenia triggera eksponaty_fts_update:");
+        return;
+    }
+
+    if (!query.exec("SELECT COUNT(*) FROM information_schema.statistics "
+                    "WHERE table_schema = DATABASE() "
+                    "AND table_name = 'eksponaty' "
+                    "AND index_name = 'ft_eksponaty_text'")) {
+        qDebug() << "Błąd sprawdzania indeksu pełnotekstowego (MySQL):" << query.lastError().text();
+        return;
+    }
+    if (query.next() && query.value(0).toInt() > 0)
+        return;
+
+    // InnoDB utrzymuje FULLTEXT sam — triggery nie są potrzebne.
+    execSchemaQuery(query,
+                    "ALTER TABLE eksponaty ADD FULLTEXT INDEX ft_eksponaty_text "
+                    "(name, serial_number, part_number, description)",
+                    "Indeks pełnotekstowy niedostępny (MySQL):");
 }
 
 bool seedDictionaryData(QSqlDatabase &db)
@@ -391,7 +772,7 @@ bool ensureDatabaseSchema(QSqlDatabase &db)
         execOrTrack(R"(
             CREATE TABLE IF NOT EXISTS eksponaty (
                 id VARCHAR(36) PRIMARY KEY,
-                name TEXT NOT NULL,
+                name VARCHAR(255) NOT NULL,
                 type_id VARCHAR(36) NOT NULL,
                 vendor_id VARCHAR(36) NOT NULL,
                 model_id VARCHAR(36) NOT NULL,
@@ -465,5 +846,62 @@ bool ensureDatabaseSchema(QSqlDatabase &db)
             return false;
     }
 
-    return ensureHasOriginalPackagingColumn(db) && ensurePhotoIndex(db);
+    if (!ensureHasOriginalPackagingColumn(db) || !ensurePhotoThumbnailTable(db) || !ensurePhotoBlobStorage(db)
+        || !ensureIndexCatalog(db))
+        return false;
+
+    DatabaseIndexReport indexReport;
+    if (verifyDatabaseIndexes(db, &indexReport)) {
+        if (!indexReport.missing.isEmpty())
+            qDebug() << "Brakujące indeksy z katalogu:" << indexReport.missing;
+        if (!indexReport.undeclared.isEmpty())
+            qDebug() << "Indeksy spoza katalogu (możliwe, że nieużywane):" << indexReport.undeclared;
+    }
+
+    ensureFullTextIndex(db);
+    return true;
+}
+
+bool verifyDatabaseIndexes(QSqlDatabase &db, DatabaseIndexReport *report)
+{
+    *report = DatabaseIndexReport();
+    const bool sqlite = db.driverName() == "QSQLITE";
+
+    QStringList declared;
+    QStringList tables;
+    for (const IndexSpec &index : kIndexCatalog) {
+        if (!tables.contains(QLatin1String(index.table)))
+            tables.append(QLatin1String(index.table));
+        if (!sqlite && !index.mysqlColumns)
+            continue;
+        declared.append(QLatin1String(index.name));
+
+        bool exists = false;
+        if (!indexExists(db, QLatin1String(index.table), QLatin1String(index.name), &exists))
+            return false;
+        if (!exists)
+            report->missing.append(QLatin1String(index.name));
+    }
+
+    // Indeksy tworzone przez bazę (PRIMARY KEY, UNIQUE, klucze obce w MySQL) i FULLTEXT
+    // wyszukiwarki nie są w katalogu i nie są raportowane.
+    QSqlQuery query(db);
+    const QString tableList = QLatin1Char('\'') + tables.join(QStringLiteral("','")) + QLatin1Char('\'');
+    const QString sql = sqlite
+                            ? QString("SELECT name FROM sqlite_master WHERE type = 'index' AND sql IS NOT NULL "
+                                      "AND tbl_name IN (%1)").arg(tableList)
+                            : QString("SELECT DISTINCT index_name FROM information_schema.statistics "
+                                      "WHERE table_schema = DATABASE() AND non_unique = 1 "
+                                      "AND index_name NOT LIKE 'fk\\_%' AND index_type <> 'FULLTEXT' "
+                                      "AND table_name IN (%1)").arg(tableList);
+    if (!query.exec(sql)) {
+        qDebug() << "Błąd odczytu listy indeksów:" << query.lastError().text();
+        return false;
+    }
+    while (query.next()) {
+        const QString name = query.value(0).toString();
+        if (!declared.contains(name))
+            report->undeclared.append(name);
+    }
+    return true;
 }
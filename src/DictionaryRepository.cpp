@@ -1,5 +1,7 @@
 #include "DictionaryRepository.h"
 
+#include "PreparedStatementCache.h"
+
 #include <QSqlError>
 #include <QSqlQuery>
 #include <QUuid>
@@ -22,28 +24,34 @@ bool DictionaryRepository::addEntry(const QString &tableName,
                                     const QString &name,
                                     QString *errorMessage,
                                     const QString &parentColumn,
-                                    const QString &parentId)
+                                    const QString &parentId,
+                                    QString *entryId)
 {
-    QSqlQuery query(m_db);
+    PreparedStatement query;
 
     if (!parentColumn.isEmpty()) {
-        query.prepare(QString("INSERT INTO %1 (id, name, %2) VALUES (:id, :name, :parentId)")
-                          .arg(tableName, parentColumn));
-        query.bindValue(":parentId", parentId);
+        query = PreparedStatementCache::instance().prepare(
+            m_db,
+            QString("INSERT INTO %1 (id, name, %2) VALUES (:id, :name, :parentId)").arg(tableName, parentColumn));
+        query->bindValue(":parentId", parentId);
     } else {
-        query.prepare(QString("INSERT INTO %1 (id, name) VALUES (:id, :name)").arg(tableName));
+        query = PreparedStatementCache::instance().prepare(
+            m_db, QString("INSERT INTO %1 (id, name) VALUES (:id, :name)").arg(tableName));
     }
 
-    query.bindValue(":id", QUuid::createUuid().toString(QUuid::WithoutBraces));
-    query.bindValue(":name", name);
+    const QString id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    query->bindValue(":id", id);
+    query->bindValue(":name", name);
 
-    if (!query.exec()) {
+    if (!query->exec()) {
         if (errorMessage)
             *errorMessage = formatDbError(QObject::tr("Nie udało się dodać wpisu do słownika."),
-                                          query.lastError().text());
+                                          query->lastError().text());
         return false;
     }
 
+    if (entryId)
+        *entryId = id;
     if (errorMessage)
         errorMessage->clear();
     return true;
@@ -54,31 +62,31 @@ bool DictionaryRepository::renameEntry(const QString &tableName,
                                        const QString &newName,
                                        QString *errorMessage)
 {
-    QSqlQuery query(m_db);
-    query.prepare(QString("SELECT id FROM %1 WHERE name = :name").arg(tableName));
-    query.bindValue(":name", currentName);
-    if (!query.exec()) {
+    PreparedStatement query = PreparedStatementCache::instance().prepare(
+        m_db, QString("SELECT id FROM %1 WHERE name = :name").arg(tableName));
+    query->bindValue(":name", currentName);
+    if (!query->exec()) {
         if (errorMessage)
             *errorMessage = formatDbError(QObject::tr("Nie udało się odczytać wpisu słownika do edycji."),
-                                          query.lastError().text());
+                                          query->lastError().text());
         return false;
     }
 
-    if (!query.next()) {
+    if (!query->next()) {
         if (errorMessage)
             *errorMessage = QObject::tr("Nie znaleziono rekordu do edycji.");
         return false;
     }
 
-    const QString id = query.value(0).toString();
-    QSqlQuery updateQuery(m_db);
-    updateQuery.prepare(QString("UPDATE %1 SET name = :newName WHERE id = :id").arg(tableName));
-    updateQuery.bindValue(":newName", newName);
-    updateQuery.bindValue(":id", id);
-    if (!updateQuery.exec()) {
+    const QString id = query->value(0).toString();
+    PreparedStatement updateQuery = PreparedStatementCache::instance().prepare(
+        m_db, QString("UPDATE %1 SET name = :newName WHERE id = :id").arg(tableName));
+    updateQuery->bindValue(":newName", newName);
+    updateQuery->bindValue(":id", id);
+    if (!updateQuery->exec()) {
         if (errorMessage)
             *errorMessage = formatDbError(QObject::tr("Nie udało się zmienić nazwy wpisu słownika."),
-                                          updateQuery.lastError().text());
+                                          updateQuery->lastError().text());
         return false;
     }
 
@@ -92,13 +100,13 @@ bool DictionaryRepository::deleteEntry(const QString &tableName,
                                        QString *errorMessage,
                                        const QString &nameColumn)
 {
-    QSqlQuery query(m_db);
-    query.prepare(QString("DELETE FROM %1 WHERE %2 = :name").arg(tableName, nameColumn));
-    query.bindValue(":name", name);
-    if (!query.exec()) {
+    PreparedStatement query = PreparedStatementCache::instance().prepare(
+        m_db, QString("DELETE FROM %1 WHERE %2 = :name").arg(tableName, nameColumn));
+    query->bindValue(":name", name);
+    if (!query->exec()) {
         if (errorMessage)
             *errorMessage = formatDbError(QObject::tr("Nie udało się usunąć wpisu ze słownika."),
-                                          query.lastError().text());
+                                          query->lastError().text());
         return false;
     }
 
@@ -0,0 +1,19 @@
+#include "ItemChangeNotifier.h"
+
+ItemChangeNotifier &ItemChangeNotifier::instance()
+{
+    static ItemChangeNotifier notifier;
+    return notifier;
+}
+
+void ItemChangeNotifier::notifyItemsChanged(const QStringList &itemIds)
+{
+    if (!itemIds.isEmpty())
+        emit itemsChanged(itemIds);
+}
+
+void ItemChangeNotifier::notifyItemsRemoved(const QStringList &itemIds)
+{
+    if (!itemIds.isEmpty())
+        emit itemsRemoved(itemIds);
+}
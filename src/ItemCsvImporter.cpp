@@ -0,0 +1,469 @@
+#include "ItemCsvImporter.h"
+
+#include "DictionaryRepository.h"
+#include "ItemRepository.h"
+#include "ItemSearchIndex.h"
+
+#include <QFile>
+#include <QIODevice>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringConverter>
+#include <QTextStream>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace {
+
+/// Wierszy pliku na jedno wywołanie ItemRepository::saveItems.
+constexpr int kImportBatchSize = 5000;
+/// Tyle bajtów z początku pliku wystarcza do rozpoznania separatora w nagłówku.
+constexpr qint64 kDelimiterSniffBytes = 64 * 1024;
+
+enum ImportField {
+    NameField,
+    TypeField,
+    VendorField,
+    ModelField,
+    StatusField,
+    StorageField,
+    SerialNumberField,
+    PartNumberField,
+    RevisionField,
+    ProductionYearField,
+    DescriptionField,
+    ValueField,
+    PackagingField,
+    FieldCount
+};
+
+/// Słowniki w kolejności rozwiązywania — producent przed modelem (models.vendor_id).
+struct DictionaryTable
+{
+    const char *table;
+    ImportField field;
+};
+constexpr DictionaryTable kDictionaryTables[] = {{"types", TypeField},
+                                                 {"vendors", VendorField},
+                                                 {"models", ModelField},
+                                                 {"statuses", StatusField},
+                                                 {"storage_places", StorageField}};
+constexpr int kModelDictionary = 2;
+
+/// Klucz wpisu w m_dictionaryIds: nazwa bez względu na wielkość liter (w MySQL,
+/// collation *_ci, „atari” i „Atari” to ten sam klucz UNIQUE); model — razem z producentem.
+QString dictionaryKey(int dictionary, const QString &name, const QString &vendorId)
+{
+    const QString folded = name.toCaseFolded();
+    return dictionary == kModelDictionary ? vendorId + QLatin1Char('\n') + folded : folded;
+}
+
+QString formatDbError(const QString &context, const QString &details)
+{
+    return ItemCsvImporter::tr("%1\n%2").arg(context, details);
+}
+
+/// „Rok produkcji” → „rok_produkcji”, „Wartość” → „wartosc”.
+QString normalizeHeader(const QString &header)
+{
+    QString normalized;
+    for (const QChar c : ItemSearchIndex::fold(header.trimmed())) {
+        if (c.isLetterOrNumber())
+            normalized.append(c);
+        else if (!normalized.isEmpty() && !normalized.endsWith(QLatin1Char('_')))
+            normalized.append(QLatin1Char('_'));
+    }
+    while (normalized.endsWith(QLatin1Char('_')))
+        normalized.chop(1);
+    return normalized;
+}
+
+int headerField(const QString &header)
+{
+    static const QHash<QString, int> aliases = {
+        {QStringLiteral("nazwa"), NameField},
+        {QStringLiteral("name"), NameField},
+        {QStringLiteral("typ"), TypeField},
+        {QStringLiteral("type"), TypeField},
+        {QStringLiteral("producent"), VendorField},
+        {QStringLiteral("vendor"), VendorField},
+        {QStringLiteral("model"), ModelField},
+        {QStringLiteral("status"), StatusField},
+        {QStringLiteral("miejsce_przechowywania"), StorageField},
+        {QStringLiteral("miejsce"), StorageField},
+        {QStringLiteral("storage_place"), StorageField},
+        {QStringLiteral("numer_seryjny"), SerialNumberField},
+        {QStringLiteral("nr_seryjny"), SerialNumberField},
+        {QStringLiteral("serial_number"), SerialNumberField},
+        {QStringLiteral("part_number"), PartNumberField},
+        {QStringLiteral("numer_czesci"), PartNumberField},
+        {QStringLiteral("rewizja"), RevisionField},
+        {QStringLiteral("revision"), RevisionField},
+        {QStringLiteral("rok_produkcji"), ProductionYearField},
+        {QStringLiteral("rok"), ProductionYearField},
+        {QStringLiteral("production_year"), ProductionYearField},
+        {QStringLiteral("opis"), DescriptionField},
+        {QStringLiteral("description"), DescriptionField},
+        {QStringLiteral("wartosc"), ValueField},
+        {QStringLiteral("value"), ValueField},
+        {QStringLiteral("oryginalne_opakowanie"), PackagingField},
+        {QStringLiteral("opakowanie"), PackagingField},
+        {QStringLiteral("has_original_packaging"), PackagingField}};
+    return aliases.value(normalizeHeader(header), -1);
+}
+
+/// Separator najczęstszy w pierwszej linii (poza cudzysłowami); domyślnie `;` jak w polskim Excelu.
+QChar detectDelimiter(const QByteArray &head)
+{
+    const QString firstLine = QString::fromUtf8(head.left(head.indexOf('\n')));
+    const QChar candidates[] = {QLatin1Char(';'), QLatin1Char(','), QLatin1Char('\t')};
+    int counts[3] = {};
+    bool inQuotes = false;
+    for (const QChar c : firstLine) {
+        if (c == QLatin1Char('"'))
+            inQuotes = !inQuotes;
+        for (int i = 0; !inQuotes && i < 3; ++i) {
+            if (c == candidates[i])
+                ++counts[i];
+        }
+    }
+    int best = 0;
+    for (int i = 1; i < 3; ++i) {
+        if (counts[i] > counts[best])
+            best = i;
+    }
+    return candidates[best];
+}
+
+/// Rekordy CSV (RFC 4180) czytane linia po linii — pole w cudzysłowach może
+/// obejmować kilka linii, `""` wewnątrz cudzysłowów to jeden cudzysłów.
+class CsvReader
+{
+public:
+    CsvReader(QTextStream *stream, QChar delimiter)
+        : m_stream(stream)
+        , m_delimiter(delimiter)
+    {
+    }
+
+    /// false na końcu pliku; `line` — numer linii, w której zaczyna się rekord.
+    bool readRecord(QStringList *fields, int *line)
+    {
+        fields->clear();
+        QString field;
+        bool inQuotes = false;
+        bool started = false;
+        while (!m_stream->atEnd()) {
+            const QString text = m_stream->readLine();
+            ++m_lineNumber;
+            if (!started) {
+                *line = m_lineNumber;
+                started = true;
+            }
+            for (int i = 0; i < text.size(); ++i) {
+                const QChar c = text[i];
+                if (inQuotes) {
+                    if (c != QLatin1Char('"')) {
+                        field.append(c);
+                    } else if (i + 1 < text.size() && text[i + 1] == QLatin1Char('"')) {
+                        field.append(c);
+                        ++i;
+                    } else {
+                        inQuotes = false;
+                    }
+                } else if (c == QLatin1Char('"')) {
+                    inQuotes = true;
+                } else if (c == m_delimiter) {
+                    fields->append(field);
+                    field.clear();
+                } else {
+                    field.append(c);
+                }
+            }
+            if (!inQuotes)
+                break;
+            field.append(QLatin1Char('\n'));
+        }
+        if (!started)
+            return false;
+        fields->append(field);
+        return true;
+    }
+
+private:
+    QTextStream *m_stream;
+    QChar m_delimiter;
+    int m_lineNumber = 0;
+};
+
+bool parseBool(const QString &text, bool *value)
+{
+    const QString folded = ItemSearchIndex::fold(text.trimmed());
+    static const QStringList yes = {QStringLiteral("1"), QStringLiteral("tak"), QStringLiteral("t"),
+                                    QStringLiteral("true"), QStringLiteral("yes"), QStringLiteral("y"),
+                                    QStringLiteral("x")};
+    static const QStringList no = {QString(), QStringLiteral("0"), QStringLiteral("nie"), QStringLiteral("n"),
+                                   QStringLiteral("false"), QStringLiteral("no")};
+    *value = yes.contains(folded);
+    return *value || no.contains(folded);
+}
+
+}
+
+ItemCsvImporter::ItemCsvImporter(QSqlDatabase database)
+    : m_db(database)
+{
+}
+
+bool ItemCsvImporter::importFile(const QString &filePath,
+                                 ItemImportResult *result,
+                                 QString *errorMessage,
+                                 const std::function<bool(qint64, qint64)> &progressCallback)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorMessage)
+            *errorMessage = ItemCsvImporter::tr("Nie udało się otworzyć pliku %1:\n%2")
+                                .arg(filePath, file.errorString());
+        return false;
+    }
+    return importCsv(&file, result, errorMessage, progressCallback);
+}
+
+bool ItemCsvImporter::importCsv(QIODevice *device,
+                                ItemImportResult *result,
+                                QString *errorMessage,
+                                const std::function<bool(qint64, qint64)> &progressCallback)
+{
+    ItemImportResult localResult;
+    if (!result)
+        result = &localResult;
+    *result = ItemImportResult();
+
+    if (!m_db.isOpen()) {
+        if (errorMessage)
+            *errorMessage = ItemCsvImporter::tr("Połączenie z bazą danych jest zamknięte.");
+        return false;
+    }
+
+    const qint64 totalBytes = device->size();
+    const QChar delimiter = detectDelimiter(device->peek(kDelimiterSniffBytes));
+    QTextStream stream(device);
+    stream.setEncoding(QStringConverter::Utf8);
+    CsvReader reader(&stream, delimiter);
+
+    QStringList header;
+    int line = 0;
+    if (!reader.readRecord(&header, &line)) {
+        if (errorMessage)
+            *errorMessage = ItemCsvImporter::tr("Plik jest pusty.");
+        return false;
+    }
+
+    int columns[FieldCount];
+    std::fill(std::begin(columns), std::end(columns), -1);
+    for (int column = 0; column < header.size(); ++column) {
+        const int field = headerField(header[column]);
+        if (field >= 0 && columns[field] < 0)
+            columns[field] = column;
+    }
+
+    const std::pair<ImportField, QString> requiredFields[] = {
+        {NameField, ItemCsvImporter::tr("Nazwa")},
+        {TypeField, ItemCsvImporter::tr("Typ")},
+        {VendorField, ItemCsvImporter::tr("Producent")},
+        {ModelField, ItemCsvImporter::tr("Model")},
+        {StatusField, ItemCsvImporter::tr("Status")},
+        {StorageField, ItemCsvImporter::tr("Miejsce przechowywania")}};
+    QStringList missingColumns;
+    for (const auto &[field, label] : requiredFields) {
+        if (columns[field] < 0)
+            missingColumns.append(label);
+    }
+    if (!missingColumns.isEmpty()) {
+        if (errorMessage)
+            *errorMessage = ItemCsvImporter::tr("W nagłówku pliku brakuje kolumn: %1.")
+                                .arg(missingColumns.join(QStringLiteral(", ")));
+        return false;
+    }
+
+    if (!loadDictionaries(errorMessage))
+        return false;
+
+    ItemRepository repository(m_db);
+    QList<ItemRecordData> batch;
+    QList<int> batchLines;
+    auto saveBatch = [&]()
+    {
+        QStringList savedItemIds;
+        QList<ItemSaveError> saveErrors;
+        if (!repository.saveItems(batch, &savedItemIds, &saveErrors, errorMessage))
+            return false;
+        result->importedCount += savedItemIds.size();
+        for (const ItemSaveError &error : saveErrors)
+            result->rowErrors.append({batchLines.value(error.index), error.message});
+        batch.clear();
+        batchLines.clear();
+
+        if (progressCallback && !progressCallback(device->pos(), totalBytes)) {
+            if (errorMessage)
+                *errorMessage = ItemCsvImporter::tr("Przerwano import po %1 rekordach.").arg(result->importedCount);
+            return false;
+        }
+        return true;
+    };
+
+    QStringList fields;
+    while (reader.readRecord(&fields, &line)) {
+        if (fields.join(QString()).trimmed().isEmpty())
+            continue;
+
+        auto value = [&fields, &columns](ImportField field)
+        { return columns[field] >= 0 ? fields.value(columns[field]).trimmed() : QString(); };
+        auto rowError = [result, line](const QString &message)
+        { result->rowErrors.append({line, message}); };
+
+        ItemRecordData item;
+        item.name = value(NameField);
+        if (item.name.isEmpty()) {
+            rowError(ItemCsvImporter::tr("Brak nazwy eksponatu."));
+            continue;
+        }
+        if (item.name.size() > ItemRecordData::kMaxNameLength) {
+            rowError(ItemCsvImporter::tr("Nazwa eksponatu jest dłuższa niż %1 znaków.")
+                         .arg(ItemRecordData::kMaxNameLength));
+            continue;
+        }
+        item.serialNumber = value(SerialNumberField);
+        item.partNumber = value(PartNumberField);
+        item.revision = value(RevisionField);
+        item.description = columns[DescriptionField] >= 0 ? fields.value(columns[DescriptionField]) : QString();
+
+        bool ok = false;
+        const QString productionYear = value(ProductionYearField);
+        if (!productionYear.isEmpty()) {
+            item.productionYear = productionYear.toInt(&ok);
+            if (!ok) {
+                rowError(ItemCsvImporter::tr("Nieprawidłowy rok produkcji: %1").arg(productionYear));
+                continue;
+            }
+        }
+        QString itemValue = value(ValueField);
+        itemValue.remove(QLatin1Char(' ')).replace(QLatin1Char(','), QLatin1Char('.'));
+        if (!itemValue.isEmpty()) {
+            item.value = qRound(itemValue.toDouble(&ok));
+            if (!ok) {
+                rowError(ItemCsvImporter::tr("Nieprawidłowa wartość: %1").arg(value(ValueField)));
+                continue;
+            }
+        }
+        if (!parseBool(value(PackagingField), &item.hasOriginalPackaging)) {
+            rowError(ItemCsvImporter::tr("Nieprawidłowa wartość „oryginalne opakowanie”: %1")
+                         .arg(value(PackagingField)));
+            continue;
+        }
+
+        QString *dictionaryIds[] = {&item.typeId, &item.vendorId, &item.modelId, &item.statusId,
+                                    &item.storagePlaceId};
+        bool dictionariesOk = true;
+        for (int dictionary = 0; dictionary < 5 && dictionariesOk; ++dictionary) {
+            const int column = columns[kDictionaryTables[dictionary].field];
+            const QString name = value(kDictionaryTables[dictionary].field);
+            if (name.isEmpty()) {
+                rowError(ItemCsvImporter::tr("Brak wartości w kolumnie „%1”.").arg(header.value(column)));
+                dictionariesOk = false;
+                break;
+            }
+            // models.name jest UNIQUE — model innego producenta nie powstanie drugi raz.
+            if (dictionary == kModelDictionary) {
+                const QString modelVendorId = m_modelVendorIds.value(name.toCaseFolded());
+                if (!modelVendorId.isEmpty() && modelVendorId != item.vendorId) {
+                    rowError(ItemCsvImporter::tr("Model „%1” należy do innego producenta.").arg(name));
+                    dictionariesOk = false;
+                    break;
+                }
+            }
+            if (!resolveDictionaryId(dictionary, name, item.vendorId, dictionaryIds[dictionary], result,
+                                     errorMessage))
+                return false;
+        }
+        if (!dictionariesOk)
+            continue;
+
+        batch.append(item);
+        batchLines.append(line);
+        if (batch.size() >= kImportBatchSize && !saveBatch())
+            return false;
+    }
+
+    if (!batch.isEmpty() && !saveBatch())
+        return false;
+
+    if (errorMessage)
+        errorMessage->clear();
+    return true;
+}
+
+bool ItemCsvImporter::loadDictionaries(QString *errorMessage)
+{
+    for (int dictionary = 0; dictionary < 5; ++dictionary) {
+        QHash<QString, QString> &ids = m_dictionaryIds[dictionary];
+        ids.clear();
+        const bool isModel = dictionary == kModelDictionary;
+        if (isModel)
+            m_modelVendorIds.clear();
+
+        QSqlQuery query(m_db);
+        if (!query.exec(QStringLiteral("SELECT id, name, %1 FROM %2")
+                            .arg(isModel ? QStringLiteral("vendor_id") : QStringLiteral("NULL"),
+                                 QLatin1String(kDictionaryTables[dictionary].table)))) {
+            if (errorMessage)
+                *errorMessage = formatDbError(ItemCsvImporter::tr("Nie udało się wczytać słowników."),
+                                              query.lastError().text());
+            return false;
+        }
+        while (query.next()) {
+            const QString name = query.value(1).toString();
+            const QString key = dictionaryKey(dictionary, name, query.value(2).toString());
+            if (!ids.contains(key))
+                ids.insert(key, query.value(0).toString());
+            if (isModel)
+                m_modelVendorIds.insert(name.toCaseFolded(), query.value(2).toString());
+        }
+    }
+    return true;
+}
+
+bool ItemCsvImporter::resolveDictionaryId(int dictionary,
+                                          const QString &name,
+                                          const QString &vendorId,
+                                          QString *id,
+                                          ItemImportResult *result,
+                                          QString *errorMessage)
+{
+    QHash<QString, QString> &ids = m_dictionaryIds[dictionary];
+    const QString key = dictionaryKey(dictionary, name, vendorId);
+    const auto it = ids.constFind(key);
+    if (it != ids.constEnd()) {
+        *id = it.value();
+        return true;
+    }
+
+    const bool isModel = dictionary == kModelDictionary;
+    DictionaryRepository repository(m_db);
+    if (!repository.addEntry(QLatin1String(kDictionaryTables[dictionary].table),
+                             name,
+                             errorMessage,
+                             isModel ? QStringLiteral("vendor_id") : QString(),
+                             isModel ? vendorId : QString(),
+                             id))
+        return false;
+
+    ids.insert(key, *id);
+    if (isModel)
+        m_modelVendorIds.insert(name.toCaseFolded(), vendorId);
+    ++result->createdDictionaryEntries;
+    return true;
+}
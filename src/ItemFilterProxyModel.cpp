@@ -31,7 +31,9 @@
  */
 
 #include "ItemFilterProxyModel.h"
+#include "ItemTableModel.h"
 #include <QModelIndex>
+
 namespace {
 
 constexpr int kNameColumn = 1;
@@ -85,6 +87,7 @@ ItemFilterProxyModel::ItemFilterProxyModel(QObject *parent)
 void ItemFilterProxyModel::setTypeFilter(const QString &type)
 {
     m_type = type;
+    updateRowFilter();
     invalidateFilter(); // odświeżenie widoku
 }
 
@@ -99,6 +102,7 @@ void ItemFilterProxyModel::setTypeFilter(const QString &type)
 void ItemFilterProxyModel::setVendorFilter(const QString &vendor)
 {
     m_vendor = vendor;
+    updateRowFilter();
     invalidateFilter();
 }
 
@@ -113,6 +117,7 @@ void ItemFilterProxyModel::setVendorFilter(const QString &vendor)
 void ItemFilterProxyModel::setModelFilter(const QString &model)
 {
     m_model = model;
+    updateRowFilter();
     invalidateFilter();
 }
 
@@ -127,6 +132,7 @@ void ItemFilterProxyModel::setModelFilter(const QString &model)
 void ItemFilterProxyModel::setStatusFilter(const QString &status)
 {
     m_status = status;
+    updateRowFilter();
     invalidateFilter();
 }
 
@@ -141,6 +147,7 @@ void ItemFilterProxyModel::setStatusFilter(const QString &status)
 void ItemFilterProxyModel::setStorageFilter(const QString &storage)
 {
     m_storage = storage;
+    updateRowFilter();
     invalidateFilter();
 }
 
@@ -155,38 +162,107 @@ void ItemFilterProxyModel::setStorageFilter(const QString &storage)
 void ItemFilterProxyModel::setNameFilter(const QString &filter)
 {
     qDebug() << "ItemFilterProxyModel: Ustawiam nameFilter:" << filter;
+    const bool wasFullText = m_fullTextActive;
     m_nameFilter = filter;
+    m_fullTextActive = false;
+    m_fullTextRanks.clear();
+    updateRowFilter();
     invalidateFilter();
+    if (wasFullText)
+        QSortFilterProxyModel::sort(-1);
+}
+
+ItemFilterState ItemFilterProxyModel::filterState() const
+{
+    ItemFilterState state;
+    state.dictionaryNames = {m_type, m_vendor, m_model, m_status, m_storage};
+    state.searchText = m_nameFilter;
+    state.originalPackagingOnly = m_originalPackagingFilterEnabled;
+    state.withoutDescriptionOnly = m_withoutDescriptionOnly;
+    state.withoutSerialNumberOnly = m_withoutSerialNumberOnly;
+    state.withoutModelOnly = m_withoutModelOnly;
+    state.withoutVendorOnly = m_withoutVendorOnly;
+    return state;
+}
+
+void ItemFilterProxyModel::setFilterState(const ItemFilterState &state)
+{
+    applyFilterState(state, nullptr, QBitArray(), 0);
+}
+
+void ItemFilterProxyModel::applyFilterState(const ItemFilterState &state,
+                                            const ItemRowFilter::FullTextRanks *fullTextRanks,
+                                            const QBitArray &acceptedRows,
+                                            quint64 revision)
+{
+    const bool wasFullText = m_fullTextActive;
+    m_type = state.dictionaryNames[0];
+    m_vendor = state.dictionaryNames[1];
+    m_model = state.dictionaryNames[2];
+    m_status = state.dictionaryNames[3];
+    m_storage = state.dictionaryNames[4];
+    m_nameFilter = state.searchText;
+    m_showOriginalPackaging = state.originalPackagingOnly;
+    m_originalPackagingFilterEnabled = state.originalPackagingOnly;
+    m_withoutDescriptionOnly = state.withoutDescriptionOnly;
+    m_withoutSerialNumberOnly = state.withoutSerialNumberOnly;
+    m_withoutModelOnly = state.withoutModelOnly;
+    m_withoutVendorOnly = state.withoutVendorOnly;
+    m_fullTextActive = fullTextRanks != nullptr;
+    m_fullTextRanks = fullTextRanks ? *fullTextRanks : ItemRowFilter::FullTextRanks();
+    updateRowFilter();
+    if (m_itemModel && revision == m_itemModel->revision()) {
+        m_acceptedRows = acceptedRows;
+        m_acceptedRowsRevision = revision;
+    }
+
+    invalidateFilter();
+    if (m_fullTextActive)
+        QSortFilterProxyModel::sort(0);
+    else if (wasFullText)
+        QSortFilterProxyModel::sort(-1);
+}
+
+void ItemFilterProxyModel::updateRowFilter()
+{
+    m_acceptedRows.clear();
+    if (m_itemModel)
+        m_rowFilter.reset(m_itemModel, filterState(), m_fullTextActive ? &m_fullTextRanks : nullptr);
 }
 
 void ItemFilterProxyModel::setOriginalPackagingFilter(bool show)
 {
     m_showOriginalPackaging = show;
     m_originalPackagingFilterEnabled = show; // Filtr jest aktywny tylko gdy checkbox jest zaznaczony
+    updateRowFilter();
     invalidateFilter();
 }
 
 void ItemFilterProxyModel::setWithoutDescriptionFilter(bool show)
 {
     m_withoutDescriptionOnly = show;
+    updateRowFilter();
     invalidateFilter();
 }
 
 void ItemFilterProxyModel::setWithoutSerialNumberFilter(bool show)
 {
     m_withoutSerialNumberOnly = show;
+    updateRowFilter();
     invalidateFilter();
 }
 
 void ItemFilterProxyModel::setWithoutModelFilter(bool show)
 {
     m_withoutModelOnly = show;
+    updateRowFilter();
     invalidateFilter();
 }
 
 void ItemFilterProxyModel::setWithoutVendorFilter(bool show)
 {
     m_withoutVendorOnly = show;
+    updateRowFilter();
     invalidateFilter();
 }
 
@@ -204,6 +280,13 @@ void ItemFilterProxyModel::setWithoutVendorFilter(bool show)
  */
 bool ItemFilterProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
 {
+    if (m_itemModel) {
+        // Wynik policzony w tle (applyFilterState) — tylko dla tej samej wersji modelu.
+        if (sourceRow < m_acceptedRows.size() && m_acceptedRowsRevision == m_itemModel->revision())
+            return m_acceptedRows.testBit(sourceRow);
+        return m_rowFilter.acceptsRow(sourceRow);
+    }
+
     QModelIndex typeIndex = sourceModel()->index(sourceRow, kTypeColumn, sourceParent);
     QModelIndex vendorIndex = sourceModel()->index(sourceRow, kVendorColumn, sourceParent);
     QModelIndex modelIndex = sourceModel()->index(sourceRow, kModelColumn, sourceParent);
@@ -268,3 +351,58 @@ bool ItemFilterProxyModel::matchesSearchText(int sourceRow, const QModelIndex &s
 
     return false;
 }
+
+void ItemFilterProxyModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    disconnect(m_itemModelResetConnection);
+    disconnect(m_itemModelDictionaryConnection);
+    m_itemModel = qobject_cast<const ItemTableModel *>(sourceModel);
+    m_rowFilter = ItemRowFilter();
+    updateRowFilter();
+    // Połączenie przed QSortFilterProxyModel::setSourceModel — nameId muszą być
+    // przeliczone, zanim proxy po resecie modelu przefiltruje wiersze od nowa.
+    if (m_itemModel) {
+        m_itemModelResetConnection = connect(m_itemModel, &QAbstractItemModel::modelReset, this,
+                                             [this]() { m_rowFilter.resolve(); });
+        // Nazwa, której dotąd nie było, mogła właśnie dojść do słownika.
+        m_itemModelDictionaryConnection = connect(m_itemModel, &ItemTableModel::dictionaryNamesAdded, this,
+                                                  [this]()
+                                                  {
+            m_rowFilter.resolve();
+            invalidateFilter(); });
+    }
+    QSortFilterProxyModel::setSourceModel(sourceModel);
+}
+
+ItemFilterProxyModel::FacetCounts ItemFilterProxyModel::facetCounts() const
+{
+    FacetCounts facets;
+    m_rowFilter.facetCounts(&facets);
+    return facets;
+}
+
+void ItemFilterProxyModel::sort(int column, Qt::SortOrder order)
+{
+    if (!m_itemModel) {
+        QSortFilterProxyModel::sort(column, order);
+        return;
+    }
+
+    // Sortuje ItemTableModel (rangi zamiast porównań tekstów z data()); proxy
+    // zachowuje kolejność źródła albo — przy wyniku pełnotekstowym — trafności.
+    sourceModel()->sort(column, order);
+    QSortFilterProxyModel::sort(m_fullTextActive ? 0 : -1);
+}
+
+bool ItemFilterProxyModel::lessThan(const QModelIndex &sourceLeft, const QModelIndex &sourceRight) const
+{
+    if (!m_fullTextActive || !m_itemModel)
+        return QSortFilterProxyModel::lessThan(sourceLeft, sourceRight);
+
+    // Trafienia tylko po producencie/modelu — za wynikami z indeksu, w kolejności modelu.
+    const int leftRank = m_rowFilter.fullTextRank(m_itemModel->itemId(sourceLeft.row()));
+    const int rightRank = m_rowFilter.fullTextRank(m_itemModel->itemId(sourceRight.row()));
+    if (leftRank != rightRank)
+        return leftRank < rightRank;
+    return sourceLeft.row() < sourceRight.row();
+}
@@ -0,0 +1,127 @@
+#include "ItemFilterScheduler.h"
+
+#include "ItemTableModel.h"
+
+#include <QMetaObject>
+#include <QTimer>
+
+#include <memory>
+
+ItemFilterScheduler::ItemFilterScheduler(ItemTableModel *model, ItemFilterProxyModel *proxyModel, QObject *parent)
+    : QObject(parent)
+    , m_model(model)
+    , m_proxyModel(proxyModel)
+    , m_timer(new QTimer(this))
+{
+    m_pool.setMaxThreadCount(1);
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &ItemFilterScheduler::start);
+    m_pendingState = proxyModel->filterState();
+}
+
+ItemFilterScheduler::~ItemFilterScheduler()
+{
+    // Zadanie w puli odwołuje się do tego obiektu — musi się skończyć przed nim.
+    ++m_generation;
+    m_pool.waitForDone();
+}
+
+void ItemFilterScheduler::schedule(const ItemFilterState &state, int delayMs)
+{
+    m_pendingState = state;
+    m_timer->start(qMax(0, delayMs));
+}
+
+bool ItemFilterScheduler::isBusy() const
+{
+    return m_timer->isActive() || m_running;
+}
+
+bool ItemFilterScheduler::prepare(const ItemFilterState &state, ItemRowFilter::FullTextRanks *fullTextRanks)
+{
+    emit aboutToFilter(state);
+
+    fullTextRanks->clear();
+    if (!m_fullTextSearch || state.searchText.trimmed().isEmpty())
+        return false;
+    QStringList rankedItemIds;
+    if (!m_fullTextSearch(state.searchText, &rankedItemIds))
+        return false;
+    fullTextRanks->reserve(rankedItemIds.size());
+    for (int rank = 0; rank < rankedItemIds.size(); ++rank)
+        fullTextRanks->insert(rankedItemIds[rank], rank);
+    return true;
+}
+
+void ItemFilterScheduler::flush()
+{
+    m_timer->stop();
+    ++m_generation;
+    m_running = false;
+
+    const ItemFilterState state = m_pendingState;
+    ItemRowFilter::FullTextRanks fullTextRanks;
+    const bool fullText = prepare(state, &fullTextRanks);
+    m_proxyModel->applyFilterState(state, fullText ? &fullTextRanks : nullptr, QBitArray(), 0);
+    m_hasApplied = true;
+    m_appliedState = state;
+    m_appliedRevision = m_model->revision();
+    emit filtered(state, m_proxyModel->facetCounts());
+}
+
+void ItemFilterScheduler::start()
+{
+    // Przerywa liczenie starszego stanu — także wtedy, gdy wracamy do już zastosowanego.
+    const quint64 generation = ++m_generation;
+    m_running = false;
+
+    const ItemFilterState state = m_pendingState;
+    if (m_hasApplied && state == m_appliedState && m_model->revision() == m_appliedRevision)
+        return;
+
+    ItemRowFilter::FullTextRanks fullTextRanks;
+    const bool fullText = prepare(state, &fullTextRanks);
+    std::shared_ptr<const ItemTableModel> snapshot = m_model->createSnapshot();
+
+    m_running = true;
+    m_pool.start([this, generation, state, fullText, fullTextRanks, snapshot]() mutable
+                 {
+        const auto cancelled = [this, generation]() { return m_generation.load() != generation; };
+        ItemRowFilter filter;
+        filter.reset(snapshot.get(), state, fullText ? &fullTextRanks : nullptr);
+        QBitArray acceptedRows;
+        ItemFilterProxyModel::FacetCounts facets;
+        if (!filter.acceptedRows(&acceptedRows, cancelled) || !filter.facetCounts(&facets, cancelled))
+            return;
+
+        const quint64 revision = snapshot->revision();
+        snapshot.reset();
+        QMetaObject::invokeMethod(this,
+                                  [this, generation, state, fullText, fullTextRanks, acceptedRows, facets,
+                                   revision]()
+                                  { finish(generation, state, fullText, fullTextRanks, acceptedRows, facets, revision); },
+                                  Qt::QueuedConnection); });
+}
+
+void ItemFilterScheduler::finish(quint64 generation, const ItemFilterState &state, bool fullText,
+                                 const ItemRowFilter::FullTextRanks &fullTextRanks,
+                                 const QBitArray &acceptedRows,
+                                 const ItemFilterProxyModel::FacetCounts &facets,
+                                 quint64 revision)
+{
+    if (generation != m_generation.load())
+        return;
+    m_running = false;
+
+    // Model zmienił się w trakcie liczenia — bity dotyczą innych wierszy.
+    if (revision != m_model->revision()) {
+        m_timer->start(0);
+        return;
+    }
+
+    m_proxyModel->applyFilterState(state, fullText ? &fullTextRanks : nullptr, acceptedRows, revision);
+    m_hasApplied = true;
+    m_appliedState = state;
+    m_appliedRevision = revision;
+    emit filtered(state, facets);
+}
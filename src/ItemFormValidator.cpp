@@ -1,5 +1,8 @@
 #include "ItemFormValidator.h"
 
+#include "ItemRepository.h"
+#include "PreparedStatementCache.h"
+
 #include <QSqlError>
 #include <QSqlQuery>
 
@@ -24,12 +27,18 @@ ItemValidationResult ItemValidationResult::error(const QString &title,
 
 ItemValidationResult ItemFormValidator::validateName(const QString &name)
 {
-    if (!name.trimmed().isEmpty())
-        return ItemValidationResult::ok();
+    if (name.trimmed().isEmpty())
+        return ItemValidationResult::error(QObject::tr("Brak danych"),
+                                           QObject::tr("Nazwa eksponatu jest wymagana."),
+                                           ItemValidationField::Name);
 
-    return ItemValidationResult::error(QObject::tr("Brak danych"),
-                                       QObject::tr("Nazwa eksponatu jest wymagana."),
-                                       ItemValidationField::Name);
+    if (name.size() > ItemRecordData::kMaxNameLength)
+        return ItemValidationResult::error(QObject::tr("Błędna wartość"),
+                                           QObject::tr("Nazwa eksponatu może mieć najwyżej %1 znaków.")
+                                               .arg(ItemRecordData::kMaxNameLength),
+                                           ItemValidationField::Name);
+
+    return ItemValidationResult::ok();
 }
 
 ItemValidationResult ItemFormValidator::validateSelection(const QString &selectedId,
@@ -65,19 +74,19 @@ ItemValidationResult ItemFormValidator::validateModelVendorConsistency(QSqlDatab
                                                                        const QString &vendorId,
                                                                        const QString &modelId)
 {
-    QSqlQuery query(db);
-    query.prepare(QStringLiteral("SELECT 1 FROM models WHERE id = :model_id AND vendor_id = :vendor_id"));
-    query.bindValue(QStringLiteral(":model_id"), modelId);
-    query.bindValue(QStringLiteral(":vendor_id"), vendorId);
+    PreparedStatement query = PreparedStatementCache::instance().prepare(
+        db, QStringLiteral("SELECT 1 FROM models WHERE id = :model_id AND vendor_id = :vendor_id"));
+    query->bindValue(QStringLiteral(":model_id"), modelId);
+    query->bindValue(QStringLiteral(":vendor_id"), vendorId);
 
-    if (!query.exec()) {
+    if (!query->exec()) {
         return ItemValidationResult::error(QObject::tr("Błąd walidacji"),
                                            QObject::tr("Nie udało się sprawdzić zgodności modelu i producenta:\n%1")
-                                               .arg(query.lastError().text()),
+                                               .arg(query->lastError().text()),
                                            ItemValidationField::Database);
     }
 
-    if (query.next())
+    if (query->next())
         return ItemValidationResult::ok();
 
     return ItemValidationResult::error(QObject::tr("Niespójne dane"),
@@ -0,0 +1,131 @@
+#include "ItemQueryBuilder.h"
+
+#include <utility>
+
+namespace {
+
+/// Kolumny eksponaty w kolejności ItemTableModel::Dictionary.
+constexpr const char *kDictionaryColumns[ItemTableModel::DictionaryCount] = {
+    "type_id",
+    "vendor_id",
+    "model_id",
+    "status_id",
+    "storage_place_id",
+};
+
+}
+
+void ItemQueryBuilder::restrictDictionary(ItemTableModel::Dictionary dictionary, const QStringList &uuids)
+{
+    addDictionaryCondition(dictionary, uuids, dictionary);
+}
+
+void ItemQueryBuilder::restrictToPlaceholders(ItemTableModel::Dictionary dictionary,
+                                              const QStringList &placeholderUuids)
+{
+    addDictionaryCondition(dictionary, placeholderUuids, -1);
+}
+
+void ItemQueryBuilder::addDictionaryCondition(ItemTableModel::Dictionary dictionary,
+                                              const QStringList &uuids,
+                                              int owner)
+{
+    Condition condition;
+    condition.dictionary = owner;
+    if (uuids.isEmpty()) {
+        condition.sql = QStringLiteral("1 = 0");
+        m_conditions.append(condition);
+        return;
+    }
+
+    QStringList placeholders;
+    for (const QString &uuid : uuids) {
+        placeholders.append(QStringLiteral("?"));
+        condition.bindValues.append(uuid);
+    }
+    condition.sql = QStringLiteral("%1 IN (%2)")
+                        .arg(QLatin1String(kDictionaryColumns[dictionary]), placeholders.join(QLatin1Char(',')));
+    m_conditions.append(condition);
+}
+
+void ItemQueryBuilder::setOriginalPackagingOnly(bool enabled)
+{
+    if (enabled)
+        m_conditions.append({QStringLiteral("COALESCE(has_original_packaging, 0) = 1"), {}, -1});
+}
+
+void ItemQueryBuilder::setWithoutDescriptionOnly(bool enabled)
+{
+    if (enabled)
+        m_conditions.append({QStringLiteral("(description IS NULL OR TRIM(description) = '')"), {}, -1});
+}
+
+void ItemQueryBuilder::setWithoutSerialNumberOnly(bool enabled)
+{
+    if (enabled)
+        m_conditions.append({QStringLiteral("(serial_number IS NULL OR TRIM(serial_number) = '')"), {}, -1});
+}
+
+void ItemQueryBuilder::setSearchText(const QString &text)
+{
+    const QString trimmed = text.trimmed();
+    if (trimmed.isEmpty())
+        return;
+
+    // '!' jako znak ucieczki — ukośnik wsteczny w literale SQL znaczy co innego w SQLite i MySQL.
+    QString escaped = trimmed;
+    escaped.replace(QLatin1Char('!'), QStringLiteral("!!"))
+        .replace(QLatin1Char('%'), QStringLiteral("!%"))
+        .replace(QLatin1Char('_'), QStringLiteral("!_"));
+    const QString pattern = QLatin1Char('%') + escaped + QLatin1Char('%');
+
+    Condition condition;
+    QStringList alternatives;
+    for (const char *column : {"name", "serial_number", "part_number", "description"}) {
+        alternatives.append(QStringLiteral("%1 LIKE ? ESCAPE '!'").arg(QLatin1String(column)));
+        condition.bindValues.append(pattern);
+    }
+    const std::pair<ItemTableModel::Dictionary, const char *> dictionaries[] = {
+        {ItemTableModel::VendorDictionary, "vendors"},
+        {ItemTableModel::ModelDictionary, "models"}};
+    for (const auto &[dictionary, table] : dictionaries) {
+        alternatives.append(QStringLiteral("%1 IN (SELECT id FROM %2 WHERE name LIKE ? ESCAPE '!')")
+                                .arg(QLatin1String(kDictionaryColumns[dictionary]), QLatin1String(table)));
+        condition.bindValues.append(pattern);
+    }
+    condition.sql = QLatin1Char('(') + alternatives.join(QStringLiteral(" OR ")) + QLatin1Char(')');
+    m_conditions.append(condition);
+}
+
+QString ItemQueryBuilder::whereSql() const
+{
+    QVariantList bindValues;
+    return joinConditions(-1, &bindValues);
+}
+
+QVariantList ItemQueryBuilder::bindValues() const
+{
+    QVariantList bindValues;
+    joinConditions(-1, &bindValues);
+    return bindValues;
+}
+
+QString ItemQueryBuilder::facetCountSql(ItemTableModel::Dictionary dictionary, QVariantList *bindValues) const
+{
+    const QLatin1String column(kDictionaryColumns[dictionary]);
+    const QString where = joinConditions(dictionary, bindValues);
+    return QStringLiteral("SELECT %1, COUNT(*) FROM eksponaty%2 GROUP BY %1")
+        .arg(column, where.isEmpty() ? QString() : QStringLiteral(" WHERE ") + where);
+}
+
+QString ItemQueryBuilder::joinConditions(int skippedDictionary, QVariantList *bindValues) const
+{
+    QStringList conditions;
+    for (const Condition &condition : m_conditions) {
+        if (skippedDictionary >= 0 && condition.dictionary == skippedDictionary)
+            continue;
+        conditions.append(condition.sql);
+        bindValues->append(condition.bindValues);
+    }
+    return conditions.join(QStringLiteral(" AND "));
+}
@@ -1,16 +1,64 @@
 #include "ItemRepository.h"
 
+#include "ItemChangeNotifier.h"
+#include "PhotoCache.h"
+#include "PhotoService.h"
+#include "PreparedStatementCache.h"
+
 #include <QSqlError>
 #include <QSqlQuery>
 #include <QUuid>
+#include <QVariant>
 
 namespace {
 
+/// v1.5: tyle ID w jednym UPDATE ... WHERE id IN (...) — razem z wartością kolumny
+/// mieści się w limicie 999 parametrów SQLite; MySQL dostaje ~10x mniej zapytań na 5000 rekordów.
+constexpr int kBulkUpdateChunkSize = 500;
+
+/// v1.5 (import): rekordów w jednym INSERT — 64 × 14 kolumn mieści się w limicie
+/// 999 parametrów SQLite i w domyślnym max_allowed_packet MySQL.
+constexpr int kBulkInsertRowsPerStatement = 64;
+/// Rekordów w jednej transakcji saveItems — rzadkie COMMIT-y, ale ograniczony rollback.
+constexpr int kBulkInsertTransactionSize = 5000;
+
+constexpr int kItemInsertColumnCount = 14;
+
 QString formatDbError(const QString &context, const QString &details)
 {
     return ItemRepository::tr("%1\n%2").arg(context, details);
 }
 
+/// INSERT INTO eksponaty dla `rowCount` rekordów, parametry pozycyjne (bindItemRow).
+QString itemInsertSql(int rowCount)
+{
+    QString rowPlaceholders = QStringLiteral("(?");
+    for (int column = 1; column < kItemInsertColumnCount; ++column)
+        rowPlaceholders.append(QStringLiteral(", ?"));
+    rowPlaceholders.append(QLatin1Char(')'));
+
+    QStringList rows;
+    rows.reserve(rowCount);
+    for (int row = 0; row < rowCount; ++row)
+        rows.append(rowPlaceholders);
+    return QStringLiteral("INSERT INTO eksponaty "
+                          "(id, name, serial_number, part_number, revision, production_year, "
+                          "status_id, type_id, vendor_id, model_id, storage_place_id, "
+                          "description, value, has_original_packaging) VALUES %1")
+        .arg(rows.join(QStringLiteral(", ")));
+}
+
+/// Parametry rekordu od pozycji `row` × kItemInsertColumnCount w zapytaniu z itemInsertSql.
+void bindItemRow(QSqlQuery &query, int row, const QString &itemId, const ItemRecordData &item)
+{
+    const QVariant values[kItemInsertColumnCount] = {
+        itemId, item.name, item.serialNumber, item.partNumber, item.revision, item.productionYear,
+        item.statusId, item.typeId, item.vendorId, item.modelId, item.storagePlaceId,
+        item.description, item.value, item.hasOriginalPackaging};
+    for (int column = 0; column < kItemInsertColumnCount; ++column)
+        query.bindValue(row * kItemInsertColumnCount + column, values[column]);
+}
+
 }
 
 ItemRepository::ItemRepository(QSqlDatabase database)
@@ -22,6 +70,21 @@ bool ItemRepository::saveItem(const ItemRecordData &item,
                               const QList<QByteArray> &newPhotos,
                               QString *savedItemId,
                               QString *errorMessage)
+{
+    QList<IngestedPhoto> photos;
+    photos.reserve(newPhotos.size());
+    for (const QByteArray &photoData : newPhotos) {
+        IngestedPhoto photo;
+        photo.data = photoData;
+        photos.append(photo);
+    }
+    return saveItemWithIngestedPhotos(item, photos, savedItemId, errorMessage);
+}
+
+bool ItemRepository::saveItemWithIngestedPhotos(const ItemRecordData &item,
+                                                const QList<IngestedPhoto> &newPhotos,
+                                                QString *savedItemId,
+                                                QString *errorMessage)
 {
     if (!m_db.isOpen()) {
         if (errorMessage)
@@ -40,9 +103,9 @@ bool ItemRepository::saveItem(const ItemRecordData &item,
         return false;
     }
 
-    QSqlQuery query(m_db);
+    QString sql;
     if (!item.editMode) {
-        query.prepare(R"(
+        sql = R"(
             INSERT INTO eksponaty
             (id, name, serial_number, part_number, revision, production_year,
              status_id, type_id, vendor_id, model_id, storage_place_id,
@@ -51,9 +114,9 @@ bool ItemRepository::saveItem(const ItemRecordData &item,
             (:id, :name, :serial_number, :part_number, :revision, :production_year,
              :status_id, :type_id, :vendor_id, :model_id, :storage_place_id,
              :description, :value, :has_original_packaging)
-        )");
+        )";
     } else {
-        query.prepare(R"(
+        sql = R"(
             UPDATE eksponaty
             SET name=:name,
                 serial_number=:serial_number,
@@ -69,31 +132,33 @@ bool ItemRepository::saveItem(const ItemRecordData &item,
                 value=:value,
                 has_original_packaging=:has_original_packaging
             WHERE id=:id
-        )");
+        )";
     }
 
-    query.bindValue(":id", itemId);
-    query.bindValue(":name", item.name);
-    query.bindValue(":serial_number", item.serialNumber);
-    query.bindValue(":part_number", item.partNumber);
-    query.bindValue(":revision", item.revision);
-    query.bindValue(":production_year", item.productionYear);
-    query.bindValue(":status_id", item.statusId);
-    query.bindValue(":type_id", item.typeId);
-    query.bindValue(":vendor_id", item.vendorId);
-    query.bindValue(":model_id", item.modelId);
-    query.bindValue(":storage_place_id", item.storagePlaceId);
-    query.bindValue(":description", item.description);
-    query.bindValue(":value", item.value);
-    query.bindValue(":has_original_packaging", item.hasOriginalPackaging);
-
-    if (!query.exec()) {
+    PreparedStatement query = PreparedStatementCache::instance().prepare(m_db, sql);
+
+    query->bindValue(":id", itemId);
+    query->bindValue(":name", item.name);
+    query->bindValue(":serial_number", item.serialNumber);
+    query->bindValue(":part_number", item.partNumber);
+    query->bindValue(":revision", item.revision);
+    query->bindValue(":production_year", item.productionYear);
+    query->bindValue(":status_id", item.statusId);
+    query->bindValue(":type_id", item.typeId);
+    query->bindValue(":vendor_id", item.vendorId);
+    query->bindValue(":model_id", item.modelId);
+    query->bindValue(":storage_place_id", item.storagePlaceId);
+    query->bindValue(":description", item.description);
+    query->bindValue(":value", item.value);
+    query->bindValue(":has_original_packaging", item.hasOriginalPackaging);
+
+    if (!query->exec()) {
         m_db.rollback();
         if (errorMessage)
             *errorMessage = formatDbError(item.editMode
                                               ? ItemRepository::tr("Nie udało się zaktualizować eksponatu.")
                                               : ItemRepository::tr("Nie udało się dodać eksponatu."),
-                                          query.lastError().text());
+                                          query->lastError().text());
         return false;
     }
 
@@ -102,24 +167,18 @@ bool ItemRepository::saveItem(const ItemRecordData &item,
     // BEZPOSREDNIO INSERT do photos w momencie dodania w UI (mainwindow.cpp:973-1015).
     // saveItem w editMode zapisuje tylko meta-fields. newPhotos zawsze pusty
     // gdy editMode=true (m_photoBuffer w MainWindow nie jest wtedy uzywany).
-    if (!item.editMode) {
-        for (const QByteArray &photoData : newPhotos) {
-            QSqlQuery photoQuery(m_db);
-            photoQuery.prepare(R"(
-                INSERT INTO photos (id, eksponat_id, photo)
-                VALUES (:id, :itemId, :photo)
-            )");
-            photoQuery.bindValue(":id", QUuid::createUuid().toString(QUuid::WithoutBraces));
-            photoQuery.bindValue(":itemId", itemId);
-            photoQuery.bindValue(":photo", photoData);
-
-            if (!photoQuery.exec()) {
-                m_db.rollback();
-                if (errorMessage)
-                    *errorMessage = formatDbError(ItemRepository::tr("Nie udało się zapisać zdjęcia eksponatu."),
-                                                  photoQuery.lastError().text());
-                return false;
-            }
+    // v1.5: PhotoService::insertPhoto zapisuje oryginał razem z miniaturami
+    // (photo_thumbnails) w tej samej transakcji — lista nie dekoduje już BLOB-ów.
+    // Powtórzone zdjęcie (ten sam SHA-256) nie jest wysyłane drugi raz — patrz photo_blobs.
+    // Wszystkie zdjęcia naraz — wielowierszowe INSERT-y zamiast zapytań na zdjęcie.
+    if (!item.editMode && !newPhotos.isEmpty()) {
+        const PhotoService photoService(m_db);
+        QString photoError;
+        if (!photoService.insertPhotos(itemId, newPhotos, nullptr, &photoError)) {
+            m_db.rollback();
+            if (errorMessage)
+                *errorMessage = photoError;
+            return false;
         }
     }
 
@@ -131,6 +190,8 @@ bool ItemRepository::saveItem(const ItemRecordData &item,
         return false;
     }
 
+    ItemChangeNotifier::instance().notifyItemsChanged({itemId});
+
     if (savedItemId)
         *savedItemId = itemId;
     if (errorMessage)
@@ -138,6 +199,112 @@ bool ItemRepository::saveItem(const ItemRecordData &item,
     return true;
 }
 
+bool ItemRepository::saveItems(const QList<ItemRecordData> &items,
+                               QStringList *savedItemIds,
+                               QList<ItemSaveError> *rowErrors,
+                               QString *errorMessage,
+                               const std::function<bool(int, int)> &progressCallback)
+{
+    if (savedItemIds)
+        savedItemIds->clear();
+    if (rowErrors)
+        rowErrors->clear();
+
+    if (!m_db.isOpen()) {
+        if (errorMessage)
+            *errorMessage = ItemRepository::tr("Połączenie z bazą danych jest zamknięte.");
+        return false;
+    }
+
+    const int total = items.size();
+    for (int chunkStart = 0; chunkStart < total; chunkStart += kBulkInsertTransactionSize) {
+        const int chunkEnd = qMin(total, chunkStart + kBulkInsertTransactionSize);
+        if (!m_db.transaction()) {
+            if (errorMessage)
+                *errorMessage = formatDbError(ItemRepository::tr("Nie udało się rozpocząć transakcji zapisu."),
+                                              m_db.lastError().text());
+            return false;
+        }
+
+        QStringList chunkIds;
+        for (int batchStart = chunkStart; batchStart < chunkEnd; batchStart += kBulkInsertRowsPerStatement)
+            insertItemBatch(items, batchStart, qMin(chunkEnd, batchStart + kBulkInsertRowsPerStatement),
+                            &chunkIds, rowErrors);
+
+        if (!m_db.commit()) {
+            m_db.rollback();
+            if (errorMessage)
+                *errorMessage = formatDbError(ItemRepository::tr("Nie udało się zatwierdzić zapisu w bazie danych."),
+                                              m_db.lastError().text());
+            return false;
+        }
+
+        if (!chunkIds.isEmpty())
+            ItemChangeNotifier::instance().notifyItemsChanged(chunkIds);
+        if (savedItemIds)
+            savedItemIds->append(chunkIds);
+
+        if (progressCallback && !progressCallback(chunkEnd, total)) {
+            if (errorMessage)
+                *errorMessage = ItemRepository::tr("Przerwano zapis po %1 z %2 rekordów.").arg(chunkEnd).arg(total);
+            return false;
+        }
+    }
+
+    if (errorMessage)
+        errorMessage->clear();
+    return true;
+}
+
+void ItemRepository::insertItemBatch(const QList<ItemRecordData> &items,
+                                     int begin,
+                                     int end,
+                                     QStringList *savedItemIds,
+                                     QList<ItemSaveError> *rowErrors)
+{
+    QStringList batchIds;
+    QList<int> batchIndexes;
+    for (int index = begin; index < end; ++index) {
+        if (items[index].editMode) {
+            if (rowErrors)
+                rowErrors->append({index, ItemRepository::tr("saveItems dodaje tylko nowe rekordy.")});
+            continue;
+        }
+        batchIds.append(items[index].id.isEmpty() ? QUuid::createUuid().toString(QUuid::WithoutBraces)
+                                                  : items[index].id);
+        batchIndexes.append(index);
+    }
+    if (batchIndexes.isEmpty())
+        return;
+
+    // Pełna paczka ma stały tekst SQL i przez cały import używa jednego uchwytu z cache;
+    // krótsza (ostatnia) nie zajmuje miejsca w cache wariantem, który się nie powtórzy.
+    const QString batchSql = itemInsertSql(batchIndexes.size());
+    PreparedStatement query = batchIndexes.size() == kBulkInsertRowsPerStatement
+                                  ? PreparedStatementCache::instance().prepare(m_db, batchSql)
+                                  : PreparedStatementCache::prepareUncached(m_db, batchSql);
+    for (int i = 0; i < batchIndexes.size(); ++i)
+        bindItemRow(*query, i, batchIds[i], items[batchIndexes[i]]);
+    if (query->exec()) {
+        savedItemIds->append(batchIds);
+        return;
+    }
+
+    // SQLite i MySQL wycofują tylko nieudane zapytanie, nie całą transakcję —
+    // szukamy winnego rekordu, wstawiając paczkę pojedynczo.
+    PreparedStatement singleQuery = PreparedStatementCache::instance().prepare(m_db, itemInsertSql(1));
+    for (int i = 0; i < batchIndexes.size(); ++i) {
+        bindItemRow(*singleQuery, 0, batchIds[i], items[batchIndexes[i]]);
+        if (singleQuery->exec()) {
+            savedItemIds->append(batchIds[i]);
+        } else if (rowErrors) {
+            rowErrors->append({batchIndexes[i],
+                               formatDbError(ItemRepository::tr("Nie udało się dodać eksponatu."),
+                                             singleQuery->lastError().text())});
+        }
+    }
+}
+
 bool ItemRepository::deleteItem(const QString &itemId, QString *errorMessage)
 {
     if (!m_db.isOpen()) {
@@ -156,30 +323,78 @@ bool ItemRepository::deleteItem(const QString &itemId, QString *errorMessage)
     // O-4 (audit 2026-04-26): osobne QSqlQuery per statement.
     // Re-use jednego obiektu na MySQL/MariaDB driver cachuje server-side prepared
     // stmt handles do końca życia QSqlQuery — w long-running procesie bije
-    // w max_prepared_stmt_count (default 16382, error 1461). Każdy w własnym
-    // scope = handle finalizowany od razu.
+    // w max_prepared_stmt_count (default 16382, error 1461).
+    // v1.5: zapytania bierzemy z PreparedStatementCache — limit uchwytów na połączenie
+    // pilnuje LRU cache, a koniec scope zwalnia tylko kursor (finish()), nie uchwyt.
+    QStringList photoIds;
     {
-        QSqlQuery photoDelete(m_db);
-        photoDelete.prepare("DELETE FROM photos WHERE eksponat_id = :id");
-        photoDelete.bindValue(":id", itemId);
-        if (!photoDelete.exec()) {
+        // ID zdjęć do unieważnienia PhotoCache po zatwierdzeniu usunięcia.
+        PreparedStatement photoIdQuery = PreparedStatementCache::instance().prepare(
+            m_db, "SELECT id FROM photos WHERE eksponat_id = :id");
+        photoIdQuery->bindValue(":id", itemId);
+        if (!photoIdQuery->exec()) {
+            m_db.rollback();
+            if (errorMessage)
+                *errorMessage = formatDbError(ItemRepository::tr("Nie udało się odczytać zdjęć eksponatu."),
+                                              photoIdQuery->lastError().text());
+            return false;
+        }
+        while (photoIdQuery->next())
+            photoIds.append(photoIdQuery->value(0).toString());
+    }
+
+    {
+        // Miniatury kasujemy jawnie — starsze bazy SQLite mogą nie mieć
+        // włączonego PRAGMA foreign_keys, więc nie polegamy na CASCADE.
+        PreparedStatement thumbnailDelete = PreparedStatementCache::instance().prepare(
+            m_db, "DELETE FROM photo_thumbnails WHERE photo_id IN "
+                  "(SELECT id FROM photos WHERE eksponat_id = :id)");
+        thumbnailDelete->bindValue(":id", itemId);
+        if (!thumbnailDelete->exec()) {
+            m_db.rollback();
+            if (errorMessage)
+                *errorMessage = formatDbError(ItemRepository::tr("Nie udało się usunąć miniatur zdjęć eksponatu."),
+                                              thumbnailDelete->lastError().text());
+            return false;
+        }
+    }
+
+    // v1.5: bloby z photo_blobs są współdzielone — najpierw zwalniamy referencje,
+    // po usunięciu wierszy photos sprzątamy bloby bez referencji (ta sama transakcja).
+    const PhotoService photoService(m_db);
+    if (!photoService.releaseItemBlobs(itemId, errorMessage)) {
+        m_db.rollback();
+        return false;
+    }
+
+    {
+        PreparedStatement photoDelete = PreparedStatementCache::instance().prepare(
+            m_db, "DELETE FROM photos WHERE eksponat_id = :id");
+        photoDelete->bindValue(":id", itemId);
+        if (!photoDelete->exec()) {
             m_db.rollback();
             if (errorMessage)
                 *errorMessage = formatDbError(ItemRepository::tr("Nie udało się usunąć zdjęć eksponatu."),
-                                              photoDelete.lastError().text());
+                                              photoDelete->lastError().text());
             return false;
         }
     }
 
+    QStringList releasedFiles;
+    if (!photoService.collectUnreferencedBlobs(&releasedFiles, errorMessage)) {
+        m_db.rollback();
+        return false;
+    }
+
     {
-        QSqlQuery itemDelete(m_db);
-        itemDelete.prepare("DELETE FROM eksponaty WHERE id = :id");
-        itemDelete.bindValue(":id", itemId);
-        if (!itemDelete.exec()) {
+        PreparedStatement itemDelete = PreparedStatementCache::instance().prepare(
+            m_db, "DELETE FROM eksponaty WHERE id = :id");
+        itemDelete->bindValue(":id", itemId);
+        if (!itemDelete->exec()) {
             m_db.rollback();
             if (errorMessage)
                 *errorMessage = formatDbError(ItemRepository::tr("Nie udało się usunąć eksponatu."),
-                                              itemDelete.lastError().text());
+                                              itemDelete->lastError().text());
             return false;
         }
     }
@@ -192,6 +407,10 @@ bool ItemRepository::deleteItem(const QString &itemId, QString *errorMessage)
         return false;
     }
 
+    photoService.removeBlobFiles(releasedFiles);
+    PhotoCache::instance().invalidateItem(itemId, photoIds);
+    ItemChangeNotifier::instance().notifyItemsRemoved({itemId});
+
     if (errorMessage)
         errorMessage->clear();
     return true;
@@ -199,24 +418,28 @@ bool ItemRepository::deleteItem(const QString &itemId, QString *errorMessage)
 
 bool ItemRepository::updateStatusForItems(const QStringList &itemIds,
                                           const QString &statusId,
-                                          QString *errorMessage)
+                                          QString *errorMessage,
+                                          const std::function<bool(int, int)> &progressCallback)
 {
     return updateItemsColumn(itemIds,
                              QStringLiteral("status_id"),
                              statusId,
                              ItemRepository::tr("zmiany statusu"),
-                             errorMessage);
+                             errorMessage,
+                             progressCallback);
 }
 
 bool ItemRepository::updateStoragePlaceForItems(const QStringList &itemIds,
                                                 const QString &storagePlaceId,
-                                                QString *errorMessage)
+                                                QString *errorMessage,
+                                                const std::function<bool(int, int)> &progressCallback)
 {
     return updateItemsColumn(itemIds,
                              QStringLiteral("storage_place_id"),
                              storagePlaceId,
                              ItemRepository::tr("zmiany miejsca przechowywania"),
-                             errorMessage);
+                             errorMessage,
+                             progressCallback);
 }
 
 bool ItemRepository::updateDescription(const QString &itemId,
@@ -237,24 +460,26 @@ bool ItemRepository::updateDescription(const QString &itemId,
         return false;
     }
 
-    QSqlQuery query(m_db);
-    query.prepare(QStringLiteral("UPDATE eksponaty SET description = :desc WHERE id = :id"));
-    query.bindValue(QStringLiteral(":desc"), newDescription);
-    query.bindValue(QStringLiteral(":id"), itemId);
+    PreparedStatement query = PreparedStatementCache::instance().prepare(
+        m_db, QStringLiteral("UPDATE eksponaty SET description = :desc WHERE id = :id"));
+    query->bindValue(QStringLiteral(":desc"), newDescription);
+    query->bindValue(QStringLiteral(":id"), itemId);
 
-    if (!query.exec()) {
+    if (!query->exec()) {
         if (errorMessage)
             *errorMessage = formatDbError(ItemRepository::tr("Nie udało się zaktualizować opisu eksponatu."),
-                                          query.lastError().text());
+                                          query->lastError().text());
         return false;
     }
 
-    if (query.numRowsAffected() == 0) {
+    if (query->numRowsAffected() == 0) {
         if (errorMessage)
             *errorMessage = ItemRepository::tr("Eksponat o podanym ID nie istnieje (description NIE zmieniono).");
         return false;
     }
 
+    ItemChangeNotifier::instance().notifyItemsChanged({itemId});
+
     if (errorMessage)
         errorMessage->clear();
     return true;
@@ -264,7 +489,8 @@ bool ItemRepository::updateItemsColumn(const QStringList &itemIds,
                                        const QString &columnName,
                                        const QString &valueId,
                                        const QString &operationLabel,
-                                       QString *errorMessage)
+                                       QString *errorMessage,
+                                       const std::function<bool(int, int)> &progressCallback)
 {
     if (!m_db.isOpen()) {
         if (errorMessage)
@@ -292,12 +518,31 @@ bool ItemRepository::updateItemsColumn(const QStringList &itemIds,
         return false;
     }
 
-    QSqlQuery query(m_db);
-    query.prepare(QStringLiteral("UPDATE eksponaty SET %1 = :value WHERE id = :id").arg(columnName));
-
-    for (const QString &itemId : itemIds) {
-        query.bindValue(QStringLiteral(":value"), valueId);
-        query.bindValue(QStringLiteral(":id"), itemId);
+    // v1.5: jedno UPDATE ... WHERE id IN (...) na paczkę ID zamiast jednego na rekord.
+    // Osobne zapytanie na każdy rozmiar paczki: pełne przygotowane raz i używane ponownie,
+    // ostatnia, krótsza paczka — własne. Tekst SQL zależy od kolumny i liczby ID, więc poza cache.
+    const auto prepareChunkUpdate = [&](int chunkSize) {
+        QStringList placeholders;
+        placeholders.reserve(chunkSize);
+        for (int i = 0; i < chunkSize; ++i)
+            placeholders.append(QStringLiteral("?"));
+        return PreparedStatementCache::prepareUncached(
+            m_db, QStringLiteral("UPDATE eksponaty SET %1 = ? WHERE id IN (%2)")
+                      .arg(columnName, placeholders.join(QLatin1Char(','))));
+    };
+    PreparedStatement fullChunkQuery;
+    PreparedStatement tailChunkQuery;
+    const int total = itemIds.size();
+    for (int offset = 0; offset < total; offset += kBulkUpdateChunkSize) {
+        const QStringList chunk = itemIds.mid(offset, kBulkUpdateChunkSize);
+        PreparedStatement &statement = chunk.size() == kBulkUpdateChunkSize ? fullChunkQuery : tailChunkQuery;
+        if (!statement.get())
+            statement = prepareChunkUpdate(chunk.size());
+        QSqlQuery &query = *statement;
+
+        query.bindValue(0, valueId);
+        for (int i = 0; i < chunk.size(); ++i)
+            query.bindValue(i + 1, chunk[i]);
         if (!query.exec()) {
             m_db.rollback();
             if (errorMessage)
@@ -306,6 +551,14 @@ bool ItemRepository::updateItemsColumn(const QStringList &itemIds,
                                               query.lastError().text());
             return false;
         }
+
+        if (progressCallback && !progressCallback(offset + chunk.size(), total)) {
+            m_db.rollback();
+            if (errorMessage)
+                *errorMessage = ItemRepository::tr("Przerwano %1 — żaden rekord nie został zmieniony.")
+                                    .arg(operationLabel);
+            return false;
+        }
     }
 
     if (!m_db.commit()) {
@@ -317,6 +570,8 @@ bool ItemRepository::updateItemsColumn(const QStringList &itemIds,
         return false;
     }
 
+    ItemChangeNotifier::instance().notifyItemsChanged(itemIds);
+
     if (errorMessage)
         errorMessage->clear();
     return true;
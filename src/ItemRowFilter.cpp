@@ -0,0 +1,210 @@
+#include "ItemRowFilter.h"
+
+#include "ItemSearchIndex.h"
+#include "ItemTableModel.h"
+
+#include <QRegularExpression>
+
+#include <utility>
+
+static_assert(std::tuple_size<ItemRowFilter::FacetCounts>::value == ItemTableModel::DictionaryCount,
+              "FacetCounts ma po jednym wektorze na słownik ItemTableModel");
+
+namespace {
+
+/// Wartości m_dictionaryFilterIds: brak filtru / nazwa, której nie ma w modelu.
+constexpr int kAnyNameId = -1;
+constexpr int kMissingNameId = -2;
+
+/// Co tyle wierszy pętle w tle sprawdzają, czy wynik jest jeszcze potrzebny.
+constexpr int kCancelCheckInterval = 4096;
+
+bool isCancelled(const std::function<bool()> &cancelled, int row)
+{
+    return cancelled && row % kCancelCheckInterval == 0 && cancelled();
+}
+
+}
+
+void ItemRowFilter::reset(const ItemTableModel *model, const ItemFilterState &state,
+                          const FullTextRanks *fullTextRanks)
+{
+    m_model = model;
+    m_state = state;
+    m_foldedSearchText = ItemSearchIndex::fold(state.searchText);
+    static const QRegularExpression separators(QStringLiteral("[^\\p{L}\\p{N}]+"));
+    m_foldedSearchTokens = m_foldedSearchText.split(separators, Qt::SkipEmptyParts);
+    m_searchCandidatesGeneration = 0;
+    m_fullTextActive = fullTextRanks != nullptr;
+    m_fullTextRanks = fullTextRanks ? *fullTextRanks : FullTextRanks();
+    resolve();
+}
+
+void ItemRowFilter::resolve()
+{
+    m_fullTextVendorIds.clear();
+    m_fullTextModelIds.clear();
+    if (!m_model)
+        return;
+
+    for (int dictionary = 0; dictionary < ItemTableModel::DictionaryCount; ++dictionary) {
+        const QString &name = m_state.dictionaryNames[dictionary];
+        if (name.isEmpty()) {
+            m_dictionaryFilterIds[dictionary] = kAnyNameId;
+            continue;
+        }
+        const int nameId = m_model->findDictionaryName(static_cast<ItemTableModel::Dictionary>(dictionary), name);
+        m_dictionaryFilterIds[dictionary] = nameId >= 0 ? nameId : kMissingNameId;
+    }
+
+    // Producent i model nie są w indeksie pełnotekstowym bazy — słowniki są małe,
+    // więc nazwy zawierające którekolwiek słowo zapytania liczymy tutaj, raz na zmianę
+    // słownika albo filtru.
+    if (!m_fullTextActive)
+        return;
+    const std::pair<ItemTableModel::Dictionary, QBitArray *> dictionaries[] = {
+        {ItemTableModel::VendorDictionary, &m_fullTextVendorIds},
+        {ItemTableModel::ModelDictionary, &m_fullTextModelIds}};
+    for (const auto &[dictionary, nameIds] : dictionaries) {
+        const int size = m_model->dictionarySize(dictionary);
+        nameIds->fill(false, size);
+        for (int nameId = 0; nameId < size; ++nameId) {
+            const QString name = ItemSearchIndex::fold(m_model->dictionaryName(dictionary, nameId));
+            for (const QString &token : std::as_const(m_foldedSearchTokens)) {
+                if (name.contains(token)) {
+                    nameIds->setBit(nameId);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+int ItemRowFilter::fullTextRank(const QString &itemId) const
+{
+    return m_fullTextRanks.value(itemId, m_fullTextRanks.size());
+}
+
+/// Kolejność warunków — od najtańszych.
+bool ItemRowFilter::acceptsRow(int row) const
+{
+    const ItemTableModel &model = *m_model;
+    for (int dictionary = 0; dictionary < ItemTableModel::DictionaryCount; ++dictionary) {
+        const int filterId = m_dictionaryFilterIds[dictionary];
+        if (filterId != kAnyNameId
+            && model.dictionaryId(static_cast<ItemTableModel::Dictionary>(dictionary), row) != filterId)
+            return false;
+    }
+    return acceptsFlagsAndText(row);
+}
+
+bool ItemRowFilter::acceptsFlagsAndText(int row) const
+{
+    const ItemTableModel &model = *m_model;
+    if (m_state.originalPackagingOnly && !model.hasOriginalPackaging(row))
+        return false;
+    if (m_state.withoutDescriptionOnly && !model.hasEmptyDescription(row))
+        return false;
+    if (m_state.withoutSerialNumberOnly && !model.hasEmptySerialNumber(row))
+        return false;
+    if (m_state.withoutModelOnly
+        && !model.isPlaceholderName(ItemTableModel::ModelDictionary,
+                                    model.dictionaryId(ItemTableModel::ModelDictionary, row)))
+        return false;
+    if (m_state.withoutVendorOnly
+        && !model.isPlaceholderName(ItemTableModel::VendorDictionary,
+                                    model.dictionaryId(ItemTableModel::VendorDictionary, row)))
+        return false;
+
+    return m_state.searchText.isEmpty() || matchesSearchText(row);
+}
+
+bool ItemRowFilter::matchesSearchText(int row) const
+{
+    const ItemTableModel &model = *m_model;
+    if (m_fullTextActive) {
+        if (m_fullTextRanks.contains(model.itemId(row)))
+            return true;
+        // Część słów może pasować do producenta albo modelu, reszta do tekstu spoza
+        // słowników — taki wiersz sprawdzamy słowo po słowie w pamięci.
+        if (!m_fullTextVendorIds.testBit(model.dictionaryId(ItemTableModel::VendorDictionary, row))
+            && !m_fullTextModelIds.testBit(model.dictionaryId(ItemTableModel::ModelDictionary, row)))
+            return false;
+        for (const QString &token : m_foldedSearchTokens) {
+            if (!model.rowContainsFoldedText(row, token))
+                return false;
+        }
+        return true;
+    }
+
+    if (m_searchCandidatesGeneration != model.searchGeneration()) {
+        QVector<int> documentIds;
+        m_searchUsesIndex = model.searchCandidates(m_foldedSearchText, &documentIds);
+        m_searchCandidates.fill(false, model.searchDocumentLimit());
+        for (int documentId : documentIds)
+            m_searchCandidates.setBit(documentId);
+        m_searchCandidatesGeneration = model.searchGeneration();
+    }
+
+    if (m_searchUsesIndex && !m_searchCandidates.testBit(model.searchDocumentId(row)))
+        return false;
+    // Indeks daje nadzbiór — kolejność trigramów sprawdza dopiero contains().
+    return model.rowContainsFoldedText(row, m_foldedSearchText);
+}
+
+bool ItemRowFilter::acceptedRows(QBitArray *rows, const std::function<bool()> &cancelled) const
+{
+    const int rowCount = m_model ? m_model->rowCount() : 0;
+    rows->fill(false, rowCount);
+    for (int row = 0; row < rowCount; ++row) {
+        if (isCancelled(cancelled, row))
+            return false;
+        if (acceptsRow(row))
+            rows->setBit(row);
+    }
+    return true;
+}
+
+bool ItemRowFilter::facetCounts(FacetCounts *facets, const std::function<bool()> &cancelled) const
+{
+    for (QVector<int> &counts : *facets)
+        counts.clear();
+    if (!m_model)
+        return true;
+
+    const ItemTableModel &model = *m_model;
+    for (int dictionary = 0; dictionary < ItemTableModel::DictionaryCount; ++dictionary)
+        (*facets)[dictionary].fill(0, model.dictionarySize(static_cast<ItemTableModel::Dictionary>(dictionary)));
+
+    const int rowCount = model.rowCount();
+    for (int row = 0; row < rowCount; ++row) {
+        if (isCancelled(cancelled, row))
+            return false;
+
+        // Wiersz niezgodny z dwoma filtrami słownikowymi nie trafi do żadnego combo.
+        int mismatchedDictionary = -1;
+        bool excluded = false;
+        for (int dictionary = 0; dictionary < ItemTableModel::DictionaryCount; ++dictionary) {
+            const int filterId = m_dictionaryFilterIds[dictionary];
+            if (filterId == kAnyNameId
+                || model.dictionaryId(static_cast<ItemTableModel::Dictionary>(dictionary), row) == filterId)
+                continue;
+            if (mismatchedDictionary >= 0) {
+                excluded = true;
+                break;
+            }
+            mismatchedDictionary = dictionary;
+        }
+        if (excluded || !acceptsFlagsAndText(row))
+            continue;
+
+        if (mismatchedDictionary >= 0) {
+            const auto dictionary = static_cast<ItemTableModel::Dictionary>(mismatchedDictionary);
+            ++(*facets)[mismatchedDictionary][model.dictionaryId(dictionary, row)];
+            continue;
+        }
+        for (int dictionary = 0; dictionary < ItemTableModel::DictionaryCount; ++dictionary)
+            ++(*facets)[dictionary][model.dictionaryId(static_cast<ItemTableModel::Dictionary>(dictionary), row)];
+    }
+    return true;
+}
@@ -0,0 +1,132 @@
+#include "ItemSearchIndex.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+/// Separator pól tekstu dokumentu — nie występuje w zapytaniu z QLineEdit.
+constexpr char16_t kFieldSeparator = u'\n';
+
+bool isAscii(const QString &text)
+{
+    for (QChar ch : text) {
+        if (ch.unicode() >= 0x80)
+            return false;
+    }
+    return true;
+}
+
+}
+
+QString ItemSearchIndex::fold(const QString &text)
+{
+    if (isAscii(text))
+        return text.toLower();
+
+    const QString decomposed = text.normalized(QString::NormalizationForm_KD);
+    QString folded;
+    folded.reserve(decomposed.size());
+    for (QChar ch : decomposed) {
+        if (ch.category() == QChar::Mark_NonSpacing)
+            continue;
+        // „ł” nie rozkłada się na literę i znak diakrytyczny.
+        if (ch == QChar(0x0141) || ch == QChar(0x0142))
+            ch = QLatin1Char('l');
+        folded.append(ch);
+    }
+    return folded.toCaseFolded();
+}
+
+void ItemSearchIndex::clear()
+{
+    m_postings.clear();
+    m_documentTrigrams.clear();
+}
+
+void ItemSearchIndex::setDocument(int docId, const QString &foldedText)
+{
+    removeDocument(docId);
+
+    const QVector<Trigram> documentTrigrams = trigrams(foldedText);
+    for (Trigram trigram : documentTrigrams) {
+        QVector<int> &posting = m_postings[trigram];
+        // Nowe dokumenty mają największe docId — zwykle wystarczy dopisać na końcu.
+        if (posting.isEmpty() || posting.last() < docId)
+            posting.append(docId);
+        else
+            posting.insert(std::lower_bound(posting.begin(), posting.end(), docId), docId);
+    }
+    if (!documentTrigrams.isEmpty())
+        m_documentTrigrams.insert(docId, documentTrigrams);
+}
+
+void ItemSearchIndex::removeDocument(int docId)
+{
+    const auto it = m_documentTrigrams.constFind(docId);
+    if (it == m_documentTrigrams.constEnd())
+        return;
+
+    for (Trigram trigram : it.value()) {
+        auto posting = m_postings.find(trigram);
+        if (posting == m_postings.end())
+            continue;
+        const auto position = std::lower_bound(posting->begin(), posting->end(), docId);
+        if (position != posting->end() && *position == docId)
+            posting->erase(position);
+        if (posting->isEmpty())
+            m_postings.erase(posting);
+    }
+    m_documentTrigrams.erase(it);
+}
+
+bool ItemSearchIndex::candidates(const QString &foldedQuery, QVector<int> *docIds) const
+{
+    docIds->clear();
+    const QVector<Trigram> queryTrigrams = trigrams(foldedQuery);
+    if (queryTrigrams.isEmpty())
+        return false;
+
+    QVector<const QVector<int> *> postings;
+    postings.reserve(queryTrigrams.size());
+    for (Trigram trigram : queryTrigrams) {
+        const auto it = m_postings.constFind(trigram);
+        if (it == m_postings.constEnd())
+            return true;
+        postings.append(&it.value());
+    }
+    std::sort(postings.begin(), postings.end(),
+              [](const QVector<int> *left, const QVector<int> *right) { return left->size() < right->size(); });
+
+    *docIds = *postings.first();
+    QVector<int> intersection;
+    for (int i = 1; i < postings.size() && !docIds->isEmpty(); ++i) {
+        intersection.clear();
+        std::set_intersection(docIds->cbegin(), docIds->cend(),
+                              postings[i]->cbegin(), postings[i]->cend(),
+                              std::back_inserter(intersection));
+        docIds->swap(intersection);
+    }
+    return true;
+}
+
+QVector<ItemSearchIndex::Trigram> ItemSearchIndex::trigrams(const QString &foldedText)
+{
+    QVector<Trigram> result;
+    const int size = foldedText.size();
+    if (size < 3)
+        return result;
+
+    result.reserve(size - 2);
+    const QChar *data = foldedText.constData();
+    for (int i = 0; i + 2 < size; ++i) {
+        if (data[i] == kFieldSeparator || data[i + 1] == kFieldSeparator || data[i + 2] == kFieldSeparator)
+            continue;
+        result.append((Trigram(data[i].unicode()) << 32)
+                      | (Trigram(data[i + 1].unicode()) << 16)
+                      | Trigram(data[i + 2].unicode()));
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
@@ -0,0 +1,141 @@
+#include "ItemSearchService.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPointer>
+#include <QRegularExpression>
+#include <QSettings>
+#include <QSqlDriver>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStandardPaths>
+
+namespace {
+
+QString formatDbError(const QString &context, const QString &details)
+{
+    return ItemSearchService::tr("%1\n%2").arg(context, details);
+}
+
+/// Domyślne innodb_ft_min_token_size — krótsze słowa FULLTEXT pomija.
+constexpr int kMysqlMinTokenSize = 3;
+
+QStringList searchTokens(const QString &text)
+{
+    static const QRegularExpression separators(QStringLiteral("[^\\p{L}\\p{N}]+"));
+    return text.split(separators, Qt::SkipEmptyParts);
+}
+
+/// Wynik isAvailable() dla połączenia. Połączenie otwarte ponownie pod tą samą
+/// nazwą ma nowy sterownik — wtedy wpis jest nieaktualny.
+struct Availability
+{
+    QPointer<QSqlDriver> driver;
+    bool available = false;
+};
+
+QMutex availabilityMutex;
+QHash<QString, Availability> availabilityByConnection;
+
+bool queryAvailability(const QSqlDatabase &db)
+{
+    QSettings settings(QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation)
+                           + "/inwentaryzacja.ini",
+                       QSettings::IniFormat);
+    if (!settings.value("search/fulltext", false).toBool())
+        return false;
+
+    QSqlQuery query(db);
+    // Sama obecność tabeli nie wystarcza — bez modułu FTS5 zapytanie do niej się nie uda.
+    if (db.driverName() == "QSQLITE")
+        return query.exec(QStringLiteral("SELECT 1 FROM eksponaty_fts LIMIT 0"));
+    query.prepare(QStringLiteral("SELECT COUNT(*) FROM information_schema.statistics "
+                                 "WHERE table_schema = DATABASE() "
+                                 "AND table_name = 'eksponaty' "
+                                 "AND index_name = 'ft_eksponaty_text'"));
+    return query.exec() && query.next() && query.value(0).toInt() > 0;
+}
+
+}
+
+ItemSearchService::ItemSearchService(QSqlDatabase database)
+    : m_db(database)
+{
+}
+
+bool ItemSearchService::isAvailable() const
+{
+    if (!m_db.isOpen())
+        return false;
+
+    // Wołane przy każdej zmianie pola „Szukaj” — ustawienie i obecność indeksu
+    // sprawdzamy raz na połączenie, bez QSettings i zapytania do katalogu bazy.
+    {
+        const QMutexLocker locker(&availabilityMutex);
+        const auto it = availabilityByConnection.constFind(m_db.connectionName());
+        if (it != availabilityByConnection.constEnd() && it->driver == m_db.driver())
+            return it->available;
+    }
+
+    Availability entry;
+    entry.driver = m_db.driver();
+    entry.available = queryAvailability(m_db);
+    const QMutexLocker locker(&availabilityMutex);
+    availabilityByConnection.insert(m_db.connectionName(), entry);
+    return entry.available;
+}
+
+bool ItemSearchService::search(const QString &text, QStringList *itemIds, QString *errorMessage) const
+{
+    itemIds->clear();
+    if (errorMessage)
+        errorMessage->clear();
+
+    const QStringList tokens = searchTokens(text);
+    if (tokens.isEmpty() || !isAvailable())
+        return false;
+
+    const bool sqlite = m_db.driverName() == "QSQLITE";
+    QStringList terms;
+    for (const QString &token : tokens) {
+        if (sqlite) {
+            // Słowo w cudzysłowie — bez interpretacji AND/OR/NEAR; gwiazdka = prefiks.
+            // ł → l jak w treści indeksu (ensureFullTextIndex), resztę znaków zdejmuje tokenizer.
+            QString term = token;
+            term.replace(QChar(0x0142), QLatin1Char('l')).replace(QChar(0x0141), QLatin1Char('L'));
+            terms.append(QLatin1Char('"') + term + QStringLiteral("\"*"));
+        } else {
+            if (token.size() < kMysqlMinTokenSize)
+                return false;
+            terms.append(QLatin1Char('+') + token + QLatin1Char('*'));
+        }
+    }
+    const QString match = terms.join(QLatin1Char(' '));
+
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    if (sqlite) {
+        query.prepare(QStringLiteral("SELECT item_id FROM eksponaty_fts WHERE eksponaty_fts MATCH ? "
+                                     "ORDER BY rank"));
+        query.addBindValue(match);
+    } else {
+        query.prepare(QStringLiteral("SELECT id FROM eksponaty "
+                                     "WHERE MATCH(name, serial_number, part_number, description) "
+                                     "AGAINST (? IN BOOLEAN MODE) "
+                                     "ORDER BY MATCH(name, serial_number, part_number, description) "
+                                     "AGAINST (? IN BOOLEAN MODE) DESC"));
+        query.addBindValue(match);
+        query.addBindValue(match);
+    }
+    if (!query.exec()) {
+        if (errorMessage)
+            *errorMessage = formatDbError(tr("Nie udało się przeszukać indeksu pełnotekstowego."),
+                                          query.lastError().text());
+        return false;
+    }
+
+    while (query.next())
+        itemIds->append(query.value(0).toString());
+    return true;
+}
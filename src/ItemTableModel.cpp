@@ -0,0 +1,1020 @@
+#include "ItemTableModel.h"
+
+#include <QCollator>
+#include <QDebug>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QThread>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+namespace {
+
+QString formatDbError(const QString &context, const QString &details)
+{
+    return QObject::tr("%1\n%2").arg(context, details);
+}
+
+/// Tabele słowników w kolejności ItemTableModel::Dictionary.
+constexpr const char *kDictionaryTables[ItemTableModel::DictionaryCount] = {
+    "types",
+    "vendors",
+    "models",
+    "statuses",
+    "storage_places",
+};
+
+/// Kolumny eksponaty w kolejności ItemTableModel::Column.
+constexpr const char *kItemColumns[ItemTableModel::ColumnCount] = {
+    "id",
+    "name",
+    "type_id",
+    "vendor_id",
+    "model_id",
+    "serial_number",
+    "part_number",
+    "revision",
+    "production_year",
+    "status_id",
+    "storage_place_id",
+    "description",
+    "value",
+    "has_original_packaging",
+};
+
+constexpr const char *kSelectItems =
+    "SELECT id, name, type_id, vendor_id, model_id, serial_number, part_number, revision, "
+    "production_year, status_id, storage_place_id, description, value, has_original_packaging";
+
+/// Limit parametrów w jednym IN (SQLite: 999 zmiennych na zapytanie).
+constexpr int kRefreshChunkSize = 500;
+
+/// Poniżej tej liczby wierszy sortujemy w jednym wątku — start puli kosztuje więcej niż zysk.
+constexpr int kParallelSortThreshold = 20000;
+
+/// refreshItems: do tylu rekordów każdy wiersz jest przesuwany na swoje miejsce
+/// osobno (beginMoveRows); przy większej zmianie — jedno sortowanie całości.
+constexpr int kIncrementalSortLimit = 64;
+
+/// Porządek tekstów jak w combo boxach filtrów: wg języka, bez wielkości liter, „A2” < „A10”.
+QCollator createSortCollator()
+{
+    QCollator collator;
+    collator.setCaseSensitivity(Qt::CaseInsensitive);
+    collator.setNumericMode(true);
+    return collator;
+}
+
+/// std::stable_sort; dla dużych tablic — kawałki sortowane w QThreadPool i scalane
+/// std::inplace_merge (też stabilnie). `less` musi być bezpieczne dla wielu wątków.
+template<typename Less>
+void stableSortRows(QVector<int> &rows, Less less)
+{
+    const int threadCount = QThread::idealThreadCount();
+    int *data = rows.data();
+    const int size = rows.size();
+    if (size < kParallelSortThreshold || threadCount < 2) {
+        std::stable_sort(data, data + size, less);
+        return;
+    }
+
+    const int chunkCount = qMin(threadCount, size / (kParallelSortThreshold / 2));
+    QVector<int> bounds;
+    for (int chunk = 0; chunk <= chunkCount; ++chunk)
+        bounds.append(int(qint64(size) * chunk / chunkCount));
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(chunkCount);
+    for (int chunk = 0; chunk < chunkCount; ++chunk) {
+        int *first = data + bounds[chunk];
+        int *last = data + bounds[chunk + 1];
+        pool.start([first, last, &less]() { std::stable_sort(first, last, less); });
+    }
+    pool.waitForDone();
+
+    for (int width = 1; width < chunkCount; width *= 2) {
+        for (int chunk = 0; chunk + width < chunkCount; chunk += 2 * width)
+            std::inplace_merge(data + bounds[chunk], data + bounds[chunk + width],
+                               data + bounds[qMin(chunk + 2 * width, chunkCount)], less);
+    }
+}
+
+template<typename T>
+void permuteVector(QVector<T> &values, const QVector<int> &order)
+{
+    QVector<T> permuted;
+    permuted.reserve(order.size());
+    for (int row : order)
+        permuted.append(std::move(values[row]));
+    values.swap(permuted);
+}
+
+/// Słownik kolumny albo DictionaryCount dla kolumn spoza słowników.
+ItemTableModel::Dictionary dictionaryForColumn(int column)
+{
+    switch (column) {
+    case ItemTableModel::TypeColumn: return ItemTableModel::TypeDictionary;
+    case ItemTableModel::VendorColumn: return ItemTableModel::VendorDictionary;
+    case ItemTableModel::ModelColumn: return ItemTableModel::ModelDictionary;
+    case ItemTableModel::StatusColumn: return ItemTableModel::StatusDictionary;
+    case ItemTableModel::StorageColumn: return ItemTableModel::StorageDictionary;
+    default: return ItemTableModel::DictionaryCount;
+    }
+}
+
+/// Klucz stron przy sortowaniu w bazie — wyrażenie bez NULL-i (porównanie
+/// `(klucz, id) > (?, ?)` z NULL-em odrzuciłoby wiersz), słowniki po nazwie.
+/// `name` i `id` zostają gołe, żeby zapytanie mogło iść indeksem (name, id).
+QString pageSortKeySql(int column)
+{
+    const ItemTableModel::Dictionary dictionary = dictionaryForColumn(column);
+    if (dictionary != ItemTableModel::DictionaryCount)
+        return QStringLiteral("COALESCE((SELECT name FROM %1 WHERE %1.id = eksponaty.%2), '')")
+            .arg(QLatin1String(kDictionaryTables[dictionary]), QLatin1String(kItemColumns[column]));
+
+    const QLatin1String name(kItemColumns[column]);
+    switch (column) {
+    case ItemTableModel::IdColumn:
+    case ItemTableModel::NameColumn: return name;
+    case ItemTableModel::ProductionYearColumn:
+    case ItemTableModel::ValueColumn:
+        return QStringLiteral("COALESCE(%1, %2)").arg(name).arg(std::numeric_limits<int>::min());
+    case ItemTableModel::PackagingColumn: return QStringLiteral("COALESCE(%1, 0)").arg(name);
+    default: return QStringLiteral("COALESCE(%1, '')").arg(name);
+    }
+}
+
+int compareNumbers(int left, int right)
+{
+    return (left > right) - (left < right);
+}
+
+bool isPlaceholderText(const QString &name)
+{
+    const QString normalized = name.trimmed().toLower();
+    return normalized.isEmpty()
+           || normalized == QStringLiteral("unknown")
+           || normalized == QStringLiteral("brak")
+           || normalized == QStringLiteral("nieznany");
+}
+
+}
+
+ItemTableModel::ItemTableModel(QSqlDatabase db, QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_db(db)
+{
+}
+
+int ItemTableModel::DictionaryColumn::intern(const QString &name)
+{
+    auto it = nameIdByName.constFind(name);
+    if (it != nameIdByName.constEnd())
+        return it.value();
+
+    const int nameId = names.size();
+    nameIdByName.insert(name, nameId);
+    names.append(name);
+    placeholders.append(isPlaceholderText(name) ? 1 : 0);
+    return nameId;
+}
+
+void ItemTableModel::DictionaryColumn::updateSortRanks(const QCollator &collator)
+{
+    if (sortRanks.size() == names.size())
+        return;
+
+    QVector<int> order(names.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this, &collator](int left, int right)
+              { return collator.compare(names[left], names[right]) < 0; });
+
+    sortRanks.resize(names.size());
+    int rank = 0;
+    for (int i = 0; i < order.size(); ++i) {
+        if (i > 0 && collator.compare(names[order[i - 1]], names[order[i]]) != 0)
+            ++rank;
+        sortRanks[order[i]] = rank;
+    }
+}
+
+bool ItemTableModel::reload(QString *errorMessage)
+{
+    // Wczytujemy do kopii — przy błędzie widok zostaje z poprzednimi danymi.
+    ItemTableModel loaded(m_db);
+    loaded.m_pageSize = m_pageSize;
+    loaded.m_sortColumn = m_sortColumn;
+    loaded.m_sortOrder = m_sortOrder;
+    loaded.m_rowFilterSql = m_rowFilterSql;
+    loaded.m_rowFilterBindValues = m_rowFilterBindValues;
+
+    for (int dictionary = 0; dictionary < DictionaryCount; ++dictionary) {
+        DictionaryColumn &column = loaded.m_dictionaries[dictionary];
+
+        QSqlQuery query(m_db);
+        query.setForwardOnly(true);
+        if (!query.exec(QStringLiteral("SELECT id, name FROM %1")
+                            .arg(QLatin1String(kDictionaryTables[dictionary])))) {
+            if (errorMessage)
+                *errorMessage = formatDbError(QObject::tr("Nie udało się wczytać słownika %1.")
+                                                  .arg(QLatin1String(kDictionaryTables[dictionary])),
+                                              query.lastError().text());
+            return false;
+        }
+        while (query.next())
+            column.nameIdByUuid.insert(query.value(0).toString(), column.intern(query.value(1).toString()));
+    }
+
+    int skipped = 0;
+    if (m_pageSize > 0) {
+        QVector<RowValues> rows;
+        if (!loaded.countRows(errorMessage) || !loaded.readPage(&rows, nullptr, errorMessage))
+            return false;
+        for (const RowValues &values : std::as_const(rows))
+            loaded.appendRow(values);
+    } else {
+        QVariantList bindValues;
+        QSqlQuery query(m_db);
+        query.setForwardOnly(true);
+        query.prepare(loaded.selectSql({}, &bindValues));
+        for (const QVariant &value : std::as_const(bindValues))
+            query.addBindValue(value);
+        if (!query.exec()) {
+            if (errorMessage)
+                *errorMessage = formatDbError(QObject::tr("Nie udało się wczytać listy eksponatów."),
+                                              query.lastError().text());
+            return false;
+        }
+
+        RowValues values;
+        while (query.next()) {
+            if (loaded.readRow(query, false, &values, nullptr))
+                loaded.appendRow(values);
+            else
+                ++skipped;
+        }
+        loaded.m_totalRowCount = loaded.m_ids.size();
+    }
+
+    beginResetModel();
+    m_ids.swap(loaded.m_ids);
+    m_names.swap(loaded.m_names);
+    m_serialNumbers.swap(loaded.m_serialNumbers);
+    m_partNumbers.swap(loaded.m_partNumbers);
+    m_revisions.swap(loaded.m_revisions);
+    m_descriptions.swap(loaded.m_descriptions);
+    m_productionYears.swap(loaded.m_productionYears);
+    m_values.swap(loaded.m_values);
+    m_flags.swap(loaded.m_flags);
+    m_dictionaries.swap(loaded.m_dictionaries);
+    m_rowById.swap(loaded.m_rowById);
+    m_searchTexts.swap(loaded.m_searchTexts);
+    m_searchDocIds.swap(loaded.m_searchDocIds);
+    std::swap(m_searchIndex, loaded.m_searchIndex);
+    m_nextSearchDocId = loaded.m_nextSearchDocId;
+    ++m_searchGeneration;
+    m_totalRowCount = loaded.m_totalRowCount;
+    m_hasMorePages = loaded.m_hasMorePages;
+    m_lastPageKey = loaded.m_lastPageKey;
+    m_lastPageId = loaded.m_lastPageId;
+    ++m_revision;
+    // Strony przychodzą już w porządku sortowania (readPage).
+    if (m_pageSize == 0 && m_sortColumn >= 0)
+        permuteRows(sortedRowOrder(m_sortColumn, m_sortOrder));
+    endResetModel();
+
+    if (skipped > 0)
+        qDebug() << "ItemTableModel: pominięto" << skipped
+                 << "rekordów z odwołaniem do nieistniejącego wpisu słownika";
+
+    if (errorMessage)
+        errorMessage->clear();
+    return true;
+}
+
+bool ItemTableModel::refreshItems(const QStringList &itemIds, QString *errorMessage)
+{
+    QHash<QString, RowValues> fetched;
+    bool extended = false;
+
+    for (int offset = 0; offset < itemIds.size(); offset += kRefreshChunkSize) {
+        const QStringList chunk = itemIds.mid(offset, kRefreshChunkSize);
+        QStringList placeholders;
+        for (int i = 0; i < chunk.size(); ++i)
+            placeholders.append(QStringLiteral("?"));
+
+        // Lista IN (...) ma zmienną długość, więc zapytanie nie idzie przez PreparedStatementCache
+        // (każdy wariant zająłby osobny uchwyt na serwerze); jedno prepare() na porcję.
+        // Rekord, który przestał spełniać setRowFilter, wypada z modelu jak usunięty.
+        QVariantList bindValues;
+        const QString sql = selectSql({QStringLiteral("id IN (%1)").arg(placeholders.join(QLatin1Char(',')))},
+                                      &bindValues);
+        for (const QString &itemId : chunk)
+            bindValues.append(itemId);
+        QSqlQuery query(m_db);
+        query.setForwardOnly(true);
+        query.prepare(sql);
+        for (const QVariant &value : std::as_const(bindValues))
+            query.addBindValue(value);
+        if (!query.exec()) {
+            if (errorMessage)
+                *errorMessage = formatDbError(QObject::tr("Nie udało się odczytać zmienionych eksponatów."),
+                                              query.lastError().text());
+            return false;
+        }
+
+        RowValues values;
+        while (query.next()) {
+            if (readRow(query, true, &values, &extended))
+                fetched.insert(values.id, values);
+        }
+    }
+
+    if (extended)
+        emit dictionaryNamesAdded();
+
+    // Aktywne sortowanie obejmuje też zmienione i nowe wiersze. Przy kilku rekordach
+    // każdy jest przesuwany na swoje miejsce zaraz po zmianie (reszta jest wtedy
+    // posortowana, więc wystarcza wyszukiwanie binarne); przy wielu — sort() na końcu.
+    // W trybie stronicowanym porządek wyznacza baza — nowe wiersze idą na koniec.
+    const bool sorted = m_sortColumn >= 0 && m_pageSize == 0;
+    const bool placeEachRow = sorted && fetched.size() <= kIncrementalSortLimit;
+    const QCollator collator = createSortCollator();
+    if (placeEachRow) {
+        const Dictionary dictionary = dictionaryForColumn(m_sortColumn);
+        if (dictionary != DictionaryCount)
+            m_dictionaries[dictionary].updateSortRanks(collator);
+    }
+
+    QStringList removed;
+    for (const QString &itemId : itemIds) {
+        const int row = rowForItemId(itemId);
+        const auto it = fetched.constFind(itemId);
+        if (it == fetched.constEnd()) {
+            if (row >= 0)
+                removed.append(itemId);
+            continue;
+        }
+
+        if (row >= 0) {
+            assignRow(row, it.value());
+            emit dataChanged(index(row, 0), index(row, ColumnCount - 1));
+        } else {
+            // W trybie stronicowanym nowy rekord trafia na koniec wczytanej części;
+            // readPage() pominie go, gdy dojdzie do jego strony.
+            const int newRow = m_ids.size();
+            beginInsertRows(QModelIndex(), newRow, newRow);
+            appendRow(it.value());
+            endInsertRows();
+            ++m_totalRowCount;
+        }
+        if (placeEachRow)
+            moveToSortedPosition(rowForItemId(itemId), collator);
+    }
+    removeItems(removed);
+    if (sorted && !placeEachRow && !fetched.isEmpty())
+        sort(m_sortColumn, m_sortOrder);
+
+    if (errorMessage)
+        errorMessage->clear();
+    return true;
+}
+
+void ItemTableModel::removeItems(const QStringList &itemIds)
+{
+    QVector<int> rows;
+    for (const QString &itemId : itemIds) {
+        const int row = rowForItemId(itemId);
+        if (row >= 0)
+            rows.append(row);
+    }
+    if (rows.isEmpty())
+        return;
+
+    // Od końca, żeby numery pozostałych wierszy do usunięcia się nie przesuwały.
+    std::sort(rows.begin(), rows.end(), std::greater<int>());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    for (int row : rows) {
+        beginRemoveRows(QModelIndex(), row, row);
+        m_rowById.remove(m_ids[row]);
+        m_searchIndex.removeDocument(m_searchDocIds[row]);
+        m_searchTexts.removeAt(row);
+        m_searchDocIds.removeAt(row);
+        m_ids.removeAt(row);
+        m_names.removeAt(row);
+        m_serialNumbers.removeAt(row);
+        m_partNumbers.removeAt(row);
+        m_revisions.removeAt(row);
+        m_descriptions.removeAt(row);
+        m_productionYears.removeAt(row);
+        m_values.removeAt(row);
+        m_flags.removeAt(row);
+        for (DictionaryColumn &column : m_dictionaries)
+            column.rows.removeAt(row);
+        endRemoveRows();
+    }
+    ++m_searchGeneration;
+    ++m_revision;
+
+    for (int row = rows.last(); row < m_ids.size(); ++row)
+        m_rowById[m_ids[row]] = row;
+    m_totalRowCount = qMax(0, m_totalRowCount - rows.size());
+}
+
+std::unique_ptr<ItemTableModel> ItemTableModel::createSnapshot() const
+{
+    auto snapshot = std::make_unique<ItemTableModel>(QSqlDatabase());
+    snapshot->m_ids = m_ids;
+    snapshot->m_names = m_names;
+    snapshot->m_serialNumbers = m_serialNumbers;
+    snapshot->m_partNumbers = m_partNumbers;
+    snapshot->m_revisions = m_revisions;
+    snapshot->m_descriptions = m_descriptions;
+    snapshot->m_productionYears = m_productionYears;
+    snapshot->m_values = m_values;
+    snapshot->m_flags = m_flags;
+    snapshot->m_dictionaries = m_dictionaries;
+    snapshot->m_rowById = m_rowById;
+    snapshot->m_searchTexts = m_searchTexts;
+    snapshot->m_searchDocIds = m_searchDocIds;
+    snapshot->m_searchIndex = m_searchIndex;
+    snapshot->m_nextSearchDocId = m_nextSearchDocId;
+    snapshot->m_searchGeneration = m_searchGeneration;
+    snapshot->m_totalRowCount = m_totalRowCount;
+    snapshot->m_revision = m_revision;
+    snapshot->moveToThread(nullptr);
+    return snapshot;
+}
+
+void ItemTableModel::sort(int column, Qt::SortOrder order)
+{
+    const int sortColumn = column >= 0 && column < ColumnCount ? column : -1;
+    if (m_pageSize > 0) {
+        // Posortowane w pamięci byłyby tylko wczytane strony — porządek ustala baza
+        // (ORDER BY kolumna, id), a lista wczytuje się od pierwszej strony.
+        if (sortColumn == m_sortColumn && (sortColumn < 0 || order == m_sortOrder))
+            return;
+        m_sortColumn = sortColumn;
+        m_sortOrder = order;
+        QString errorMessage;
+        if (!reload(&errorMessage))
+            qDebug() << "ItemTableModel: błąd sortowania w bazie:" << errorMessage;
+        return;
+    }
+
+    m_sortColumn = sortColumn;
+    m_sortOrder = order;
+    if (m_sortColumn < 0 || m_ids.size() < 2)
+        return;
+
+    const QVector<int> rowOrder = sortedRowOrder(m_sortColumn, m_sortOrder);
+
+    emit layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+    QVector<int> newRows(rowOrder.size());
+    for (int row = 0; row < rowOrder.size(); ++row)
+        newRows[rowOrder[row]] = row;
+    permuteRows(rowOrder);
+
+    const QModelIndexList oldIndexes = persistentIndexList();
+    QModelIndexList newIndexes;
+    newIndexes.reserve(oldIndexes.size());
+    for (const QModelIndex &oldIndex : oldIndexes)
+        newIndexes.append(index(newRows[oldIndex.row()], oldIndex.column()));
+    changePersistentIndexList(oldIndexes, newIndexes);
+    emit layoutChanged({}, QAbstractItemModel::VerticalSortHint);
+}
+
+QVector<int> ItemTableModel::sortedRowOrder(int column, Qt::SortOrder order)
+{
+    QVector<int> rows(m_ids.size());
+    std::iota(rows.begin(), rows.end(), 0);
+
+    // Klucz całkowity na wiersz — porównanie to dwa odczyty z wektora.
+    QVector<int> keys;
+    const Dictionary dictionary = dictionaryForColumn(column);
+    switch (column) {
+    case ProductionYearColumn: keys = m_productionYears; break;
+    case ValueColumn: keys = m_values; break;
+    case PackagingColumn:
+        keys.resize(m_flags.size());
+        for (int row = 0; row < m_flags.size(); ++row)
+            keys[row] = m_flags[row] & OriginalPackagingFlag;
+        break;
+    default: break;
+    }
+
+    const QCollator collator = createSortCollator();
+    if (dictionary != DictionaryCount) {
+        DictionaryColumn &dictionaryColumn = m_dictionaries[dictionary];
+        dictionaryColumn.updateSortRanks(collator);
+        keys.resize(dictionaryColumn.rows.size());
+        for (int row = 0; row < keys.size(); ++row)
+            keys[row] = dictionaryColumn.sortRanks[dictionaryColumn.rows[row]];
+    }
+
+    const bool ascending = order == Qt::AscendingOrder;
+    if (keys.size() == rows.size()) {
+        const int *rowKeys = keys.constData();
+        stableSortRows(rows, [rowKeys, ascending](int left, int right)
+                       { return ascending ? rowKeys[left] < rowKeys[right] : rowKeys[right] < rowKeys[left]; });
+        return rows;
+    }
+
+    // Kolumny tekstowe: klucz sortowania QCollator liczony raz na wiersz.
+    const QVector<QString> *texts = nullptr;
+    switch (column) {
+    case IdColumn: texts = &m_ids; break;
+    case NameColumn: texts = &m_names; break;
+    case SerialNumberColumn: texts = &m_serialNumbers; break;
+    case PartNumberColumn: texts = &m_partNumbers; break;
+    case RevisionColumn: texts = &m_revisions; break;
+    default: texts = &m_descriptions; break;
+    }
+    std::vector<QCollatorSortKey> sortKeys;
+    sortKeys.reserve(texts->size());
+    for (const QString &text : *texts)
+        sortKeys.push_back(collator.sortKey(text));
+    const QCollatorSortKey *rowKeys = sortKeys.data();
+    stableSortRows(rows, [rowKeys, ascending](int left, int right)
+                   { return ascending ? rowKeys[left].compare(rowKeys[right]) < 0
+                                      : rowKeys[right].compare(rowKeys[left]) < 0; });
+    return rows;
+}
+
+int ItemTableModel::compareRows(int left, int right, const QCollator &collator) const
+{
+    const Dictionary dictionary = dictionaryForColumn(m_sortColumn);
+    if (dictionary != DictionaryCount) {
+        const DictionaryColumn &column = m_dictionaries[dictionary];
+        return compareNumbers(column.sortRanks[column.rows[left]], column.sortRanks[column.rows[right]]);
+    }
+
+    switch (m_sortColumn) {
+    case ProductionYearColumn: return compareNumbers(m_productionYears[left], m_productionYears[right]);
+    case ValueColumn: return compareNumbers(m_values[left], m_values[right]);
+    case PackagingColumn:
+        return compareNumbers(m_flags[left] & OriginalPackagingFlag, m_flags[right] & OriginalPackagingFlag);
+    case IdColumn: return collator.compare(m_ids[left], m_ids[right]);
+    case NameColumn: return collator.compare(m_names[left], m_names[right]);
+    case SerialNumberColumn: return collator.compare(m_serialNumbers[left], m_serialNumbers[right]);
+    case PartNumberColumn: return collator.compare(m_partNumbers[left], m_partNumbers[right]);
+    case RevisionColumn: return collator.compare(m_revisions[left], m_revisions[right]);
+    default: return collator.compare(m_descriptions[left], m_descriptions[right]);
+    }
+}
+
+void ItemTableModel::moveToSortedPosition(int row, const QCollator &collator)
+{
+    if (row < 0 || m_sortColumn < 0)
+        return;
+
+    // Miejsce wśród pozostałych (posortowanych) wierszy: za ostatnim równym,
+    // jak przy sortowaniu stabilnym. `position` liczy wiersze bez `row`.
+    const bool ascending = m_sortOrder == Qt::AscendingOrder;
+    int low = 0;
+    int high = m_ids.size() - 1;
+    while (low < high) {
+        const int position = (low + high) / 2;
+        const int comparison = compareRows(row, position < row ? position : position + 1, collator);
+        if (ascending ? comparison < 0 : comparison > 0)
+            high = position;
+        else
+            low = position + 1;
+    }
+    const int target = low;
+    if (target == row)
+        return;
+
+    beginMoveRows(QModelIndex(), row, row, QModelIndex(), target > row ? target + 1 : target);
+    m_ids.move(row, target);
+    m_names.move(row, target);
+    m_serialNumbers.move(row, target);
+    m_partNumbers.move(row, target);
+    m_revisions.move(row, target);
+    m_descriptions.move(row, target);
+    m_productionYears.move(row, target);
+    m_values.move(row, target);
+    m_flags.move(row, target);
+    for (DictionaryColumn &column : m_dictionaries)
+        column.rows.move(row, target);
+    m_searchTexts.move(row, target);
+    m_searchDocIds.move(row, target);
+    for (int moved = qMin(row, target); moved <= qMax(row, target); ++moved)
+        m_rowById[m_ids[moved]] = moved;
+    ++m_revision;
+    endMoveRows();
+}
+
+void ItemTableModel::permuteRows(const QVector<int> &order)
+{
+    permuteVector(m_ids, order);
+    permuteVector(m_names, order);
+    permuteVector(m_serialNumbers, order);
+    permuteVector(m_partNumbers, order);
+    permuteVector(m_revisions, order);
+    permuteVector(m_descriptions, order);
+    permuteVector(m_productionYears, order);
+    permuteVector(m_values, order);
+    permuteVector(m_flags, order);
+    for (DictionaryColumn &column : m_dictionaries)
+        permuteVector(column.rows, order);
+    // docId w indeksie wyszukiwania są stałe — przestawiamy tylko przypisanie do wierszy.
+    permuteVector(m_searchTexts, order);
+    permuteVector(m_searchDocIds, order);
+
+    for (int row = 0; row < m_ids.size(); ++row)
+        m_rowById[m_ids[row]] = row;
+    ++m_revision;
+}
+
+void ItemTableModel::setRowFilter(const QString &whereSql, const QVariantList &bindValues)
+{
+    m_rowFilterSql = whereSql.trimmed();
+    m_rowFilterBindValues = m_rowFilterSql.isEmpty() ? QVariantList() : bindValues;
+}
+
+QString ItemTableModel::selectSql(const QStringList &conditions, QVariantList *bindValues,
+                                  const QString &extraColumn) const
+{
+    QStringList where;
+    if (!m_rowFilterSql.isEmpty()) {
+        where.append(QLatin1Char('(') + m_rowFilterSql + QLatin1Char(')'));
+        bindValues->append(m_rowFilterBindValues);
+    }
+    where.append(conditions);
+
+    QString sql = QString::fromLatin1(kSelectItems);
+    if (!extraColumn.isEmpty())
+        sql += QStringLiteral(", ") + extraColumn;
+    sql += QStringLiteral(" FROM eksponaty");
+    if (!where.isEmpty())
+        sql += QStringLiteral(" WHERE ") + where.join(QStringLiteral(" AND "));
+    return sql;
+}
+
+bool ItemTableModel::countRows(QString *errorMessage)
+{
+    QString sql = QStringLiteral("SELECT COUNT(*) FROM eksponaty");
+    if (!m_rowFilterSql.isEmpty())
+        sql += QStringLiteral(" WHERE ") + m_rowFilterSql;
+
+    QSqlQuery query(m_db);
+    query.prepare(sql);
+    for (const QVariant &value : std::as_const(m_rowFilterBindValues))
+        query.addBindValue(value);
+    if (!query.exec() || !query.next()) {
+        if (errorMessage)
+            *errorMessage = formatDbError(QObject::tr("Nie udało się policzyć eksponatów."),
+                                          query.lastError().text());
+        return false;
+    }
+    m_totalRowCount = query.value(0).toInt();
+    return true;
+}
+
+QString ItemTableModel::pageSql(bool afterKey, QVariantList *bindValues) const
+{
+    // Bez sortowania — porządek (name, id). Klucz strony jako wartość wiersza:
+    // `(klucz, id) > (?, ?)`, przy malejącym porządku `<`.
+    const QString sortKey = pageSortKeySql(m_sortColumn >= 0 ? m_sortColumn : int(NameColumn));
+    const bool descending = m_sortColumn >= 0 && m_sortOrder == Qt::DescendingOrder;
+    QStringList conditions;
+    if (afterKey)
+        conditions.append(QStringLiteral("(%1, id) %2 (?, ?)").arg(sortKey, QLatin1String(descending ? "<" : ">")));
+    const QString direction = descending ? QStringLiteral(" DESC") : QString();
+    return selectSql(conditions, bindValues, sortKey)
+           + QStringLiteral(" ORDER BY %1%2, id%2 LIMIT %3").arg(sortKey, direction).arg(m_pageSize);
+}
+
+bool ItemTableModel::readPage(QVector<RowValues> *rows, bool *extended, QString *errorMessage)
+{
+    rows->clear();
+    QVariantList bindValues;
+    const bool firstPage = m_lastPageId.isEmpty();
+    const QString sql = pageSql(!firstPage, &bindValues);
+    if (!firstPage)
+        bindValues << m_lastPageKey << m_lastPageId;
+
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    query.prepare(sql);
+    for (const QVariant &value : std::as_const(bindValues))
+        query.addBindValue(value);
+    if (!query.exec()) {
+        if (errorMessage)
+            *errorMessage = formatDbError(QObject::tr("Nie udało się wczytać strony listy eksponatów."),
+                                          query.lastError().text());
+        return false;
+    }
+
+    int fetched = 0;
+    RowValues values;
+    while (query.next()) {
+        ++fetched;
+        // Klucz strony z każdego wiersza — także pominiętego (martwe odwołanie do słownika).
+        m_lastPageKey = query.value(ColumnCount);
+        m_lastPageId = query.value(IdColumn).toString();
+        if (readRow(query, extended != nullptr, &values, extended))
+            rows->append(values);
+    }
+    m_hasMorePages = fetched == m_pageSize;
+    return true;
+}
+
+bool ItemTableModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && m_pageSize > 0 && m_hasMorePages;
+}
+
+void ItemTableModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent))
+        return;
+
+    QVector<RowValues> rows;
+    bool extended = false;
+    QString errorMessage;
+    if (!readPage(&rows, &extended, &errorMessage)) {
+        qDebug() << "ItemTableModel: błąd wczytywania strony:" << errorMessage;
+        m_hasMorePages = false;
+        return;
+    }
+    if (extended)
+        emit dictionaryNamesAdded();
+
+    // Rekordy dodane wcześniej przez refreshItems() są już w modelu.
+    rows.erase(std::remove_if(rows.begin(), rows.end(),
+                              [this](const RowValues &values) { return m_rowById.contains(values.id); }),
+               rows.end());
+    if (rows.isEmpty())
+        return;
+
+    const int firstRow = m_ids.size();
+    beginInsertRows(QModelIndex(), firstRow, firstRow + rows.size() - 1);
+    for (const RowValues &values : std::as_const(rows))
+        appendRow(values);
+    endInsertRows();
+}
+
+bool ItemTableModel::readRow(const QSqlQuery &query, bool fetchMissing, RowValues *values, bool *extended)
+{
+    constexpr int dictionaryColumns[DictionaryCount] = {
+        TypeColumn, VendorColumn, ModelColumn, StatusColumn, StorageColumn};
+    for (int dictionary = 0; dictionary < DictionaryCount; ++dictionary) {
+        values->nameIds[dictionary] = resolveDictionaryUuid(static_cast<Dictionary>(dictionary),
+                                                            query.value(dictionaryColumns[dictionary]).toString(),
+                                                            fetchMissing,
+                                                            extended);
+        if (values->nameIds[dictionary] < 0)
+            return false;
+    }
+
+    values->id = query.value(IdColumn).toString();
+    values->name = query.value(NameColumn).toString();
+    values->serialNumber = query.value(SerialNumberColumn).toString();
+    values->partNumber = query.value(PartNumberColumn).toString();
+    values->revision = query.value(RevisionColumn).toString();
+    values->description = query.value(DescriptionColumn).toString();
+
+    const QVariant productionYear = query.value(ProductionYearColumn);
+    values->productionYear = productionYear.isNull() ? kNullNumber : productionYear.toInt();
+    const QVariant value = query.value(ValueColumn);
+    values->value = value.isNull() ? kNullNumber : value.toInt();
+
+    values->flags = 0;
+    if (query.value(PackagingColumn).toInt() != 0)
+        values->flags |= OriginalPackagingFlag;
+    if (values->description.trimmed().isEmpty())
+        values->flags |= EmptyDescriptionFlag;
+    if (values->serialNumber.trimmed().isEmpty())
+        values->flags |= EmptySerialNumberFlag;
+    return true;
+}
+
+int ItemTableModel::resolveDictionaryUuid(Dictionary dictionary,
+                                          const QString &uuid,
+                                          bool fetchMissing,
+                                          bool *extended)
+{
+    DictionaryColumn &column = m_dictionaries[dictionary];
+    const auto it = column.nameIdByUuid.constFind(uuid);
+    if (it != column.nameIdByUuid.constEnd())
+        return it.value();
+    if (!fetchMissing)
+        return -1;
+
+    QSqlQuery query(m_db);
+    query.prepare(QStringLiteral("SELECT name FROM %1 WHERE id = :id")
+                      .arg(QLatin1String(kDictionaryTables[dictionary])));
+    query.bindValue(QStringLiteral(":id"), uuid);
+    if (!query.exec() || !query.next())
+        return -1;
+
+    const int namesBefore = column.names.size();
+    const int nameId = column.intern(query.value(0).toString());
+    column.nameIdByUuid.insert(uuid, nameId);
+    if (extended && column.names.size() != namesBefore)
+        *extended = true;
+    return nameId;
+}
+
+void ItemTableModel::appendRow(const RowValues &values)
+{
+    m_rowById.insert(values.id, m_ids.size());
+    m_ids.append(values.id);
+    m_names.append(values.name);
+    m_serialNumbers.append(values.serialNumber);
+    m_partNumbers.append(values.partNumber);
+    m_revisions.append(values.revision);
+    m_descriptions.append(values.description);
+    m_productionYears.append(values.productionYear);
+    m_values.append(values.value);
+    m_flags.append(values.flags);
+    for (int dictionary = 0; dictionary < DictionaryCount; ++dictionary)
+        m_dictionaries[dictionary].rows.append(values.nameIds[dictionary]);
+
+    const int docId = m_nextSearchDocId++;
+    m_searchDocIds.append(docId);
+    m_searchTexts.append(searchText(values));
+    m_searchIndex.setDocument(docId, m_searchTexts.last());
+    ++m_searchGeneration;
+    ++m_revision;
+}
+
+void ItemTableModel::assignRow(int row, const RowValues &values)
+{
+    m_names[row] = values.name;
+    m_serialNumbers[row] = values.serialNumber;
+    m_partNumbers[row] = values.partNumber;
+    m_revisions[row] = values.revision;
+    m_descriptions[row] = values.description;
+    m_productionYears[row] = values.productionYear;
+    m_values[row] = values.value;
+    m_flags[row] = values.flags;
+    for (int dictionary = 0; dictionary < DictionaryCount; ++dictionary)
+        m_dictionaries[dictionary].rows[row] = values.nameIds[dictionary];
+
+    m_searchTexts[row] = searchText(values);
+    m_searchIndex.setDocument(m_searchDocIds[row], m_searchTexts[row]);
+    ++m_searchGeneration;
+    ++m_revision;
+}
+
+QString ItemTableModel::searchText(const RowValues &values) const
+{
+    const QString fields[] = {
+        values.name,
+        m_dictionaries[VendorDictionary].names[values.nameIds[VendorDictionary]],
+        m_dictionaries[ModelDictionary].names[values.nameIds[ModelDictionary]],
+        values.serialNumber,
+        values.partNumber,
+        values.description,
+    };
+    QString text;
+    for (const QString &field : fields) {
+        if (!text.isEmpty())
+            text.append(QLatin1Char('\n'));
+        text.append(ItemSearchIndex::fold(field));
+    }
+    return text;
+}
+
+int ItemTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_ids.size();
+}
+
+int ItemTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant ItemTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || (role != Qt::DisplayRole && role != Qt::EditRole))
+        return {};
+
+    const int row = index.row();
+    if (row < 0 || row >= m_ids.size())
+        return {};
+
+    switch (index.column()) {
+    case IdColumn:
+        return m_ids[row];
+    case NameColumn:
+        return m_names[row];
+    case TypeColumn:
+        return m_dictionaries[TypeDictionary].names[dictionaryId(TypeDictionary, row)];
+    case VendorColumn:
+        return m_dictionaries[VendorDictionary].names[dictionaryId(VendorDictionary, row)];
+    case ModelColumn:
+        return m_dictionaries[ModelDictionary].names[dictionaryId(ModelDictionary, row)];
+    case SerialNumberColumn:
+        return m_serialNumbers[row];
+    case PartNumberColumn:
+        return m_partNumbers[row];
+    case RevisionColumn:
+        return m_revisions[row];
+    case ProductionYearColumn:
+        return m_productionYears[row] == kNullNumber ? QVariant() : QVariant(m_productionYears[row]);
+    case StatusColumn:
+        return m_dictionaries[StatusDictionary].names[dictionaryId(StatusDictionary, row)];
+    case StorageColumn:
+        return m_dictionaries[StorageDictionary].names[dictionaryId(StorageDictionary, row)];
+    case DescriptionColumn:
+        return m_descriptions[row];
+    case ValueColumn:
+        return m_values[row] == kNullNumber ? QVariant() : QVariant(m_values[row]);
+    case PackagingColumn:
+        return hasOriginalPackaging(row) ? 1 : 0;
+    default:
+        return {};
+    }
+}
+
+QVariant ItemTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QAbstractTableModel::headerData(section, orientation, role);
+
+    switch (section) {
+    case IdColumn:
+        return tr("ID");
+    case NameColumn:
+        return tr("Nazwa");
+    case TypeColumn:
+        return tr("Typ");
+    case VendorColumn:
+        return tr("Producent");
+    case ModelColumn:
+        return tr("Model");
+    case SerialNumberColumn:
+        return tr("Numer seryjny");
+    case PartNumberColumn:
+        return tr("Part number");
+    case RevisionColumn:
+        return tr("Revision");
+    case ProductionYearColumn:
+        return tr("Rok produkcji");
+    case StatusColumn:
+        return tr("Status");
+    case StorageColumn:
+        return tr("Miejsce przechowywania");
+    case DescriptionColumn:
+        return tr("Opis");
+    case ValueColumn:
+        return tr("Ilość");
+    case PackagingColumn:
+        return tr("Oryg. opak.");
+    default:
+        return {};
+    }
+}
+
+int ItemTableModel::findDictionaryName(Dictionary dictionary, const QString &name) const
+{
+    return m_dictionaries[dictionary].nameIdByName.value(name, -1);
+}
+
+QString ItemTableModel::dictionaryName(Dictionary dictionary, int nameId) const
+{
+    return m_dictionaries[dictionary].names.value(nameId);
+}
+
+bool ItemTableModel::isPlaceholderName(Dictionary dictionary, int nameId) const
+{
+    return m_dictionaries[dictionary].placeholders.value(nameId, 0) != 0;
+}
+
+QStringList ItemTableModel::dictionaryUuids(Dictionary dictionary, const QString &name) const
+{
+    const DictionaryColumn &column = m_dictionaries[dictionary];
+    const int nameId = column.nameIdByName.value(name, -1);
+    QStringList uuids;
+    for (auto it = column.nameIdByUuid.cbegin(); it != column.nameIdByUuid.cend(); ++it) {
+        if (it.value() == nameId)
+            uuids.append(it.key());
+    }
+    return uuids;
+}
+
+QStringList ItemTableModel::placeholderUuids(Dictionary dictionary) const
+{
+    const DictionaryColumn &column = m_dictionaries[dictionary];
+    QStringList uuids;
+    for (auto it = column.nameIdByUuid.cbegin(); it != column.nameIdByUuid.cend(); ++it) {
+        if (column.placeholders.value(it.value(), 0) != 0)
+            uuids.append(it.key());
+    }
+    return uuids;
+}
+
+bool ItemTableModel::rowContainsText(int row, const QString &text) const
+{
+    return rowContainsFoldedText(row, ItemSearchIndex::fold(text));
+}
@@ -0,0 +1,100 @@
+#include "PhotoBlobStore.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QObject>
+#include <QSaveFile>
+#include <QSettings>
+#include <QStandardPaths>
+
+PhotoBlobStore::PhotoBlobStore(const QString &rootDirectory)
+    : m_rootDirectory(rootDirectory.trimmed())
+{
+}
+
+QString PhotoBlobStore::directoryFromSettings()
+{
+    QSettings settings(QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation)
+                           + "/inwentaryzacja.ini",
+                       QSettings::IniFormat);
+    return settings.value("photos/blob_store_dir").toString().trimmed();
+}
+
+QString PhotoBlobStore::pathForHash(const QString &hash) const
+{
+    if (!isEnabled() || hash.size() < 4)
+        return QString();
+    return QDir(m_rootDirectory).filePath(hash.left(2) + QLatin1Char('/') + hash.mid(2, 2)
+                                          + QLatin1Char('/') + hash);
+}
+
+bool PhotoBlobStore::write(const QString &hash, const QByteArray &data, QString *errorMessage) const
+{
+    const QString path = pathForHash(hash);
+    if (path.isEmpty()) {
+        if (errorMessage)
+            *errorMessage = QObject::tr("Magazyn plików zdjęć nie jest skonfigurowany.");
+        return false;
+    }
+
+    // Zawsze zapisujemy od nowa, także gdy plik już jest: inne stanowisko mogło go
+    // właśnie usuwać (removeBlobFiles po zwolnieniu ostatniej referencji). QSaveFile
+    // podmienia plik atomowo, więc czytający widzą starą albo nową — tę samą — treść.
+    const QFileInfo existing(path);
+    if (!QDir().mkpath(existing.absolutePath())) {
+        if (errorMessage)
+            *errorMessage = QObject::tr("Nie udało się utworzyć katalogu:\n%1").arg(existing.absolutePath());
+        return false;
+    }
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        if (errorMessage)
+            *errorMessage = QObject::tr("Nie udało się zapisać pliku zdjęcia %1:\n%2").arg(path, file.errorString());
+        return false;
+    }
+    return true;
+}
+
+QByteArray PhotoBlobStore::read(const QString &hash, QString *errorMessage) const
+{
+    QFile file(pathForHash(hash));
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorMessage)
+            *errorMessage = QObject::tr("Nie udało się odczytać pliku zdjęcia %1:\n%2")
+                                .arg(file.fileName(), file.errorString());
+        return {};
+    }
+    return file.readAll();
+}
+
+bool PhotoBlobStore::readMapped(const QString &hash,
+                                const std::function<void(const QByteArray &)> &consumer,
+                                QString *errorMessage) const
+{
+    QFile file(pathForHash(hash));
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorMessage)
+            *errorMessage = QObject::tr("Nie udało się odczytać pliku zdjęcia %1:\n%2")
+                                .arg(file.fileName(), file.errorString());
+        return false;
+    }
+
+    uchar *mapped = file.size() > 0 ? file.map(0, file.size()) : nullptr;
+    if (!mapped) {
+        // Udziały sieciowe nie zawsze wspierają mmap — wtedy zwykły odczyt.
+        consumer(file.readAll());
+        return true;
+    }
+
+    consumer(QByteArray::fromRawData(reinterpret_cast<const char *>(mapped), file.size()));
+    file.unmap(mapped);
+    return true;
+}
+
+bool PhotoBlobStore::remove(const QString &hash) const
+{
+    const QString path = pathForHash(hash);
+    return !path.isEmpty() && QFile::remove(path);
+}
@@ -0,0 +1,149 @@
+#include "PhotoCache.h"
+
+#include <QMutexLocker>
+#include <QSettings>
+#include <QStandardPaths>
+
+PhotoCache::PhotoCache(qint64 budgetBytes)
+{
+    m_cache.setMaxCost(qMax<qint64>(0, budgetBytes));
+}
+
+PhotoCache &PhotoCache::instance()
+{
+    static PhotoCache cache;
+    return cache;
+}
+
+qint64 PhotoCache::budgetFromSettings()
+{
+    QSettings settings(QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation)
+                           + "/inwentaryzacja.ini",
+                       QSettings::IniFormat);
+    bool ok = false;
+    const qint64 budgetMb = settings.value("photos/cache_mb", kDefaultBudgetMb).toLongLong(&ok);
+    if (!ok || budgetMb < 0)
+        return qint64(kDefaultBudgetMb) * 1024 * 1024;
+    return budgetMb * 1024 * 1024;
+}
+
+QString PhotoCache::cacheKey(const QString &photoId, const QSize &size)
+{
+    if (!size.isValid())
+        return photoId;
+    return QStringLiteral("%1@%2x%3").arg(photoId).arg(size.width()).arg(size.height());
+}
+
+QImage PhotoCache::find(const QString &photoId, const QSize &size)
+{
+    QMutexLocker locker(&m_mutex);
+    // QCache::object przesuwa wpis na początek listy LRU.
+    if (const QImage *image = m_cache.object(cacheKey(photoId, size))) {
+        ++m_hits;
+        return *image;
+    }
+    ++m_misses;
+    return QImage();
+}
+
+bool PhotoCache::insert(const QString &photoId, const QImage &image, const QSize &size)
+{
+    if (photoId.isEmpty() || image.isNull())
+        return false;
+
+    QMutexLocker locker(&m_mutex);
+    return m_cache.insert(cacheKey(photoId, size), new QImage(image), image.sizeInBytes());
+}
+
+bool PhotoCache::findItemPhotos(const QString &itemId, QStringList *photoIds)
+{
+    QMutexLocker locker(&m_mutex);
+    const auto it = m_itemPhotos.constFind(itemId);
+    if (it == m_itemPhotos.constEnd())
+        return false;
+    if (photoIds)
+        *photoIds = it.value();
+    return true;
+}
+
+void PhotoCache::setItemPhotos(const QString &itemId, const QStringList &photoIds)
+{
+    QMutexLocker locker(&m_mutex);
+    m_itemPhotos.insert(itemId, photoIds);
+}
+
+void PhotoCache::invalidatePhoto(const QString &photoId)
+{
+    QMutexLocker locker(&m_mutex);
+    removePhotoLocked(photoId);
+    for (auto it = m_itemPhotos.begin(); it != m_itemPhotos.end();) {
+        if (it.value().contains(photoId))
+            it = m_itemPhotos.erase(it);
+        else
+            ++it;
+    }
+}
+
+void PhotoCache::invalidateItem(const QString &itemId, const QStringList &photoIds)
+{
+    QMutexLocker locker(&m_mutex);
+    QStringList toRemove = photoIds;
+    toRemove += m_itemPhotos.take(itemId);
+    for (const QString &photoId : std::as_const(toRemove))
+        removePhotoLocked(photoId);
+}
+
+void PhotoCache::removePhotoLocked(const QString &photoId)
+{
+    // Rozmiary nie są indeksowane osobno — przeglądamy klucze (setki wpisów, nie miliony).
+    const QString sizedPrefix = photoId + QLatin1Char('@');
+    const QList<QString> keys = m_cache.keys();
+    for (const QString &key : keys) {
+        if (key == photoId || key.startsWith(sizedPrefix))
+            m_cache.remove(key);
+    }
+}
+
+void PhotoCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_cache.clear();
+    m_itemPhotos.clear();
+}
+
+PhotoCache::Stats PhotoCache::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    Stats result;
+    result.hits = m_hits;
+    result.misses = m_misses;
+    result.usedBytes = m_cache.totalCost();
+    result.budgetBytes = m_cache.maxCost();
+    result.entries = m_cache.count();
+    return result;
+}
+
+void PhotoCache::resetStats()
+{
+    QMutexLocker locker(&m_mutex);
+    m_hits = 0;
+    m_misses = 0;
+}
+
+qint64 PhotoCache::budgetBytes() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cache.maxCost();
+}
+
+qint64 PhotoCache::usedBytes() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cache.totalCost();
+}
+
+int PhotoCache::count() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cache.count();
+}
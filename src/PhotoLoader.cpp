@@ -0,0 +1,207 @@
+#include "PhotoLoader.h"
+
+#include "DatabaseConnectionPool.h"
+#include "PhotoCache.h"
+#include "PhotoService.h"
+
+#include <QDebug>
+#include <QHash>
+#include <QMetaObject>
+#include <QSqlDatabase>
+
+namespace {
+
+/// Żyje w PhotoLoader::m_dbThread; tylko ten wątek dotyka połączenia roboczego.
+class PhotoLoaderWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    PhotoLoaderWorker(const QString &sourceConnectionName,
+                      std::shared_ptr<std::atomic<quint64>> generation,
+                      QThreadPool *decodePool,
+                      PhotoLoader *loader)
+        : m_sourceConnectionName(sourceConnectionName)
+        , m_generation(std::move(generation))
+        , m_decodePool(decodePool)
+        , m_loader(loader)
+    {
+    }
+
+    void fetch(quint64 requestId, const QString &itemId, int size)
+    {
+        if (isStale(requestId))
+            return;
+
+        // Lista ID zawsze z bazy — na wspólnej bazie MySQL zdjęcia mogą dojść albo zniknąć
+        // na innym stanowisku. Z PhotoCache bierzemy tylko zdekodowane obrazy; gdy są
+        // wszystkie, miniatury nie są nawet pobierane.
+        PhotoCache &cache = PhotoCache::instance();
+        const QSize thumbnailSize(size, size);
+        QString errorMessage;
+        QStringList photoIds;
+        QHash<QString, QImage> cachedImages;
+        QList<StoredPhotoData> thumbnails;
+        {
+            // Połączenie wątku zostaje w puli do następnego żądania.
+            const PooledConnection connection = DatabaseConnectionPool::instance(m_sourceConnectionName)
+                                                    .acquire(&errorMessage);
+            if (!connection.isValid()) {
+                emit loadFailed(requestId, errorMessage);
+                return;
+            }
+            const PhotoService photoService(connection.database());
+            photoIds = photoService.loadPhotoIds(itemId, &errorMessage);
+            if (errorMessage.isEmpty()) {
+                for (const QString &photoId : std::as_const(photoIds)) {
+                    const QImage image = cache.find(photoId, thumbnailSize);
+                    if (!image.isNull())
+                        cachedImages.insert(photoId, image);
+                }
+                if (cachedImages.size() != photoIds.size() && !isStale(requestId)) {
+                    thumbnails = photoService.loadThumbnailData(itemId, size, &errorMessage);
+                    photoIds.clear();
+                    for (const StoredPhotoData &thumbnail : std::as_const(thumbnails))
+                        photoIds.append(thumbnail.id);
+                }
+            }
+        }
+        if (isStale(requestId))
+            return;
+        if (!errorMessage.isEmpty()) {
+            emit loadFailed(requestId, errorMessage);
+            return;
+        }
+
+        cache.setItemPhotos(itemId, photoIds);
+        emit photosListed(requestId, itemId, photoIds);
+
+        // photosListed i photoReady trafiają do tej samej kolejki zdarzeń wątku GUI,
+        // więc placeholdery zawsze powstają przed pierwszym obrazem.
+        for (auto it = cachedImages.constBegin(); it != cachedImages.constEnd(); ++it) {
+            if (photoIds.contains(it.key()))
+                deliver(m_loader, requestId, it.key(), it.value());
+        }
+
+        const std::shared_ptr<std::atomic<quint64>> generation = m_generation;
+        PhotoLoader *loader = m_loader;
+        for (const StoredPhotoData &thumbnail : std::as_const(thumbnails)) {
+            if (cachedImages.contains(thumbnail.id))
+                continue;
+            m_decodePool->start([generation, loader, requestId, thumbnailSize, thumbnail]()
+                                {
+                if (generation->load() != requestId)
+                    return;
+
+                const QImage image = QImage::fromData(thumbnail.data);
+                if (image.isNull()) {
+                    qDebug() << "PhotoLoader: nie można zdekodować miniatury" << thumbnail.id;
+                    return;
+                }
+                // Do cache także wtedy, gdy żądanie już nieaktualne — dekodowanie i tak się odbyło.
+                PhotoCache::instance().insert(thumbnail.id, image, thumbnailSize);
+                if (generation->load() != requestId)
+                    return;
+                deliver(loader, requestId, thumbnail.id, image); });
+        }
+    }
+
+    void closeConnection()
+    {
+        DatabaseConnectionPool::instance(m_sourceConnectionName).closeThreadConnection();
+    }
+
+signals:
+    void photosListed(quint64 requestId, const QString &itemId, const QStringList &photoIds);
+    void loadFailed(quint64 requestId, const QString &errorMessage);
+
+private:
+    bool isStale(quint64 requestId) const { return m_generation->load() != requestId; }
+
+    /// Emisja photoReady w wątku GUI. Kontekst = loader: zdarzenie zostanie odrzucone,
+    /// jeśli loader zginie.
+    static void deliver(PhotoLoader *loader, quint64 requestId, const QString &photoId, const QImage &image)
+    {
+        QMetaObject::invokeMethod(loader,
+                                  [loader, requestId, photoId, image]()
+                                  {
+            if (loader->currentRequestId() == requestId)
+                emit loader->photoReady(requestId, photoId, image); },
+                                  Qt::QueuedConnection);
+    }
+
+    QString m_sourceConnectionName;
+    std::shared_ptr<std::atomic<quint64>> m_generation;
+    QThreadPool *m_decodePool;
+    PhotoLoader *m_loader;
+};
+
+}
+
+PhotoLoader::PhotoLoader(const QString &connectionName, QObject *parent)
+    : QObject(parent)
+    , m_generation(std::make_shared<std::atomic<quint64>>(0))
+{
+    // Dekodowanie miniatur jest krótkie — kilka wątków wystarcza, a nie zabieramy
+    // całej maszyny innym pracom w tle (backup, backfill miniatur).
+    m_decodePool.setMaxThreadCount(qBound(1, QThread::idealThreadCount() - 1, 4));
+
+    auto *worker = new PhotoLoaderWorker(connectionName, m_generation, &m_decodePool, this);
+    worker->moveToThread(&m_dbThread);
+    m_worker = worker;
+
+    connect(worker, &PhotoLoaderWorker::photosListed, this,
+            [this](quint64 requestId, const QString &itemId, const QStringList &photoIds)
+            {
+        if (requestId == currentRequestId())
+            emit photosListed(requestId, itemId, photoIds); });
+    connect(worker, &PhotoLoaderWorker::loadFailed, this,
+            [this](quint64 requestId, const QString &errorMessage)
+            {
+        if (requestId == currentRequestId())
+            emit loadFailed(requestId, errorMessage); });
+
+    m_dbThread.setObjectName(QStringLiteral("PhotoLoaderDb"));
+    m_dbThread.start();
+}
+
+PhotoLoader::~PhotoLoader()
+{
+    m_generation->fetch_add(1);
+    m_decodePool.clear();
+
+    auto *worker = static_cast<PhotoLoaderWorker *>(m_worker);
+    QMetaObject::invokeMethod(worker, [worker]() { worker->closeConnection(); }, Qt::BlockingQueuedConnection);
+    m_dbThread.quit();
+    m_dbThread.wait();
+    delete m_worker;
+    m_worker = nullptr;
+
+    m_decodePool.waitForDone();
+}
+
+quint64 PhotoLoader::requestThumbnails(const QString &itemId, int size)
+{
+    const quint64 requestId = m_generation->fetch_add(1) + 1;
+    m_decodePool.clear();
+
+    auto *worker = static_cast<PhotoLoaderWorker *>(m_worker);
+    QMetaObject::invokeMethod(worker,
+                              [worker, requestId, itemId, size]()
+                              { worker->fetch(requestId, itemId, size); },
+                              Qt::QueuedConnection);
+    return requestId;
+}
+
+void PhotoLoader::cancel()
+{
+    m_generation->fetch_add(1);
+    m_decodePool.clear();
+}
+
+quint64 PhotoLoader::currentRequestId() const
+{
+    return m_generation->load();
+}
+
+#include "PhotoLoader.moc"
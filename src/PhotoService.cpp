@@ -1,48 +1,588 @@
 #include "PhotoService.h"
 
+#include "PhotoBlobStore.h"
+#include "PhotoCache.h"
+#include "PreparedStatementCache.h"
+
+#include <QBuffer>
+#include <QCryptographicHash>
 #include <QDebug>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QHash>
+#include <QImage>
+#include <QImageReader>
+#include <QImageWriter>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
+#include <QSettings>
 #include <QSqlError>
 #include <QSqlQuery>
+#include <QStandardPaths>
+#include <QThread>
+#include <QThreadPool>
+#include <QTransform>
+#include <QUuid>
+#include <QVariant>
+
+#include <atomic>
 
 namespace {
 
+// v1.5: nowe zdjęcia leżą w photo_blobs (deduplikacja po SHA-256), stare — w photos.photo.
+constexpr const char *kPhotoBlobJoin = "LEFT JOIN photo_blobs ON photo_blobs.hash = photos.blob_hash";
+constexpr const char *kPhotoDataColumn = "COALESCE(photo_blobs.data, photos.photo)";
+
+/// v1.5: wierszy w jednym wielowierszowym INSERT — 6 kolumn × 150 mieści się w limicie
+/// 999 parametrów SQLite.
+constexpr int kMaxRowsPerStatement = 150;
+/// Bajtów danych w jednym INSERT dla SQLite (brak limitu pakietu — ograniczamy pamięć).
+constexpr qint64 kSqliteStatementBytes = 32 * 1024 * 1024;
+/// max_allowed_packet przyjmowany, gdy serwera nie da się zapytać (domyślny MySQL 5.7).
+constexpr qint64 kDefaultMaxAllowedPacket = 4 * 1024 * 1024;
+
 QString formatDbError(const QString &context, const QString &details)
 {
     return QObject::tr("%1\n%2").arg(context, details);
 }
 
+/// Przekształcenie współrzędnych obrazu zapisanego w pliku (`storedSize`) na obraz po
+/// orientacji EXIF — w tej samej kolejności co QImageReader: odbicia, potem obrót.
+QTransform orientationTransform(QImageIOHandler::Transformations transformation, const QSize &storedSize)
+{
+    const qreal width = storedSize.width();
+    const qreal height = storedSize.height();
+    if (transformation == QImageIOHandler::TransformationRotate270)
+        return QTransform(0, -1, 1, 0, 0, width);
+
+    QTransform transform;
+    if (transformation.testFlag(QImageIOHandler::TransformationMirror))
+        transform *= QTransform(-1, 0, 0, 1, width, 0);
+    if (transformation.testFlag(QImageIOHandler::TransformationFlip))
+        transform *= QTransform(1, 0, 0, -1, 0, height);
+    if (transformation.testFlag(QImageIOHandler::TransformationRotate90))
+        transform *= QTransform(0, 1, -1, 0, height, 0);
+    return transform;
+}
+
+/// Odczytane budżety według nazwy połączenia; czyszczone przez
+/// PhotoService::releaseStatementBudget / clearStatementBudgets.
+QMutex &budgetMutex()
+{
+    static QMutex mutex;
+    return mutex;
+}
+
+QHash<QString, qint64> &budgetCache()
+{
+    static QHash<QString, qint64> budgets;
+    return budgets;
+}
+
+/// Budżet bajtów na jedno zapytanie: połowa max_allowed_packet (zapas na nagłówki
+/// protokołu i pozostałe kolumny), odczytana raz na otwarte połączenie.
+qint64 statementByteBudget(QSqlDatabase &db)
+{
+    if (!db.driverName().contains(QStringLiteral("QMYSQL"), Qt::CaseInsensitive))
+        return kSqliteStatementBytes;
+
+    const QMutexLocker locker(&budgetMutex());
+    QHash<QString, qint64> &budgets = budgetCache();
+    const auto it = budgets.constFind(db.connectionName());
+    if (it != budgets.constEnd())
+        return it.value();
+
+    qint64 maxAllowedPacket = kDefaultMaxAllowedPacket;
+    QSqlQuery query(db);
+    if (query.exec(QStringLiteral("SELECT @@max_allowed_packet")) && query.next())
+        maxAllowedPacket = qMax<qint64>(query.value(0).toLongLong(), 1024 * 1024);
+    else
+        qDebug() << "Nie udało się odczytać max_allowed_packet:" << query.lastError().text();
+
+    const qint64 budget = maxAllowedPacket / 2;
+    budgets.insert(db.connectionName(), budget);
+    return budget;
+}
+
+/// v1.5: wielowierszowy INSERT składany z kolejnych wierszy — zapytanie jest wysyłane,
+/// gdy paczka osiągnie kMaxRowsPerStatement wierszy albo `byteBudget` bajtów danych.
+/// Wiersz większy niż budżet idzie sam.
+class MultiRowInsert
+{
+public:
+    MultiRowInsert(QSqlDatabase &db,
+                   const QString &insertSql,
+                   const QString &rowPlaceholders,
+                   qint64 byteBudget,
+                   const QString &errorContext)
+        : m_db(db)
+        , m_insertSql(insertSql)
+        , m_rowPlaceholders(rowPlaceholders)
+        , m_byteBudget(byteBudget)
+        , m_errorContext(errorContext)
+    {
+    }
+
+    bool addRow(const QVariantList &values, qint64 bytes, QString *errorMessage)
+    {
+        if (!m_rows.isEmpty()
+            && (m_rows.size() >= kMaxRowsPerStatement || m_bytes + bytes > m_byteBudget)
+            && !flush(errorMessage))
+            return false;
+        m_rows.append(values);
+        m_bytes += bytes;
+        return true;
+    }
+
+    bool flush(QString *errorMessage)
+    {
+        if (m_rows.isEmpty())
+            return true;
+
+        QStringList rows;
+        rows.reserve(m_rows.size());
+        for (int row = 0; row < m_rows.size(); ++row)
+            rows.append(m_rowPlaceholders);
+        QSqlQuery query(m_db);
+        query.prepare(m_insertSql + QLatin1Char(' ') + rows.join(QStringLiteral(", ")));
+        int position = 0;
+        for (const QVariantList &values : std::as_const(m_rows)) {
+            for (const QVariant &value : values)
+                query.bindValue(position++, value);
+        }
+        m_rows.clear();
+        m_bytes = 0;
+
+        if (!query.exec()) {
+            if (errorMessage)
+                *errorMessage = formatDbError(m_errorContext, query.lastError().text());
+            return false;
+        }
+        return true;
+    }
+
+private:
+    QSqlDatabase &m_db;
+    QString m_insertSql;
+    QString m_rowPlaceholders;
+    qint64 m_byteBudget;
+    QString m_errorContext;
+    QList<QVariantList> m_rows;
+    qint64 m_bytes = 0;
+};
+
+QByteArray encodeThumbnail(const QImage &image, int size)
+{
+    if (image.isNull() || size <= 0)
+        return {};
+
+    // Miniatury nigdy nie są powiększane — małe zdjęcia zapisujemy 1:1.
+    const QImage scaled = (image.width() > size || image.height() > size)
+                              ? image.scaled(size, size, Qt::KeepAspectRatio, Qt::SmoothTransformation)
+                              : image;
+
+    QByteArray bytes;
+    QBuffer buffer(&bytes);
+    buffer.open(QIODevice::WriteOnly);
+    const bool saved = scaled.hasAlphaChannel() ? scaled.save(&buffer, "PNG")
+                                                : scaled.save(&buffer, "JPG", 85);
+    if (!saved)
+        return {};
+    return bytes;
+}
+
+QHash<int, QByteArray> encodeAllThumbnails(const QByteArray &photoData)
+{
+    QHash<int, QByteArray> thumbnails;
+    // Dekodujemy od razu do największej miniatury — pełna bitmapa aparatu
+    // (24 Mpx ≈ 100 MB RGBA) nigdy nie powstaje.
+    int largestSize = 0;
+    for (int size : PhotoService::thumbnailSizes())
+        largestSize = qMax(largestSize, size);
+    const QImage image = PhotoService::decodeScaled(photoData, QSize(largestSize, largestSize));
+    if (image.isNull())
+        return thumbnails;
+
+    for (int size : PhotoService::thumbnailSizes()) {
+        const QByteArray encoded = encodeThumbnail(image, size);
+        if (!encoded.isEmpty())
+            thumbnails.insert(size, encoded);
+    }
+    return thumbnails;
+}
+
+bool writeThumbnails(QSqlDatabase &db,
+                     const QString &photoId,
+                     const QHash<int, QByteArray> &thumbnails,
+                     QString *errorMessage)
+{
+    for (auto it = thumbnails.cbegin(); it != thumbnails.cend(); ++it) {
+        // REPLACE INTO działa w SQLite i MySQL — backfill w tle i zapis z UI
+        // mogą trafić na ten sam (photo_id, size_px) bez błędu klucza.
+        PreparedStatement query = PreparedStatementCache::instance().prepare(
+            db, "REPLACE INTO photo_thumbnails (photo_id, size_px, thumbnail) "
+                "VALUES (:photoId, :size, :thumbnail)");
+        query->bindValue(":photoId", photoId);
+        query->bindValue(":size", it.key());
+        query->bindValue(":thumbnail", it.value());
+        if (!query->exec()) {
+            if (errorMessage)
+                *errorMessage = formatDbError(QObject::tr("Nie udało się zapisać miniatury zdjęcia."),
+                                              query->lastError().text());
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Przekazuje treść zdjęcia do `consumer` — z bazy (photo_blobs.data / photos.photo)
+/// albo zmapowaną z PhotoBlobStore, gdy blob jest zewnętrzny.
+bool withPhotoData(QSqlDatabase &db,
+                   const PhotoBlobStore &blobStore,
+                   const QString &photoId,
+                   const std::function<void(const QByteArray &)> &consumer,
+                   QString *errorMessage)
+{
+    QString hash;
+    bool external = false;
+    QByteArray data;
+    {
+        PreparedStatement query = PreparedStatementCache::instance().prepare(
+            db, "SELECT photos.blob_hash, COALESCE(photo_blobs.external, 0), "
+                + QString::fromLatin1(kPhotoDataColumn) + " FROM photos "
+                + QString::fromLatin1(kPhotoBlobJoin) + " WHERE photos.id = :id");
+        query->bindValue(":id", photoId);
+        if (!query->exec()) {
+            if (errorMessage)
+                *errorMessage = formatDbError(QObject::tr("Nie udało się odczytać zdjęcia."),
+                                              query->lastError().text());
+            return false;
+        }
+        if (!query->next()) {
+            if (errorMessage)
+                *errorMessage = QObject::tr("Zdjęcie o podanym ID nie istnieje.");
+            return false;
+        }
+        hash = query->value(0).toString();
+        external = query->value(1).toInt() != 0;
+        if (!external)
+            data = query->value(2).toByteArray();
+    }
+
+    if (!external) {
+        consumer(data);
+        return true;
+    }
+
+    if (!blobStore.isEnabled()) {
+        if (errorMessage)
+            *errorMessage = QObject::tr("Zdjęcie leży w magazynie plików, a katalog "
+                                        "photos/blob_store_dir nie jest ustawiony.");
+        return false;
+    }
+    return blobStore.readMapped(hash, consumer, errorMessage);
+}
+
+QByteArray fetchPhotoData(QSqlDatabase &db,
+                          const PhotoBlobStore &blobStore,
+                          const QString &photoId,
+                          QString *errorMessage)
+{
+    QByteArray data;
+    // Kopia jest tu konieczna — wywołujący trzyma dane dłużej niż mapowanie pliku.
+    withPhotoData(db, blobStore, photoId,
+                  [&data](const QByteArray &bytes) { data = QByteArray(bytes.constData(), bytes.size()); },
+                  errorMessage);
+    return data;
+}
+
 }
 
-PhotoService::PhotoService(QSqlDatabase database)
+PhotoService::PhotoService(QSqlDatabase database, const PhotoBlobStore &blobStore)
     : m_db(database)
+    , m_blobStore(blobStore)
+{
+}
+
+QList<int> PhotoService::thumbnailSizes()
+{
+    return {kListThumbnailSize, kPreviewThumbnailSize};
+}
+
+QByteArray PhotoService::createThumbnail(const QByteArray &photoData, int size)
+{
+    return encodeThumbnail(decodeScaled(photoData, QSize(size, size)), size);
+}
+
+QImage PhotoService::decodeScaled(const QByteArray &photoData, const QSize &bounds)
+{
+    QBuffer buffer;
+    buffer.setData(photoData);
+    if (!buffer.open(QIODevice::ReadOnly))
+        return {};
+
+    QImageReader reader(&buffer);
+    reader.setAutoTransform(true);
+
+    const QSize sourceSize = reader.size();
+    if (bounds.isValid() && sourceSize.isValid()) {
+        // setScaledSize działa na obrazie zapisanym w pliku, a orientacja EXIF
+        // jest nakładana po nim — dla obrotu o 90° zamieniamy osie ramki.
+        QSize storedBounds = bounds;
+        if (reader.transformation() & QImageIOHandler::TransformationRotate90)
+            storedBounds.transpose();
+
+        if (sourceSize.width() > storedBounds.width() || sourceSize.height() > storedBounds.height())
+            reader.setScaledSize(sourceSize.scaled(storedBounds, Qt::KeepAspectRatio));
+    }
+
+    const QImage image = reader.read();
+    if (image.isNull())
+        qDebug() << "Nie można zdekodować zdjęcia:" << reader.errorString();
+    return image;
+}
+
+QSize PhotoService::imageSize(const QByteArray &photoData, bool *transformed)
+{
+    QBuffer buffer;
+    buffer.setData(photoData);
+    if (!buffer.open(QIODevice::ReadOnly))
+        return {};
+    QImageReader reader(&buffer);
+    reader.setAutoTransform(true);
+    if (transformed)
+        *transformed = reader.transformation() != QImageIOHandler::TransformationNone;
+    QSize size = reader.size();
+    if (reader.transformation() & QImageIOHandler::TransformationRotate90)
+        size.transpose();
+    return size;
+}
+
+QImage PhotoService::decodeRegion(const QByteArray &photoData, const QRect &region, const QSize &targetSize)
 {
+    QBuffer buffer;
+    buffer.setData(photoData);
+    if (!buffer.open(QIODevice::ReadOnly))
+        return {};
+
+    // Bez autoTransform: clip rect dotyczy obrazu zapisanego w pliku.
+    QImageReader reader(&buffer);
+    reader.setClipRect(region);
+    if (targetSize.isValid() && targetSize != region.size())
+        reader.setScaledSize(targetSize);
+    const QImage image = reader.read();
+    if (image.isNull())
+        qDebug() << "Nie można zdekodować fragmentu zdjęcia:" << reader.errorString();
+    return image;
+}
+
+QImage PhotoService::decodeOrientedRegion(const QByteArray &photoData, const QRect &region, const QSize &targetSize)
+{
+    QSize storedSize;
+    QImageIOHandler::Transformations transformation = QImageIOHandler::TransformationNone;
+    {
+        QBuffer buffer;
+        buffer.setData(photoData);
+        if (!buffer.open(QIODevice::ReadOnly))
+            return {};
+        QImageReader reader(&buffer);
+        reader.setAutoTransform(true);
+        storedSize = reader.size();
+        transformation = reader.transformation();
+    }
+    if (transformation == QImageIOHandler::TransformationNone)
+        return decodeRegion(photoData, region, targetSize);
+
+    const QRect storedRegion = orientationTransform(transformation, storedSize)
+                                   .inverted()
+                                   .mapRect(QRectF(region))
+                                   .toAlignedRect()
+                               & QRect(QPoint(), storedSize);
+    QSize storedTargetSize = targetSize;
+    if (transformation.testFlag(QImageIOHandler::TransformationRotate90))
+        storedTargetSize.transpose();
+
+    const QImage tile = decodeRegion(photoData, storedRegion, storedTargetSize);
+    if (tile.isNull())
+        return tile;
+    if (transformation == QImageIOHandler::TransformationRotate270)
+        return tile.transformed(QTransform().rotate(270));
+    const QImage mirrored = tile.mirrored(transformation.testFlag(QImageIOHandler::TransformationMirror),
+                                          transformation.testFlag(QImageIOHandler::TransformationFlip));
+    if (transformation.testFlag(QImageIOHandler::TransformationRotate90))
+        return mirrored.transformed(QTransform().rotate(90));
+    return mirrored;
+}
+
+PhotoIngestOptions PhotoIngestOptions::fromSettings()
+{
+    QSettings settings(QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation)
+                           + "/inwentaryzacja.ini",
+                       QSettings::IniFormat);
+    PhotoIngestOptions options;
+    options.enabled = settings.value("photos/ingest_enabled", options.enabled).toBool();
+    options.maxLongEdge = qMax(0, settings.value("photos/ingest_max_edge", options.maxLongEdge).toInt());
+    options.quality = qBound(1, settings.value("photos/ingest_quality", options.quality).toInt(), 100);
+    options.archiveDirectory = settings.value("photos/archive_dir").toString().trimmed();
+
+    const QByteArray format = settings.value("photos/ingest_format", "jpg").toString().trimmed().toUpper().toLatin1();
+    if (format == "WEBP" && QImageWriter::supportedImageFormats().contains("webp"))
+        options.format = "WEBP";
+    else if (format != "JPG" && format != "JPEG")
+        qDebug() << "photos/ingest_format" << format << "niedostępny — używam JPG";
+    return options;
+}
+
+QByteArray PhotoService::normalizePhoto(const QByteArray &photoData,
+                                        const PhotoIngestOptions &options,
+                                        bool *normalized)
+{
+    if (normalized)
+        *normalized = false;
+    if (!options.enabled || photoData.isEmpty())
+        return photoData;
+
+    const QSize bounds = options.maxLongEdge > 0 ? QSize(options.maxLongEdge, options.maxLongEdge) : QSize();
+    const QImage image = decodeScaled(photoData, bounds);
+    if (image.isNull())
+        return photoData;
+
+    QByteArray encoded;
+    QBuffer buffer(&encoded);
+    buffer.open(QIODevice::WriteOnly);
+    const bool saved = image.hasAlphaChannel() ? image.save(&buffer, "PNG")
+                                               : image.save(&buffer, options.format.constData(), options.quality);
+    if (!saved || encoded.isEmpty())
+        return photoData;
+
+    // Zrzut ekranu w PNG potrafi urosnąć po konwersji do JPEG — wtedy zostaje
+    // oryginał (orientację EXIF i tak nakłada decodeScaled przy wyświetlaniu), ale
+    // tylko gdy mieści się w maxLongEdge: limit wymiarów ma pierwszeństwo przed rozmiarem.
+    if (encoded.size() >= photoData.size()) {
+        const QSize originalSize = imageSize(photoData);
+        const bool fits = options.maxLongEdge <= 0
+                          || (originalSize.isValid()
+                              && qMax(originalSize.width(), originalSize.height()) <= options.maxLongEdge);
+        if (fits)
+            return photoData;
+    }
+
+    if (normalized)
+        *normalized = true;
+    return encoded;
+}
+
+QList<IngestedPhoto> PhotoService::ingestFiles(const QStringList &paths,
+                                               const PhotoIngestOptions &options,
+                                               qint64 *bytesSaved,
+                                               const std::function<bool(int, int, qint64)> &progressCallback)
+{
+    QList<IngestedPhoto> results(paths.size());
+
+    std::atomic<int> completed{0};
+    std::atomic<qint64> bytesRead{0};
+    std::atomic<bool> cancelled{false};
+    const int total = paths.size();
+
+    // Każdy wątek pisze tylko do swojego elementu — bez blokad. Miniatury i skrót
+    // liczymy tutaj, żeby zapis w wątku GUI robił już tylko INSERT-y.
+    QThreadPool pool;
+    pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount()));
+    for (int i = 0; i < paths.size(); ++i) {
+        IngestedPhoto *result = &results[i];
+        result->sourcePath = paths.at(i);
+        pool.start([result, &options, &completed, &bytesRead, &cancelled, &progressCallback, total]()
+                   {
+            if (cancelled.load())
+                return;
+
+            QFile file(result->sourcePath);
+            if (!file.open(QIODevice::ReadOnly)) {
+                result->errorMessage = file.errorString();
+            } else {
+                const QByteArray original = file.readAll();
+                result->originalBytes = original.size();
+                result->data = normalizePhoto(original, options, &result->normalized);
+                result->contentHash = contentHash(result->data);
+                result->thumbnails = encodeAllThumbnails(result->data);
+            }
+
+            const int done = completed.fetch_add(1) + 1;
+            const qint64 read = bytesRead.fetch_add(result->originalBytes) + result->originalBytes;
+            if (progressCallback && !progressCallback(done, total, read))
+                cancelled.store(true); });
+    }
+    pool.waitForDone();
+
+    if (bytesSaved) {
+        *bytesSaved = 0;
+        for (const IngestedPhoto &result : std::as_const(results)) {
+            if (result.errorMessage.isEmpty() && !result.data.isEmpty())
+                *bytesSaved += result.originalBytes - result.data.size();
+        }
+    }
+    return results;
+}
+
+QStringList PhotoService::archiveOriginals(const QStringList &photoPaths, const QString &archiveDirectory)
+{
+    QStringList failures;
+    if (archiveDirectory.isEmpty() || photoPaths.isEmpty())
+        return failures;
+
+    if (!QDir().mkpath(archiveDirectory)) {
+        for (const QString &path : photoPaths)
+            failures.append(QFileInfo(path).fileName());
+        return failures;
+    }
+
+    const QDir dir(archiveDirectory);
+    for (const QString &path : photoPaths) {
+        const QFileInfo fileInfo(path);
+        QString destination = dir.filePath(fileInfo.fileName());
+        for (int suffix = 1; QFileInfo::exists(destination); ++suffix) {
+            destination = dir.filePath(QStringLiteral("%1_%2.%3")
+                                           .arg(fileInfo.completeBaseName())
+                                           .arg(suffix)
+                                           .arg(fileInfo.suffix()));
+        }
+        if (!QFile::copy(path, destination))
+            failures.append(fileInfo.fileName());
+    }
+    return failures;
 }
 
 QList<StoredPhoto> PhotoService::loadStoredPhotos(const QString &itemId, QString *errorMessage) const
 {
     QList<StoredPhoto> photos;
-    QSqlQuery query(m_db);
-    query.prepare("SELECT id, photo FROM photos WHERE eksponat_id = :id");
-    query.bindValue(":id", itemId);
-    if (!query.exec()) {
+    PreparedStatement query = PreparedStatementCache::instance().prepare(
+        m_db, "SELECT photos.id AS id, photos.blob_hash AS blob_hash, "
+              "COALESCE(photo_blobs.external, 0) AS external, "
+              + QString::fromLatin1(kPhotoDataColumn) + " AS photo FROM photos "
+              + QString::fromLatin1(kPhotoBlobJoin) + " WHERE photos.eksponat_id = :id");
+    query->bindValue(":id", itemId);
+    if (!query->exec()) {
         if (errorMessage)
             *errorMessage = formatDbError(QObject::tr("Nie udało się odczytać zdjęć eksponatu."),
-                                          query.lastError().text());
+                                          query->lastError().text());
         return photos;
     }
 
-    while (query.next()) {
+    while (query->next()) {
         QPixmap pixmap;
-        if (!pixmap.loadFromData(query.value("photo").toByteArray())) {
-            qDebug() << "Nie można załadować BLOB zdjęcia";
+        QString readError;
+        const QByteArray data = query->value("external").toInt() != 0
+                                    ? m_blobStore.read(query->value("blob_hash").toString(), &readError)
+                                    : query->value("photo").toByteArray();
+        if (!pixmap.loadFromData(data)) {
+            qDebug() << "Nie można załadować BLOB zdjęcia" << readError;
             continue;
         }
 
         StoredPhoto photo;
-        photo.id = query.value("id").toString();
+        photo.id = query->value("id").toString();
         photo.pixmap = pixmap;
         photos.append(photo);
     }
@@ -52,17 +592,872 @@ QList<StoredPhoto> PhotoService::loadStoredPhotos(const QString &itemId, QString
     return photos;
 }
 
-QList<QPixmap> PhotoService::loadPixmapsFromBuffer(const QList<QByteArray> &photoBuffer) const
+QList<StoredPhoto> PhotoService::loadThumbnails(const QString &itemId, int size, QString *errorMessage) const
+{
+    QList<StoredPhoto> photos;
+    const QList<StoredPhotoData> thumbnails = loadThumbnailData(itemId, size, errorMessage);
+    for (const StoredPhotoData &thumbnail : thumbnails) {
+        StoredPhoto photo;
+        photo.id = thumbnail.id;
+        if (!photo.pixmap.loadFromData(thumbnail.data)) {
+            qDebug() << "Nie można załadować miniatury zdjęcia" << photo.id;
+            continue;
+        }
+        photos.append(photo);
+    }
+    return photos;
+}
+
+QList<StoredPhotoData> PhotoService::loadThumbnailData(const QString &itemId,
+                                                       int size,
+                                                       QString *errorMessage) const
+{
+    QList<StoredPhotoData> thumbnails;
+    {
+        PreparedStatement query = PreparedStatementCache::instance().prepare(m_db, R"(
+            SELECT photos.id, photo_thumbnails.thumbnail
+            FROM photos
+            LEFT JOIN photo_thumbnails
+              ON photo_thumbnails.photo_id = photos.id
+             AND photo_thumbnails.size_px = :size
+            WHERE photos.eksponat_id = :id
+        )");
+        query->bindValue(":size", size);
+        query->bindValue(":id", itemId);
+        if (!query->exec()) {
+            if (errorMessage)
+                *errorMessage = formatDbError(QObject::tr("Nie udało się odczytać miniatur zdjęć eksponatu."),
+                                              query->lastError().text());
+            return thumbnails;
+        }
+
+        while (query->next()) {
+            // Pusta miniatura = wiersz sprzed v1.5; uzupełniamy ją poniżej,
+            // po zamknięciu zapytania (MySQL nie lubi zagnieżdżonych result setów).
+            StoredPhotoData thumbnail;
+            thumbnail.id = query->value(0).toString();
+            thumbnail.data = query->value(1).toByteArray();
+            thumbnails.append(thumbnail);
+        }
+    }
+
+    QSqlDatabase db = m_db;
+    for (auto it = thumbnails.begin(); it != thumbnails.end();) {
+        if (!it->data.isEmpty()) {
+            ++it;
+            continue;
+        }
+
+        QString fetchError;
+        const QByteArray original = fetchPhotoData(db, m_blobStore, it->id, &fetchError);
+        const QHash<int, QByteArray> generated = encodeAllThumbnails(original);
+        if (!generated.contains(size)) {
+            qDebug() << "Nie można wygenerować miniatury zdjęcia" << it->id << fetchError;
+            it = thumbnails.erase(it);
+            continue;
+        }
+
+        QString writeError;
+        if (!writeThumbnails(db, it->id, generated, &writeError))
+            qDebug() << "Nie udało się utrwalić miniatury:" << writeError;
+
+        it->data = generated.value(size);
+        ++it;
+    }
+
+    if (errorMessage)
+        errorMessage->clear();
+    return thumbnails;
+}
+
+QStringList PhotoService::loadPhotoIds(const QString &itemId, QString *errorMessage) const
+{
+    QStringList photoIds;
+    PreparedStatement query = PreparedStatementCache::instance().prepare(
+        m_db, "SELECT id FROM photos WHERE eksponat_id = :id");
+    query->bindValue(":id", itemId);
+    if (!query->exec()) {
+        if (errorMessage)
+            *errorMessage = formatDbError(QObject::tr("Nie udało się odczytać listy zdjęć eksponatu."),
+                                          query->lastError().text());
+        return photoIds;
+    }
+    while (query->next())
+        photoIds.append(query->value(0).toString());
+
+    if (errorMessage)
+        errorMessage->clear();
+    return photoIds;
+}
+
+QByteArray PhotoService::loadPhotoThumbnail(const QString &photoId, int size, QString *errorMessage) const
+{
+    PreparedStatement query = PreparedStatementCache::instance().prepare(
+        m_db, "SELECT thumbnail FROM photo_thumbnails WHERE photo_id = :id AND size_px = :size");
+    query->bindValue(":id", photoId);
+    query->bindValue(":size", size);
+    if (!query->exec()) {
+        if (errorMessage)
+            *errorMessage = formatDbError(QObject::tr("Nie udało się odczytać miniatury zdjęcia."),
+                                          query->lastError().text());
+        return QByteArray();
+    }
+
+    if (errorMessage)
+        errorMessage->clear();
+    return query->next() ? query->value(0).toByteArray() : QByteArray();
+}
+
+QByteArray PhotoService::loadPhotoData(const QString &photoId, QString *errorMessage) const
+{
+    QSqlDatabase db = m_db;
+    QString fetchError;
+    const QByteArray data = fetchPhotoData(db, m_blobStore, photoId, &fetchError);
+    if (errorMessage) {
+        if (data.isEmpty() && fetchError.isEmpty())
+            fetchError = QObject::tr("Zdjęcie jest puste.");
+        *errorMessage = data.isEmpty() ? fetchError : QString();
+    }
+    return data;
+}
+
+QPixmap PhotoService::loadOriginalPhoto(const QString &photoId, QString *errorMessage) const
+{
+    QSqlDatabase db = m_db;
+    QImage image;
+    if (!withPhotoData(db, m_blobStore, photoId,
+                       [&image](const QByteArray &data) { image = decodeScaled(data, QSize()); },
+                       errorMessage))
+        return QPixmap();
+
+    if (image.isNull()) {
+        if (errorMessage)
+            *errorMessage = QObject::tr("Nie można zdekodować zdjęcia.");
+        return QPixmap();
+    }
+
+    if (errorMessage)
+        errorMessage->clear();
+    return QPixmap::fromImage(image);
+}
+
+QImage PhotoService::loadScaledPhoto(const QString &photoId,
+                                     const QSize &bounds,
+                                     QString *errorMessage) const
+{
+    // Dla magazynu plików dekodujemy prosto ze zmapowanego pliku — bez kopii BLOB-a.
+    QSqlDatabase db = m_db;
+    QImage image;
+    if (!withPhotoData(db, m_blobStore, photoId,
+                       [&image, &bounds](const QByteArray &data) { image = decodeScaled(data, bounds); },
+                       errorMessage))
+        return {};
+
+    if (image.isNull()) {
+        if (errorMessage)
+            *errorMessage = QObject::tr("Nie można zdekodować zdjęcia.");
+        return image;
+    }
+
+    if (errorMessage)
+        errorMessage->clear();
+    return image;
+}
+
+QString PhotoService::contentHash(const QByteArray &photoData)
+{
+    return QString::fromLatin1(QCryptographicHash::hash(photoData, QCryptographicHash::Sha256).toHex());
+}
+
+bool PhotoService::insertPhoto(const QString &itemId,
+                               const QByteArray &photoData,
+                               QString *photoId,
+                               QString *errorMessage) const
+{
+    return insertPhotoData(itemId, photoData, contentHash(photoData), nullptr, photoId, errorMessage);
+}
+
+bool PhotoService::insertPhoto(const QString &itemId,
+                               const IngestedPhoto &photo,
+                               QString *photoId,
+                               QString *errorMessage) const
+{
+    const QString hash = photo.contentHash.isEmpty() ? contentHash(photo.data) : photo.contentHash;
+    return insertPhotoData(itemId,
+                           photo.data,
+                           hash,
+                           photo.thumbnails.isEmpty() ? nullptr : &photo.thumbnails,
+                           photoId,
+                           errorMessage);
+}
+
+bool PhotoService::insertPhotos(const QString &itemId,
+                                const QList<QByteArray> &photos,
+                                QStringList *photoIds,
+                                QString *errorMessage) const
+{
+    QList<IngestedPhoto> ingested;
+    ingested.reserve(photos.size());
+    for (const QByteArray &photoData : photos) {
+        IngestedPhoto photo;
+        photo.data = photoData;
+        ingested.append(photo);
+    }
+    return insertPhotos(itemId, ingested, photoIds, errorMessage);
+}
+
+bool PhotoService::insertPhotos(const QString &itemId,
+                                const QList<IngestedPhoto> &photos,
+                                QStringList *photoIds,
+                                QString *errorMessage) const
+{
+    if (photoIds)
+        photoIds->clear();
+    if (photos.isEmpty())
+        return true;
+
+    QSqlDatabase db = m_db;
+    const qint64 byteBudget = statementByteBudget(db);
+
+    QStringList hashes;
+    hashes.reserve(photos.size());
+    for (const IngestedPhoto &photo : photos)
+        hashes.append(photo.contentHash.isEmpty() ? contentHash(photo.data) : photo.contentHash);
+
+    // Bloby, które już są w bazie — dla nich insertPhotoData zwiększa tylko licznik.
+    QSet<QString> storedHashes;
+    {
+        QStringList distinctHashes = hashes;
+        distinctHashes.removeDuplicates();
+        QStringList placeholders;
+        for (int i = 0; i < distinctHashes.size(); ++i)
+            placeholders.append(QStringLiteral("?"));
+        QSqlQuery query(db);
+        query.prepare(QStringLiteral("SELECT hash FROM photo_blobs WHERE hash IN (%1)")
+                          .arg(placeholders.join(QLatin1Char(','))));
+        for (int i = 0; i < distinctHashes.size(); ++i)
+            query.bindValue(i, distinctHashes[i]);
+        if (!query.exec()) {
+            if (errorMessage)
+                *errorMessage = formatDbError(QObject::tr("Nie udało się zapisać zdjęcia eksponatu."),
+                                              query.lastError().text());
+            return false;
+        }
+        while (query.next())
+            storedHashes.insert(query.value(0).toString());
+    }
+
+    // Nowy skrót: jeden wiersz photo_blobs z ref_count = liczba wystąpień na liście
+    // i jeden komplet miniatur dla wszystkich jego zdjęć.
+    QHash<QString, int> newBlobRefs;
+    QList<int> newBlobIndexes;
+    for (int index = 0; index < photos.size(); ++index) {
+        if (storedHashes.contains(hashes[index]))
+            continue;
+        if (!newBlobRefs.contains(hashes[index]))
+            newBlobIndexes.append(index);
+        ++newBlobRefs[hashes[index]];
+    }
+
+    const bool external = m_blobStore.isEnabled();
+    MultiRowInsert blobInsert(db,
+                              QStringLiteral("INSERT INTO photo_blobs (hash, data, ref_count, external, width, height) VALUES"),
+                              QStringLiteral("(?, ?, ?, ?, ?, ?)"),
+                              byteBudget,
+                              QObject::tr("Nie udało się zapisać zdjęcia eksponatu."));
+    QHash<QString, QHash<int, QByteArray>> newBlobThumbnails;
+    for (int index : std::as_const(newBlobIndexes)) {
+        const QByteArray &photoData = photos[index].data;
+        const QString &hash = hashes[index];
+        const QSize dimensions = PhotoService::imageSize(photoData);
+        if (!blobInsert.addRow({hash,
+                                external ? QByteArray("") : photoData,
+                                newBlobRefs.value(hash),
+                                external ? 1 : 0,
+                                dimensions.isValid() ? QVariant(dimensions.width()) : QVariant(),
+                                dimensions.isValid() ? QVariant(dimensions.height()) : QVariant()},
+                               external ? 0 : photoData.size(),
+                               errorMessage))
+            return false;
+        // Miniatury policzone przez ingestFiles nie są kodowane drugi raz.
+        newBlobThumbnails.insert(hash, photos[index].thumbnails.isEmpty() ? encodeAllThumbnails(photoData)
+                                                                          : photos[index].thumbnails);
+    }
+    if (!blobInsert.flush(errorMessage))
+        return false;
+    // Pliki po wierszach photo_blobs — jak w insertPhotoData.
+    for (int index : std::as_const(newBlobIndexes)) {
+        if (external && !m_blobStore.write(hashes[index], photos[index].data, errorMessage))
+            return false;
+    }
+
+    // photos.photo jest NOT NULL w istniejących bazach — dla nowych wierszy pusty BLOB.
+    MultiRowInsert photoInsert(db,
+                               QStringLiteral("INSERT INTO photos (id, eksponat_id, photo, blob_hash) VALUES"),
+                               QStringLiteral("(?, ?, X'', ?)"),
+                               byteBudget,
+                               QObject::tr("Nie udało się zapisać zdjęcia eksponatu."));
+    MultiRowInsert thumbnailInsert(db,
+                                   QStringLiteral("REPLACE INTO photo_thumbnails (photo_id, size_px, thumbnail) VALUES"),
+                                   QStringLiteral("(?, ?, ?)"),
+                                   byteBudget,
+                                   QObject::tr("Nie udało się zapisać miniatury zdjęcia."));
+    QStringList insertedIds;
+    for (int index = 0; index < photos.size(); ++index) {
+        const QString &hash = hashes[index];
+        QString photoId;
+        if (storedHashes.contains(hash)) {
+            const IngestedPhoto &photo = photos[index];
+            if (!insertPhotoData(itemId, photo.data, hash, photo.thumbnails.isEmpty() ? nullptr : &photo.thumbnails,
+                                 &photoId, errorMessage))
+                return false;
+        } else {
+            photoId = QUuid::createUuid().toString(QUuid::WithoutBraces);
+            if (!photoInsert.addRow({photoId, itemId, hash}, 0, errorMessage))
+                return false;
+        }
+        insertedIds.append(photoId);
+    }
+    if (!photoInsert.flush(errorMessage))
+        return false;
+
+    // Miniatury wskazują na photos.id — dopiero po zapisaniu wszystkich wierszy photos.
+    for (int index = 0; index < photos.size(); ++index) {
+        const auto thumbnails = newBlobThumbnails.constFind(hashes[index]);
+        if (thumbnails == newBlobThumbnails.constEnd())
+            continue;
+        for (auto it = thumbnails->cbegin(); it != thumbnails->cend(); ++it) {
+            if (!thumbnailInsert.addRow({insertedIds[index], it.key(), it.value()}, it.value().size(),
+                                        errorMessage))
+                return false;
+        }
+    }
+    if (!thumbnailInsert.flush(errorMessage))
+        return false;
+
+    PhotoCache::instance().invalidateItem(itemId);
+
+    if (photoIds)
+        *photoIds = insertedIds;
+    if (errorMessage)
+        errorMessage->clear();
+    return true;
+}
+
+void PhotoService::releaseStatementBudget(const QString &connectionName)
+{
+    const QMutexLocker locker(&budgetMutex());
+    budgetCache().remove(connectionName);
+}
+
+void PhotoService::clearStatementBudgets()
+{
+    const QMutexLocker locker(&budgetMutex());
+    budgetCache().clear();
+}
+
+bool PhotoService::insertPhotoData(const QString &itemId,
+                                   const QByteArray &photoData,
+                                   const QString &hash,
+                                   const QHash<int, QByteArray> *thumbnails,
+                                   QString *photoId,
+                                   QString *errorMessage) const
+{
+    const QString newPhotoId = QUuid::createUuid().toString(QUuid::WithoutBraces);
+
+    // v1.5: najpierw sam licznik — jeśli blob już jest, dane w ogóle nie idą do serwera.
+    bool blobExists = false;
+    {
+        PreparedStatement refQuery = PreparedStatementCache::instance().prepare(
+            m_db, "UPDATE photo_blobs SET ref_count = ref_count + 1 WHERE hash = :hash");
+        refQuery->bindValue(":hash", hash);
+        if (!refQuery->exec()) {
+            if (errorMessage)
+                *errorMessage = formatDbError(QObject::tr("Nie udało się zapisać zdjęcia eksponatu."),
+                                              refQuery->lastError().text());
+            return false;
+        }
+        blobExists = refQuery->numRowsAffected() > 0;
+    }
+
+    if (!blobExists) {
+        // Magazyn plików: najpierw wiersz, potem plik — removeBlobFiles innego stanowiska
+        // widzi wtedy (albo czeka na) nowy wiersz i nie usuwa świeżo zapisanego pliku.
+        // Po wycofaniu transakcji zostaje najwyżej nieużywany plik adresowany treścią.
+        const bool external = m_blobStore.isEnabled();
+        const QSize dimensions = PhotoService::imageSize(photoData);
+        PreparedStatement blobInsert = PreparedStatementCache::instance().prepare(
+            m_db, "INSERT INTO photo_blobs (hash, data, ref_count, external, width, height) "
+                  "VALUES (:hash, :data, 1, :external, :width, :height)");
+        blobInsert->bindValue(":hash", hash);
+        blobInsert->bindValue(":data", external ? QByteArray("") : photoData);
+        blobInsert->bindValue(":external", external ? 1 : 0);
+        blobInsert->bindValue(":width", dimensions.isValid() ? QVariant(dimensions.width()) : QVariant());
+        blobInsert->bindValue(":height", dimensions.isValid() ? QVariant(dimensions.height()) : QVariant());
+        if (!blobInsert->exec()) {
+            if (errorMessage)
+                *errorMessage = formatDbError(QObject::tr("Nie udało się zapisać zdjęcia eksponatu."),
+                                              blobInsert->lastError().text());
+            return false;
+        }
+        if (external && !m_blobStore.write(hash, photoData, errorMessage))
+            return false;
+    }
+
+    {
+        // photos.photo jest NOT NULL w istniejących bazach — dla nowych wierszy pusty BLOB.
+        PreparedStatement query = PreparedStatementCache::instance().prepare(m_db, R"(
+            INSERT INTO photos (id, eksponat_id, photo, blob_hash)
+            VALUES (:id, :itemId, X'', :hash)
+        )");
+        query->bindValue(":id", newPhotoId);
+        query->bindValue(":itemId", itemId);
+        query->bindValue(":hash", hash);
+        if (!query->exec()) {
+            if (errorMessage)
+                *errorMessage = formatDbError(QObject::tr("Nie udało się zapisać zdjęcia eksponatu."),
+                                              query->lastError().text());
+            return false;
+        }
+    }
+
+    // Ten sam blob ma już miniatury przy innym wierszu photos — kopiujemy je zamiast dekodować.
+    bool thumbnailsCopied = false;
+    if (blobExists) {
+        PreparedStatement thumbnailCopy = PreparedStatementCache::instance().prepare(m_db, R"(
+            INSERT INTO photo_thumbnails (photo_id, size_px, thumbnail)
+            SELECT :newId, photo_thumbnails.size_px, photo_thumbnails.thumbnail
+            FROM photo_thumbnails
+            WHERE photo_thumbnails.photo_id = (
+                SELECT photos.id FROM photos
+                WHERE photos.blob_hash = :hash AND photos.id <> :excludedId
+                LIMIT 1)
+        )");
+        thumbnailCopy->bindValue(":newId", newPhotoId);
+        thumbnailCopy->bindValue(":hash", hash);
+        thumbnailCopy->bindValue(":excludedId", newPhotoId);
+        if (!thumbnailCopy->exec()) {
+            if (errorMessage)
+                *errorMessage = formatDbError(QObject::tr("Nie udało się zapisać miniatury zdjęcia."),
+                                              thumbnailCopy->lastError().text());
+            return false;
+        }
+        thumbnailsCopied = thumbnailCopy->numRowsAffected() >= thumbnailSizes().size();
+    }
+
+    if (!thumbnailsCopied) {
+        if (thumbnails) {
+            QSqlDatabase db = m_db;
+            if (!writeThumbnails(db, newPhotoId, *thumbnails, errorMessage))
+                return false;
+        } else if (!storeThumbnails(newPhotoId, photoData, errorMessage)) {
+            return false;
+        }
+    }
+
+    // Lista zdjęć eksponatu w PhotoCache jest już nieaktualna.
+    PhotoCache::instance().invalidateItem(itemId);
+
+    if (photoId)
+        *photoId = newPhotoId;
+    if (errorMessage)
+        errorMessage->clear();
+    return true;
+}
+
+bool PhotoService::storeThumbnails(const QString &photoId,
+                                   const QByteArray &photoData,
+                                   QString *errorMessage) const
+{
+    const QHash<int, QByteArray> thumbnails = encodeAllThumbnails(photoData);
+    if (thumbnails.isEmpty()) {
+        // Niedekodowalne dane zostawiamy bez miniatur — oryginał nadal jest w bazie,
+        // a loadThumbnails po prostu go pominie (tak jak wcześniej loadStoredPhotos).
+        qDebug() << "Brak miniatur dla zdjęcia" << photoId << "(nieznany format)";
+        return true;
+    }
+
+    QSqlDatabase db = m_db;
+    return writeThumbnails(db, photoId, thumbnails, errorMessage);
+}
+
+bool PhotoService::deletePhoto(const QString &photoId, QStringList *releasedFileHashes, QString *errorMessage) const
+{
+    {
+        PreparedStatement thumbnailDelete = PreparedStatementCache::instance().prepare(
+            m_db, "DELETE FROM photo_thumbnails WHERE photo_id = :id");
+        thumbnailDelete->bindValue(":id", photoId);
+        if (!thumbnailDelete->exec()) {
+            if (errorMessage)
+                *errorMessage = formatDbError(QObject::tr("Nie udało się usunąć miniatur zdjęcia."),
+                                              thumbnailDelete->lastError().text());
+            return false;
+        }
+    }
+
+    {
+        PreparedStatement releaseQuery = PreparedStatementCache::instance().prepare(
+            m_db, "UPDATE photo_blobs SET ref_count = ref_count - 1 "
+                  "WHERE hash = (SELECT blob_hash FROM photos WHERE id = :id)");
+        releaseQuery->bindValue(":id", photoId);
+        if (!releaseQuery->exec()) {
+            if (errorMessage)
+                *errorMessage = formatDbError(QObject::tr("Nie udało się zwolnić danych zdjęcia."),
+                                              releaseQuery->lastError().text());
+            return false;
+        }
+    }
+
+    {
+        PreparedStatement photoDelete = PreparedStatementCache::instance().prepare(
+            m_db, "DELETE FROM photos WHERE id = :id");
+        photoDelete->bindValue(":id", photoId);
+        if (!photoDelete->exec()) {
+            if (errorMessage)
+                *errorMessage = formatDbError(QObject::tr("Nie udało się usunąć zdjęcia."),
+                                              photoDelete->lastError().text());
+            return false;
+        }
+    }
+
+    // Pliki blobów usuwa wywołujący po COMMIT — wycofana transakcja zostawia je na miejscu.
+    if (!collectUnreferencedBlobs(releasedFileHashes, errorMessage))
+        return false;
+
+    PhotoCache::instance().invalidatePhoto(photoId);
+
+    if (errorMessage)
+        errorMessage->clear();
+    return true;
+}
+
+bool PhotoService::releaseItemBlobs(const QString &itemId, QString *errorMessage) const
+{
+    // Eksponat może mieć kilka wierszy z tym samym blobem — odejmujemy ich liczbę.
+    PreparedStatement releaseQuery = PreparedStatementCache::instance().prepare(m_db, R"(
+        UPDATE photo_blobs
+        SET ref_count = ref_count - (
+            SELECT COUNT(*) FROM photos
+            WHERE photos.blob_hash = photo_blobs.hash AND photos.eksponat_id = :countItemId)
+        WHERE hash IN (SELECT blob_hash FROM photos WHERE eksponat_id = :itemId)
+    )");
+    releaseQuery->bindValue(":countItemId", itemId);
+    releaseQuery->bindValue(":itemId", itemId);
+    if (!releaseQuery->exec()) {
+        if (errorMessage)
+            *errorMessage = formatDbError(QObject::tr("Nie udało się zwolnić danych zdjęć eksponatu."),
+                                          releaseQuery->lastError().text());
+        return false;
+    }
+
+    if (errorMessage)
+        errorMessage->clear();
+    return true;
+}
+
+bool PhotoService::collectUnreferencedBlobs(QStringList *releasedFileHashes, QString *errorMessage) const
+{
+    if (releasedFileHashes) {
+        releasedFileHashes->clear();
+        QSqlQuery fileQuery(m_db);
+        if (!fileQuery.exec("SELECT hash FROM photo_blobs WHERE ref_count <= 0 AND external <> 0")) {
+            if (errorMessage)
+                *errorMessage = formatDbError(QObject::tr("Nie udało się usunąć nieużywanych danych zdjęć."),
+                                              fileQuery.lastError().text());
+            return false;
+        }
+        while (fileQuery.next())
+            releasedFileHashes->append(fileQuery.value(0).toString());
+    }
+
+    QSqlQuery gcQuery(m_db);
+    if (!gcQuery.exec("DELETE FROM photo_blobs WHERE ref_count <= 0")) {
+        if (errorMessage)
+            *errorMessage = formatDbError(QObject::tr("Nie udało się usunąć nieużywanych danych zdjęć."),
+                                          gcQuery.lastError().text());
+        return false;
+    }
+
+    if (errorMessage)
+        errorMessage->clear();
+    return true;
+}
+
+void PhotoService::removeBlobFiles(const QStringList &hashes) const
+{
+    if (hashes.isEmpty() || !m_blobStore.isEnabled())
+        return;
+
+    // Inne stanowisko mogło w międzyczasie dodać zdjęcie o tej samej treści: INSERT do
+    // photo_blobs, potem zapis pliku. Sprawdzenie i unlink idą więc w jednej transakcji,
+    // która trzyma blokadę do usunięcia pliku — cudzy INSERT tego skrótu czeka na nasz
+    // COMMIT i zapisuje plik od nowa, a niezatwierdzony cudzy INSERT wstrzymuje nasz odczyt.
+    // SQLite: BEGIN IMMEDIATE (blokada zapisu całej bazy). MySQL: SELECT ... FOR UPDATE
+    // w REPEATABLE READ zakłada też blokadę luki, gdy wiersza nie ma (READ COMMITTED by jej nie dał).
+    QSqlDatabase db = m_db;
+    const bool mysql = db.driverName() == "QMYSQL";
+    QSqlQuery transactionQuery(db);
+    bool started = false;
+    if (mysql) {
+        transactionQuery.exec("SET TRANSACTION ISOLATION LEVEL REPEATABLE READ");
+        started = db.transaction();
+    } else {
+        started = transactionQuery.exec("BEGIN IMMEDIATE");
+    }
+    if (!started) {
+        // Bez blokady pliku nie usuwamy — osierocony plik jest nieszkodliwy, utracony nie.
+        qDebug() << "Nie udało się zablokować photo_blobs przed usunięciem plików zdjęć:"
+                 << (mysql ? db.lastError().text() : transactionQuery.lastError().text());
+        return;
+    }
+
+    for (const QString &hash : hashes) {
+        PreparedStatement query = PreparedStatementCache::instance().prepare(
+            db, mysql ? "SELECT 1 FROM photo_blobs WHERE hash = :hash FOR UPDATE"
+                      : "SELECT 1 FROM photo_blobs WHERE hash = :hash");
+        query->bindValue(":hash", hash);
+        if (!query->exec() || query->next())
+            continue;
+        if (!m_blobStore.remove(hash))
+            qDebug() << "Nie udało się usunąć pliku zdjęcia" << m_blobStore.pathForHash(hash);
+    }
+
+    // Transakcja niczego nie zapisała — COMMIT tylko zwalnia blokady.
+    if (mysql ? !db.commit() : !transactionQuery.exec("COMMIT"))
+        qDebug() << "Nie udało się zwolnić blokady photo_blobs:"
+                 << (mysql ? db.lastError().text() : transactionQuery.lastError().text());
+}
+
+bool PhotoService::migrateBlobsToFileStore(int *movedCount,
+                                           QString *errorMessage,
+                                           const std::function<bool(int, int)> &progressCallback) const
+{
+    if (movedCount)
+        *movedCount = 0;
+    if (!m_blobStore.isEnabled()) {
+        if (errorMessage)
+            *errorMessage = QObject::tr("Magazyn plików zdjęć nie jest skonfigurowany.");
+        return false;
+    }
+
+    QSqlDatabase db = m_db;
+    auto fail = [&db, errorMessage](const QString &context, const QString &details)
+    {
+        db.rollback();
+        if (errorMessage)
+            *errorMessage = formatDbError(context, details);
+        return false;
+    };
+
+    QStringList legacyPhotoIds;
+    {
+        QSqlQuery query(m_db);
+        if (!query.exec("SELECT id FROM photos WHERE blob_hash IS NULL")) {
+            if (errorMessage)
+                *errorMessage = formatDbError(QObject::tr("Nie udało się wyszukać zdjęć do przeniesienia."),
+                                              query.lastError().text());
+            return false;
+        }
+        while (query.next())
+            legacyPhotoIds.append(query.value(0).toString());
+    }
+
+    // Jeden BLOB w pamięci naraz i osobna transakcja na wiersz — migrację można
+    // przerwać w dowolnym momencie i wznowić przy następnym uruchomieniu.
+    int processed = 0;
+    int moved = 0;
+    const int legacyTotal = legacyPhotoIds.size();
+    for (const QString &photoId : std::as_const(legacyPhotoIds)) {
+        QByteArray data;
+        {
+            PreparedStatement query = PreparedStatementCache::instance().prepare(
+                m_db, "SELECT photo FROM photos WHERE id = :id AND blob_hash IS NULL");
+            query->bindValue(":id", photoId);
+            if (query->exec() && query->next())
+                data = query->value(0).toByteArray();
+        }
+
+        if (!data.isEmpty()) {
+            const QString hash = contentHash(data);
+            if (!db.transaction()) {
+                if (errorMessage)
+                    *errorMessage = formatDbError(QObject::tr("Nie udało się rozpocząć transakcji."),
+                                                  db.lastError().text());
+                return false;
+            }
+
+            PreparedStatement refQuery = PreparedStatementCache::instance().prepare(
+                m_db, "UPDATE photo_blobs SET ref_count = ref_count + 1 WHERE hash = :hash");
+            refQuery->bindValue(":hash", hash);
+            if (!refQuery->exec())
+                return fail(QObject::tr("Nie udało się przenieść zdjęcia."), refQuery->lastError().text());
+
+            if (refQuery->numRowsAffected() <= 0) {
+                const QSize dimensions = PhotoService::imageSize(data);
+                PreparedStatement blobInsert = PreparedStatementCache::instance().prepare(
+                    m_db, "INSERT INTO photo_blobs (hash, data, ref_count, external, width, height) "
+                          "VALUES (:hash, X'', 1, 1, :width, :height)");
+                blobInsert->bindValue(":hash", hash);
+                blobInsert->bindValue(":width", dimensions.isValid() ? QVariant(dimensions.width()) : QVariant());
+                blobInsert->bindValue(":height", dimensions.isValid() ? QVariant(dimensions.height()) : QVariant());
+                if (!blobInsert->exec())
+                    return fail(QObject::tr("Nie udało się przenieść zdjęcia."), blobInsert->lastError().text());
+            }
+
+            // Plik po wierszu photo_blobs — jak w insertPhotoData.
+            QString writeError;
+            if (!m_blobStore.write(hash, data, &writeError)) {
+                db.rollback();
+                if (errorMessage)
+                    *errorMessage = writeError;
+                return false;
+            }
+
+            PreparedStatement photoUpdate = PreparedStatementCache::instance().prepare(
+                m_db, "UPDATE photos SET photo = X'', blob_hash = :hash WHERE id = :id");
+            photoUpdate->bindValue(":hash", hash);
+            photoUpdate->bindValue(":id", photoId);
+            if (!photoUpdate->exec())
+                return fail(QObject::tr("Nie udało się przenieść zdjęcia."), photoUpdate->lastError().text());
+
+            if (!db.commit())
+                return fail(QObject::tr("Nie udało się zatwierdzić przeniesienia zdjęcia."),
+                            db.lastError().text());
+            ++moved;
+            if (movedCount)
+                *movedCount = moved;
+        }
+
+        ++processed;
+        if (progressCallback && !progressCallback(processed, legacyTotal))
+            return true;
+    }
+
+    // Bloby już zdeduplikowane, ale trzymane w bazie. Lista dopiero teraz —
+    // pętla wyżej mogła podbić licznik istniejącego bloba w bazie.
+    QStringList databaseHashes;
+    {
+        QSqlQuery query(m_db);
+        if (!query.exec("SELECT hash FROM photo_blobs WHERE external = 0")) {
+            if (errorMessage)
+                *errorMessage = formatDbError(QObject::tr("Nie udało się wyszukać zdjęć do przeniesienia."),
+                                              query.lastError().text());
+            return false;
+        }
+        while (query.next())
+            databaseHashes.append(query.value(0).toString());
+    }
+
+    const int total = legacyTotal + databaseHashes.size();
+    for (const QString &hash : std::as_const(databaseHashes)) {
+        QByteArray data;
+        {
+            PreparedStatement query = PreparedStatementCache::instance().prepare(
+                m_db, "SELECT data FROM photo_blobs WHERE hash = :hash AND external = 0");
+            query->bindValue(":hash", hash);
+            if (query->exec() && query->next())
+                data = query->value(0).toByteArray();
+        }
+
+        if (!data.isEmpty()) {
+            if (!m_blobStore.write(hash, data, errorMessage))
+                return false;
+
+            const QSize dimensions = PhotoService::imageSize(data);
+            PreparedStatement blobUpdate = PreparedStatementCache::instance().prepare(
+                m_db, "UPDATE photo_blobs SET data = X'', external = 1, width = :width, height = :height "
+                      "WHERE hash = :hash AND external = 0");
+            blobUpdate->bindValue(":width", dimensions.isValid() ? QVariant(dimensions.width()) : QVariant());
+            blobUpdate->bindValue(":height", dimensions.isValid() ? QVariant(dimensions.height()) : QVariant());
+            blobUpdate->bindValue(":hash", hash);
+            if (!blobUpdate->exec()) {
+                if (errorMessage)
+                    *errorMessage = formatDbError(QObject::tr("Nie udało się przenieść zdjęcia."),
+                                                  blobUpdate->lastError().text());
+                return false;
+            }
+            ++moved;
+            if (movedCount)
+                *movedCount = moved;
+        }
+
+        ++processed;
+        if (progressCallback && !progressCallback(processed, total))
+            return true;
+    }
+
+    if (errorMessage)
+        errorMessage->clear();
+    return true;
+}
+
+bool PhotoService::backfillThumbnails(int *generatedCount,
+                                      QString *errorMessage,
+                                      const std::function<bool(int, int)> &progressCallback) const
+{
+    if (generatedCount)
+        *generatedCount = 0;
+
+    QStringList pendingIds;
+    {
+        QSqlQuery query(m_db);
+        if (!query.exec(R"(
+                SELECT photos.id FROM photos
+                WHERE NOT EXISTS (
+                    SELECT 1 FROM photo_thumbnails
+                    WHERE photo_thumbnails.photo_id = photos.id
+                )
+            )")) {
+            if (errorMessage)
+                *errorMessage = formatDbError(QObject::tr("Nie udało się wyszukać zdjęć bez miniatur."),
+                                              query.lastError().text());
+            return false;
+        }
+        while (query.next())
+            pendingIds.append(query.value(0).toString());
+    }
+
+    // Oryginały czytamy pojedynczo — backfill nie może trzymać w pamięci
+    // wszystkich BLOB-ów naraz (kilkaset zdjęć po kilka MB).
+    QSqlDatabase db = m_db;
+    int processed = 0;
+    int generated = 0;
+    for (const QString &photoId : pendingIds) {
+        QString stepError;
+        const QByteArray original = fetchPhotoData(db, m_blobStore, photoId, &stepError);
+        const QHash<int, QByteArray> thumbnails = encodeAllThumbnails(original);
+        if (!thumbnails.isEmpty()) {
+            if (!writeThumbnails(db, photoId, thumbnails, errorMessage))
+                return false;
+            ++generated;
+            if (generatedCount)
+                *generatedCount = generated;
+        } else {
+            qDebug() << "Pomijam zdjęcie bez miniatury" << photoId << stepError;
+        }
+
+        ++processed;
+        if (progressCallback && !progressCallback(processed, pendingIds.size()))
+            break;
+    }
+
+    if (errorMessage)
+        errorMessage->clear();
+    return true;
+}
+
+QList<QPixmap> PhotoService::loadPixmapsFromBuffer(const QList<QByteArray> &photoBuffer,
+                                                   const QSize &bounds) const
 {
     QList<QPixmap> pixmaps;
 
     for (const QByteArray &photoData : photoBuffer) {
-        QPixmap pixmap;
-        if (!pixmap.loadFromData(photoData)) {
-            qDebug() << "Błąd loadFromData w buforze zdjęć";
+        const QImage image = decodeScaled(photoData, bounds);
+        if (image.isNull()) {
+            qDebug() << "Błąd dekodowania zdjęcia w buforze zdjęć";
             continue;
         }
-        pixmaps.append(pixmap);
+        pixmaps.append(QPixmap::fromImage(image));
     }
 
     return pixmaps;
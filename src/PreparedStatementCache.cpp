@@ -0,0 +1,131 @@
+#include "PreparedStatementCache.h"
+
+#include <QMutexLocker>
+#include <QSqlDriver>
+#include <QSettings>
+#include <QStandardPaths>
+
+PreparedStatementCache::PreparedStatementCache(int capacity)
+    : m_capacity(qMax(0, capacity))
+{}
+
+PreparedStatementCache &PreparedStatementCache::instance()
+{
+    static PreparedStatementCache cache;
+    return cache;
+}
+
+int PreparedStatementCache::capacityFromSettings()
+{
+    QSettings settings(QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation)
+                           + "/inwentaryzacja.ini",
+                       QSettings::IniFormat);
+    bool ok = false;
+    const int capacity = settings.value("database/statement_cache_size", kDefaultCapacity).toInt(&ok);
+    if (!ok || capacity < 0)
+        return kDefaultCapacity;
+    return capacity;
+}
+
+PreparedStatement PreparedStatementCache::prepare(const QSqlDatabase &db, const QString &sql)
+{
+    const bool cacheable = m_capacity > 0 && db.isOpen();
+    const void *handle = cacheable ? nativeHandle(db) : nullptr;
+    bool inUse = false;
+    if (cacheable) {
+        QMutexLocker locker(&m_mutex);
+        std::shared_ptr<ConnectionEntry> &entry = m_connections[db.connectionName()];
+        if (!entry || !matches(*entry, db, handle)) {
+            // Ten sam sterownik z innym uchwytem: close() i open() bez release().
+            Q_ASSERT_X(!entry || entry->driver != db.driver(), "PreparedStatementCache::prepare",
+                       "połączenie otwarte ponownie bez release()");
+            // Nowe połączenie albo otwarte od nowa pod tą samą nazwą — stare uchwyty są nieważne.
+            entry = std::make_shared<ConnectionEntry>(m_capacity);
+            entry->driver = db.driver();
+            entry->handle = handle;
+        }
+
+        // QCache::object przesuwa wpis na początek listy LRU.
+        if (const QueryPointer *cached = entry->queries.object(sql)) {
+            if (cached->use_count() == 1) {
+                ++m_hits;
+                return PreparedStatement(*cached);
+            }
+            // Zagnieżdżone użycie tego samego SQL — osobne, niecache'owane zapytanie.
+            inUse = true;
+        }
+        ++m_misses;
+    }
+
+    // prepare() poza muteksem — przy MySQL to podróż do serwera.
+    auto query = std::make_shared<QSqlQuery>(db);
+    if (!query->prepare(sql) || !cacheable || inUse)
+        return PreparedStatement(std::move(query));
+
+    QMutexLocker locker(&m_mutex);
+    const auto it = m_connections.constFind(db.connectionName());
+    if (it != m_connections.constEnd() && matches(*it.value(), db, handle)) {
+        // Przy przekroczeniu limitu QCache usuwa (i zwalnia na serwerze) najdawniej użyte.
+        it.value()->queries.insert(sql, new QueryPointer(query), 1);
+    }
+    return PreparedStatement(std::move(query));
+}
+
+PreparedStatement PreparedStatementCache::prepareUncached(const QSqlDatabase &db, const QString &sql)
+{
+    auto query = std::make_shared<QSqlQuery>(db);
+    query->prepare(sql);
+    return PreparedStatement(std::move(query));
+}
+
+const void *PreparedStatementCache::nativeHandle(const QSqlDatabase &db)
+{
+    // Wszystkie sterowniki Qt zwracają w handle() wskaźnik (sqlite3*, MYSQL*, PGconn*…).
+    const QVariant handle = db.driver() ? db.driver()->handle() : QVariant();
+    if (!handle.isValid() || handle.metaType().sizeOf() != qsizetype(sizeof(void *)))
+        return nullptr;
+    return *static_cast<void *const *>(handle.constData());
+}
+
+bool PreparedStatementCache::matches(const ConnectionEntry &entry, const QSqlDatabase &db, const void *handle)
+{
+    return entry.driver == db.driver() && entry.handle == handle;
+}
+
+void PreparedStatementCache::release(const QString &connectionName)
+{
+    QMutexLocker locker(&m_mutex);
+    m_connections.remove(connectionName);
+}
+
+void PreparedStatementCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_connections.clear();
+}
+
+PreparedStatementCache::Stats PreparedStatementCache::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    Stats result;
+    result.hits = m_hits;
+    result.misses = m_misses;
+    result.connections = m_connections.size();
+    for (const auto &entry : m_connections)
+        result.entries += entry->queries.count();
+    return result;
+}
+
+void PreparedStatementCache::resetStats()
+{
+    QMutexLocker locker(&m_mutex);
+    m_hits = 0;
+    m_misses = 0;
+}
+
+int PreparedStatementCache::count(const QString &connectionName) const
+{
+    QMutexLocker locker(&m_mutex);
+    const auto it = m_connections.constFind(connectionName);
+    return it == m_connections.constEnd() ? 0 : it.value()->queries.count();
+}
@@ -4,9 +4,13 @@
 #include "AiEnrichmentService.h"
 #include "EnrichPreviewDialog.h"
 #include "ItemRepository.h"
+#include "PhotoCache.h"
+#include "PhotoService.h"
 
+#include <QBuffer>
 #include <QCheckBox>
 #include <QHBoxLayout>
+#include <QImage>
 #include <QMessageBox>
 #include <QProgressDialog>
 #include <QPushButton>
@@ -129,20 +133,51 @@ void PreviewDialog::loadRecord()
 
 QList<QByteArray> PreviewDialog::fetchPhotos(int limit) const
 {
-    QList<QByteArray> photos;
-    QSqlQuery q(m_db);
-    q.prepare(QStringLiteral("SELECT photo FROM photos WHERE eksponat_id = :id LIMIT %1").arg(limit));
-    q.bindValue(QStringLiteral(":id"), m_recordId);
-    if (!q.exec())
+    // v1.5: zamiast surowych BLOB-ów (często kilka MB każdy) bierzemy obraz
+    // przeskalowany do dłuższej krawędzi 1568 px — większe i tak są zmniejszane
+    // po stronie API. Zdekodowany obraz trafia do wspólnego PhotoCache, więc
+    // ponowne "Wzbogać" (albo podgląd tego samego zdjęcia) nie dekoduje od nowa.
+    static const QSize kAiImageBounds(1568, 1568);
+
+    QStringList photoIds;
     {
-        qWarning() << "PreviewDialog::fetchPhotos: SQL error" << q.lastError().text();
-        return photos;
+        QSqlQuery q(m_db);
+        q.prepare(QStringLiteral("SELECT id FROM photos WHERE eksponat_id = :id LIMIT %1").arg(limit));
+        q.bindValue(QStringLiteral(":id"), m_recordId);
+        if (!q.exec())
+        {
+            qWarning() << "PreviewDialog::fetchPhotos: SQL error" << q.lastError().text();
+            return {};
+        }
+        while (q.next())
+            photoIds.append(q.value(0).toString());
     }
-    while (q.next())
+
+    QList<QByteArray> photos;
+    PhotoCache &photoCache = PhotoCache::instance();
+    const PhotoService photoService(m_db);
+    for (const QString &photoId : std::as_const(photoIds))
     {
-        const QByteArray blob = q.value(0).toByteArray();
-        if (!blob.isEmpty())
-            photos.append(blob);
+        QImage image = photoCache.find(photoId, kAiImageBounds);
+        if (image.isNull())
+        {
+            QString errorMessage;
+            image = photoService.loadScaledPhoto(photoId, kAiImageBounds, &errorMessage);
+            if (image.isNull())
+            {
+                qWarning() << "PreviewDialog::fetchPhotos: pomijam zdjęcie" << photoId << errorMessage;
+                continue;
+            }
+            photoCache.insert(photoId, image, kAiImageBounds);
+        }
+
+        QByteArray encoded;
+        QBuffer buffer(&encoded);
+        buffer.open(QIODevice::WriteOnly);
+        const bool ok = image.hasAlphaChannel() ? image.save(&buffer, "PNG")
+                                                : image.save(&buffer, "JPG", 90);
+        if (ok && !encoded.isEmpty())
+            photos.append(encoded);
     }
     return photos;
 }
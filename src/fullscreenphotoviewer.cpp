@@ -1,30 +1,338 @@
 /**
  * @file fullscreenphotoviewer.cpp
- * @brief Pusty plik implementacyjny dla klas ZoomableGraphicsView i FullScreenPhotoViewer.
+ * @brief Implementacja podglądu progresywnego w FullScreenPhotoViewer.
  * @author Stowarzyszenie Miłośników Oldschoolowych Komputerów SMOK & Claude & ChatGPT & GROK
  * @version \projectnumber
  * @date 2025-05-03
  *
  * @section Overview
- * Plik fullscreenphotoviewer.cpp jest pusty, ponieważ cała implementacja klas 
- * ZoomableGraphicsView i FullScreenPhotoViewer znajduje się w pliku nagłówkowym 
- * fullscreenphotoviewer.h, gdzie metody są zdefiniowane inline. Plik istnieje dla 
- * kompletności struktury projektu i zgodności z konwencją oddzielania deklaracji od implementacji.
+ * Widok ZoomableGraphicsView i podgląd gotowego QPixmap pozostają inline w pliku
+ * fullscreenphotoviewer.h. Tutaj znajduje się konstruktor przyjmujący ID zdjęcia:
+ * okno pokazuje od razu powiększoną miniaturę, a PhotoDecodeWorker w osobnym wątku
+ * pobiera treść zdjęcia (z bazy lub magazynu plików), dekoduje wersję dopasowaną do ekranu
+ * i — przy powiększeniu — tylko widoczne fragmenty oryginału.
  *
  * @section Structure
- * Plik zawiera jedynie zakomentowane włączenie nagłówka fullscreenphotoviewer.h, 
- * co wskazuje na brak dodatkowej implementacji. Brak kodu wynika z faktu, że wszystkie 
- * metody klas są zdefiniowane w pliku nagłówkowym.
- *
- * @section Dependencies
- * - **Nagłówek**: fullscreenphotoviewer.h (zakomentowane włączenie).
+ * 1. **PhotoDecodeWorker** – worker w wątku m_decodeThread z własnym połączeniem roboczym.
+ * 2. **FullScreenPhotoViewer** – podmiana miniatury na ostry obraz i obsługa kafli.
  *
  * @section Notes
- * - Kod nie został zmodyfikowany, zgodnie z wymaganiami użytkownika.
- * - Plik jest pusty z wyjątkiem zakomentowanego #include, co jest zgodne z oryginalnym kodem.
- * - Dokumentacja w pliku nagłówkowym (fullscreenphotoviewer.h) w pełni opisuje funkcjonalność klas.
+ * - Scena pracuje we współrzędnych pikseli oryginału (po orientacji EXIF), niezależnie od tego,
+ *   który obraz jest aktualnie wyświetlany.
+ * - Kafle zdjęć z orientacją EXIF są przeliczane na współrzędne pliku i obracane po dekodowaniu
+ *   (PhotoService::decodeOrientedRegion) — pełny oryginał nie jest dekodowany.
+ * - Zamknięcie okna nie czeka na wątek: worker sprawdza flagę przerwania przed każdym krokiem,
+ *   a wątek i worker usuwają się sami po zakończeniu.
  */
 
-// #include "fullscreenphotoviewer.h" // NOLINT
+#include "fullscreenphotoviewer.h"
+
+#include "DatabaseConnectionPool.h"
+#include "PhotoCache.h"
+#include "PhotoService.h"
+
+#include <QDebug>
+#include <QGraphicsPixmapItem>
+#include <QGuiApplication>
+#include <QMetaObject>
+#include <QResizeEvent>
+#include <QScreen>
+#include <QSqlDatabase>
+#include <QTimer>
+
+namespace {
+
+/// Kafel jest zamawiany dopiero, gdy widok przestanie się zmieniać.
+constexpr int kTileDebounceMs = 150;
+
+/// Żyje w FullScreenPhotoViewer::m_decodeThread; treść zdjęcia pobiera raz i trzyma do końca.
+/// `cancelled` ustawia destruktor podglądu — kolejne kroki są wtedy pomijane.
+class PhotoDecodeWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    PhotoDecodeWorker(const QString &photoId,
+                      const QString &sourceConnectionName,
+                      const QSize &fitBounds,
+                      bool loadPreviewThumbnail,
+                      std::shared_ptr<std::atomic<quint64>> latestTile,
+                      std::shared_ptr<std::atomic<bool>> cancelled)
+        : m_photoId(photoId)
+        , m_sourceConnectionName(sourceConnectionName)
+        , m_fitBounds(fitBounds)
+        , m_loadPreviewThumbnail(loadPreviewThumbnail)
+        , m_latestTile(std::move(latestTile))
+        , m_cancelled(std::move(cancelled))
+    {
+    }
+
+    void load()
+    {
+        if (m_cancelled->load())
+            return;
+
+        DatabaseConnectionPool &pool = DatabaseConnectionPool::instance(m_sourceConnectionName);
+        QString errorMessage;
+        {
+            const PooledConnection connection = pool.acquire(&errorMessage);
+            if (connection.isValid()) {
+                const PhotoService photoService(connection.database());
+                if (m_loadPreviewThumbnail)
+                    loadPreviewThumbnail(photoService);
+                if (!m_cancelled->load())
+                    m_data = photoService.loadPhotoData(m_photoId, &errorMessage);
+            }
+        }
+        // Zdjęcie jest już w pamięci — połączenie nie musi czekać do zamknięcia podglądu.
+        pool.closeThreadConnection();
+        if (m_cancelled->load())
+            return;
+        if (m_data.isEmpty()) {
+            emit failed(errorMessage);
+            return;
+        }
+
+        m_originalSize = PhotoService::imageSize(m_data);
+        if (m_originalSize.isValid())
+            emit originalSizeKnown(m_originalSize);
+
+        const QImage fitImage = PhotoService::decodeScaled(m_data, m_fitBounds);
+        if (m_cancelled->load())
+            return;
+        if (fitImage.isNull()) {
+            emit failed(QObject::tr("Nie można zdekodować zdjęcia."));
+            return;
+        }
+        PhotoCache::instance().insert(m_photoId, fitImage, m_fitBounds);
+        emit fitImageReady(fitImage);
+    }
+
+    void decodeTile(quint64 requestId, const QRect &region, const QSize &targetSize)
+    {
+        if (m_cancelled->load() || m_data.isEmpty() || m_latestTile->load() != requestId)
+            return;
+
+        const QImage tile = PhotoService::decodeOrientedRegion(m_data, region, targetSize);
+        if (tile.isNull() || m_cancelled->load() || m_latestTile->load() != requestId)
+            return;
+        emit tileReady(requestId, region, tile);
+    }
+
+signals:
+    void previewReady(const QImage &image);
+    void originalSizeKnown(const QSize &size);
+    void fitImageReady(const QImage &image);
+    void tileReady(quint64 requestId, const QRect &region, const QImage &tile);
+    void failed(const QString &errorMessage);
+
+private:
+    /// Miniatura 480 px to kilkadziesiąt kB — pokazujemy ją, zanim przyjdzie wielomegabajtowy oryginał.
+    void loadPreviewThumbnail(const PhotoService &photoService)
+    {
+        if (m_cancelled->load())
+            return;
+        const QSize previewSize(PhotoService::kPreviewThumbnailSize, PhotoService::kPreviewThumbnailSize);
+        QString errorMessage;
+        const QImage preview = QImage::fromData(
+            photoService.loadPhotoThumbnail(m_photoId, PhotoService::kPreviewThumbnailSize, &errorMessage));
+        if (preview.isNull())
+            return;
+        PhotoCache::instance().insert(m_photoId, preview, previewSize);
+        emit previewReady(preview);
+    }
+
+    QString m_photoId;
+    QString m_sourceConnectionName;
+    QSize m_fitBounds;
+    bool m_loadPreviewThumbnail = false;
+    std::shared_ptr<std::atomic<quint64>> m_latestTile;
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
+    QByteArray m_data;
+    QSize m_originalSize;
+};
+
+}
+
+FullScreenPhotoViewer::FullScreenPhotoViewer(const QString &photoId,
+                                             const QImage &preview,
+                                             const QString &connectionName,
+                                             QWidget *parent)
+    : QMainWindow(parent)
+    , m_latestTile(std::make_shared<std::atomic<quint64>>(0))
+    , m_cancelled(std::make_shared<std::atomic<bool>>(false))
+{
+    setWindowFlags(windowFlags() | Qt::FramelessWindowHint | Qt::WindowStaysOnTopHint);
+
+    setWindowModality(Qt::ApplicationModal);
+    setAttribute(Qt::WA_DeleteOnClose, true);
+
+    m_scene = new QGraphicsScene(this);
+    m_baseItem = m_scene->addPixmap(QPixmap::fromImage(preview));
+    m_baseItem->setTransformationMode(Qt::SmoothTransformation);
+    m_scene->setSceneRect(m_baseItem->boundingRect());
+
+    m_view = new ZoomableGraphicsView(this);
+    m_view->setScene(m_scene);
+    setCentralWidget(m_view);
+
+    m_tileTimer = new QTimer(this);
+    m_tileTimer->setSingleShot(true);
+    m_tileTimer->setInterval(kTileDebounceMs);
+    connect(m_tileTimer, &QTimer::timeout, this, &FullScreenPhotoViewer::requestTile);
+    connect(m_view, &ZoomableGraphicsView::viewportChanged, m_tileTimer, qOverload<>(&QTimer::start));
+
+    const bool loadPreviewThumbnail = preview.width() < PhotoService::kPreviewThumbnailSize
+                                      && preview.height() < PhotoService::kPreviewThumbnailSize;
+    auto *worker = new PhotoDecodeWorker(photoId, connectionName, fitBounds(this), loadPreviewThumbnail,
+                                         m_latestTile, m_cancelled);
+    // Bez rodzica — wątek może przeżyć okno (destruktor nie czeka na pobieranie oryginału).
+    m_decodeThread = new QThread;
+    worker->moveToThread(m_decodeThread);
+    m_decoder = worker;
+    connect(m_decodeThread, &QThread::started, worker, &PhotoDecodeWorker::load);
+    connect(m_decodeThread, &QThread::finished, worker, &QObject::deleteLater);
+    connect(m_decodeThread, &QThread::finished, m_decodeThread, &QObject::deleteLater);
+    connect(worker, &PhotoDecodeWorker::previewReady, this, &FullScreenPhotoViewer::showPreviewImage);
+    connect(worker, &PhotoDecodeWorker::originalSizeKnown, this, &FullScreenPhotoViewer::setOriginalSize);
+    connect(worker, &PhotoDecodeWorker::fitImageReady, this, &FullScreenPhotoViewer::showDecodedImage);
+    connect(worker, &PhotoDecodeWorker::tileReady, this, &FullScreenPhotoViewer::showTile);
+    connect(worker, &PhotoDecodeWorker::failed, this, [](const QString &errorMessage)
+            { qDebug() << "Błąd pobierania oryginału zdjęcia:" << errorMessage; });
+    m_decodeThread->start();
+
+    activateWindow();
+    raise();
+    showFullScreen();
+}
+
+FullScreenPhotoViewer::~FullScreenPhotoViewer()
+{
+    if (!m_decodeThread)
+        return;
+    // Bieżący krok workera kończy się w tle; sygnały do usuniętego okna Qt rozłącza sam.
+    m_cancelled->store(true);
+    m_decodeThread->quit();
+}
+
+QSize FullScreenPhotoViewer::fitBounds(const QWidget *widget)
+{
+    const QScreen *screen = widget ? widget->screen() : QGuiApplication::primaryScreen();
+    if (!screen)
+        return QSize(1920, 1080);
+    return screen->size() * screen->devicePixelRatio();
+}
+
+void FullScreenPhotoViewer::resizeEvent(QResizeEvent *event)
+{
+    QMainWindow::resizeEvent(event);
+    if (m_baseItem && !m_view->isZoomed())
+        fitToWindow();
+}
+
+void FullScreenPhotoViewer::fitToWindow()
+{
+    const QRectF rect = m_scene->sceneRect();
+    if (rect.isEmpty())
+        return;
+
+    m_view->resetZoom();
+    const QSize viewport = m_view->viewport()->size();
+    qreal factor = qMin(viewport.width() / rect.width(), viewport.height() / rect.height());
+    // Miniaturę rozciągamy na ekran; oryginał wyświetlamy co najwyżej 1:1.
+    if (m_originalSize.isValid())
+        factor = qMin(factor, 1.0);
+    m_view->setTransform(QTransform::fromScale(factor, factor));
+    m_tileTimer->start();
+}
+
+void FullScreenPhotoViewer::setOriginalSize(const QSize &size)
+{
+    const QPixmap pixmap = m_baseItem->pixmap();
+    if (!size.isValid() || pixmap.isNull())
+        return;
+
+    m_originalSize = size;
+    m_baseItem->setScale(qreal(size.width()) / pixmap.width());
+    m_scene->setSceneRect(QRectF(QPointF(), QSizeF(size)));
+    if (!m_view->isZoomed())
+        fitToWindow();
+}
+
+void FullScreenPhotoViewer::showPreviewImage(const QImage &image)
+{
+    // Przychodzi przed rozmiarem oryginału; scena jest jeszcze w pikselach podglądu.
+    if (m_originalSize.isValid())
+        return;
+    m_baseItem->setPixmap(QPixmap::fromImage(image));
+    m_scene->setSceneRect(m_baseItem->boundingRect());
+    if (!m_view->isZoomed())
+        fitToWindow();
+}
+
+void FullScreenPhotoViewer::showDecodedImage(const QImage &image)
+{
+    const QPixmap pixmap = QPixmap::fromImage(image);
+    m_baseItem->setPixmap(pixmap);
+    if (m_originalSize.isValid())
+        m_baseItem->setScale(qreal(m_originalSize.width()) / pixmap.width());
+    else
+        setOriginalSize(image.size());
+    m_tileTimer->start();
+}
+
+void FullScreenPhotoViewer::requestTile()
+{
+    if (!m_decoder || !m_originalSize.isValid())
+        return;
+
+    // Kafel ma sens tylko wtedy, gdy obraz bazowy jest pomniejszony, a widok go rozciąga.
+    const qreal baseScale = m_baseItem->scale();
+    const qreal viewScale = m_view->transform().m11();
+    if (baseScale <= 1.01 || viewScale * baseScale <= 1.01) {
+        if (m_tileItem)
+            m_tileItem->setVisible(false);
+        return;
+    }
+
+    const QRect visible = m_view->mapToScene(m_view->viewport()->rect()).boundingRect().toAlignedRect()
+                          & QRect(QPoint(), m_originalSize);
+    if (visible.isEmpty())
+        return;
+
+    const qreal resolution = qMin(viewScale, 1.0);
+    if (m_tileItem && m_tileItem->isVisible() && m_tileRegion.contains(visible)
+        && m_tileResolution >= resolution * 0.99)
+        return;
+
+    const QSize targetSize = QSize(qMax(1, qRound(visible.width() * resolution)),
+                                   qMax(1, qRound(visible.height() * resolution)));
+    const quint64 requestId = m_latestTile->fetch_add(1) + 1;
+    auto *worker = static_cast<PhotoDecodeWorker *>(m_decoder);
+    QMetaObject::invokeMethod(worker,
+                              [worker, requestId, visible, targetSize]()
+                              { worker->decodeTile(requestId, visible, targetSize); },
+                              Qt::QueuedConnection);
+}
+
+void FullScreenPhotoViewer::showTile(quint64 requestId, const QRect &region, const QImage &tile)
+{
+    if (requestId != m_latestTile->load())
+        return;
+
+    const QPixmap pixmap = QPixmap::fromImage(tile);
+    if (!m_tileItem) {
+        m_tileItem = m_scene->addPixmap(pixmap);
+        m_tileItem->setTransformationMode(Qt::SmoothTransformation);
+        m_tileItem->setZValue(1);
+    } else {
+        m_tileItem->setPixmap(pixmap);
+    }
+    m_tileItem->setPos(region.topLeft());
+    m_tileItem->setScale(qreal(region.width()) / pixmap.width());
+    m_tileItem->setVisible(true);
+    m_tileRegion = region;
+    m_tileResolution = qreal(pixmap.width()) / region.width();
+}
 
-// Jeśli nie ma dodatkowych metod, ten plik może być pusty
+#include "fullscreenphotoviewer.moc"
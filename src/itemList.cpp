@@ -32,8 +32,17 @@
 
 #include "itemList.h"
 #include "DatabaseBackupService.h"
+#include "DatabaseConnectionPool.h"
+#include "ItemChangeNotifier.h"
+#include "ItemCsvImporter.h"
 #include "ItemFilterProxyModel.h"
+#include "ItemFilterScheduler.h"
+#include "ItemQueryBuilder.h"
+#include "ItemTableModel.h"
 #include "ItemRepository.h"
+#include "ItemSearchService.h"
+#include "PhotoCache.h"
+#include "PhotoLoader.h"
 #include "PhotoService.h"
 #include "PreviewDialog.h"
 #include "fullscreenphotoviewer.h"
@@ -55,6 +64,7 @@
 #include <QGraphicsPixmapItem>
 #include <QGraphicsScene>
 #include <QGuiApplication>
+#include <QHeaderView>
 #include <QItemSelectionModel>
 #include <QInputDialog>
 #include <QStandardPaths>
@@ -70,20 +80,71 @@
 #include <QSqlDatabase>
 #include <QSqlError>
 #include <QSqlQuery>
-#include <QSqlRelation>
-#include <QSqlRelationalDelegate>
-#include <QSqlRelationalTableModel>
 #include <QStringListModel>
+#include <QStyledItemDelegate>
 #include <QTimer>
 #include <QThread>
 #include <QtMath>
+#include <algorithm>
 #include <functional>
 #include <memory>
+#include <utility>
 #include <QLibraryInfo>
 #include <QPluginLoader>
 
 namespace {
 
+/// Rola z liczbą eksponatów dla pozycji combo boxa filtra (patrz FacetCountDelegate).
+constexpr int kFacetCountRole = Qt::UserRole + 1;
+
+/// Opóźnienie filtra „Szukaj” — filtrujemy dopiero po przerwie w pisaniu.
+constexpr int kNameFilterDelayMs = 300;
+
+/// Po tylu ms zmiana zbiorcza (status, miejsce przechowywania) pokazuje okno postępu.
+constexpr int kBulkProgressDelayMs = 500;
+
+/// Dopisuje „(N)” do pozycji listy combo boxa filtra. Tekst pozycji zostaje samą
+/// nazwą, więc currentText() i findText() dalej porównują czyste wartości słownika.
+class FacetCountDelegate : public QStyledItemDelegate
+{
+public:
+    using QStyledItemDelegate::QStyledItemDelegate;
+
+protected:
+    void initStyleOption(QStyleOptionViewItem *option, const QModelIndex &index) const override
+    {
+        QStyledItemDelegate::initStyleOption(option, index);
+        const QVariant count = index.data(kFacetCountRole);
+        if (count.isValid())
+            option->text = QStringLiteral("%1 (%2)").arg(option->text).arg(count.toInt());
+    }
+};
+
+/// Filtry combo boxów i flagi jako warunek SQL. `withSearchText` — także pole „Szukaj”.
+ItemQueryBuilder sqlFilterQuery(const ItemTableModel &model, const ItemFilterState &state, bool withSearchText)
+{
+    ItemQueryBuilder builder;
+    for (int dictionary = 0; dictionary < ItemTableModel::DictionaryCount; ++dictionary)
+    {
+        const QString &name = state.dictionaryNames[dictionary];
+        const auto column = static_cast<ItemTableModel::Dictionary>(dictionary);
+        if (!name.isEmpty())
+            builder.restrictDictionary(column, model.dictionaryUuids(column, name));
+    }
+    if (state.withoutModelOnly)
+        builder.restrictToPlaceholders(ItemTableModel::ModelDictionary,
+                                       model.placeholderUuids(ItemTableModel::ModelDictionary));
+    if (state.withoutVendorOnly)
+        builder.restrictToPlaceholders(ItemTableModel::VendorDictionary,
+                                       model.placeholderUuids(ItemTableModel::VendorDictionary));
+    builder.setOriginalPackagingOnly(state.originalPackagingOnly);
+    builder.setWithoutDescriptionOnly(state.withoutDescriptionOnly);
+    builder.setWithoutSerialNumberOnly(state.withoutSerialNumberOnly);
+    if (withSearchText)
+        builder.setSearchText(state.searchText);
+    return builder;
+}
+
 QSettings createItemListSettings()
 {
     return QSettings(QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation)
@@ -147,6 +208,52 @@ private:
     QString m_outputPath;
 };
 
+/// v1.5: uzupełnia photo_thumbnails dla zdjęć dodanych przed wprowadzeniem
+/// miniatur. Działa na własnym połączeniu (klon default_connection) — QSqlDatabase
+/// nie może być współdzielony między wątkami.
+class ThumbnailBackfillWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ThumbnailBackfillWorker(const QString &sourceConnectionName)
+        : m_sourceConnectionName(sourceConnectionName)
+    {
+    }
+
+signals:
+    void finished(bool success, int generatedCount, const QString &errorMessage);
+
+public slots:
+    void run()
+    {
+        bool success = false;
+        int generatedCount = 0;
+        QString errorMessage;
+        {
+            // Połączenie wątku z puli — zamykane razem z wątkiem po zakończeniu pracy.
+            const PooledConnection connection = DatabaseConnectionPool::instance(m_sourceConnectionName)
+                                                    .acquire(&errorMessage);
+            if (connection.isValid())
+            {
+                const PhotoService photoService(connection.database());
+                success = photoService.backfillThumbnails(&generatedCount,
+                                                          &errorMessage,
+                                                          [](int, int)
+                                                          {
+                                                              return !QThread::currentThread()
+                                                                          ->isInterruptionRequested();
+                                                          });
+            }
+        }
+
+        emit finished(success, generatedCount, errorMessage);
+    }
+
+private:
+    QString m_sourceConnectionName;
+};
+
 }
 
 /**
@@ -155,7 +262,7 @@ private:
  *
  * @section ConstructorOverview
  * Inicjalizuje interfejs użytkownika, ustanawia połączenie z bazą danych MySQL, konfiguruje
- * model danych (QSqlRelationalTableModel), model proxy (ItemFilterProxyModel), filtry
+ * model danych (ItemTableModel), model proxy (ItemFilterProxyModel), filtry
  * kaskadowe w combo boxach oraz podłącza sygnały i sloty dla przycisków, tabeli i interakcji
  * ze zdjęciami. W razie potrzeby tworzy schemat bazy danych i wstawia przykładowe dane.
  */
@@ -176,6 +283,9 @@ itemList::itemList(QWidget *parent)
     filterStatusComboBox = ui->filterStatusComboBox;
     filterStorageComboBox = ui->filterStorageComboBox;
     filterNameLineEdit = ui->filterNameLineEdit;
+    for (QComboBox *comboBox : {filterTypeComboBox, filterVendorComboBox, filterModelComboBox,
+                                filterStatusComboBox, filterStorageComboBox})
+        comboBox->setItemDelegate(new FacetCountDelegate(comboBox));
     qDebug() << "itemList: Pola UI zainicjalizowane";
     ui->labelFilterName->setText(tr("Szukaj:"));
 
@@ -217,44 +327,72 @@ itemList::itemList(QWidget *parent)
     }
     qDebug() << "itemList: Konstruktor zakończony";
 
-    // Model źródłowy
-    m_sourceModel = new QSqlRelationalTableModel(this, db);
-    m_sourceModel->setTable("eksponaty");
-    m_sourceModel->setEditStrategy(QSqlRelationalTableModel::OnManualSubmit);
-    m_sourceModel->setRelation(2, QSqlRelation("types", "id", "name"));
-    m_sourceModel->setRelation(3, QSqlRelation("vendors", "id", "name"));
-    m_sourceModel->setRelation(4, QSqlRelation("models", "id", "name"));
-    m_sourceModel->setRelation(9, QSqlRelation("statuses", "id", "name"));
-    m_sourceModel->setRelation(10, QSqlRelation("storage_places", "id", "name"));
-    m_sourceModel->select();
-
-    // Ustaw nagłówki kolumn
-    m_sourceModel->setHeaderData(0, Qt::Horizontal, tr("ID"));
-    m_sourceModel->setHeaderData(1, Qt::Horizontal, tr("Nazwa"));
-    m_sourceModel->setHeaderData(2, Qt::Horizontal, tr("Typ"));
-    m_sourceModel->setHeaderData(3, Qt::Horizontal, tr("Producent"));
-    m_sourceModel->setHeaderData(4, Qt::Horizontal, tr("Model"));
-    m_sourceModel->setHeaderData(5, Qt::Horizontal, tr("Numer seryjny"));
-    m_sourceModel->setHeaderData(6, Qt::Horizontal, tr("Part number"));
-    m_sourceModel->setHeaderData(7, Qt::Horizontal, tr("Revision"));
-    m_sourceModel->setHeaderData(8, Qt::Horizontal, tr("Rok produkcji"));
-    m_sourceModel->setHeaderData(9, Qt::Horizontal, tr("Status"));
-    m_sourceModel->setHeaderData(10, Qt::Horizontal, tr("Miejsce przechowywania"));
-    m_sourceModel->setHeaderData(11, Qt::Horizontal, tr("Opis"));
-    m_sourceModel->setHeaderData(12, Qt::Horizontal, tr("Ilość"));
-    m_sourceModel->setHeaderData(13, Qt::Horizontal, tr("Oryg. opak."));
+    // Model źródłowy — kolumnowy model w pamięci zamiast QSqlRelationalTableModel
+    m_sourceModel = new ItemTableModel(db, this);
+    // v1.5: duże zdalne katalogi — lista otwiera się od COUNT(*) i pierwszej strony,
+    // resztę dociąga przewijanie (0 = cała tabela naraz).
+    m_sourceModel->setPageSize(settings.value("itemList/page_size", 0).toInt());
+    // Przy stronicowaniu filtry zawsze idą do SQL — inaczej widziałyby tylko wczytane strony.
+    m_sqlFilters = m_sourceModel->pageSize() > 0 || settings.value("itemList/sql_filters", false).toBool();
+    QString loadError;
+    if (!m_sourceModel->reload(&loadError))
+        qDebug() << "itemList: Błąd wczytywania listy eksponatów:" << loadError;
+
+    // Zapisy przez ItemRepository łatają pojedyncze wiersze zamiast pełnego reload().
+    connect(&ItemChangeNotifier::instance(), &ItemChangeNotifier::itemsChanged, m_sourceModel,
+            [this](const QStringList &itemIds)
+            {
+        QString errorMessage;
+        if (!m_sourceModel->refreshItems(itemIds, &errorMessage))
+            qDebug() << "itemList: Błąd odświeżania zmienionych rekordów:" << errorMessage;
+        // Wynik indeksu pełnotekstowego nie zna nowych treści — pytamy bazę ponownie.
+        if (m_filterScheduler && m_proxyModel->hasFullTextMatches())
+            scheduleFilter();
+        updateHeaderSummary(); });
+    connect(&ItemChangeNotifier::instance(), &ItemChangeNotifier::itemsRemoved, m_sourceModel,
+            [this](const QStringList &itemIds)
+            {
+        m_sourceModel->removeItems(itemIds);
+        updateHeaderSummary(); });
 
     // Model proxy
     m_proxyModel = new ItemFilterProxyModel(this);
     m_proxyModel->setSourceModel(m_sourceModel);
 
+    // Każda zmiana filtrów przechodzi przez ItemFilterScheduler — łączenie zmian,
+    // filtry SQL i indeks pełnotekstowy w wątku GUI, dopasowanie wierszy w tle.
+    m_filterScheduler = new ItemFilterScheduler(m_sourceModel, m_proxyModel, this);
+    m_filterScheduler->setFullTextSearch([](const QString &text, QStringList *rankedItemIds)
+                                         {
+        const ItemSearchService searchService;
+        QString errorMessage;
+        if (searchService.search(text, rankedItemIds, &errorMessage))
+            return true;
+        if (!errorMessage.isEmpty())
+            qDebug() << "itemList: Szukanie pełnotekstowe niedostępne, szukam w pamięci:" << errorMessage;
+        return false; });
+    connect(m_filterScheduler, &ItemFilterScheduler::aboutToFilter, this, &itemList::applySqlRowFilter);
+    connect(m_filterScheduler, &ItemFilterScheduler::filtered, this,
+            [this](const ItemFilterState &state, const ItemFilterProxyModel::FacetCounts &facets)
+            {
+        // Model z filtrami SQL nie ma rekordów innych wartości — liczniki z bazy.
+        ItemFilterProxyModel::FacetCounts sqlFacets;
+        if (m_sqlFilters && sqlFacetCounts(state, &sqlFacets))
+            updateFilterComboBoxes(sqlFacets);
+        else
+            updateFilterComboBoxes(facets); });
+
     // Konfiguracja widoku tabeli
     ui->itemList_tableView->setModel(m_proxyModel);
-    ui->itemList_tableView->setItemDelegate(new QSqlRelationalDelegate(ui->itemList_tableView));
     ui->itemList_tableView->setSelectionBehavior(QAbstractItemView::SelectRows);
     ui->itemList_tableView->setSelectionMode(QAbstractItemView::ExtendedSelection);
     ui->itemList_tableView->setEditTriggers(QAbstractItemView::NoEditTriggers);
     ui->itemList_tableView->hideColumn(0); // Ukryj kolumnę UUID
+    // Sortowanie po kliknięciu nagłówka (ItemTableModel::sort). Bez wskaźnika
+    // na starcie — setSortingEnabled posortowałoby od razu po ukrytej kolumnie UUID.
+    // Przy stronicowaniu (itemList/page_size) sortuje baza, od pierwszej strony.
+    ui->itemList_tableView->horizontalHeader()->setSortIndicator(-1, Qt::AscendingOrder);
+    ui->itemList_tableView->setSortingEnabled(true);
     ui->itemList_tableView->resizeColumnsToContents();
 
     // Połączenia przycisków
@@ -280,12 +418,31 @@ itemList::itemList(QWidget *parent)
             this,
             &itemList::onBulkStorageButtonClicked);
     connect(ui->itemList_pushButton_end, &QPushButton::clicked, this, &itemList::onEndButtonClicked);
+    connect(ui->itemList_pushButton_importCsv,
+            &QPushButton::clicked,
+            this,
+            &itemList::onImportCsvButtonClicked);
     connect(ui->itemList_pushButton_backup,
             &QPushButton::clicked,
             this,
             &itemList::onBackupButtonClicked);
+    // v1.5: przenoszenie zdjęć do magazynu plików tylko na żądanie — katalog z
+    // photos/blob_store_dir musi być widoczny ze wszystkich stanowisk.
+    ui->itemList_pushButton_migrateBlobs->setVisible(!PhotoBlobStore::directoryFromSettings().isEmpty());
+    connect(ui->itemList_pushButton_migrateBlobs,
+            &QPushButton::clicked,
+            this,
+            &itemList::onMigrateBlobsButtonClicked);
     connect(ui->itemList_pushButton_about, &QPushButton::clicked, this, &itemList::onAboutClicked);
 
+    m_photoLoader = new PhotoLoader(QStringLiteral("default_connection"), this);
+    connect(m_photoLoader, &PhotoLoader::photosListed, this, &itemList::onPhotosListed);
+    connect(m_photoLoader, &PhotoLoader::photoReady, this, &itemList::onPhotoReady);
+    connect(m_photoLoader, &PhotoLoader::loadFailed, this, [this](quint64, const QString &errorMessage)
+            {
+        qDebug() << "Błąd pobierania zdjęć:" << errorMessage;
+        replaceScene(ui->itemList_graphicsView, nullptr); });
+
     connect(ui->itemList_tableView->selectionModel(),
             &QItemSelectionModel::selectionChanged,
             this,
@@ -298,7 +455,7 @@ itemList::itemList(QWidget *parent)
                 if (!proxyIdx.isValid())
                     return;
                 const QModelIndex srcIdx = m_proxyModel->mapToSource(proxyIdx);
-                const QString recordId = m_sourceModel->data(m_sourceModel->index(srcIdx.row(), 0)).toString();
+                const QString recordId = m_sourceModel->itemId(srcIdx.row());
                 if (recordId.isEmpty())
                     return;
                 auto *preview = new PreviewDialog(QSqlDatabase::database("default_connection"), recordId, this);
@@ -307,12 +464,15 @@ itemList::itemList(QWidget *parent)
                 preview->show();
             });
 
-    // Inicjalizacja timera utrzymującego połączenie
+    // Inicjalizacja timera utrzymującego połączenie — acquire() sprawdza bezczynne
+    // połączenie (SELECT 1) i po zerwaniu łączy się ponownie.
     m_keepAliveTimer = new QTimer(this);
     connect(m_keepAliveTimer, &QTimer::timeout, this, []()
             {
-        QSqlQuery q(QSqlDatabase::database("default_connection"));
-        q.exec("SELECT 1"); });
+        QString errorMessage;
+        const PooledConnection connection = DatabaseConnectionPool::instance().acquire(&errorMessage);
+        if (!connection.isValid())
+            qDebug() << "itemList: keep-alive:" << errorMessage; });
     m_keepAliveTimer->start(30000);
 
     // Inicjalizacja timera do sprawdzania pozycji kursora
@@ -331,16 +491,6 @@ itemList::itemList(QWidget *parent)
             }
         } });
 
-    // Inicjalizacja timera dla opóźnienia filtrowania
-    m_nameFilterTimer = new QTimer(this);
-    m_nameFilterTimer->setSingleShot(true);
-    connect(m_nameFilterTimer, &QTimer::timeout, this, [this]()
-            {
-        qDebug() << "itemList: Wykonuję opóźnione filtrowanie, tekst:"
-                 << filterNameLineEdit->text();
-        m_proxyModel->setNameFilter(filterNameLineEdit->text());
-        updateFilterComboBoxes(); });
-
     // Inicjalizacja filtrów
     initFilters(db);
 
@@ -395,17 +545,13 @@ itemList::itemList(QWidget *parent)
             &itemList::onClearFiltersClicked);
 
     restoreSavedFilters();
-    onFilterChanged();
-    m_proxyModel->setNameFilter(filterNameLineEdit->text());
-    m_proxyModel->setOriginalPackagingFilter(ui->filterOriginalPackaging->isChecked());
-    m_proxyModel->setWithoutDescriptionFilter(ui->filterWithoutDescription->isChecked());
-    m_proxyModel->setWithoutSerialNumberFilter(ui->filterWithoutSerialNumber->isChecked());
-    m_proxyModel->setWithoutModelFilter(ui->filterWithoutModel->isChecked());
-    m_proxyModel->setWithoutVendorFilter(ui->filterWithoutVendor->isChecked());
-    updateFilterComboBoxes();
+    // Przywrócone filtry — jeden przebieg, od razu, żeby lista nie mignęła bez filtrów.
+    m_filterScheduler->schedule(currentFilterState());
+    m_filterScheduler->flush();
     m_filtersInitialized = true;
     saveCurrentFilters();
     updateHeaderSummary();
+    startThumbnailBackfill();
 }
 
 /**
@@ -418,9 +564,49 @@ itemList::~itemList()
 {
     if (m_keepAliveTimer)
         m_keepAliveTimer->stop();
+    if (m_thumbnailBackfillThread)
+    {
+        m_thumbnailBackfillThread->requestInterruption();
+        m_thumbnailBackfillThread->quit();
+        m_thumbnailBackfillThread->wait();
+    }
     delete ui;
 }
 
+/**
+ * @brief Uruchamia w tle generowanie brakujących miniatur zdjęć.
+ *
+ * @section MethodOverview
+ * Zdjęcia zapisane przed v1.5 nie mają wierszy w photo_thumbnails. Worker w osobnym
+ * wątku uzupełnia je jednorazowo; do tego czasu PhotoService::loadThumbnails
+ * generuje brakujące miniatury na żądanie.
+ */
+void itemList::startThumbnailBackfill()
+{
+    if (m_thumbnailBackfillThread)
+        return;
+
+    auto *thread = new QThread(this);
+    auto *worker = new ThumbnailBackfillWorker(QStringLiteral("default_connection"));
+    worker->moveToThread(thread);
+
+    connect(thread, &QThread::started, worker, &ThumbnailBackfillWorker::run);
+    connect(worker,
+            &ThumbnailBackfillWorker::finished,
+            this,
+            [thread](bool success, int generatedCount, const QString &errorMessage)
+            {
+        if (success)
+            qDebug() << "itemList: Wygenerowano brakujące miniatury:" << generatedCount;
+        else
+            qDebug() << "itemList: Backfill miniatur nie powiódł się:" << errorMessage;
+        thread->quit(); });
+    connect(thread, &QThread::finished, worker, &QObject::deleteLater);
+    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+    m_thumbnailBackfillThread = thread;
+    thread->start(QThread::LowPriority);
+}
+
 void itemList::closeEvent(QCloseEvent *event)
 {
     QSettings settings = createItemListSettings();
@@ -562,7 +748,8 @@ void itemList::refreshFilters()
     restoreFilter(filterModelComboBox, currentModel);
     restoreFilter(filterStatusComboBox, currentStatus);
     restoreFilter(filterStorageComboBox, currentStorage);
-    updateHeaderSummary();
+    // initFilters wypełnił combo boxy pełnymi listami — liczniki wrócą z filtrowaniem.
+    scheduleFilter();
 }
 
 /**
@@ -571,13 +758,14 @@ void itemList::refreshFilters()
  * @param deselected Odznaczone indeksy.
  *
  * @section MethodOverview
- * Wczytuje zdjęcia powiązane z wybranym eksponatem z tabeli photos i wyświetla ich miniatury
- * w QGraphicsView.
+ * Wczytuje miniatury zdjęć wybranego eksponatu z tabeli photo_thumbnails i wyświetla je
+ * w QGraphicsView. Pełne oryginały są pobierane dopiero przy podglądzie lub pełnym ekranie.
  */
 void itemList::onTableViewSelectionChanged(const QItemSelection &selected, const QItemSelection &)
 {
     if (selected.indexes().isEmpty())
     {
+        m_photoLoader->cancel();
         replaceScene(ui->itemList_graphicsView, nullptr);
         m_currentRecordId.clear();
         return;
@@ -586,6 +774,7 @@ void itemList::onTableViewSelectionChanged(const QItemSelection &selected, const
     if (ui->itemList_tableView->selectionModel()
         && ui->itemList_tableView->selectionModel()->selectedRows().size() != 1)
     {
+        m_photoLoader->cancel();
         replaceScene(ui->itemList_graphicsView, nullptr);
         m_currentRecordId.clear();
         return;
@@ -593,67 +782,61 @@ void itemList::onTableViewSelectionChanged(const QItemSelection &selected, const
 
     QModelIndex proxyIndex = selected.indexes().first();
     QModelIndex srcIndex = m_proxyModel->mapToSource(proxyIndex);
-    m_currentRecordId = m_sourceModel->data(m_sourceModel->index(srcIndex.row(), 0)).toString();
+    m_currentRecordId = m_sourceModel->itemId(srcIndex.row());
 
-    PhotoService photoService(QSqlDatabase::database("default_connection"));
-    QString errorMessage;
-    const QList<StoredPhoto> photos = photoService.loadStoredPhotos(m_currentRecordId, &errorMessage);
-    if (!errorMessage.isEmpty())
-    {
-        qDebug() << "Błąd pobierania zdjęć (MySQL):" << errorMessage;
-        replaceScene(ui->itemList_graphicsView, nullptr);
-        return;
-    }
+    // Miniatury ładuje PhotoLoader w tle — poprzednia scena znika od razu,
+    // a nieaktualne żądanie (szybkie przewijanie tabeli) jest anulowane.
+    replaceScene(ui->itemList_graphicsView, nullptr);
+    m_photoLoader->requestThumbnails(m_currentRecordId, PhotoService::kListThumbnailSize);
+}
 
-    int viewWidth = ui->itemList_graphicsView->viewport()->width() - 10;
-    int viewHeight = ui->itemList_graphicsView->viewport()->height() - 10;
+/**
+ * @brief Rysuje placeholdery miniatur, zanim zdjęcia zostaną zdekodowane.
+ *
+ * @section MethodOverview
+ * Układa siatkę komórek dla wszystkich zdjęć eksponatu. Każdy PhotoItem trzyma ID zdjęcia
+ * (photoId) i rozmiar komórki (data 0); onPhotoReady podmienia placeholder na miniaturę.
+ */
+void itemList::onPhotosListed(quint64 requestId, const QString &itemId, const QStringList &photoIds)
+{
+    if (requestId != m_photoLoader->currentRequestId() || itemId != m_currentRecordId)
+        return;
 
-    if (photos.isEmpty())
+    if (photoIds.isEmpty())
     {
         replaceScene(ui->itemList_graphicsView, nullptr);
         return;
     }
 
-    showStoredPhotos(photos);
-}
-
-void itemList::showStoredPhotos(const QList<StoredPhoto> &photos)
-{
     int viewWidth = ui->itemList_graphicsView->viewport()->width() - 10;
     int viewHeight = ui->itemList_graphicsView->viewport()->height() - 10;
 
     QGraphicsScene *scene = new QGraphicsScene(this);
     const int spacing = 5;
-    int photoCount = photos.size();
+    int photoCount = photoIds.size();
 
     int cols = qMax(1, qMin(qCeil(qSqrt(photoCount)), viewWidth / 100));
     int rows = (photoCount + cols - 1) / cols;
-    int maxThumbnailWidth = (viewWidth - (cols - 1) * spacing) / cols;
-    int maxThumbnailHeight = (viewHeight - (rows - 1) * spacing) / rows;
+    int maxThumbnailWidth = qMax(1, (viewWidth - (cols - 1) * spacing) / cols);
+    int maxThumbnailHeight = qMax(1, (viewHeight - (rows - 1) * spacing) / rows);
+    const QSize cellSize(maxThumbnailWidth, maxThumbnailHeight);
+
+    QPixmap placeholder(cellSize);
+    placeholder.fill(QColor(128, 128, 128, 60));
 
-    int x = 5, y = 5;
     for (int i = 0; i < photoCount; i++)
     {
-        QPixmap original = photos[i].pixmap;
-        QPixmap scaled = original.scaled(maxThumbnailWidth,
-                                         maxThumbnailHeight,
-                                         Qt::KeepAspectRatio,
-                                         Qt::SmoothTransformation);
         PhotoItem *item = new PhotoItem();
-        item->setPixmap(scaled);
-        item->setData(0, QVariant(original));
-        item->setPos(x, y);
+        item->setPixmap(placeholder);
+        // v1.5: zamiast oryginału trzymamy ID zdjęcia — oryginał ładowany leniwie.
+        item->setPhotoId(photoIds[i]);
+        item->setData(0, cellSize);
+        item->setPos(5 + (i % cols) * (maxThumbnailWidth + spacing),
+                     5 + (i / cols) * (maxThumbnailHeight + spacing));
         scene->addItem(item);
 
         connect(item, &PhotoItem::clicked, this, &itemList::onPhotoHovered);
         connect(item, &PhotoItem::doubleClicked, this, &itemList::onPhotoClicked);
-
-        x += scaled.width() + spacing;
-        if ((i + 1) % cols == 0)
-        {
-            x = 5;
-            y += scaled.height() + spacing;
-        }
     }
 
     int totalWidth = cols * maxThumbnailWidth + (cols - 1) * spacing + 10;
@@ -663,6 +846,33 @@ void itemList::showStoredPhotos(const QList<StoredPhoto> &photos)
     ui->itemList_graphicsView->fitInView(scene->sceneRect(), Qt::KeepAspectRatio);
 }
 
+void itemList::onPhotoReady(quint64 requestId, const QString &photoId, const QImage &image)
+{
+    if (requestId != m_photoLoader->currentRequestId())
+        return;
+
+    QGraphicsScene *scene = ui->itemList_graphicsView->scene();
+    if (!scene)
+        return;
+
+    const QList<QGraphicsItem *> items = scene->items();
+    for (QGraphicsItem *graphicsItem : items)
+    {
+        PhotoItem *item = dynamic_cast<PhotoItem *>(graphicsItem);
+        if (!item || item->photoId() != photoId)
+            continue;
+
+        const QSize cellSize = item->data(0).toSize();
+        const QPixmap scaled = QPixmap::fromImage(image).scaled(cellSize,
+                                                                Qt::KeepAspectRatio,
+                                                                Qt::SmoothTransformation);
+        item->setPixmap(scaled);
+        item->setOffset((cellSize.width() - scaled.width()) / 2.0,
+                        (cellSize.height() - scaled.height()) / 2.0);
+        return;
+    }
+}
+
 QString itemList::selectedRecordIdOrWarn(const QString &message) const
 {
     auto *sel = ui->itemList_tableView->selectionModel();
@@ -674,7 +884,7 @@ QString itemList::selectedRecordIdOrWarn(const QString &message) const
 
     QModelIndex proxyIdx = sel->selectedRows().first();
     QModelIndex srcIdx = m_proxyModel->mapToSource(proxyIdx);
-    return m_sourceModel->data(m_sourceModel->index(srcIdx.row(), 0)).toString();
+    return m_sourceModel->itemId(srcIdx.row());
 }
 
 QString itemList::selectedSingleRecordIdOrWarn(const QString &emptyMessage,
@@ -695,7 +905,7 @@ QString itemList::selectedSingleRecordIdOrWarn(const QString &emptyMessage,
     }
 
     const QModelIndex srcIdx = m_proxyModel->mapToSource(rows.first());
-    return m_sourceModel->data(m_sourceModel->index(srcIdx.row(), 0)).toString();
+    return m_sourceModel->itemId(srcIdx.row());
 }
 
 QStringList itemList::selectedRecordIds() const
@@ -709,7 +919,7 @@ QStringList itemList::selectedRecordIds() const
     for (const QModelIndex &proxyIdx : rows)
     {
         const QModelIndex srcIdx = m_proxyModel->mapToSource(proxyIdx);
-        ids << m_sourceModel->data(m_sourceModel->index(srcIdx.row(), 0)).toString();
+        ids << m_sourceModel->itemId(srcIdx.row());
     }
     return ids;
 }
@@ -722,7 +932,7 @@ QString itemList::selectedRecordName() const
 
     const QModelIndex proxyIdx = sel->selectedRows().first();
     const QModelIndex srcIdx = m_proxyModel->mapToSource(proxyIdx);
-    return m_sourceModel->data(m_sourceModel->index(srcIdx.row(), 1)).toString();
+    return m_sourceModel->itemName(srcIdx.row());
 }
 
 void itemList::openRecordWindowForNew()
@@ -909,7 +1119,6 @@ void itemList::onDeleteButtonClicked()
                 ui->itemList_tableView->selectionModel()->clearSelection();
             replaceScene(ui->itemList_graphicsView, nullptr);
             m_currentRecordId.clear();
-            m_sourceModel->select();
             QMessageBox::information(this, tr("Sukces"), tr("Rekord usunięty."));
         }
     }
@@ -947,6 +1156,118 @@ void itemList::onAboutClicked()
     QMessageBox::about(this, tr("O programie"), html);
 }
 
+void itemList::onImportCsvButtonClicked()
+{
+    const QString filePath = QFileDialog::getOpenFileName(this,
+                                                          tr("Importuj eksponaty z CSV"),
+                                                          QString(),
+                                                          tr("Pliki CSV (*.csv *.txt)"));
+    if (filePath.isEmpty())
+        return;
+
+    // Postęp w bajtach pliku — importer czyta strumieniowo i nie zna liczby wierszy.
+    constexpr int kProgressScale = 1000;
+    QProgressDialog progress(tr("Importuję eksponaty..."), tr("Anuluj"), 0, kProgressScale, this);
+    progress.setWindowTitle(tr("Import CSV"));
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(kBulkProgressDelayMs);
+    const auto onProgress = [&progress](qint64 bytesRead, qint64 totalBytes)
+    {
+        if (totalBytes > 0)
+            progress.setValue(static_cast<int>(bytesRead * kProgressScale / totalBytes));
+        return !progress.wasCanceled();
+    };
+
+    ItemCsvImporter importer(QSqlDatabase::database("default_connection"));
+    ItemImportResult result;
+    QString errorMessage;
+    const bool imported = importer.importFile(filePath, &result, &errorMessage, onProgress);
+    progress.reset();
+    if (result.importedCount > 0 || result.createdDictionaryEntries > 0)
+        refreshFilters();
+
+    if (!imported)
+    {
+        QMessageBox::critical(this,
+                              tr("Błąd importu"),
+                              tr("Import przerwany (zapisano %1 rekordów):\n%2")
+                                  .arg(result.importedCount)
+                                  .arg(errorMessage));
+        return;
+    }
+
+    QMessageBox box(result.rowErrors.isEmpty() ? QMessageBox::Information : QMessageBox::Warning,
+                    tr("Import CSV"),
+                    tr("Zaimportowano %1 rekordów, pominięto %2 wierszy, dodano %3 wpisów słowników.")
+                        .arg(result.importedCount)
+                        .arg(result.rowErrors.size())
+                        .arg(result.createdDictionaryEntries),
+                    QMessageBox::Ok,
+                    this);
+    if (!result.rowErrors.isEmpty())
+    {
+        QStringList details;
+        for (const ItemImportRowError &error : std::as_const(result.rowErrors))
+            details.append(tr("Linia %1: %2").arg(error.line).arg(error.message));
+        box.setDetailedText(details.join(QLatin1Char('\n')));
+    }
+    box.exec();
+}
+
+void itemList::onMigrateBlobsButtonClicked()
+{
+    const PhotoService photoService(QSqlDatabase::database("default_connection"));
+    const QString storeDirectory = photoService.blobStore().rootDirectory();
+    if (!photoService.blobStore().isEnabled())
+        return;
+
+    // Po przeniesieniu treść zdjęć jest tylko w plikach — stanowisko bez tego
+    // katalogu (albo z innym photos/blob_store_dir) przestanie widzieć zdjęcia.
+    const auto answer = QMessageBox::question(this,
+                                              tr("Zdjęcia do plików"),
+                                              tr("Treść zdjęć zostanie przeniesiona z bazy danych do katalogu:\n%1\n\n"
+                                                 "Wszystkie stanowiska muszą mieć ten sam katalog (udział sieciowy) "
+                                                 "ustawiony jako photos/blob_store_dir. Kontynuować?")
+                                                  .arg(QDir::toNativeSeparators(storeDirectory)),
+                                              QMessageBox::Yes | QMessageBox::No,
+                                              QMessageBox::No);
+    if (answer != QMessageBox::Yes)
+        return;
+
+    QProgressDialog progress(tr("Przenoszę zdjęcia do plików..."), tr("Anuluj"), 0, 0, this);
+    progress.setWindowTitle(tr("Zdjęcia do plików"));
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(kBulkProgressDelayMs);
+    const auto onProgress = [&progress](int done, int total)
+    {
+        progress.setMaximum(total);
+        progress.setValue(done);
+        return !progress.wasCanceled();
+    };
+
+    int movedCount = 0;
+    QString errorMessage;
+    const bool migrated = photoService.migrateBlobsToFileStore(&movedCount, &errorMessage, onProgress);
+    const bool cancelled = progress.wasCanceled();
+    progress.reset();
+
+    if (!migrated)
+    {
+        QMessageBox::critical(this,
+                              tr("Zdjęcia do plików"),
+                              tr("Przenoszenie przerwane (przeniesiono %1 zdjęć):\n%2")
+                                  .arg(movedCount)
+                                  .arg(errorMessage));
+        return;
+    }
+    QMessageBox::information(this,
+                             tr("Zdjęcia do plików"),
+                             cancelled ? tr("Przenoszenie anulowane — przeniesiono %1 zdjęć. "
+                                            "Można je wznowić w dowolnym momencie.")
+                                             .arg(movedCount)
+                                       : tr("Przeniesiono %1 zdjęć do magazynu plików.").arg(movedCount));
+}
+
 void itemList::onBackupButtonClicked()
 {
     DatabaseBackupService backupService(QSqlDatabase::database("default_connection"));
@@ -1087,10 +1408,6 @@ void itemList::onPhotoHovered(PhotoItem *item)
         m_currentHoveredItem = nullptr;
     }
 
-    QPixmap originalPixmap = item->data(0).value<QPixmap>();
-    if (originalPixmap.isNull())
-        return;
-
     QScreen *screen = QGuiApplication::primaryScreen();
     if (!screen)
         return;
@@ -1101,10 +1418,34 @@ void itemList::onPhotoHovered(PhotoItem *item)
 
     int maxWidth = screenGeometry.width() * 0.8;
     int maxHeight = screenGeometry.height() * 0.8;
-    QPixmap scaled = originalPixmap.scaled(maxWidth,
-                                           maxHeight,
-                                           Qt::KeepAspectRatio,
-                                           Qt::SmoothTransformation);
+
+    // v1.5: miniatura w scenie nie trzyma oryginału. Najpierw podgląd w tym rozmiarze
+    // z PhotoCache, potem oryginał (oglądany na pełnym ekranie); w ostateczności
+    // dekodujemy od razu do rozmiaru podglądu (QImageReader::setScaledSize) i zapisujemy
+    // w cache. Końcowe scaled() tylko powiększa małe zdjęcia, jak dotychczas.
+    const QString photoId = item->photoId();
+    const QSize previewBounds(maxWidth, maxHeight);
+    PhotoCache &photoCache = PhotoCache::instance();
+    QImage previewImage = photoCache.find(photoId, previewBounds);
+    if (previewImage.isNull())
+        previewImage = photoCache.find(photoId);
+    if (previewImage.isNull())
+    {
+        PhotoService photoService(QSqlDatabase::database("default_connection"));
+        QString errorMessage;
+        previewImage = photoService.loadScaledPhoto(photoId, previewBounds, &errorMessage);
+        if (previewImage.isNull())
+        {
+            qDebug() << "Błąd pobierania oryginału zdjęcia:" << errorMessage;
+            return;
+        }
+        photoCache.insert(photoId, previewImage, previewBounds);
+    }
+
+    QPixmap scaled = QPixmap::fromImage(previewImage).scaled(maxWidth,
+                                                             maxHeight,
+                                                             Qt::KeepAspectRatio,
+                                                             Qt::SmoothTransformation);
 
     m_previewWindow = new QWidget(this,
                                   Qt::FramelessWindowHint | Qt::WindowStaysOnTopHint | Qt::Tool);
@@ -1215,15 +1556,32 @@ bool itemList::eventFilter(QObject *watched, QEvent *event)
  * @param item Wskaźnik na element PhotoItem.
  *
  * @section MethodOverview
- * Tworzy nowe okno FullScreenPhotoViewer z oryginalnym zdjęciem i wyświetla je.
+ * Gdy oryginał jest we wspólnym cache (PhotoCache::instance()), wyświetla go od razu.
+ * W przeciwnym razie okno FullScreenPhotoViewer startuje z najlepszym dostępnym podglądem
+ * (obraz dopasowany do ekranu, miniatura 480 px albo miniatura 160 px ze sceny), a ostrą
+ * wersję dekoduje w tle — kliknięcie nie blokuje GUI na czas odczytu BLOB-a. Miniaturę 480 px
+ * okno dociąga samo, zanim pobierze oryginał.
  */
 void itemList::onPhotoClicked(PhotoItem *item)
 {
-    QPixmap original = item->data(0).value<QPixmap>();
-    if (original.isNull())
+    const QString photoId = item->photoId();
+    const QImage original = PhotoCache::instance().find(photoId);
+    if (!original.isNull())
+    {
+        FullScreenPhotoViewer *viewer = new FullScreenPhotoViewer(QPixmap::fromImage(original), this);
+        viewer->show();
         return;
+    }
+
+    QImage preview = PhotoCache::instance().find(photoId, FullScreenPhotoViewer::fitBounds(this));
+    if (preview.isNull())
+        preview = PhotoCache::instance().find(photoId,
+                                              QSize(PhotoService::kPreviewThumbnailSize,
+                                                    PhotoService::kPreviewThumbnailSize));
+    if (preview.isNull())
+        preview = item->pixmap().toImage();
 
-    FullScreenPhotoViewer *viewer = new FullScreenPhotoViewer(original, this);
+    FullScreenPhotoViewer *viewer = new FullScreenPhotoViewer(photoId, preview, QStringLiteral("default_connection"), this);
     viewer->show();
 }
 
@@ -1232,11 +1590,14 @@ void itemList::onPhotoClicked(PhotoItem *item)
  * @param recordId ID zapisanego rekordu.
  *
  * @section MethodOverview
- * Wywołuje refreshList z podanym ID rekordu, aby odświeżyć widok i zaznaczyć zapisany rekord.
+ * Wiersz rekordu jest już w modelu (ItemChangeNotifier → ItemTableModel::refreshItems),
+ * więc odświeża tylko combo boxy filtrów i zaznacza zapisany rekord — bez pełnego reload().
  */
 void itemList::onRecordSaved(const QString &recordId)
 {
-    refreshList(recordId);
+    refreshFilters();
+    selectRecord(recordId);
+    updateHeaderSummary();
 }
 
 /**
@@ -1249,10 +1610,10 @@ void itemList::onRecordSaved(const QString &recordId)
 void itemList::refreshList(const QString &recordId)
 {
     qDebug() << "itemList: Rozpoczynam refreshList, recordId:" << recordId;
-    if (!m_sourceModel->select())
+    QString errorMessage;
+    if (!m_sourceModel->reload(&errorMessage))
     {
-        qDebug() << "itemList: Błąd w m_sourceModel->select():"
-                 << m_sourceModel->lastError().text();
+        qDebug() << "itemList: Błąd w m_sourceModel->reload():" << errorMessage;
     }
     ui->itemList_tableView->resizeColumnsToContents();
     qDebug() << "itemList: Tabela odświeżona, wierszy w źródle:" << m_sourceModel->rowCount();
@@ -1260,26 +1621,32 @@ void itemList::refreshList(const QString &recordId)
     refreshFilters();
     qDebug() << "itemList: Filtry odświeżone";
 
-    if (!recordId.isEmpty())
-    {
-        for (int row = 0; row < m_sourceModel->rowCount(); ++row)
-        {
-            QModelIndex srcIdx = m_sourceModel->index(row, 0);
-            if (m_sourceModel->data(srcIdx).toString() == recordId)
-            {
-                QModelIndex proxyIdx = m_proxyModel->mapFromSource(srcIdx);
-                ui->itemList_tableView->selectionModel()->select(proxyIdx,
-                                                                 QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
-                m_currentRecordId = recordId;
-                qDebug() << "itemList: Wybrano rekord:" << recordId;
-                break;
-            }
-        }
-    }
+    selectRecord(recordId);
     updateHeaderSummary();
     qDebug() << "itemList: refreshList zakończony";
 }
 
+/**
+ * @brief Zaznacza w tabeli rekord o podanym ID (o ile przechodzi przez filtry).
+ * @param recordId ID rekordu; pusty — bez zmiany zaznaczenia.
+ */
+void itemList::selectRecord(const QString &recordId)
+{
+    if (recordId.isEmpty())
+        return;
+
+    const int row = m_sourceModel->rowForItemId(recordId);
+    if (row < 0)
+        return;
+
+    QModelIndex proxyIdx = m_proxyModel->mapFromSource(m_sourceModel->index(row, 0));
+    ui->itemList_tableView->selectionModel()->select(proxyIdx,
+                                                     QItemSelectionModel::ClearAndSelect | QItemSelectionModel::Rows);
+    ui->itemList_tableView->scrollTo(proxyIdx);
+    m_currentRecordId = recordId;
+    qDebug() << "itemList: Wybrano rekord:" << recordId;
+}
+
 /**
  * @brief Weryfikuje schemat bazy danych.
  * @param db Referencja do obiektu bazy danych.
@@ -1293,23 +1660,12 @@ void itemList::refreshList(const QString &recordId)
  * @brief Aktualizuje filtry po zmianie wartości w combo boxach.
  *
  * @section MethodOverview
- * Ustawia filtry w modelu proxy na podstawie wybranych wartości w combo boxach i odbudowuje
- * listy combo boxów dla filtrowania kaskadowego.
+ * Zleca filtrowanie dla bieżącego stanu kontrolek (ItemFilterScheduler łączy kolejne
+ * zmiany w jedno filtrowanie) i zapisuje filtry.
  */
 void itemList::onFilterChanged()
 {
-    auto sel = [&](QComboBox *cb)
-    {
-        QString t = cb->currentText();
-        return t == tr("Wszystkie") ? QString() : t;
-    };
-    m_proxyModel->setTypeFilter(sel(filterTypeComboBox));
-    m_proxyModel->setVendorFilter(sel(filterVendorComboBox));
-    m_proxyModel->setModelFilter(sel(filterModelComboBox));
-    m_proxyModel->setStatusFilter(sel(filterStatusComboBox));
-    m_proxyModel->setStorageFilter(sel(filterStorageComboBox));
-    updateFilterComboBoxes();
-    updateHeaderSummary();
+    scheduleFilter();
     saveCurrentFilters();
 }
 
@@ -1318,143 +1674,167 @@ void itemList::onFilterChanged()
  * @param text Tekst wpisany w filterNameLineEdit.
  *
  * @section MethodOverview
- * Ustawia filtr nazwy w modelu proxy i aktualizuje combo boxy dla kaskadowego filtrowania.
+ * Zleca filtrowanie z opóźnieniem kNameFilterDelayMs — kolejne naciśnięcia klawiszy
+ * przesuwają termin, więc filtrujemy raz, po przerwie w pisaniu.
  */
 void itemList::onFilterNameChanged(const QString &text)
 {
     qDebug() << "itemList: onFilterNameChanged wywołane, tekst:" << text;
-    m_nameFilterTimer->start(300); // 300 ms opóźnienia
+    scheduleFilter(kNameFilterDelayMs);
     saveCurrentFilters();
 }
 
 /**
- * @brief Odbudowuje listy w combo boxach filtrów.
+ * @brief Składa stan filtrów z kontrolek.
  *
  * @section MethodOverview
- * Aktualizuje zawartość combo boxów z uwzględnieniem kaskadowego filtrowania, pobierając
- * unikalne wartości z bazy danych z uwzględnieniem innych aktywnych filtrów, w tym filtru nazwy.
+ * „Wszystkie” w combo boxie oznacza brak filtru danego słownika.
  */
-void itemList::updateFilterComboBoxes()
+ItemFilterState itemList::currentFilterState() const
 {
-    qDebug() << "itemList: Rozpoczynam updateFilterComboBoxes";
-    QSqlDatabase db = QSqlDatabase::database("default_connection");
-    if (!db.isOpen())
+    auto selected = [](const QComboBox *comboBox)
     {
-        qDebug() << "itemList: Baza danych nie jest otwarta w updateFilterComboBoxes";
+        const QString text = comboBox->currentText();
+        return text == tr("Wszystkie") ? QString() : text;
+    };
+
+    ItemFilterState state;
+    state.dictionaryNames = {selected(filterTypeComboBox), selected(filterVendorComboBox),
+                             selected(filterModelComboBox), selected(filterStatusComboBox),
+                             selected(filterStorageComboBox)};
+    state.searchText = filterNameLineEdit->text();
+    state.originalPackagingOnly = ui->filterOriginalPackaging->isChecked();
+    state.withoutDescriptionOnly = ui->filterWithoutDescription->isChecked();
+    state.withoutSerialNumberOnly = ui->filterWithoutSerialNumber->isChecked();
+    state.withoutModelOnly = ui->filterWithoutModel->isChecked();
+    state.withoutVendorOnly = ui->filterWithoutVendor->isChecked();
+    return state;
+}
+
+void itemList::scheduleFilter(int delayMs)
+{
+    if (m_filterScheduler)
+        m_filterScheduler->schedule(currentFilterState(), delayMs);
+}
+
+void itemList::applySqlRowFilter(const ItemFilterState &state)
+{
+    if (!m_sqlFilters || !m_sourceModel)
         return;
+
+    // Bez stronicowania model ma wszystkie rekordy spełniające pozostałe filtry — „Szukaj”
+    // zostaje w pamięci (bez zapytania na każdy znak); przy stronicowaniu musi iść do bazy.
+    const ItemQueryBuilder builder = sqlFilterQuery(*m_sourceModel, state, m_sourceModel->pageSize() > 0);
+
+    const QString whereSql = builder.whereSql();
+    const QVariantList bindValues = builder.bindValues();
+    if (whereSql == m_sourceModel->rowFilterSql() && bindValues == m_sourceModel->rowFilterBindValues())
+        return;
+
+    m_sourceModel->setRowFilter(whereSql, bindValues);
+    QString errorMessage;
+    if (!m_sourceModel->reload(&errorMessage))
+        qDebug() << "itemList: Błąd wczytywania listy z filtrami SQL:" << errorMessage;
+}
+
+/**
+ * @brief Liczy wartości słowników dla combo boxów zapytaniami do bazy.
+ * @param state Stan filtrów, dla którego liczone są wartości.
+ * @param facets Wynik — liczba rekordów na nameId, osobno dla każdego słownika.
+ * @return false, gdy któreś zapytanie się nie powiodło.
+ *
+ * @section MethodOverview
+ * W trybie filtrów SQL model ma tylko rekordy spełniające wszystkie filtry, więc liczniki
+ * z modelu zostawiłyby w combo boxie jedynie wybraną wartość. Dla każdego słownika idzie
+ * osobne `SELECT <słownik>_id, COUNT(*) … GROUP BY` bez filtra tego słownika
+ * (ItemQueryBuilder::facetCountSql), z polem „Szukaj” jako warunkiem LIKE.
+ */
+bool itemList::sqlFacetCounts(const ItemFilterState &state, ItemFilterProxyModel::FacetCounts *facets) const
+{
+    const ItemQueryBuilder builder = sqlFilterQuery(*m_sourceModel, state, true);
+    for (int dictionary = 0; dictionary < ItemTableModel::DictionaryCount; ++dictionary)
+    {
+        const auto column = static_cast<ItemTableModel::Dictionary>(dictionary);
+        QVector<int> &counts = (*facets)[dictionary];
+        counts.fill(0, m_sourceModel->dictionarySize(column));
+
+        // Lista IN (...) ma zmienną długość — zwykłe QSqlQuery, bez PreparedStatementCache.
+        QVariantList bindValues;
+        QSqlQuery query(QSqlDatabase::database("default_connection"));
+        query.setForwardOnly(true);
+        query.prepare(builder.facetCountSql(column, &bindValues));
+        for (const QVariant &value : std::as_const(bindValues))
+            query.addBindValue(value);
+        if (!query.exec())
+        {
+            qDebug() << "itemList: Błąd liczenia wartości filtrów w bazie:" << query.lastError().text();
+            return false;
+        }
+        while (query.next())
+        {
+            const int nameId = m_sourceModel->dictionaryNameId(column, query.value(0).toString());
+            if (nameId >= 0)
+                counts[nameId] += query.value(1).toInt();
+        }
     }
+    return true;
+}
 
-    QString selType = filterTypeComboBox->currentText() == tr("Wszystkie")
-                          ? QString()
-                          : filterTypeComboBox->currentText();
-    QString selVendor = filterVendorComboBox->currentText() == tr("Wszystkie")
-                            ? QString()
-                            : filterVendorComboBox->currentText();
-    QString selModel = filterModelComboBox->currentText() == tr("Wszystkie")
-                           ? QString()
-                           : filterModelComboBox->currentText();
-    QString selStatus = filterStatusComboBox->currentText() == tr("Wszystkie")
-                            ? QString()
-                            : filterStatusComboBox->currentText();
-    QString selStorage = filterStorageComboBox->currentText() == tr("Wszystkie")
-                             ? QString()
-                             : filterStorageComboBox->currentText();
-    QString selName = filterNameLineEdit->text().isEmpty() ? QString() : filterNameLineEdit->text();
-    const bool withoutDescriptionOnly = ui->filterWithoutDescription->isChecked();
-    const bool withoutSerialNumberOnly = ui->filterWithoutSerialNumber->isChecked();
-    const bool withoutModelOnly = ui->filterWithoutModel->isChecked();
-    const bool withoutVendorOnly = ui->filterWithoutVendor->isChecked();
-    const bool originalPackagingOnly = ui->filterOriginalPackaging->isChecked();
-
-    qDebug() << "itemList: Filtry: type=" << selType << ", vendor=" << selVendor
-             << ", model=" << selModel << ", status=" << selStatus << ", storage=" << selStorage
-             << ", name=" << selName << ", withoutDescription=" << withoutDescriptionOnly
-             << ", withoutSerialNumber=" << withoutSerialNumberOnly
-             << ", withoutModel=" << withoutModelOnly
-             << ", withoutVendor=" << withoutVendorOnly
-             << ", originalPackaging=" << originalPackagingOnly;
+/**
+ * @brief Odbudowuje listy w combo boxach filtrów.
+ * @param facets Liczniki wartości słowników z ostatniego filtrowania.
+ *
+ * @section MethodOverview
+ * Aktualizuje zawartość combo boxów z uwzględnieniem kaskadowego filtrowania — każde combo
+ * pokazuje wartości, które dają wyniki przy pozostałych aktywnych filtrach, w tym filtrze nazwy.
+ */
+void itemList::updateFilterComboBoxes(const ItemFilterProxyModel::FacetCounts &facets)
+{
+    if (!m_sourceModel || !m_proxyModel)
+        return;
 
+    // Opcje i liczniki liczone w pamięci jednym przebiegiem po modelu — bez
+    // pięciu zapytań SELECT DISTINCT ... LIKE przy każdym naciśnięciu klawisza.
+    // W trybie filtrów SQL liczniki przychodzą z sqlFacetCounts.
     struct Filter
     {
         QComboBox *cb;
-        QString field;
+        ItemTableModel::Dictionary dictionary;
     };
-    QVector<Filter> filters = {{filterTypeComboBox, "types.name"},
-                               {filterVendorComboBox, "vendors.name"},
-                               {filterModelComboBox, "models.name"},
-                               {filterStatusComboBox, "statuses.name"},
-                               {filterStorageComboBox, "storage_places.name"}};
-
-    const QString baseJoins = R"(
-        FROM eksponaty
-        JOIN types ON eksponaty.type_id = types.id
-        JOIN vendors ON eksponaty.vendor_id = vendors.id
-        JOIN models ON eksponaty.model_id = models.id
-        JOIN statuses ON eksponaty.status_id = statuses.id
-        JOIN storage_places ON eksponaty.storage_place_id = storage_places.id
-    )";
-
-    for (auto &f : filters)
-    {
-        qDebug() << "itemList: Aktualizuję combo box dla:" << f.field;
-        f.cb->blockSignals(true);
-        QString prev = f.cb->currentText();
-        f.cb->clear();
-        f.cb->addItem(tr("Wszystkie"));
-
-        QString sql = QString("SELECT DISTINCT %1 %2 "
-                              "WHERE (:selType IS NULL OR types.name = :selType) "
-                              "AND (:selVendor IS NULL OR vendors.name = :selVendor) "
-                              "AND (:selModel IS NULL OR models.name = :selModel) "
-                              "AND (:selStatus IS NULL OR statuses.name = :selStatus) "
-                              "AND (:selStorage IS NULL OR storage_places.name = :selStorage) "
-                              "AND (:selName IS NULL OR eksponaty.name LIKE :selName "
-                              "OR vendors.name LIKE :selName "
-                              "OR models.name LIKE :selName "
-                              "OR eksponaty.serial_number LIKE :selName "
-                              "OR eksponaty.part_number LIKE :selName "
-                              "OR eksponaty.description LIKE :selName) "
-                              "AND (:withoutDescription = 0 OR eksponaty.description IS NULL "
-                              "OR TRIM(eksponaty.description) = '') "
-                              "AND (:withoutSerialNumber = 0 OR eksponaty.serial_number IS NULL "
-                              "OR TRIM(eksponaty.serial_number) = '') "
-                              "AND (:withoutModel = 0 OR models.name IS NULL "
-                              "OR TRIM(models.name) = '' "
-                              "OR LOWER(TRIM(models.name)) IN ('unknown','brak','nieznany')) "
-                              "AND (:withoutVendor = 0 OR vendors.name IS NULL "
-                              "OR TRIM(vendors.name) = '' "
-                              "OR LOWER(TRIM(vendors.name)) IN ('unknown','brak','nieznany')) "
-                              "AND (:originalPackaging = 0 OR COALESCE(eksponaty.has_original_packaging, 0) = 1) "
-                              "ORDER BY %1")
-                          .arg(f.field, baseJoins);
+    const Filter filters[] = {{filterTypeComboBox, ItemTableModel::TypeDictionary},
+                              {filterVendorComboBox, ItemTableModel::VendorDictionary},
+                              {filterModelComboBox, ItemTableModel::ModelDictionary},
+                              {filterStatusComboBox, ItemTableModel::StatusDictionary},
+                              {filterStorageComboBox, ItemTableModel::StorageDictionary}};
 
-        QSqlQuery q(db);
-        q.prepare(sql);
-        q.bindValue(":selType", selType.isEmpty() ? QVariant() : selType);
-        q.bindValue(":selVendor", selVendor.isEmpty() ? QVariant() : selVendor);
-        q.bindValue(":selModel", selModel.isEmpty() ? QVariant() : selModel);
-        q.bindValue(":selStatus", selStatus.isEmpty() ? QVariant() : selStatus);
-        q.bindValue(":selStorage", selStorage.isEmpty() ? QVariant() : selStorage);
-        q.bindValue(":selName", selName.isEmpty() ? QVariant() : QString("%%%1%%").arg(selName));
-        q.bindValue(":withoutDescription", withoutDescriptionOnly ? 1 : 0);
-        q.bindValue(":withoutSerialNumber", withoutSerialNumberOnly ? 1 : 0);
-        q.bindValue(":withoutModel", withoutModelOnly ? 1 : 0);
-        q.bindValue(":withoutVendor", withoutVendorOnly ? 1 : 0);
-        q.bindValue(":originalPackaging", originalPackagingOnly ? 1 : 0);
-        if (!q.exec())
-        {
-            qDebug() << "itemList: Błąd zapytania w updateFilterComboBoxes dla" << f.field << ":"
-                     << q.lastError().text();
-        }
-        else
+    for (const Filter &f : filters)
+    {
+        const QVector<int> &counts = facets[f.dictionary];
+        QVector<int> nameIds;
+        int total = 0;
+        for (int nameId = 0; nameId < counts.size(); ++nameId)
         {
-            int count = 0;
-            while (q.next())
+            if (counts[nameId] > 0)
             {
-                f.cb->addItem(q.value(0).toString());
-                count++;
+                nameIds.append(nameId);
+                total += counts[nameId];
             }
-            qDebug() << "itemList: Dodano" << count << "elementów do" << f.field;
+        }
+        std::sort(nameIds.begin(), nameIds.end(), [this, &f](int left, int right)
+                  {
+                      return QString::localeAwareCompare(m_sourceModel->dictionaryName(f.dictionary, left),
+                                                         m_sourceModel->dictionaryName(f.dictionary, right)) < 0;
+                  });
+
+        const QSignalBlocker blocker(f.cb);
+        const QString prev = f.cb->currentText();
+        f.cb->clear();
+        f.cb->addItem(tr("Wszystkie"));
+        f.cb->setItemData(0, total, kFacetCountRole);
+        for (int nameId : nameIds)
+        {
+            f.cb->addItem(m_sourceModel->dictionaryName(f.dictionary, nameId));
+            f.cb->setItemData(f.cb->count() - 1, counts[nameId], kFacetCountRole);
         }
 
         int idx = f.cb->findText(prev);
@@ -1465,82 +1845,67 @@ void itemList::updateFilterComboBoxes()
         }
 
         f.cb->setCurrentIndex(idx != -1 ? idx : 0);
-        f.cb->blockSignals(false);
-        qDebug() << "itemList: Combo box dla" << f.field
-                 << "zaktualizowany, wybrano:" << f.cb->currentText();
     }
-    qDebug() << "itemList: updateFilterComboBoxes zakończony";
-    m_proxyModel->invalidate(); // Wymuszenie odświeżenia tabeli
     updateHeaderSummary();
 }
 
-void itemList::onFilterOriginalPackagingChanged(bool checked)
+void itemList::onFilterOriginalPackagingChanged(bool)
 {
-    m_proxyModel->setOriginalPackagingFilter(checked);
-    updateFilterComboBoxes();
+    scheduleFilter();
     saveCurrentFilters();
 }
 
-void itemList::onFilterWithoutDescriptionChanged(bool checked)
+void itemList::onFilterWithoutDescriptionChanged(bool)
 {
-    m_proxyModel->setWithoutDescriptionFilter(checked);
-    updateFilterComboBoxes();
+    scheduleFilter();
     saveCurrentFilters();
 }
 
-void itemList::onFilterWithoutSerialNumberChanged(bool checked)
+void itemList::onFilterWithoutSerialNumberChanged(bool)
 {
-    m_proxyModel->setWithoutSerialNumberFilter(checked);
-    updateFilterComboBoxes();
+    scheduleFilter();
     saveCurrentFilters();
 }
 
-void itemList::onFilterWithoutModelChanged(bool checked)
+void itemList::onFilterWithoutModelChanged(bool)
 {
-    m_proxyModel->setWithoutModelFilter(checked);
-    updateFilterComboBoxes();
+    scheduleFilter();
     saveCurrentFilters();
 }
 
-void itemList::onFilterWithoutVendorChanged(bool checked)
+void itemList::onFilterWithoutVendorChanged(bool)
 {
-    m_proxyModel->setWithoutVendorFilter(checked);
-    updateFilterComboBoxes();
+    scheduleFilter();
     saveCurrentFilters();
 }
 
-void itemList::onFilterTypeChanged(const QString &text)
+void itemList::onFilterTypeChanged(const QString &)
 {
-    m_proxyModel->setTypeFilter(text == tr("Wszystkie") ? QString() : text);
-    updateFilterComboBoxes();
+    scheduleFilter();
     saveCurrentFilters();
 }
 
-void itemList::onFilterVendorChanged(const QString &text)
+void itemList::onFilterVendorChanged(const QString &)
 {
-    m_proxyModel->setVendorFilter(text == tr("Wszystkie") ? QString() : text);
-    updateFilterComboBoxes();
+    scheduleFilter();
     saveCurrentFilters();
 }
 
-void itemList::onFilterModelChanged(const QString &text)
+void itemList::onFilterModelChanged(const QString &)
 {
-    m_proxyModel->setModelFilter(text == tr("Wszystkie") ? QString() : text);
-    updateFilterComboBoxes();
+    scheduleFilter();
     saveCurrentFilters();
 }
 
-void itemList::onFilterStatusChanged(const QString &text)
+void itemList::onFilterStatusChanged(const QString &)
 {
-    m_proxyModel->setStatusFilter(text == tr("Wszystkie") ? QString() : text);
-    updateFilterComboBoxes();
+    scheduleFilter();
     saveCurrentFilters();
 }
 
-void itemList::onFilterStoragePlaceChanged(const QString &text)
+void itemList::onFilterStoragePlaceChanged(const QString &)
 {
-    m_proxyModel->setStorageFilter(text == tr("Wszystkie") ? QString() : text);
-    updateFilterComboBoxes();
+    scheduleFilter();
     saveCurrentFilters();
 }
 
@@ -1573,17 +1938,29 @@ bool itemList::applyBulkStatusChange(const QStringList &recordIds, const QString
         return false;
     }
 
+    // v1.5: postęp po każdej paczce UPDATE — dialog pojawia się tylko przy dłuższej operacji.
+    QProgressDialog progress(tr("Zmieniam status rekordów..."), tr("Anuluj"), 0, recordIds.size(), this);
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(kBulkProgressDelayMs);
+    const auto onProgress = [&progress](int done, int)
+    {
+        progress.setValue(done);
+        return !progress.wasCanceled();
+    };
+
     ItemRepository repository(QSqlDatabase::database("default_connection"));
     QString errorMessage;
-    if (!repository.updateStatusForItems(recordIds, query.value(0).toString(), &errorMessage))
+    if (!repository.updateStatusForItems(recordIds, query.value(0).toString(), &errorMessage, onProgress))
     {
+        if (progress.wasCanceled())
+            return false;
         QMessageBox::critical(this,
                               tr("Błąd"),
                               tr("Nie udało się zmienić statusu rekordów:\n%1").arg(errorMessage));
         return false;
     }
 
-    refreshList();
+    refreshFilters();
     QMessageBox::information(this,
                              tr("Sukces"),
                              tr("Zmieniono status dla %1 rekordów.").arg(recordIds.size()));
@@ -1603,10 +1980,22 @@ bool itemList::applyBulkStorageChange(const QStringList &recordIds, const QStrin
         return false;
     }
 
+    QProgressDialog progress(tr("Zmieniam miejsce przechowywania rekordów..."), tr("Anuluj"), 0,
+                             recordIds.size(), this);
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(kBulkProgressDelayMs);
+    const auto onProgress = [&progress](int done, int)
+    {
+        progress.setValue(done);
+        return !progress.wasCanceled();
+    };
+
     ItemRepository repository(QSqlDatabase::database("default_connection"));
     QString errorMessage;
-    if (!repository.updateStoragePlaceForItems(recordIds, query.value(0).toString(), &errorMessage))
+    if (!repository.updateStoragePlaceForItems(recordIds, query.value(0).toString(), &errorMessage, onProgress))
     {
+        if (progress.wasCanceled())
+            return false;
         QMessageBox::critical(this,
                               tr("Błąd"),
                               tr("Nie udało się zmienić miejsca przechowywania rekordów:\n%1")
@@ -1614,7 +2003,7 @@ bool itemList::applyBulkStorageChange(const QStringList &recordIds, const QStrin
         return false;
     }
 
-    refreshList();
+    refreshFilters();
     QMessageBox::information(this,
                              tr("Sukces"),
                              tr("Zmieniono miejsce przechowywania dla %1 rekordów.")
@@ -1625,7 +2014,7 @@ bool itemList::applyBulkStorageChange(const QStringList &recordIds, const QStrin
 void itemList::updateHeaderSummary()
 {
     const int visibleCount = m_proxyModel ? m_proxyModel->rowCount() : 0;
-    const int totalCount = m_sourceModel ? m_sourceModel->rowCount() : 0;
+    const int totalCount = m_sourceModel ? m_sourceModel->totalRowCount() : 0;
     ui->headerLabel->setText(tr("Lista przedmiotów (%1 / %2)").arg(visibleCount).arg(totalCount));
 }
 
@@ -40,6 +40,7 @@
 
 // Nagłówki aplikacji
 #include "DatabaseConfigDialog.h"
+#include "PreparedStatementCache.h"
 #include "itemList.h"
 #include "utils.h"
 
@@ -139,5 +140,8 @@ int main(int argc, char *argv[])
 
     // Sekcja 6: Pętla zdarzeń Qt
     // Uruchamia główną pętlę zdarzeń Qt, która obsługuje interakcje użytkownika i zdarzenia systemowe.
-    return a.exec();
+    const int exitCode = a.exec();
+    // Zapytania z PreparedStatementCache zwalniamy, póki sterowniki baz jeszcze istnieją.
+    PreparedStatementCache::instance().clear();
+    return exitCode;
 }
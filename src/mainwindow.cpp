@@ -36,13 +36,16 @@
 #include "ItemRepository.h"
 #include "ItemFormValidator.h"
 #include "PacmanOverlay.h"
+#include "PhotoLoader.h"
 #include "PhotoService.h"
 
 // Inne nagłówki
+#include <QApplication>
 #include <QCompleter>
 #include <QDate>
 #include <QDebug>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileDialog>
 #include <QFileInfo>
@@ -57,17 +60,25 @@
 #include <QSqlError>
 #include <QSqlQuery>
 #include <QStandardPaths>
+#include <QStatusBar>
 #include <QTimer>
 #include <QCloseEvent>
 #include <QUuid>
 #include <QProgressDialog>
 #include <QLineEdit>
 #include <QTextEdit>
+#include <QThread>
 
+#include <atomic>
 #include <limits>
+#include <memory>
 
 namespace {
 
+/// Zdjęć w jednym wywołaniu insertPhotos przy imporcie do istniejącego rekordu —
+/// tyle trzeba zapisać, zanim pasek postępu drgnie i zanim zadziała "Anuluj".
+constexpr int kPhotosPerImportBatch = 16;
+
 void replaceScene(QGraphicsView *view, QGraphicsScene *newScene)
 {
     QGraphicsScene *oldScene = view->scene();
@@ -78,6 +89,50 @@ void replaceScene(QGraphicsView *view, QGraphicsScene *newScene)
     delete oldScene;
 }
 
+/// v1.5: odczyt i normalizacja importowanych zdjęć poza wątkiem GUI.
+/// Wyniki zostają w workerze — MainWindow odbiera je po sygnale finished().
+class PhotoImportWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    PhotoImportWorker(const QStringList &files,
+                      const PhotoIngestOptions &options,
+                      std::shared_ptr<std::atomic<bool>> cancelled)
+        : m_files(files), m_options(options), m_cancelled(std::move(cancelled))
+    {
+    }
+
+    const QList<IngestedPhoto> &results() const { return m_results; }
+    qint64 bytesSaved() const { return m_bytesSaved; }
+
+signals:
+    void progress(int done, int total, qint64 bytesRead);
+    void finished();
+
+public slots:
+    void run()
+    {
+        // progress jest emitowany z wątków puli — połączenie kolejkowane do GUI.
+        m_results = PhotoService::ingestFiles(m_files,
+                                              m_options,
+                                              &m_bytesSaved,
+                                              [this](int done, int total, qint64 bytesRead)
+                                              {
+                                                  emit progress(done, total, bytesRead);
+                                                  return !m_cancelled->load();
+                                              });
+        emit finished();
+    }
+
+private:
+    QStringList m_files;
+    PhotoIngestOptions m_options;
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
+    QList<IngestedPhoto> m_results;
+    qint64 m_bytesSaved = 0;
+};
+
 }
 #include <QPlainTextEdit>
 
@@ -98,7 +153,7 @@ void replaceScene(QGraphicsView *view, QGraphicsScene *newScene)
  * do słowników. Ustawia początkowy stan formularza (brak edycji, brak wybranego zdjęcia).
  */
 MainWindow::MainWindow(QWidget *parent)
-    : QMainWindow(parent), ui(new Ui::MainWindow), m_editMode(false), m_recordId(QString()), m_selectedPhotoIndex(-1)
+    : QMainWindow(parent), ui(new Ui::MainWindow), m_editMode(false), m_recordId(QString()), m_selectedPhotoIndex(-1), m_photoLoader(nullptr)
 {
     ui->setupUi(this);
 
@@ -344,6 +399,13 @@ MainWindow::MainWindow(QWidget *parent)
  */
 MainWindow::~MainWindow()
 {
+    if (m_photoImportThread)
+    {
+        if (m_photoImportCancelled)
+            m_photoImportCancelled->store(true);
+        m_photoImportThread->quit();
+        m_photoImportThread->wait();
+    }
     delete ui;
 }
 
@@ -500,6 +562,8 @@ void MainWindow::setEditMode(bool edit, const QString &recordId)
         }
 
         // Czyszczenie sceny zdjęć
+        if (m_photoLoader)
+            m_photoLoader->cancel();
         replaceScene(ui->graphicsView, nullptr);
         m_selectedPhotoIndex = -1;
         m_photoBuffer.clear();
@@ -549,6 +613,8 @@ void MainWindow::setCloneMode(const QString &recordId)
     m_editMode = false;
     loadRecord(recordId);
     m_recordId.clear();
+    if (m_photoLoader)
+        m_photoLoader->cancel();
     replaceScene(ui->graphicsView, nullptr);
     m_selectedPhotoIndex = -1;
     m_photoBuffer.clear();
@@ -661,41 +727,46 @@ void MainWindow::loadRecord(const QString &recordId)
  * @param recordId ID rekordu, którego zdjęcia są wczytywane.
  *
  * @section MethodOverview
- * Pobiera zdjęcia z tabeli photos, tworzy miniatury o rozmiarze 80x80 pikseli
- * i wyświetla je w QGraphicsView, z możliwością wyboru zdjęcia.
+ * Pobiera miniatury z tabeli photo_thumbnails (bez pełnych BLOB-ów z photos),
+ * skaluje je do 80x80 pikseli i wyświetla w QGraphicsView, z możliwością wyboru zdjęcia.
  */
 void MainWindow::loadPhotos(const QString &recordId)
 {
-    PhotoService photoService(db);
-    QString errorMessage;
-    const QList<StoredPhoto> photos = photoService.loadStoredPhotos(recordId, &errorMessage);
-    if (!errorMessage.isEmpty())
+    // Zapytanie i dekodowanie idą w tle (PhotoLoader); tu tylko zlecamy.
+    if (!m_photoLoader)
     {
-        qDebug() << "Błąd pobierania zdjęć:" << errorMessage;
-        replaceScene(ui->graphicsView, nullptr);
-        return;
+        m_photoLoader = new PhotoLoader(db.connectionName(), this);
+        connect(m_photoLoader, &PhotoLoader::photosListed, this, &MainWindow::onPhotosListed);
+        connect(m_photoLoader, &PhotoLoader::photoReady, this, &MainWindow::onPhotoReady);
+        connect(m_photoLoader, &PhotoLoader::loadFailed, this, [this](quint64, const QString &errorMessage)
+                {
+            qDebug() << "Błąd pobierania zdjęć:" << errorMessage;
+            replaceScene(ui->graphicsView, nullptr); });
     }
 
-    showStoredPhotos(photos);
+    m_photoLoader->requestThumbnails(recordId, PhotoService::kListThumbnailSize);
 }
 
-void MainWindow::showStoredPhotos(const QList<StoredPhoto> &photos)
+void MainWindow::onPhotosListed(quint64 requestId, const QString &itemId, const QStringList &photoIds)
 {
+    if (requestId != m_photoLoader->currentRequestId() || itemId != m_recordId)
+        return;
+
+    m_selectedPhotoIndex = -1;
     QGraphicsScene *scene = new QGraphicsScene(this);
     const int thumbSize = 80, spacing = 5;
     int x = 5, y = 5, idx = 0;
 
-    for (const StoredPhoto &photo : photos)
-    {
-        QPixmap scaled = photo.pixmap.scaled(thumbSize,
-                                    thumbSize,
-                                    Qt::KeepAspectRatio,
-                                    Qt::SmoothTransformation);
+    QPixmap placeholder(thumbSize, thumbSize);
+    placeholder.fill(QColor(128, 128, 128, 60));
 
+    for (const QString &photoId : photoIds)
+    {
         PhotoItem *item = new PhotoItem();
-        item->setPixmap(scaled);
-        item->setData(0, photo.id);
-        item->setData(1, idx);
+        item->setPixmap(placeholder);
+        item->setPhotoId(photoId);
+        item->setData(0, idx);
+        item->setEditMode(m_editMode);
 
         connect(item, &PhotoItem::clicked, this, [this, item]()
                 { onPhotoClicked(item); });
@@ -703,11 +774,11 @@ void MainWindow::showStoredPhotos(const QList<StoredPhoto> &photos)
         item->setPos(x, y);
         scene->addItem(item);
 
-        x += (scaled.width() + spacing);
+        x += (thumbSize + spacing);
         if (x + thumbSize > ui->graphicsView->width() - 10)
         {
             x = 5;
-            y += (scaled.height() + spacing);
+            y += (thumbSize + spacing);
         }
         idx++;
     }
@@ -731,6 +802,33 @@ void MainWindow::showStoredPhotos(const QList<StoredPhoto> &photos)
     }
 }
 
+void MainWindow::onPhotoReady(quint64 requestId, const QString &photoId, const QImage &image)
+{
+    if (requestId != m_photoLoader->currentRequestId())
+        return;
+
+    QGraphicsScene *scene = ui->graphicsView->scene();
+    if (!scene)
+        return;
+
+    const int thumbSize = 80;
+    const QList<QGraphicsItem *> items = scene->items();
+    for (QGraphicsItem *graphicsItem : items)
+    {
+        PhotoItem *item = dynamic_cast<PhotoItem *>(graphicsItem);
+        if (!item || item->photoId() != photoId)
+            continue;
+
+        const QPixmap scaled = QPixmap::fromImage(image).scaled(thumbSize,
+                                                                thumbSize,
+                                                                Qt::KeepAspectRatio,
+                                                                Qt::SmoothTransformation);
+        item->setPixmap(scaled);
+        item->setOffset((thumbSize - scaled.width()) / 2.0, (thumbSize - scaled.height()) / 2.0);
+        return;
+    }
+}
+
 /**
  * @brief Wczytuje zdjęcia z bufora pamięci.
  *
@@ -741,7 +839,12 @@ void MainWindow::showStoredPhotos(const QList<StoredPhoto> &photos)
 void MainWindow::loadPhotosFromBuffer()
 {
     PhotoService photoService(db);
-    const QList<QPixmap> pixmaps = photoService.loadPixmapsFromBuffer(m_photoBuffer);
+    // Miniatura 160 px policzona przy wczytywaniu; pełny plik z aparatu tylko wtedy, gdy jej brak.
+    QList<QByteArray> previews;
+    previews.reserve(m_photoBuffer.size());
+    for (const IngestedPhoto &photo : std::as_const(m_photoBuffer))
+        previews.append(photo.thumbnails.value(PhotoService::kListThumbnailSize, photo.data));
+    const QList<QPixmap> pixmaps = photoService.loadPixmapsFromBuffer(previews, QSize(80, 80));
     showBufferPhotos(pixmaps);
 }
 
@@ -911,8 +1014,8 @@ void MainWindow::onSaveClicked()
     ItemRepository repository(db);
     QString savedItemId;
     QString errorMessage;
-    const QList<QByteArray> newPhotos = m_editMode ? QList<QByteArray>() : m_photoBuffer;
-    if (!repository.saveItem(itemData, newPhotos, &savedItemId, &errorMessage))
+    const QList<IngestedPhoto> newPhotos = m_editMode ? QList<IngestedPhoto>() : m_photoBuffer;
+    if (!repository.saveItemWithIngestedPhotos(itemData, newPhotos, &savedItemId, &errorMessage))
     {
         QMessageBox::critical(this,
                               tr("Błąd"),
@@ -968,13 +1071,18 @@ void MainWindow::onCancelClicked()
  * Otwiera okno wyboru plików, ładuje zdjęcia do bufora (dla nowych rekordów) lub zapisuje do bazy danych
  * (dla edytowanych rekordów). Przeniesienie oryginalnych plików do katalogu "gotowe" jest warunkowe i
  * zależy od ustawienia przenosic_gotowe w pliku konfiguracyjnym inwentaryzacja.ini.
- * Podgląd miniaturek jest odświeżany po zakończeniu operacji.
+ * Pliki są czytane i normalizowane w tle (PhotoImportWorker; PhotoIngestOptions: maks. krawędź,
+ * jakość, format, usunięcie metadanych) z anulowalnym oknem postępu pokazującym przepustowość.
+ * Zapis i przeniesienie plików wykonuje finishPhotoImport.
  */
 void MainWindow::onAddPhotoClicked()
 {
+    if (m_photoImportThread)
+        return;
+
     QSettings settings(QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation) + "/inwentaryzacja.ini",
                        QSettings::IniFormat);
-    bool m_shouldMovePhotos = settings.value("przenosic_gotowe", "tak").toString().toLower() != "nie";
+    const bool shouldMovePhotos = settings.value("przenosic_gotowe", "tak").toString().toLower() != "nie";
 
     QStringList files = QFileDialog::getOpenFileNames(this,
                                                       tr("Wybierz zdjęcia"),
@@ -983,62 +1091,200 @@ void MainWindow::onAddPhotoClicked()
     if (files.isEmpty())
         return;
 
-    for (const auto &fn : std::as_const(files))
+    // v1.5: pliki są czytane, skalowane i kodowane od nowa w tle (PhotoService::ingestFiles
+    // na puli wątków); okno pozostaje responsywne, a import można anulować.
+    const PhotoIngestOptions ingestOptions = PhotoIngestOptions::fromSettings();
+    auto cancelled = std::make_shared<std::atomic<bool>>(false);
+    m_photoImportCancelled = cancelled;
+
+    auto *progressDialog = new QProgressDialog(tr("Wczytywanie zdjęć..."), tr("Anuluj"), 0, files.size(), this);
+    progressDialog->setWindowTitle(tr("Import zdjęć"));
+    progressDialog->setWindowModality(Qt::WindowModal);
+    progressDialog->setMinimumDuration(0);
+    progressDialog->setAutoClose(false);
+    progressDialog->setAutoReset(false);
+    progressDialog->setValue(0);
+    connect(progressDialog, &QProgressDialog::canceled, this, [cancelled]()
+            { cancelled->store(true); });
+
+    auto *thread = new QThread(this);
+    auto *worker = new PhotoImportWorker(files, ingestOptions, cancelled);
+    worker->moveToThread(thread);
+
+    auto timer = std::make_shared<QElapsedTimer>();
+    timer->start();
+    connect(worker, &PhotoImportWorker::progress, progressDialog, [this, progressDialog, timer](int done, int total, qint64 bytesRead)
+            {
+        const double seconds = qMax<qint64>(1, timer->elapsed()) / 1000.0;
+        progressDialog->setValue(done);
+        progressDialog->setLabelText(tr("Wczytano %1 z %2 zdjęć\n%3 plików/s, %4 MB/s")
+                                         .arg(done)
+                                         .arg(total)
+                                         .arg(done / seconds, 0, 'f', 1)
+                                         .arg(bytesRead / seconds / (1024 * 1024), 0, 'f', 1)); });
+    connect(thread, &QThread::started, worker, &PhotoImportWorker::run);
+    connect(worker, &PhotoImportWorker::finished, this, [this, thread, worker, progressDialog, cancelled, shouldMovePhotos, ingestOptions]()
+            {
+        // Kopia przed quit() — po zakończeniu wątku worker jest usuwany (deleteLater).
+        const QList<IngestedPhoto> results = worker->results();
+        const qint64 bytesSaved = worker->bytesSaved();
+        thread->quit();
+        if (cancelled->load())
+        {
+            progressDialog->close();
+            progressDialog->deleteLater();
+            statusBar()->showMessage(tr("Import zdjęć anulowany."), 5000);
+            return;
+        }
+        finishPhotoImport(results, bytesSaved, shouldMovePhotos, ingestOptions, progressDialog); });
+    connect(thread, &QThread::finished, worker, &QObject::deleteLater);
+    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+    m_photoImportThread = thread;
+    ui->New_item_addPhoto->setEnabled(false);
+    connect(thread, &QThread::finished, this, [this]()
+            { ui->New_item_addPhoto->setEnabled(true); });
+    thread->start();
+}
+
+/**
+ * @brief Zapisuje wczytane zdjęcia — do bufora (nowy rekord) albo do bazy w jednej transakcji.
+ *
+ * @section MethodOverview
+ * Dla nowego rekordu bufor dostaje całe IngestedPhoto, więc zapis (saveItemWithIngestedPhotos)
+ * nie dekoduje zdjęć drugi raz. Dla istniejącego rekordu wszystkie zdjęcia trafiają do bazy
+ * w jednej transakcji (miniatury i skrót policzone już przy wczytywaniu), paczkami
+ * kPhotosPerImportBatch przez PhotoService::insertPhotos. Archiwizacja oryginałów i przeniesienie plików do
+ * katalogu "gotowe" odbywa się dopiero po zatwierdzeniu transakcji; anulowanie lub błąd
+ * wycofuje cały import i pozostawia pliki na miejscu.
+ */
+void MainWindow::finishPhotoImport(const QList<IngestedPhoto> &ingested,
+                                   qint64 bytesSaved,
+                                   bool shouldMovePhotos,
+                                   const PhotoIngestOptions &options,
+                                   QProgressDialog *progressDialog)
+{
+    QStringList readFailures;
+    QList<const IngestedPhoto *> ready;
+    for (const IngestedPhoto &photo : ingested)
     {
-        QFile f(fn);
-        if (!f.open(QIODevice::ReadOnly))
+        if (!photo.errorMessage.isEmpty())
         {
-            qDebug() << "Nie można otworzyć:" << fn;
-            continue;
+            qDebug() << "Nie można otworzyć:" << photo.sourcePath << photo.errorMessage;
+            readFailures.append(QFileInfo(photo.sourcePath).fileName());
         }
-        QByteArray data = f.readAll();
-        f.close();
+        else if (!photo.data.isEmpty())
+        {
+            ready.append(&photo);
+        }
+    }
 
-        if (m_recordId.isEmpty())
+    QStringList savedPaths;
+    QStringList normalizedPaths;
+    bool importSaved = true;
+    if (m_recordId.isEmpty())
+    {
+        for (const IngestedPhoto *photo : std::as_const(ready))
         {
-            m_photoBuffer.append(data);
-            m_photoPathsBuffer.append(fn);
+            m_photoBuffer.append(*photo);
+            m_photoPathsBuffer.append(photo->sourcePath);
+            if (photo->normalized)
+                normalizedPaths.append(photo->sourcePath);
         }
-        else
+    }
+    else
+    {
+        progressDialog->setLabelText(tr("Zapisywanie zdjęć w bazie..."));
+        progressDialog->setRange(0, ready.size());
+        progressDialog->setValue(0);
+
+        // Jedna transakcja na cały import, bez autocommitu na każdym INSERT. Zdjęcia idą
+        // paczkami przez insertPhotos (wielowierszowe INSERT-y); między paczkami
+        // odświeżany jest postęp i sprawdzane anulowanie.
+        PhotoService photoService(db);
+        QString photoError;
+        bool cancelledByUser = false;
+        importSaved = db.transaction();
+        if (!importSaved)
+            photoError = db.lastError().text();
+        for (int first = 0; importSaved && first < ready.size(); first += kPhotosPerImportBatch)
         {
-            QString photoId = QUuid::createUuid().toString(QUuid::WithoutBraces);
-            QSqlQuery q(db);
-            q.prepare(R"(
-                INSERT INTO photos (id, eksponat_id, photo)
-                VALUES (:id, :exid, :photo)
-            )");
-            q.bindValue(":id", photoId);
-            q.bindValue(":exid", m_recordId);
-            q.bindValue(":photo", data);
-            if (q.exec())
+            if (progressDialog->wasCanceled())
             {
-                if (m_shouldMovePhotos)
-                {
-                    QFileInfo fi(fn);
-                    QString doneDir = fi.absolutePath() + QDir::separator() + QStringLiteral("gotowe");
-                    if (!QDir().mkpath(doneDir))
-                    {
-                        QMessageBox::warning(this,
-                                             tr("Uwaga"),
-                                             tr("Nie udało się utworzyć katalogu:\n%1").arg(doneDir));
-                    }
-                    QString dst = doneDir + QDir::separator() + fi.fileName();
-                    if (!QFile::rename(fn, dst))
-                    {
-                        QMessageBox::warning(this,
-                                             tr("Uwaga"),
-                                             tr("Nie można przenieść %1 do %2").arg(fn, dst));
-                    }
-                }
+                cancelledByUser = true;
+                importSaved = false;
+                break;
             }
-            else
+            const int last = qMin(first + kPhotosPerImportBatch, int(ready.size()));
+            QList<IngestedPhoto> batch;
+            batch.reserve(last - first);
+            for (int i = first; i < last; ++i)
+                batch.append(*ready.at(i));
+            if (!photoService.insertPhotos(m_recordId, batch, nullptr, &photoError))
+            {
+                importSaved = false;
+                break;
+            }
+            for (const IngestedPhoto &photo : std::as_const(batch))
             {
+                savedPaths.append(photo.sourcePath);
+                if (photo.normalized)
+                    normalizedPaths.append(photo.sourcePath);
+            }
+            progressDialog->setValue(last);
+        }
+        if (importSaved && !db.commit())
+        {
+            importSaved = false;
+            photoError = db.lastError().text();
+        }
+        if (!importSaved)
+        {
+            db.rollback();
+            savedPaths.clear();
+            normalizedPaths.clear();
+            if (cancelledByUser)
+                statusBar()->showMessage(tr("Import zdjęć anulowany."), 5000);
+            else
                 QMessageBox::critical(this,
                                       tr("Błąd"),
-                                      tr("Nie można zapisać zdjęcia:\n%1").arg(q.lastError().text()));
-            }
+                                      tr("Nie można zapisać zdjęcia:\n%1").arg(photoError));
         }
     }
+    progressDialog->close();
+    progressDialog->deleteLater();
+
+    const QStringList archiveFailures = PhotoService::archiveOriginals(normalizedPaths, options.archiveDirectory);
+    if (!archiveFailures.isEmpty())
+    {
+        QMessageBox::warning(this,
+                             tr("Uwaga"),
+                             tr("Nie udało się zarchiwizować oryginałów:\n%1")
+                                 .arg(archiveFailures.join(QStringLiteral("\n"))));
+    }
+
+    // Przenosimy dopiero po COMMIT — wycofany import zostawia pliki na miejscu.
+    PhotoService photoService(db);
+    const QStringList moveFailures = photoService.movePhotosToDone(savedPaths, shouldMovePhotos);
+    if (!moveFailures.isEmpty())
+    {
+        QMessageBox::warning(this,
+                             tr("Uwaga"),
+                             tr("Nie można przenieść do katalogu \"gotowe\":\n%1")
+                                 .arg(moveFailures.join(QStringLiteral("\n"))));
+    }
+    if (!readFailures.isEmpty())
+    {
+        QMessageBox::warning(this,
+                             tr("Uwaga"),
+                             tr("Nie można odczytać plików:\n%1").arg(readFailures.join(QStringLiteral("\n"))));
+    }
+
+    if (importSaved && bytesSaved > 0)
+    {
+        statusBar()->showMessage(tr("Zdjęcia zmniejszone przy dodawaniu — oszczędność %1 MB.")
+                                     .arg(double(bytesSaved) / (1024 * 1024), 0, 'f', 1),
+                                 5000);
+    }
 
     if (m_recordId.isEmpty())
         loadPhotosFromBuffer();
@@ -1053,8 +1299,8 @@ void MainWindow::onAddPhotoClicked()
  * @brief Usuwa wybrane zdjęcie z rekordu.
  *
  * @section MethodOverview
- * Usuwa zdjęcie z bazy danych po potwierdzeniu użytkownika, wykonując zapytanie DELETE
- * i odświeżając podgląd miniaturek w QGraphicsView.
+ * Usuwa zdjęcie z bazy danych po potwierdzeniu użytkownika (PhotoService::deletePhoto
+ * w jednej transakcji) i odświeża podgląd miniaturek w QGraphicsView.
  */
 void MainWindow::onRemovePhotoClicked()
 {
@@ -1078,24 +1324,38 @@ void MainWindow::onRemovePhotoClicked()
     if (!selItem)
         return;
 
-    QString photoId = selItem->data(0).toString();
+    QString photoId = selItem->photoId();
     auto ans = QMessageBox::question(this,
                                      tr("Potwierdzenie"),
                                      tr("Czy usunąć zdjęcie?"),
                                      QMessageBox::Yes | QMessageBox::No);
     if (ans == QMessageBox::Yes)
     {
-        QSqlQuery q(db);
-        q.prepare("DELETE FROM photos WHERE id=:id");
-        q.bindValue(":id", photoId);
-        if (!q.exec())
+        // DELETE zdjęcia, zmniejszenie ref_count i sprzątanie blobów w jednej
+        // transakcji — przerwane usuwanie nie zostawia bloba z błędnym licznikiem.
+        PhotoService photoService(db);
+        QString photoError;
+        QStringList releasedFiles;
+        bool removed = db.transaction();
+        if (!removed)
+            photoError = db.lastError().text();
+        if (removed && !photoService.deletePhoto(photoId, &releasedFiles, &photoError))
+            removed = false;
+        if (removed && !db.commit())
         {
+            removed = false;
+            photoError = db.lastError().text();
+        }
+        if (!removed)
+        {
+            db.rollback();
             QMessageBox::critical(this,
                                   tr("Błąd"),
-                                  tr("Nie można usunąć zdjęcia:\n%1").arg(q.lastError().text()));
+                                  tr("Nie można usunąć zdjęcia:\n%1").arg(photoError));
         }
         else
         {
+            photoService.removeBlobFiles(releasedFiles);
             loadPhotos(m_recordId);
         }
     }
@@ -1229,3 +1489,5 @@ QString MainWindow::validateUuid(const QString &uuid, const QString &defaultValu
     // UUID bez nawiasów jest prawidłowy
     return uuid;
 }
+
+#include "mainwindow.moc"
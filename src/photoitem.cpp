@@ -194,3 +194,25 @@ void PhotoItem::hoverLeaveEvent(QGraphicsSceneHoverEvent *event)
     emit unhovered(this);
     QGraphicsPixmapItem::hoverLeaveEvent(event);
 }
+
+/**
+ * @brief Ustawia identyfikator zdjęcia (photos.id) wyświetlanego przez miniaturę.
+ * @param photoId Identyfikator rekordu w tabeli photos.
+ *
+ * @section MethodOverview
+ * Miniatura trzyma tylko identyfikator — oryginał jest ładowany leniwie
+ * przez PhotoService, gdy jest potrzebny (podgląd, pełny ekran).
+ */
+void PhotoItem::setPhotoId(const QString &photoId)
+{
+    m_photoId = photoId;
+}
+
+/**
+ * @brief Zwraca identyfikator zdjęcia (photos.id) przypisany do miniatury.
+ * @return Identyfikator ustawiony przez setPhotoId lub pusty QString.
+ */
+QString PhotoItem::photoId() const
+{
+    return m_photoId;
+}
@@ -4,7 +4,10 @@
  */
 
 #include "utils.h"
+#include "DatabaseConnectionPool.h"
 #include "DatabaseMigration.h"
+#include "PhotoService.h"
+#include "PreparedStatementCache.h"
 
 #include <QDebug>
 #include <QMessageBox>
@@ -19,6 +22,10 @@ bool setupDatabase(const QString &dbType,
                    const QString &password,
                    int port)
 {
+    PreparedStatementCache::instance().release("default_connection");
+    PhotoService::releaseStatementBudget("default_connection");
+    // Klony połączenia w wątkach roboczych zostaną otwarte od nowa z nowymi ustawieniami.
+    DatabaseConnectionPool::instance().invalidate();
     QSqlDatabase::removeDatabase("default_connection");
     QSqlDatabase db = QSqlDatabase::addDatabase(dbType.compare("MySQL", Qt::CaseInsensitive) == 0
                                                     ? "QMYSQL"
@@ -52,3 +59,45 @@ bool setupDatabase(const QString &dbType,
 
     return ensureDatabaseSchema(db);
 }
+
+bool openWorkerConnection(const QString &sourceConnectionName,
+                          const QString &connectionName,
+                          QString *errorMessage)
+{
+    QSqlDatabase db = QSqlDatabase::cloneDatabase(sourceConnectionName, connectionName);
+    if (!db.isValid()) {
+        if (errorMessage)
+            *errorMessage = QObject::tr("Brak połączenia źródłowego %1.").arg(sourceConnectionName);
+        QSqlDatabase::removeDatabase(connectionName);
+        return false;
+    }
+
+    const bool isSqlite = db.driverName() == "QSQLITE";
+    if (isSqlite) {
+        // Równoległy zapis z GUI — czekamy na blokadę zamiast natychmiastowego SQLITE_BUSY.
+        QString options = db.connectOptions();
+        if (!options.contains("QSQLITE_BUSY_TIMEOUT")) {
+            if (!options.isEmpty())
+                options += ';';
+            options += "QSQLITE_BUSY_TIMEOUT=5000";
+            db.setConnectOptions(options);
+        }
+    }
+
+    if (!db.open()) {
+        if (errorMessage)
+            *errorMessage = db.lastError().text();
+        db = QSqlDatabase();
+        QSqlDatabase::removeDatabase(connectionName);
+        return false;
+    }
+
+    if (isSqlite) {
+        QSqlQuery pragmaQuery(db);
+        pragmaQuery.exec("PRAGMA foreign_keys = ON");
+    }
+
+    if (errorMessage)
+        errorMessage->clear();
+    return true;
+}
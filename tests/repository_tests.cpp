@@ -3,30 +3,47 @@
 #include "DictionaryRepository.h"
 #include "DatabaseMigration.h"
 #include "DatabaseBackupService.h"
+#include "DatabaseConnectionPool.h"
+#include "ItemChangeNotifier.h"
+#include "ItemCsvImporter.h"
 #include "ItemFilterProxyModel.h"
+#include "ItemFilterScheduler.h"
+#include "ItemTableModel.h"
 #include "ItemFormValidator.h"
+#include "ItemQueryBuilder.h"
+#include "ItemSearchIndex.h"
+#include "ItemSearchService.h"
 #include "ItemRepository.h"
 #include "PacmanAnimationModel.h"
 #include "itemList.h"
 #include "mainwindow.h"
+#include "PhotoBlobStore.h"
+#include "PhotoCache.h"
+#include "PhotoLoader.h"
 #include "PhotoService.h"
+#include "PreparedStatementCache.h"
 #include "utils.h"
 
 #include <QBuffer>
+#include <QColor>
 #include <QComboBox>
 #include <QImage>
 #include <QLineEdit>
 #include <QPushButton>
+#include <QScopeGuard>
 #include <QStandardItemModel>
 #include <QStandardPaths>
 #include <QSqlDatabase>
 #include <QSqlError>
 #include <QSqlQuery>
+#include <QSignalSpy>
 #include <QFile>
 #include <QFileInfo>
 #include <QTemporaryDir>
 #include <QUuid>
 
+#include <atomic>
+
 class RepositoryTests : public QObject
 {
     Q_OBJECT
@@ -42,14 +59,31 @@ private slots:
     void itemRepository_updatesDescription();
     void itemRepository_updateDescriptionFailsForUnknownId();
     void itemRepository_bulkUpdatesStatusAndStorage();
+    void itemRepository_bulkUpdatesInChunksWithProgress();
+    void itemCsvImporter_importsRowsAndReportsErrors();
     void dictionaryRepository_supportsCrud();
     void dictionaryRepository_addsModelWithParentVendor();
     void photoService_loadsStoredPhotos();
+    void photoService_storesThumbnailsOnInsert();
+    void photoService_createsDownscaledThumbnail();
+    void photoService_backfillsMissingThumbnails();
+    void photoService_decodesAtTargetSize();
+    void photoService_decodesRegionForZoomedViewer();
+    void photoService_normalizesPhotosOnIngest();
+    void photoService_deduplicatesPhotoBlobs();
+    void photoService_insertsPhotosInMultiRowStatements();
+    void photoService_storesBlobsInFileStore();
+    void photoLoader_deliversThumbnailsAsynchronously();
+    void photoCache_evictsLeastRecentlyUsedWithinBudget();
+    void photoCache_countsHitsAndInvalidatesOnDelete();
+    void preparedStatementCache_reusesAndEvictsStatements();
+    void databaseConnectionPool_givesEachThreadItsOwnConnection();
     void photoService_movesPhotosToDoneWhenEnabled();
     void photoService_keepsPhotosInPlaceWhenMoveDisabled();
     void databaseMigration_removesBracesFromAllRelevantTables();
     void databaseMigration_fixesKnownBrokenUuids();
     void databaseMigration_isNoOpWithoutSchema();
+    void databaseSchema_maintainsIndexCatalog();
     void databaseBackupService_buildsSafeDumpArguments();
     void databaseBackupService_buildsArgumentsWithDefaultsExtraFile();
     void databaseBackupService_rejectsNonMySqlConnection();
@@ -62,14 +96,24 @@ private slots:
     void mainWindow_setEditModeForNewRecordClearsFieldsAndDefaultsSelections();
     void mainWindow_setEditModeLoadsExistingRecord();
     void itemFilterProxyModel_searchesAcrossMultipleFields();
+    void itemTableModel_filtersOnInternedDictionaryIds();
+    void itemTableModel_patchesRowsOnRepositoryChanges();
+    void itemFilterProxyModel_computesFacetCountsInMemory();
+    void itemSearchIndex_matchesFoldedTrigramsIncrementally();
+    void itemSearchService_queriesFullTextIndex();
+    void itemTableModel_fetchesPagesByKeyset();
+    void itemQueryBuilder_pushesFiltersIntoSql();
+    void itemTableModel_sortsByDictionaryRanks();
+    void itemFilterScheduler_coalescesAndFiltersInBackground();
     void itemList_restoresSavedFilters();
+    void itemList_keepsOtherComboValuesWithSqlFilters();
     void pacmanAnimationModel_activatesAfterConfiguredDelay();
     void pacmanAnimationModel_requestsEatingInTime();
     void pacmanAnimationModel_reachesCollisionAndFinish();
 
 private:
     QString lookupId(const QString &tableName, const QString &name) const;
-    QByteArray createPhotoBytes() const;
+    QByteArray createPhotoBytes(const QColor &color = Qt::red) const;
     ItemRecordData createSampleItem() const;
 
     QString m_connectionName;
@@ -93,6 +137,11 @@ void RepositoryTests::initTestCase()
 
 void RepositoryTests::cleanup()
 {
+    PhotoCache::instance().clear();
+    PreparedStatementCache::instance().release(m_connectionName);
+    PreparedStatementCache::instance().release(QStringLiteral("default_connection"));
+    PhotoService::clearStatementBudgets();
+
     const QString connectionName = m_connectionName;
     m_db.close();
     m_db = QSqlDatabase();
@@ -111,10 +160,10 @@ QString RepositoryTests::lookupId(const QString &tableName, const QString &name)
     return query.value(0).toString();
 }
 
-QByteArray RepositoryTests::createPhotoBytes() const
+QByteArray RepositoryTests::createPhotoBytes(const QColor &color) const
 {
     QImage image(8, 8, QImage::Format_ARGB32);
-    image.fill(Qt::red);
+    image.fill(color);
 
     QByteArray bytes;
     QBuffer buffer(&bytes);
@@ -301,6 +350,147 @@ void RepositoryTests::itemRepository_bulkUpdatesStatusAndStorage()
     QCOMPARE(query.value(0).toInt(), 2);
 }
 
+void RepositoryTests::itemRepository_bulkUpdatesInChunksWithProgress()
+{
+    const ItemRecordData sample = createSampleItem();
+    QStringList itemIds;
+    QVERIFY(m_db.transaction());
+    QSqlQuery insert(m_db);
+    insert.prepare(QStringLiteral(
+        "INSERT INTO eksponaty (id, name, status_id, type_id, vendor_id, model_id, storage_place_id, "
+        "production_year, value, has_original_packaging) "
+        "VALUES (?, ?, ?, ?, ?, ?, ?, 1988, 0, 0)"));
+    for (int i = 0; i < 1203; ++i) {
+        const QString itemId = QUuid::createUuid().toString(QUuid::WithoutBraces);
+        insert.addBindValue(itemId);
+        insert.addBindValue(QStringLiteral("Eksponat %1").arg(i));
+        insert.addBindValue(sample.statusId);
+        insert.addBindValue(sample.typeId);
+        insert.addBindValue(sample.vendorId);
+        insert.addBindValue(sample.modelId);
+        insert.addBindValue(sample.storagePlaceId);
+        QVERIFY2(insert.exec(), qPrintable(insert.lastError().text()));
+        itemIds.append(itemId);
+    }
+    QVERIFY(m_db.commit());
+
+    auto countWithStatus = [this](const QString &statusId)
+    {
+        QSqlQuery query(m_db);
+        query.prepare(QStringLiteral("SELECT COUNT(*) FROM eksponaty WHERE status_id = :statusId"));
+        query.bindValue(QStringLiteral(":statusId"), statusId);
+        return query.exec() && query.next() ? query.value(0).toInt() : -1;
+    };
+
+    ItemRepository repository(m_db);
+    QString errorMessage;
+    const QString brokenStatusId = lookupId(QStringLiteral("statuses"), QStringLiteral("Uszkodzony"));
+
+    // Przerwanie po pierwszej paczce wycofuje całą transakcję.
+    QVERIFY(!repository.updateStatusForItems(itemIds, brokenStatusId, &errorMessage,
+                                             [](int, int) { return false; }));
+    QVERIFY(!errorMessage.isEmpty());
+    QCOMPARE(countWithStatus(brokenStatusId), 0);
+
+    QList<int> progress;
+    QVERIFY2(repository.updateStatusForItems(itemIds, brokenStatusId, &errorMessage,
+                                             [&progress](int done, int total)
+                                             {
+                                                 progress.append(done);
+                                                 return total == 1203;
+                                             }),
+             qPrintable(errorMessage));
+    QCOMPARE(progress, QList<int>({500, 1000, 1203}));
+    QCOMPARE(countWithStatus(brokenStatusId), 1203);
+}
+
+void RepositoryTests::itemCsvImporter_importsRowsAndReportsErrors()
+{
+    // saveItems: rekord odrzucony przez bazę (zduplikowane ID) nie przerywa paczki.
+    ItemRepository repository(m_db);
+    QString errorMessage;
+    ItemRecordData first = createSampleItem();
+    first.id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    ItemRecordData duplicate = createSampleItem();
+    duplicate.id = first.id;
+    QStringList savedItemIds;
+    QList<ItemSaveError> saveErrors;
+    QVERIFY2(repository.saveItems({first, duplicate, createSampleItem()}, &savedItemIds, &saveErrors, &errorMessage),
+             qPrintable(errorMessage));
+    QCOMPARE(savedItemIds.size(), 2);
+    QCOMPARE(saveErrors.size(), 1);
+    QCOMPARE(saveErrors.first().index, 1);
+
+    QByteArray csv = QByteArrayLiteral(
+        "Nazwa;Typ;Producent;Model;Status;Miejsce przechowywania;Rok produkcji;Opis;Oryginalne opakowanie\n"
+        "Atari z importu;Komputer;atari;Atari 800XL;Sprawny;Magazyn 1;1983;\"Opis; z separatorem\n"
+        "i drugą linią\";tak\n"
+        "\n"
+        "Spectrum;Komputer;Sinclair Research;ZX Spectrum 48K;Sprawny;Magazyn 1;198x;;\n"
+        ";Komputer;Atari;Atari 800XL;Sprawny;Magazyn 1;;;\n"
+        "Spectrum +;Komputer;Sinclair Research;ZX Spectrum+;Sprawny;Magazyn 1;1984;;nie\n");
+    QBuffer buffer(&csv);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+    ItemCsvImporter importer(m_db);
+    ItemImportResult result;
+    int progressCalls = 0;
+    QVERIFY2(importer.importCsv(&buffer, &result, &errorMessage,
+                                [&progressCalls](qint64, qint64)
+                                {
+                                    ++progressCalls;
+                                    return true;
+                                }),
+             qPrintable(errorMessage));
+    QCOMPARE(result.importedCount, 2);
+    QCOMPARE(progressCalls, 1);
+    QCOMPARE(result.rowErrors.size(), 2);
+    QCOMPARE(result.rowErrors.at(0).line, 5);
+    QCOMPARE(result.rowErrors.at(1).line, 6);
+    // Nowy producent i nowy model (wiersz z błędnym rokiem nie tworzy wpisów);
+    // „atari” to istniejący wpis „Atari”.
+    QCOMPARE(result.createdDictionaryEntries, 2);
+
+    QSqlQuery query(m_db);
+    QVERIFY(query.exec(QStringLiteral(
+        "SELECT e.description, e.has_original_packaging, e.production_year, v.name FROM eksponaty e "
+        "JOIN vendors v ON v.id = e.vendor_id WHERE e.name = 'Atari z importu'")));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toString(), QStringLiteral("Opis; z separatorem\ni drugą linią"));
+    QVERIFY(query.value(1).toBool());
+    QCOMPARE(query.value(2).toInt(), 1983);
+    QCOMPARE(query.value(3).toString(), QStringLiteral("Atari"));
+
+    QVERIFY(query.exec(QStringLiteral(
+        "SELECT COUNT(*) FROM models m JOIN vendors v ON v.id = m.vendor_id "
+        "WHERE v.name = 'Sinclair Research' AND m.name = 'ZX Spectrum+'")));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toInt(), 1);
+
+    // Model jest szukany razem z producentem — „Atari 800XL” nie trafia do Commodore.
+    QByteArray otherVendor = QByteArrayLiteral(
+        "Nazwa;Typ;Producent;Model;Status;Miejsce przechowywania
+"
+        "Pomyłka;Komputer;Commodore;Atari 800XL;Sprawny;Magazyn 1
+"
+        "Spectrum 2;Komputer;Sinclair Research;zx spectrum+;Sprawny;Magazyn 1
+");
+    QBuffer otherVendorBuffer(&otherVendor);
+    QVERIFY(otherVendorBuffer.open(QIODevice::ReadOnly));
+    QVERIFY2(importer.importCsv(&otherVendorBuffer, &result, &errorMessage), qPrintable(errorMessage));
+    QCOMPARE(result.importedCount, 1);
+    QCOMPARE(result.rowErrors.size(), 1);
+    QCOMPARE(result.rowErrors.at(0).line, 2);
+    QCOMPARE(result.createdDictionaryEntries, 0);
+
+    // Nagłówek bez wymaganych kolumn — nic nie jest zapisywane.
+    QByteArray incomplete = QByteArrayLiteral("name,type\nAtari,Komputer\n");
+    QBuffer incompleteBuffer(&incomplete);
+    QVERIFY(incompleteBuffer.open(QIODevice::ReadOnly));
+    QVERIFY(!importer.importCsv(&incompleteBuffer, &result, &errorMessage));
+    QVERIFY(errorMessage.contains(QStringLiteral("Producent")));
+}
+
 void RepositoryTests::dictionaryRepository_supportsCrud()
 {
     DictionaryRepository repository(m_db);
@@ -360,6 +550,740 @@ void RepositoryTests::photoService_loadsStoredPhotos()
     QVERIFY(!photos.first().pixmap.isNull());
 }
 
+void RepositoryTests::photoService_storesThumbnailsOnInsert()
+{
+    ItemRepository repository(m_db);
+    QString savedItemId;
+    QString errorMessage;
+
+    QVERIFY2(repository.saveItem(createSampleItem(), {createPhotoBytes()}, &savedItemId, &errorMessage),
+             qPrintable(errorMessage));
+
+    QSqlQuery thumbnailQuery(m_db);
+    QVERIFY(thumbnailQuery.exec(QStringLiteral("SELECT COUNT(*) FROM photo_thumbnails")));
+    QVERIFY(thumbnailQuery.next());
+    QCOMPARE(thumbnailQuery.value(0).toInt(), PhotoService::thumbnailSizes().size());
+
+    PhotoService photoService(m_db);
+    const QList<StoredPhoto> thumbnails =
+        photoService.loadThumbnails(savedItemId, PhotoService::kListThumbnailSize, &errorMessage);
+    QVERIFY2(errorMessage.isEmpty(), qPrintable(errorMessage));
+    QCOMPARE(thumbnails.size(), 1);
+    QVERIFY(!thumbnails.first().pixmap.isNull());
+
+    const QByteArray preview =
+        photoService.loadPhotoThumbnail(thumbnails.first().id, PhotoService::kPreviewThumbnailSize, &errorMessage);
+    QVERIFY2(!QImage::fromData(preview).isNull(), qPrintable(errorMessage));
+    QVERIFY(photoService.loadPhotoThumbnail(thumbnails.first().id, 1, &errorMessage).isEmpty());
+    QVERIFY2(errorMessage.isEmpty(), qPrintable(errorMessage));
+
+    const QPixmap original = photoService.loadOriginalPhoto(thumbnails.first().id, &errorMessage);
+    QVERIFY2(!original.isNull(), qPrintable(errorMessage));
+    QCOMPARE(original.size(), QSize(8, 8));
+
+    QVERIFY2(repository.deleteItem(savedItemId, &errorMessage), qPrintable(errorMessage));
+    QVERIFY(thumbnailQuery.exec(QStringLiteral("SELECT COUNT(*) FROM photo_thumbnails")));
+    QVERIFY(thumbnailQuery.next());
+    QCOMPARE(thumbnailQuery.value(0).toInt(), 0);
+}
+
+void RepositoryTests::photoService_createsDownscaledThumbnail()
+{
+    QImage image(400, 200, QImage::Format_RGB32);
+    image.fill(Qt::blue);
+    QByteArray bytes;
+    QBuffer buffer(&bytes);
+    buffer.open(QIODevice::WriteOnly);
+    QVERIFY(image.save(&buffer, "PNG"));
+
+    const QByteArray thumbnail = PhotoService::createThumbnail(bytes, PhotoService::kListThumbnailSize);
+    QImage decoded;
+    QVERIFY(decoded.loadFromData(thumbnail));
+    QCOMPARE(decoded.size(), QSize(160, 80));
+
+    QVERIFY(PhotoService::createThumbnail(QByteArray("not an image"), 160).isEmpty());
+}
+
+void RepositoryTests::photoService_backfillsMissingThumbnails()
+{
+    ItemRepository repository(m_db);
+    QString savedItemId;
+    QString errorMessage;
+    QVERIFY2(repository.saveItem(createSampleItem(), {}, &savedItemId, &errorMessage),
+             qPrintable(errorMessage));
+
+    // Wiersz "sprzed v1.5" — zdjęcie bez miniatur.
+    QSqlQuery insertQuery(m_db);
+    insertQuery.prepare(QStringLiteral("INSERT INTO photos (id, eksponat_id, photo) VALUES (:id, :itemId, :photo)"));
+    insertQuery.bindValue(QStringLiteral(":id"), QUuid::createUuid().toString(QUuid::WithoutBraces));
+    insertQuery.bindValue(QStringLiteral(":itemId"), savedItemId);
+    insertQuery.bindValue(QStringLiteral(":photo"), createPhotoBytes());
+    QVERIFY2(insertQuery.exec(), qPrintable(insertQuery.lastError().text()));
+
+    PhotoService photoService(m_db);
+    int generatedCount = 0;
+    QVERIFY2(photoService.backfillThumbnails(&generatedCount, &errorMessage), qPrintable(errorMessage));
+    QCOMPARE(generatedCount, 1);
+
+    QSqlQuery thumbnailQuery(m_db);
+    QVERIFY(thumbnailQuery.exec(QStringLiteral("SELECT COUNT(*) FROM photo_thumbnails")));
+    QVERIFY(thumbnailQuery.next());
+    QCOMPARE(thumbnailQuery.value(0).toInt(), PhotoService::thumbnailSizes().size());
+
+    QVERIFY2(photoService.backfillThumbnails(&generatedCount, &errorMessage), qPrintable(errorMessage));
+    QCOMPARE(generatedCount, 0);
+}
+
+void RepositoryTests::photoService_decodesAtTargetSize()
+{
+    QImage image(400, 200, QImage::Format_RGB32);
+    image.fill(Qt::green);
+    QByteArray jpegBytes;
+    QBuffer buffer(&jpegBytes);
+    buffer.open(QIODevice::WriteOnly);
+    QVERIFY(image.save(&buffer, "JPG"));
+
+    QCOMPARE(PhotoService::decodeScaled(jpegBytes, QSize(100, 100)).size(), QSize(100, 50));
+    QCOMPARE(PhotoService::decodeScaled(jpegBytes, QSize()).size(), QSize(400, 200));
+    // Małe obrazy nie są powiększane.
+    QCOMPARE(PhotoService::decodeScaled(createPhotoBytes(), QSize(100, 100)).size(), QSize(8, 8));
+    QVERIFY(PhotoService::decodeScaled(QByteArray("not an image"), QSize(100, 100)).isNull());
+}
+
+void RepositoryTests::photoService_decodesRegionForZoomedViewer()
+{
+    QImage image(400, 200, QImage::Format_RGB32);
+    image.fill(Qt::red);
+    for (int y = 0; y < image.height(); ++y)
+        for (int x = 200; x < image.width(); ++x)
+            image.setPixelColor(x, y, Qt::blue);
+    QByteArray pngBytes;
+    QBuffer buffer(&pngBytes);
+    buffer.open(QIODevice::WriteOnly);
+    QVERIFY(image.save(&buffer, "PNG"));
+
+    bool transformed = true;
+    QCOMPARE(PhotoService::imageSize(pngBytes, &transformed), QSize(400, 200));
+    QVERIFY(!transformed);
+
+    const QImage tile = PhotoService::decodeRegion(pngBytes, QRect(200, 0, 200, 200), QSize(50, 50));
+    QCOMPARE(tile.size(), QSize(50, 50));
+    QCOMPARE(tile.pixelColor(25, 25), QColor(Qt::blue));
+
+    // Ten sam obraz jako JPEG z orientacją EXIF 6 (obrót o 90° w prawo): po orientacji
+    // 200×400, czerwona górna połowa, niebieska dolna.
+    QByteArray jpegBytes;
+    QBuffer jpegBuffer(&jpegBytes);
+    jpegBuffer.open(QIODevice::WriteOnly);
+    QVERIFY(image.save(&jpegBuffer, "JPG", 100));
+    const char exifOrientation[] = {'\xFF', '\xE1', 0x00, 0x22, 'E', 'x', 'i', 'f', 0x00, 0x00,
+                                    'M', 'M', 0x00, 0x2A, 0x00, 0x00, 0x00, 0x08,
+                                    0x00, 0x01,
+                                    0x01, 0x12, 0x00, 0x03, 0x00, 0x00, 0x00, 0x01, 0x00, 0x06, 0x00, 0x00,
+                                    0x00, 0x00, 0x00, 0x00};
+    jpegBytes.insert(2, exifOrientation, sizeof(exifOrientation));
+    QCOMPARE(PhotoService::imageSize(jpegBytes, &transformed), QSize(200, 400));
+    QVERIFY(transformed);
+
+    const QImage orientedTile = PhotoService::decodeOrientedRegion(jpegBytes, QRect(0, 100, 200, 200), QSize(100, 100));
+    QCOMPARE(orientedTile.size(), QSize(100, 100));
+    QVERIFY(orientedTile.pixelColor(50, 10).red() > 200);
+    QVERIFY(orientedTile.pixelColor(50, 10).blue() < 60);
+    QVERIFY(orientedTile.pixelColor(50, 90).blue() > 200);
+    QVERIFY(orientedTile.pixelColor(50, 90).red() < 60);
+
+    ItemRepository repository(m_db);
+    QString savedItemId;
+    QString errorMessage;
+    QVERIFY2(repository.saveItem(createSampleItem(), {pngBytes}, &savedItemId, &errorMessage),
+             qPrintable(errorMessage));
+
+    PhotoService photoService(m_db);
+    const QList<StoredPhoto> photos = photoService.loadStoredPhotos(savedItemId, &errorMessage);
+    QCOMPARE(photos.size(), 1);
+    QCOMPARE(photoService.loadPhotoData(photos.first().id, &errorMessage), pngBytes);
+    QVERIFY2(errorMessage.isEmpty(), qPrintable(errorMessage));
+
+    QVERIFY(photoService.loadPhotoData(QStringLiteral("missing"), &errorMessage).isEmpty());
+    QVERIFY(!errorMessage.isEmpty());
+}
+
+void RepositoryTests::photoService_normalizesPhotosOnIngest()
+{
+    QImage image(1200, 600, QImage::Format_RGB32);
+    image.fill(Qt::darkCyan);
+    QByteArray jpegBytes;
+    QBuffer buffer(&jpegBytes);
+    buffer.open(QIODevice::WriteOnly);
+    QVERIFY(image.save(&buffer, "JPG", 100));
+
+    PhotoIngestOptions options;
+    QVERIFY(!options.enabled);
+    options.enabled = true;
+    options.maxLongEdge = 300;
+    options.quality = 80;
+
+    bool normalized = false;
+    const QByteArray result = PhotoService::normalizePhoto(jpegBytes, options, &normalized);
+    QVERIFY(normalized);
+    QVERIFY(result.size() < jpegBytes.size());
+    QCOMPARE(QImage::fromData(result).size(), QSize(300, 150));
+
+    // Oryginał większy niż maxLongEdge nigdy nie wraca bez zmian, nawet gdy po
+    // przekodowaniu (PNG jednego koloru → JPEG) plik nie jest mniejszy.
+    QByteArray pngBytes;
+    QBuffer pngBuffer(&pngBytes);
+    pngBuffer.open(QIODevice::WriteOnly);
+    QVERIFY(image.save(&pngBuffer, "PNG"));
+    options.quality = 100;
+    const QImage capped = QImage::fromData(PhotoService::normalizePhoto(pngBytes, options, &normalized));
+    QVERIFY(normalized);
+    QCOMPARE(capped.size(), QSize(300, 150));
+    options.quality = 80;
+
+    // W limicie wymiarów i bez zysku — zostaje oryginał.
+    const QByteArray smallPng = createPhotoBytes();
+    QVERIFY(PhotoService::normalizePhoto(smallPng, options, &normalized).size() <= smallPng.size());
+
+    options.enabled = false;
+    QCOMPARE(PhotoService::normalizePhoto(jpegBytes, options, &normalized), jpegBytes);
+    QVERIFY(!normalized);
+    options.enabled = true;
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString largePath = tempDir.filePath(QStringLiteral("large.jpg"));
+    QFile largeFile(largePath);
+    QVERIFY(largeFile.open(QIODevice::WriteOnly));
+    largeFile.write(jpegBytes);
+    largeFile.close();
+    const QString missingPath = tempDir.filePath(QStringLiteral("missing.jpg"));
+
+    qint64 bytesSaved = 0;
+    std::atomic<int> progressCalls{0};
+    const QList<IngestedPhoto> ingested =
+        PhotoService::ingestFiles({largePath, missingPath}, options, &bytesSaved,
+                                  [&progressCalls](int, int total, qint64)
+                                  {
+                                      ++progressCalls;
+                                      return total == 2;
+                                  });
+    QCOMPARE(progressCalls.load(), 2);
+    QCOMPARE(ingested.size(), 2);
+    QCOMPARE(ingested.at(0).sourcePath, largePath);
+    QVERIFY(ingested.at(0).normalized);
+    QCOMPARE(ingested.at(0).contentHash, PhotoService::contentHash(ingested.at(0).data));
+    QCOMPARE(ingested.at(0).thumbnails.size(), PhotoService::thumbnailSizes().size());
+    QVERIFY(!ingested.at(1).errorMessage.isEmpty());
+    QCOMPARE(bytesSaved, ingested.at(0).originalBytes - ingested.at(0).data.size());
+    QVERIFY(bytesSaved > 0);
+
+    const QString archiveDir = tempDir.filePath(QStringLiteral("archiwum"));
+    QVERIFY(PhotoService::archiveOriginals({largePath}, archiveDir).isEmpty());
+    QVERIFY(PhotoService::archiveOriginals({largePath}, archiveDir).isEmpty());
+    QVERIFY(QFileInfo::exists(archiveDir + QStringLiteral("/large.jpg")));
+    QVERIFY(QFileInfo::exists(archiveDir + QStringLiteral("/large_1.jpg")));
+
+    // Zapis z policzonymi wcześniej miniaturami.
+    ItemRepository repository(m_db);
+    QString itemId;
+    QString errorMessage;
+    QVERIFY2(repository.saveItem(createSampleItem(), {}, &itemId, &errorMessage), qPrintable(errorMessage));
+    PhotoService photoService(m_db);
+    QVERIFY2(photoService.insertPhoto(itemId, ingested.at(0), nullptr, &errorMessage), qPrintable(errorMessage));
+    const QList<StoredPhotoData> thumbnails =
+        photoService.loadThumbnailData(itemId, PhotoService::kListThumbnailSize, &errorMessage);
+    QCOMPARE(thumbnails.size(), 1);
+    QCOMPARE(thumbnails.first().data, ingested.at(0).thumbnails.value(PhotoService::kListThumbnailSize));
+
+    // Nowy rekord z bufora MainWindow: zapisywane są miniatury z IngestedPhoto, bez ponownego kodowania.
+    IngestedPhoto buffered;
+    buffered.data = createPhotoBytes(Qt::green);
+    buffered.contentHash = PhotoService::contentHash(buffered.data);
+    buffered.thumbnails.insert(PhotoService::kListThumbnailSize, createPhotoBytes(Qt::yellow));
+    QString bufferedItemId;
+    QVERIFY2(repository.saveItemWithIngestedPhotos(createSampleItem(), {buffered}, &bufferedItemId, &errorMessage),
+             qPrintable(errorMessage));
+    const QList<StoredPhotoData> bufferedThumbnails =
+        photoService.loadThumbnailData(bufferedItemId, PhotoService::kListThumbnailSize, &errorMessage);
+    QCOMPARE(bufferedThumbnails.size(), 1);
+    QCOMPARE(bufferedThumbnails.first().data, createPhotoBytes(Qt::yellow));
+
+    // Import do istniejącego rekordu (MainWindow::finishPhotoImport): paczka zdjęć
+    // z ingestFiles w jednej transakcji, z miniaturami policzonymi przy wczytywaniu.
+    IngestedPhoto red;
+    red.data = createPhotoBytes(Qt::red);
+    red.thumbnails.insert(PhotoService::kListThumbnailSize, createPhotoBytes(Qt::magenta));
+    IngestedPhoto blue;
+    blue.data = createPhotoBytes(Qt::blue);
+    QVERIFY(m_db.transaction());
+    QStringList importedIds;
+    QVERIFY2(photoService.insertPhotos(itemId, {red, blue}, &importedIds, &errorMessage), qPrintable(errorMessage));
+    QVERIFY(m_db.commit());
+    QCOMPARE(importedIds.size(), 2);
+    QCOMPARE(photoService.loadPhotoIds(itemId, &errorMessage).size(), 3);
+    QCOMPARE(photoService.loadPhotoThumbnail(importedIds.at(0), PhotoService::kListThumbnailSize, &errorMessage),
+             createPhotoBytes(Qt::magenta));
+    QVERIFY(!photoService.loadPhotoThumbnail(importedIds.at(1), PhotoService::kListThumbnailSize, &errorMessage)
+                 .isEmpty());
+}
+
+void RepositoryTests::photoService_deduplicatesPhotoBlobs()
+{
+    ItemRepository repository(m_db);
+    QString firstItemId;
+    QString secondItemId;
+    QString errorMessage;
+    QVERIFY2(repository.saveItem(createSampleItem(), {createPhotoBytes(), createPhotoBytes()},
+                                 &firstItemId, &errorMessage),
+             qPrintable(errorMessage));
+    QVERIFY2(repository.saveItem(createSampleItem(), {createPhotoBytes()}, &secondItemId, &errorMessage),
+             qPrintable(errorMessage));
+
+    auto blobState = [this]()
+    {
+        QSqlQuery query(m_db);
+        if (!query.exec(QStringLiteral("SELECT COUNT(*), COALESCE(SUM(ref_count), 0) FROM photo_blobs")) || !query.next())
+            return QPair<int, int>(-1, -1);
+        return QPair<int, int>(query.value(0).toInt(), query.value(1).toInt());
+    };
+    QCOMPARE(blobState(), QPair<int, int>(1, 3));
+
+    PhotoService photoService(m_db);
+    const QList<StoredPhotoData> thumbnails =
+        photoService.loadThumbnailData(firstItemId, PhotoService::kListThumbnailSize, &errorMessage);
+    QCOMPARE(thumbnails.size(), 2);
+    const QImage original = photoService.loadScaledPhoto(thumbnails.first().id, QSize(), &errorMessage);
+    QVERIFY2(!original.isNull(), qPrintable(errorMessage));
+    QCOMPARE(original.size(), QSize(8, 8));
+
+    QVERIFY2(photoService.deletePhoto(thumbnails.first().id, nullptr, &errorMessage), qPrintable(errorMessage));
+    QCOMPARE(blobState(), QPair<int, int>(1, 2));
+
+    QVERIFY2(repository.deleteItem(firstItemId, &errorMessage), qPrintable(errorMessage));
+    QCOMPARE(blobState(), QPair<int, int>(1, 1));
+    QVERIFY2(repository.deleteItem(secondItemId, &errorMessage), qPrintable(errorMessage));
+    QCOMPARE(blobState(), QPair<int, int>(0, 0));
+}
+
+void RepositoryTests::photoService_insertsPhotosInMultiRowStatements()
+{
+    ItemRepository repository(m_db);
+    QString itemId;
+    QString errorMessage;
+    QVERIFY2(repository.saveItem(createSampleItem(), {createPhotoBytes()}, &itemId, &errorMessage),
+             qPrintable(errorMessage));
+
+    auto photoBytes = [](const QColor &color)
+    {
+        QImage image(12, 6, QImage::Format_RGB32);
+        image.fill(color);
+        QByteArray bytes;
+        QBuffer buffer(&bytes);
+        buffer.open(QIODevice::WriteOnly);
+        image.save(&buffer, "PNG");
+        return bytes;
+    };
+    const QByteArray blue = photoBytes(Qt::blue);
+    // Zielone dwa razy, czerwone jest już w bazie (zdjęcie z saveItem).
+    const QList<QByteArray> photos = {blue, photoBytes(Qt::green), createPhotoBytes(), photoBytes(Qt::green)};
+
+    PhotoService photoService(m_db);
+    QStringList photoIds;
+    QVERIFY2(photoService.insertPhotos(itemId, photos, &photoIds, &errorMessage), qPrintable(errorMessage));
+    QCOMPARE(photoIds.size(), 4);
+    QCOMPARE(QSet<QString>(photoIds.cbegin(), photoIds.cend()).size(), 4);
+
+    QSqlQuery query(m_db);
+    QVERIFY(query.exec(QStringLiteral("SELECT COUNT(*), SUM(ref_count) FROM photo_blobs")));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toInt(), 3);
+    QCOMPARE(query.value(1).toInt(), 5);
+
+    const QList<StoredPhotoData> thumbnails =
+        photoService.loadThumbnailData(itemId, PhotoService::kListThumbnailSize, &errorMessage);
+    QCOMPARE(thumbnails.size(), 5);
+    const QImage first = photoService.loadScaledPhoto(photoIds.first(), QSize(), &errorMessage);
+    QVERIFY2(!first.isNull(), qPrintable(errorMessage));
+    QCOMPARE(first.size(), QSize(12, 6));
+    QCOMPARE(first.pixelColor(0, 0), QColor(Qt::blue));
+}
+
+void RepositoryTests::photoService_storesBlobsInFileStore()
+{
+    QTemporaryDir storeDir;
+    QVERIFY(storeDir.isValid());
+
+    ItemRepository repository(m_db);
+    QString itemId;
+    QString errorMessage;
+    QVERIFY2(repository.saveItem(createSampleItem(), {}, &itemId, &errorMessage), qPrintable(errorMessage));
+
+    // Zdjęcie sprzed magazynu plików — dane w photos.photo.
+    const QString legacyId = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    QImage legacyImage(16, 4, QImage::Format_RGB32);
+    legacyImage.fill(Qt::yellow);
+    QByteArray legacyBytes;
+    QBuffer buffer(&legacyBytes);
+    buffer.open(QIODevice::WriteOnly);
+    QVERIFY(legacyImage.save(&buffer, "PNG"));
+    QSqlQuery legacyInsert(m_db);
+    legacyInsert.prepare(QStringLiteral("INSERT INTO photos (id, eksponat_id, photo) VALUES (:id, :itemId, :photo)"));
+    legacyInsert.bindValue(QStringLiteral(":id"), legacyId);
+    legacyInsert.bindValue(QStringLiteral(":itemId"), itemId);
+    legacyInsert.bindValue(QStringLiteral(":photo"), legacyBytes);
+    QVERIFY2(legacyInsert.exec(), qPrintable(legacyInsert.lastError().text()));
+
+    const PhotoBlobStore store(storeDir.path());
+    PhotoService photoService(m_db, store);
+    QString photoId;
+    QVERIFY2(photoService.insertPhoto(itemId, createPhotoBytes(), &photoId, &errorMessage), qPrintable(errorMessage));
+
+    const QString hash = PhotoService::contentHash(createPhotoBytes());
+    QVERIFY(QFileInfo::exists(store.pathForHash(hash)));
+    QSqlQuery blobQuery(m_db);
+    QVERIFY(blobQuery.exec(QStringLiteral("SELECT LENGTH(data), external, width, height FROM photo_blobs")));
+    QVERIFY(blobQuery.next());
+    QCOMPARE(blobQuery.value(0).toInt(), 0);
+    QCOMPARE(blobQuery.value(1).toInt(), 1);
+    QCOMPARE(blobQuery.value(2).toInt(), 8);
+    QCOMPARE(blobQuery.value(3).toInt(), 8);
+    QCOMPARE(photoService.loadScaledPhoto(photoId, QSize(), &errorMessage).size(), QSize(8, 8));
+
+    int movedCount = 0;
+    QVERIFY2(photoService.migrateBlobsToFileStore(&movedCount, &errorMessage), qPrintable(errorMessage));
+    QCOMPARE(movedCount, 1);
+    QVERIFY(QFileInfo::exists(store.pathForHash(PhotoService::contentHash(legacyBytes))));
+    QCOMPARE(photoService.loadScaledPhoto(legacyId, QSize(), &errorMessage).size(), QSize(16, 4));
+
+    // Plik znika dopiero po COMMIT — wycofane usunięcie zostawia zdjęcie czytelne.
+    QStringList releasedFiles;
+    QVERIFY(m_db.transaction());
+    QVERIFY2(photoService.deletePhoto(photoId, &releasedFiles, &errorMessage), qPrintable(errorMessage));
+    QCOMPARE(releasedFiles, QStringList{hash});
+    QVERIFY(QFileInfo::exists(store.pathForHash(hash)));
+    QVERIFY(m_db.rollback());
+    QCOMPARE(photoService.loadScaledPhoto(photoId, QSize(), &errorMessage).size(), QSize(8, 8));
+
+    QVERIFY(m_db.transaction());
+    QVERIFY2(photoService.deletePhoto(photoId, &releasedFiles, &errorMessage), qPrintable(errorMessage));
+    QVERIFY(m_db.commit());
+    photoService.removeBlobFiles(releasedFiles);
+    QVERIFY(!QFileInfo::exists(store.pathForHash(hash)));
+}
+
+void RepositoryTests::photoLoader_deliversThumbnailsAsynchronously()
+{
+    // Loader klonuje połączenie, więc baza musi być plikiem (klon :memory: byłby pusty).
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString connectionName = QStringLiteral("photo_loader_%1")
+                                       .arg(QUuid::createUuid().toString(QUuid::WithoutBraces));
+    {
+        QSqlDatabase fileDb = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), connectionName);
+        fileDb.setDatabaseName(tempDir.filePath(QStringLiteral("loader.sqlite")));
+        QVERIFY2(fileDb.open(), qPrintable(fileDb.lastError().text()));
+        QVERIFY(ensureDatabaseSchema(fileDb));
+
+        ItemRepository repository(fileDb);
+        const ItemRecordData item = createSampleItem();
+        QString firstItemId;
+        QString secondItemId;
+        QString errorMessage;
+        QVERIFY2(repository.saveItem(item, {createPhotoBytes(), createPhotoBytes()}, &firstItemId, &errorMessage),
+                 qPrintable(errorMessage));
+        QVERIFY2(repository.saveItem(item, {createPhotoBytes()}, &secondItemId, &errorMessage),
+                 qPrintable(errorMessage));
+
+        {
+            PhotoLoader loader(connectionName);
+            QSignalSpy listedSpy(&loader, &PhotoLoader::photosListed);
+            QSignalSpy readySpy(&loader, &PhotoLoader::photoReady);
+
+            // Pierwsze żądanie jest natychmiast zastąpione — jego wyniki nie mogą dotrzeć.
+            loader.requestThumbnails(firstItemId, PhotoService::kListThumbnailSize);
+            const quint64 requestId = loader.requestThumbnails(secondItemId, PhotoService::kListThumbnailSize);
+
+            QTRY_COMPARE(readySpy.count(), 1);
+            QCOMPARE(listedSpy.count(), 1);
+            QCOMPARE(listedSpy.first().at(0).toULongLong(), requestId);
+            QCOMPARE(listedSpy.first().at(1).toString(), secondItemId);
+            QCOMPARE(listedSpy.first().at(2).toStringList().size(), 1);
+            QCOMPARE(readySpy.first().at(0).toULongLong(), requestId);
+            QVERIFY(!readySpy.first().at(2).value<QImage>().isNull());
+
+            // Zdjęcie usunięte z pominięciem PhotoCache (inne stanowisko) znika z listy,
+            // choć jego miniatura nadal jest w cache.
+            const QString photoId = listedSpy.first().at(2).toStringList().first();
+            QVERIFY(!PhotoCache::instance()
+                         .find(photoId, QSize(PhotoService::kListThumbnailSize, PhotoService::kListThumbnailSize))
+                         .isNull());
+            QSqlQuery deletePhoto(fileDb);
+            QVERIFY(deletePhoto.exec(QStringLiteral("DELETE FROM photo_thumbnails WHERE photo_id = '%1'").arg(photoId)));
+            QVERIFY(deletePhoto.exec(QStringLiteral("DELETE FROM photos WHERE id = '%1'").arg(photoId)));
+            const quint64 refreshId = loader.requestThumbnails(secondItemId, PhotoService::kListThumbnailSize);
+            QTRY_COMPARE(listedSpy.count(), 2);
+            QCOMPARE(listedSpy.last().at(0).toULongLong(), refreshId);
+            QVERIFY(listedSpy.last().at(2).toStringList().isEmpty());
+            QCOMPARE(readySpy.count(), 1);
+        }
+
+        PreparedStatementCache::instance().release(connectionName);
+        fileDb.close();
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
+void RepositoryTests::photoCache_evictsLeastRecentlyUsedWithinBudget()
+{
+    QImage image(100, 100, QImage::Format_ARGB32);
+    image.fill(Qt::red);
+    const qint64 imageBytes = image.sizeInBytes();
+
+    PhotoCache cache(imageBytes * 2);
+    QVERIFY(cache.insert(QStringLiteral("a"), image));
+    QVERIFY(cache.insert(QStringLiteral("b"), image));
+    QVERIFY(!cache.find(QStringLiteral("a")).isNull());
+
+    // "b" jest najdawniej używane — wypada przy przekroczeniu budżetu.
+    QVERIFY(cache.insert(QStringLiteral("c"), image));
+    QVERIFY(cache.find(QStringLiteral("b")).isNull());
+    QVERIFY(!cache.find(QStringLiteral("a")).isNull());
+    QVERIFY(!cache.find(QStringLiteral("c")).isNull());
+    QCOMPARE(cache.usedBytes(), imageBytes * 2);
+
+    QImage tooLarge(200, 200, QImage::Format_ARGB32);
+    tooLarge.fill(Qt::blue);
+    QVERIFY(!cache.insert(QStringLiteral("d"), tooLarge));
+    QVERIFY(cache.usedBytes() <= cache.budgetBytes());
+
+    // Ten sam obraz w innym rozmiarze to osobny wpis; invalidatePhoto usuwa wszystkie.
+    QVERIFY(cache.insert(QStringLiteral("c"), image, QSize(40, 40)));
+    QVERIFY(!cache.find(QStringLiteral("c"), QSize(40, 40)).isNull());
+    QVERIFY(cache.find(QStringLiteral("a"), QSize(40, 40)).isNull());
+    cache.invalidatePhoto(QStringLiteral("c"));
+    QVERIFY(cache.find(QStringLiteral("c")).isNull());
+    QVERIFY(cache.find(QStringLiteral("c"), QSize(40, 40)).isNull());
+    QCOMPARE(cache.count(), 1);
+}
+
+void RepositoryTests::photoCache_countsHitsAndInvalidatesOnDelete()
+{
+    ItemRepository repository(m_db);
+    QString savedItemId;
+    QString errorMessage;
+    QVERIFY2(repository.saveItem(createSampleItem(), {createPhotoBytes(), createPhotoBytes()},
+                                 &savedItemId, &errorMessage),
+             qPrintable(errorMessage));
+
+    PhotoService photoService(m_db);
+    const QList<StoredPhotoData> thumbnails =
+        photoService.loadThumbnailData(savedItemId, PhotoService::kListThumbnailSize, &errorMessage);
+    QCOMPARE(thumbnails.size(), 2);
+    const QString firstId = thumbnails.at(0).id;
+    const QString secondId = thumbnails.at(1).id;
+    const QSize thumbSize(PhotoService::kListThumbnailSize, PhotoService::kListThumbnailSize);
+
+    PhotoCache &cache = PhotoCache::instance();
+    cache.clear();
+    cache.resetStats();
+    cache.setItemPhotos(savedItemId, {firstId, secondId});
+    for (const StoredPhotoData &thumbnail : thumbnails)
+        QVERIFY(cache.insert(thumbnail.id, QImage::fromData(thumbnail.data), thumbSize));
+
+    QVERIFY(!cache.find(firstId, thumbSize).isNull());
+    QVERIFY(cache.find(firstId).isNull());
+    PhotoCache::Stats stats = cache.stats();
+    QCOMPARE(stats.hits, quint64(1));
+    QCOMPARE(stats.misses, quint64(1));
+    QCOMPARE(stats.entries, 2);
+
+    // Usunięcie pojedynczego zdjęcia (MainWindow::onRemovePhotoClicked).
+    QVERIFY2(photoService.deletePhoto(firstId, nullptr, &errorMessage), qPrintable(errorMessage));
+    QVERIFY(!cache.findItemPhotos(savedItemId, nullptr));
+    QVERIFY(cache.find(firstId, thumbSize).isNull());
+    QVERIFY(!cache.find(secondId, thumbSize).isNull());
+
+    // Usunięcie eksponatu zdejmuje z cache pozostałe zdjęcia, także bez listy.
+    QVERIFY2(repository.deleteItem(savedItemId, &errorMessage), qPrintable(errorMessage));
+    QVERIFY(cache.find(secondId, thumbSize).isNull());
+    QCOMPARE(cache.stats().entries, 0);
+}
+
+void RepositoryTests::preparedStatementCache_reusesAndEvictsStatements()
+{
+    const QString selectItem = QStringLiteral("SELECT name FROM eksponaty WHERE id = :id");
+    const QString selectPhotos = QStringLiteral("SELECT id FROM photos WHERE eksponat_id = :id");
+    const QString selectThumbnails = QStringLiteral("SELECT photo_id FROM photo_thumbnails WHERE size_px = :size");
+
+    PreparedStatementCache cache(2);
+    QSqlQuery *firstQuery = nullptr;
+    {
+        PreparedStatement statement = cache.prepare(m_db, selectItem);
+        firstQuery = statement.get();
+        statement->bindValue(QStringLiteral(":id"), QStringLiteral("brak"));
+        QVERIFY2(statement->exec(), qPrintable(statement->lastError().text()));
+        QVERIFY(statement->isActive());
+    }
+    {
+        // Ten sam SQL — to samo zapytanie, zamknięte (finish()) po poprzednim użyciu.
+        PreparedStatement statement = cache.prepare(m_db, selectItem);
+        QCOMPARE(statement.get(), firstQuery);
+        QVERIFY(!statement->isActive());
+
+        // Zagnieżdżone użycie tego samego SQL dostaje osobne zapytanie spoza cache.
+        PreparedStatement nested = cache.prepare(m_db, selectItem);
+        QVERIFY(nested.get() != firstQuery);
+        nested->bindValue(QStringLiteral(":id"), QStringLiteral("brak"));
+        QVERIFY2(nested->exec(), qPrintable(nested->lastError().text()));
+    }
+    QCOMPARE(cache.stats().hits, quint64(1));
+    QCOMPARE(cache.stats().misses, quint64(2));
+    QCOMPARE(cache.count(m_connectionName), 1);
+
+    // Limit 2: selectPhotos jest najdawniej używane — wypada przy trzecim zapytaniu.
+    cache.prepare(m_db, selectPhotos);
+    cache.prepare(m_db, selectItem);
+    cache.prepare(m_db, selectThumbnails);
+    QCOMPARE(cache.count(m_connectionName), 2);
+    cache.resetStats();
+    cache.prepare(m_db, selectItem);
+    cache.prepare(m_db, selectPhotos);
+    QCOMPARE(cache.stats().hits, quint64(1));
+    QCOMPARE(cache.stats().misses, quint64(1));
+
+    // Nieudane prepare() nie zajmuje miejsca w cache, błąd jest w zapytaniu.
+    cache.clear();
+    {
+        PreparedStatement broken = cache.prepare(m_db, QStringLiteral("SELECT id FROM brak_tabeli"));
+        QVERIFY(!broken->exec());
+        QVERIFY(broken->lastError().isValid());
+    }
+    QCOMPARE(cache.count(m_connectionName), 0);
+
+    cache.prepare(m_db, selectItem);
+    QCOMPARE(cache.count(m_connectionName), 1);
+    cache.release(m_connectionName);
+    QCOMPARE(cache.count(m_connectionName), 0);
+
+    // Wyłączony cache: zapytania działają, nic nie jest przechowywane.
+    PreparedStatementCache disabled(0);
+    {
+        PreparedStatement statement = disabled.prepare(m_db, selectItem);
+        statement->bindValue(QStringLiteral(":id"), QStringLiteral("brak"));
+        QVERIFY2(statement->exec(), qPrintable(statement->lastError().text()));
+    }
+    QCOMPARE(disabled.count(m_connectionName), 0);
+
+    // Repozytoria korzystają ze wspólnej instancji — drugi zapis opisu nie przygotowuje SQL od nowa.
+    ItemRepository repository(m_db);
+    QString savedItemId;
+    QString errorMessage;
+    QVERIFY2(repository.saveItem(createSampleItem(), {}, &savedItemId, &errorMessage), qPrintable(errorMessage));
+    QVERIFY2(repository.updateDescription(savedItemId, QStringLiteral("Pierwszy opis"), &errorMessage),
+             qPrintable(errorMessage));
+    PreparedStatementCache::instance().resetStats();
+    QVERIFY2(repository.updateDescription(savedItemId, QStringLiteral("Drugi opis"), &errorMessage),
+             qPrintable(errorMessage));
+    QCOMPARE(PreparedStatementCache::instance().stats().hits, quint64(1));
+    QCOMPARE(PreparedStatementCache::instance().stats().misses, quint64(0));
+    QVERIFY(PreparedStatementCache::instance().count(m_connectionName) >= 2);
+}
+
+void RepositoryTests::databaseConnectionPool_givesEachThreadItsOwnConnection()
+{
+    // Wątki robocze dostają klony, więc baza musi być plikiem (klon :memory: byłby pusty).
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString sourceName = QStringLiteral("pool_source_%1")
+                                   .arg(QUuid::createUuid().toString(QUuid::WithoutBraces));
+    {
+        QSqlDatabase sourceDb = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), sourceName);
+        sourceDb.setDatabaseName(tempDir.filePath(QStringLiteral("pool.sqlite")));
+        QVERIFY2(sourceDb.open(), qPrintable(sourceDb.lastError().text()));
+        QVERIFY(ensureDatabaseSchema(sourceDb));
+
+        DatabaseConnectionPool pool(sourceName);
+        QString errorMessage;
+        {
+            // Wątek GUI dostaje samo połączenie źródłowe.
+            const PooledConnection connection = pool.acquire(&errorMessage);
+            QVERIFY2(connection.isValid(), qPrintable(errorMessage));
+            QCOMPARE(connection.connectionName(), sourceName);
+            QCOMPARE(pool.stats().inUse, 1);
+        }
+        QCOMPARE(pool.stats().inUse, 0);
+        QCOMPARE(pool.stats().createdConnections, quint64(0));
+
+        QString workerName;
+        bool reusedInThread = false;
+        bool reopenedAfterInvalidate = false;
+        bool workerQueryOk = false;
+        QThread *worker = QThread::create([&]()
+                                          {
+            QString workerError;
+            {
+                const PooledConnection first = pool.acquire(&workerError);
+                if (!first.isValid())
+                    return;
+                workerName = first.connectionName();
+                QSqlQuery query(first.database());
+                workerQueryOk = query.exec(QStringLiteral("SELECT COUNT(*) FROM eksponaty")) && query.next();
+
+                // Zagnieżdżone wypożyczenie w tym samym wątku — to samo połączenie.
+                const PooledConnection nested = pool.acquire(&workerError);
+                reusedInThread = nested.connectionName() == workerName;
+            }
+            pool.invalidate();
+            const PooledConnection reopened = pool.acquire(&workerError);
+            reopenedAfterInvalidate = reopened.isValid() && reopened.database().isOpen()
+                                      && pool.stats().createdConnections == 2; });
+        worker->start();
+        QVERIFY(worker->wait(10000));
+        delete worker;
+
+        QVERIFY(workerQueryOk);
+        QVERIFY(!workerName.isEmpty());
+        QVERIFY(workerName != sourceName);
+        QVERIFY(reusedInThread);
+        QVERIFY(reopenedAfterInvalidate);
+        // Koniec wątku zamyka jego połączenie.
+        QVERIFY(!QSqlDatabase::contains(workerName));
+        QCOMPARE(pool.stats().connections, 1);
+        QCOMPARE(pool.stats().peakConnections, 2);
+
+        // Zamknięte połączenie jest otwierane ponownie przy wypożyczeniu.
+        sourceDb.close();
+        {
+            const PooledConnection connection = pool.acquire(&errorMessage);
+            QVERIFY2(connection.isValid(), qPrintable(errorMessage));
+            QVERIFY(connection.database().isOpen());
+        }
+        QCOMPARE(pool.stats().validationFailures, quint64(1));
+        QCOMPARE(pool.stats().reconnects, quint64(1));
+        QCOMPARE(pool.stats().checkouts, quint64(5));
+
+        PreparedStatementCache::instance().release(sourceName);
+        sourceDb.close();
+    }
+    QSqlDatabase::removeDatabase(sourceName);
+
+    // Brak połączenia źródłowego — czytelny błąd zamiast nieważnego połączenia.
+    DatabaseConnectionPool missingPool(QStringLiteral("brak_polaczenia"));
+    QString errorMessage;
+    bool failedInWorker = false;
+    QThread *worker = QThread::create([&]()
+                                      {
+        const PooledConnection connection = missingPool.acquire(&errorMessage);
+        failedInWorker = !connection.isValid(); });
+    worker->start();
+    QVERIFY(worker->wait(10000));
+    delete worker;
+    QVERIFY(failedInWorker);
+    QVERIFY(!errorMessage.isEmpty());
+    QCOMPARE(missingPool.stats().connections, 0);
+}
+
 void RepositoryTests::photoService_movesPhotosToDoneWhenEnabled()
 {
     QTemporaryDir tempDir;
@@ -555,6 +1479,62 @@ void RepositoryTests::databaseMigration_isNoOpWithoutSchema()
     QSqlDatabase::removeDatabase(QStringLiteral("default_connection"));
 }
 
+void RepositoryTests::databaseSchema_maintainsIndexCatalog()
+{
+    DatabaseIndexReport report;
+    QVERIFY(verifyDatabaseIndexes(m_db, &report));
+    QVERIFY2(report.missing.isEmpty(), qPrintable(report.missing.join(QLatin1Char(','))));
+    QVERIFY2(report.undeclared.isEmpty(), qPrintable(report.undeclared.join(QLatin1Char(','))));
+
+    // Plany zapytań listy i repozytoriów — regresja, gdy indeks zniknie z katalogu.
+    auto queryPlan = [this](const QString &sql)
+    {
+        QSqlQuery query(m_db);
+        QStringList details;
+        if (query.exec(QStringLiteral("EXPLAIN QUERY PLAN ") + sql)) {
+            while (query.next())
+                details.append(query.value(QStringLiteral("detail")).toString());
+        }
+        return details.join(QLatin1Char('\n'));
+    };
+    QVERIFY(queryPlan(QStringLiteral("SELECT id FROM photos WHERE eksponat_id = 'x'"))
+                .contains(QStringLiteral("idx_photos_eksponat_id")));
+    QVERIFY(queryPlan(QStringLiteral("SELECT id FROM eksponaty WHERE vendor_id = 'x'"))
+                .contains(QStringLiteral("idx_eksponaty_vendor_model")));
+    QVERIFY(queryPlan(QStringLiteral("SELECT id FROM eksponaty WHERE status_id IN ('x', 'y')"))
+                .contains(QStringLiteral("idx_eksponaty_status_storage")));
+    QVERIFY(queryPlan(QStringLiteral("SELECT id FROM models WHERE vendor_id = 'x'"))
+                .contains(QStringLiteral("idx_models_vendor_id")));
+
+    // Dokładnie zapytanie ItemTableModel::readPage — następna strona po kluczu (name, id).
+    ItemTableModel pagedModel(m_db);
+    pagedModel.setPageSize(50);
+    QVariantList pageBindValues;
+    QSqlQuery pagePlan(m_db);
+    QVERIFY(pagePlan.prepare(QStringLiteral("EXPLAIN QUERY PLAN ") + pagedModel.pageSql(true, &pageBindValues)));
+    pageBindValues << QStringLiteral("Eksponat") << QStringLiteral("id");
+    for (const QVariant &value : std::as_const(pageBindValues))
+        pagePlan.addBindValue(value);
+    QVERIFY2(pagePlan.exec(), qPrintable(pagePlan.lastError().text()));
+    QStringList pageDetails;
+    while (pagePlan.next())
+        pageDetails.append(pagePlan.value(QStringLiteral("detail")).toString());
+    const QString pagePlanText = pageDetails.join(QLatin1Char('\n'));
+    QVERIFY2(pagePlanText.contains(QStringLiteral("idx_eksponaty_name_id")), qPrintable(pagePlanText));
+    QVERIFY2(!pagePlanText.contains(QStringLiteral("TEMP B-TREE")), qPrintable(pagePlanText));
+
+    QSqlQuery query(m_db);
+    QVERIFY(query.exec(QStringLiteral("DROP INDEX idx_eksponaty_type_id")));
+    QVERIFY(query.exec(QStringLiteral("CREATE INDEX idx_custom_revision ON eksponaty(revision)")));
+    QVERIFY(verifyDatabaseIndexes(m_db, &report));
+    QCOMPARE(report.missing, QStringList({QStringLiteral("idx_eksponaty_type_id")}));
+    QCOMPARE(report.undeclared, QStringList({QStringLiteral("idx_custom_revision")}));
+
+    QVERIFY(ensureDatabaseSchema(m_db));
+    QVERIFY(verifyDatabaseIndexes(m_db, &report));
+    QVERIFY(report.missing.isEmpty());
+}
+
 void RepositoryTests::databaseBackupService_buildsSafeDumpArguments()
 {
     MySqlConnectionInfo connectionInfo;
@@ -646,6 +1626,10 @@ void RepositoryTests::itemFormValidator_rejectsEmptyName()
     const ItemValidationResult result = ItemFormValidator::validateName(QStringLiteral("   "));
     QVERIFY(!result.isValid);
     QCOMPARE(result.field, ItemValidationField::Name);
+
+    const QString longName(ItemRecordData::kMaxNameLength + 1, QLatin1Char('x'));
+    QVERIFY(!ItemFormValidator::validateName(longName).isValid);
+    QVERIFY(ItemFormValidator::validateName(longName.left(ItemRecordData::kMaxNameLength)).isValid);
 }
 
 void RepositoryTests::itemFormValidator_parsesNumericValue()
@@ -801,6 +1785,7 @@ void RepositoryTests::mainWindow_setEditModeLoadsExistingRecord()
         QCOMPARE(window.getNewItemModelComboBox()->currentText(), QStringLiteral("Atari 800XL"));
     }
 
+    PreparedStatementCache::instance().release(QStringLiteral("default_connection"));
     formDb.close();
     formDb = QSqlDatabase();
     QSqlDatabase::removeDatabase(QStringLiteral("default_connection"));
@@ -849,6 +1834,610 @@ void RepositoryTests::itemFilterProxyModel_searchesAcrossMultipleFields()
     QCOMPARE(proxy.rowCount(), 1);
 }
 
+void RepositoryTests::itemTableModel_filtersOnInternedDictionaryIds()
+{
+    // Drugi producent o tej samej nazwie — filtr „Atari” musi objąć oba UUID.
+    QSqlQuery duplicateVendor(m_db);
+    QVERIFY(duplicateVendor.exec(QStringLiteral("INSERT INTO vendors(id, name) VALUES('atari-duplicate', 'Atari')")));
+
+    ItemRepository repository(m_db);
+    QString errorMessage;
+    QString atariId;
+    QVERIFY2(repository.saveItem(createSampleItem(), {}, &atariId, &errorMessage), qPrintable(errorMessage));
+
+    ItemRecordData duplicate = createSampleItem();
+    duplicate.name = QStringLiteral("Drugie Atari");
+    duplicate.vendorId = QStringLiteral("atari-duplicate");
+    duplicate.description.clear();
+    duplicate.hasOriginalPackaging = false;
+    QString duplicateId;
+    QVERIFY2(repository.saveItem(duplicate, {}, &duplicateId, &errorMessage), qPrintable(errorMessage));
+
+    ItemRecordData commodore = createSampleItem();
+    commodore.name = QStringLiteral("Commodore komputer");
+    commodore.vendorId = lookupId(QStringLiteral("vendors"), QStringLiteral("Commodore"));
+    commodore.serialNumber.clear();
+    QString commodoreId;
+    QVERIFY2(repository.saveItem(commodore, {}, &commodoreId, &errorMessage), qPrintable(errorMessage));
+
+    ItemTableModel model(m_db);
+    QVERIFY2(model.reload(&errorMessage), qPrintable(errorMessage));
+    QCOMPARE(model.rowCount(), 3);
+    QCOMPARE(model.columnCount(), int(ItemTableModel::ColumnCount));
+
+    const int atariRow = model.rowForItemId(atariId);
+    const int duplicateRow = model.rowForItemId(duplicateId);
+    QVERIFY(atariRow >= 0 && duplicateRow >= 0);
+    QCOMPARE(model.dictionaryId(ItemTableModel::VendorDictionary, atariRow),
+             model.dictionaryId(ItemTableModel::VendorDictionary, duplicateRow));
+    QCOMPARE(model.data(model.index(atariRow, ItemTableModel::VendorColumn)).toString(), QStringLiteral("Atari"));
+    QCOMPARE(model.data(model.index(atariRow, ItemTableModel::ProductionYearColumn)).toInt(), 1988);
+    QCOMPARE(model.findDictionaryName(ItemTableModel::VendorDictionary, QStringLiteral("Nie ma takiego")), -1);
+
+    ItemFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+    QCOMPARE(proxy.rowCount(), 3);
+
+    proxy.setVendorFilter(QStringLiteral("Atari"));
+    QCOMPARE(proxy.rowCount(), 2);
+    proxy.setOriginalPackagingFilter(true);
+    QCOMPARE(proxy.rowCount(), 1);
+    proxy.setOriginalPackagingFilter(false);
+    proxy.setWithoutDescriptionFilter(true);
+    QCOMPARE(proxy.rowCount(), 1);
+    proxy.setWithoutDescriptionFilter(false);
+
+    proxy.setVendorFilter(QStringLiteral("Nie ma takiego"));
+    QCOMPARE(proxy.rowCount(), 0);
+
+    proxy.setVendorFilter(QString());
+    proxy.setWithoutSerialNumberFilter(true);
+    QCOMPARE(proxy.rowCount(), 1);
+    proxy.setWithoutSerialNumberFilter(false);
+    proxy.setNameFilter(QStringLiteral("commodore"));
+    QCOMPARE(proxy.rowCount(), 1);
+
+    // Po przeładowaniu filtr słownikowy jest przeliczany na nowe nameId.
+    proxy.setNameFilter(QString());
+    proxy.setVendorFilter(QStringLiteral("Commodore"));
+    QCOMPARE(proxy.rowCount(), 1);
+    QVERIFY2(repository.deleteItem(commodoreId, &errorMessage), qPrintable(errorMessage));
+    QVERIFY2(model.reload(&errorMessage), qPrintable(errorMessage));
+    QCOMPARE(model.rowCount(), 2);
+    QCOMPARE(proxy.rowCount(), 0);
+}
+
+void RepositoryTests::itemTableModel_patchesRowsOnRepositoryChanges()
+{
+    ItemRepository repository(m_db);
+    QString errorMessage;
+    QString firstId;
+    QVERIFY2(repository.saveItem(createSampleItem(), {}, &firstId, &errorMessage), qPrintable(errorMessage));
+
+    ItemTableModel model(m_db);
+    QVERIFY2(model.reload(&errorMessage), qPrintable(errorMessage));
+    QCOMPARE(model.rowCount(), 1);
+
+    connect(&ItemChangeNotifier::instance(), &ItemChangeNotifier::itemsChanged, &model,
+            [&model](const QStringList &itemIds) { model.refreshItems(itemIds); });
+    connect(&ItemChangeNotifier::instance(), &ItemChangeNotifier::itemsRemoved, &model,
+            [&model](const QStringList &itemIds) { model.removeItems(itemIds); });
+
+    QSignalSpy resetSpy(&model, &QAbstractItemModel::modelReset);
+    QSignalSpy insertedSpy(&model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy changedSpy(&model, &QAbstractItemModel::dataChanged);
+    QSignalSpy removedSpy(&model, &QAbstractItemModel::rowsRemoved);
+
+    ItemRecordData second = createSampleItem();
+    second.name = QStringLiteral("Drugi eksponat");
+    QString secondId;
+    QVERIFY2(repository.saveItem(second, {}, &secondId, &errorMessage), qPrintable(errorMessage));
+    QCOMPARE(insertedSpy.count(), 1);
+    QCOMPARE(model.rowCount(), 2);
+    QCOMPARE(model.itemName(model.rowForItemId(secondId)), QStringLiteral("Drugi eksponat"));
+
+    const QString brokenStatusId = lookupId(QStringLiteral("statuses"), QStringLiteral("Uszkodzony"));
+    QVERIFY2(repository.updateStatusForItems({firstId, secondId}, brokenStatusId, &errorMessage),
+             qPrintable(errorMessage));
+    QCOMPARE(changedSpy.count(), 2);
+    QCOMPARE(model.data(model.index(model.rowForItemId(firstId), ItemTableModel::StatusColumn)).toString(),
+             QStringLiteral("Uszkodzony"));
+
+    QVERIFY2(repository.updateDescription(secondId, QString(), &errorMessage), qPrintable(errorMessage));
+    QVERIFY(model.hasEmptyDescription(model.rowForItemId(secondId)));
+
+    QVERIFY2(repository.deleteItem(firstId, &errorMessage), qPrintable(errorMessage));
+    QCOMPARE(removedSpy.count(), 1);
+    QCOMPARE(model.rowCount(), 1);
+    QCOMPARE(model.rowForItemId(firstId), -1);
+    QCOMPARE(model.rowForItemId(secondId), 0);
+    QCOMPARE(resetSpy.count(), 0);
+}
+
+void RepositoryTests::itemFilterProxyModel_computesFacetCountsInMemory()
+{
+    ItemRepository repository(m_db);
+    QString errorMessage;
+    QVERIFY2(repository.saveItem(createSampleItem(), {}, nullptr, &errorMessage), qPrintable(errorMessage));
+
+    ItemRecordData secondAtari = createSampleItem();
+    secondAtari.name = QStringLiteral("Drugie Atari");
+    QVERIFY2(repository.saveItem(secondAtari, {}, nullptr, &errorMessage), qPrintable(errorMessage));
+
+    ItemRecordData commodore = createSampleItem();
+    commodore.name = QStringLiteral("Commodore komputer");
+    commodore.vendorId = lookupId(QStringLiteral("vendors"), QStringLiteral("Commodore"));
+    QVERIFY2(repository.saveItem(commodore, {}, nullptr, &errorMessage), qPrintable(errorMessage));
+
+    ItemTableModel model(m_db);
+    QVERIFY2(model.reload(&errorMessage), qPrintable(errorMessage));
+    ItemFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+
+    const int atari = model.findDictionaryName(ItemTableModel::VendorDictionary, QStringLiteral("Atari"));
+    const int commodoreVendor = model.findDictionaryName(ItemTableModel::VendorDictionary,
+                                                         QStringLiteral("Commodore"));
+    const int computer = model.findDictionaryName(ItemTableModel::TypeDictionary, QStringLiteral("Komputer"));
+    QVERIFY(atari >= 0 && commodoreVendor >= 0 && computer >= 0);
+
+    ItemFilterProxyModel::FacetCounts facets = proxy.facetCounts();
+    QCOMPARE(facets[ItemTableModel::VendorDictionary].value(atari), 2);
+    QCOMPARE(facets[ItemTableModel::VendorDictionary].value(commodoreVendor), 1);
+    QCOMPARE(facets[ItemTableModel::TypeDictionary].value(computer), 3);
+
+    // Własny filtr wymiaru nie zawęża jego opcji — pozostałe wymiary już tak.
+    proxy.setVendorFilter(QStringLiteral("Atari"));
+    facets = proxy.facetCounts();
+    QCOMPARE(facets[ItemTableModel::VendorDictionary].value(atari), 2);
+    QCOMPARE(facets[ItemTableModel::VendorDictionary].value(commodoreVendor), 1);
+    QCOMPARE(facets[ItemTableModel::TypeDictionary].value(computer), 2);
+
+    proxy.setNameFilter(QStringLiteral("commodore"));
+    facets = proxy.facetCounts();
+    QCOMPARE(facets[ItemTableModel::VendorDictionary].value(atari), 0);
+    QCOMPARE(facets[ItemTableModel::VendorDictionary].value(commodoreVendor), 1);
+    QCOMPARE(facets[ItemTableModel::TypeDictionary].value(computer), 0);
+    QCOMPARE(proxy.rowCount(), 0);
+}
+
+void RepositoryTests::itemSearchIndex_matchesFoldedTrigramsIncrementally()
+{
+    QCOMPARE(ItemSearchIndex::fold(QStringLiteral("ŁÓDŹ Żółć")), QStringLiteral("lodz zolc"));
+
+    ItemSearchIndex index;
+    index.setDocument(0, ItemSearchIndex::fold(QStringLiteral("Atari 800XL")));
+    index.setDocument(1, ItemSearchIndex::fold(QStringLiteral("Amiga 500")));
+    QVector<int> docIds;
+    QVERIFY(index.candidates(QStringLiteral("atari"), &docIds));
+    QCOMPARE(docIds, QVector<int>({0}));
+    QVERIFY(!index.candidates(QStringLiteral("a5"), &docIds));
+    index.setDocument(0, ItemSearchIndex::fold(QStringLiteral("Amiga 600")));
+    QVERIFY(index.candidates(QStringLiteral("amiga"), &docIds));
+    QCOMPARE(docIds, QVector<int>({0, 1}));
+    index.removeDocument(1);
+    QVERIFY(index.candidates(QStringLiteral("amiga"), &docIds));
+    QCOMPARE(docIds, QVector<int>({0}));
+
+    ItemRepository repository(m_db);
+    QString errorMessage;
+    ItemRecordData item = createSampleItem();
+    item.name = QStringLiteral("Komputer z Łodzi");
+    QString itemId;
+    QVERIFY2(repository.saveItem(item, {}, &itemId, &errorMessage), qPrintable(errorMessage));
+    QVERIFY2(repository.saveItem(createSampleItem(), {}, nullptr, &errorMessage), qPrintable(errorMessage));
+
+    ItemTableModel model(m_db);
+    QVERIFY2(model.reload(&errorMessage), qPrintable(errorMessage));
+    ItemFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+
+    proxy.setNameFilter(QStringLiteral("lodzi"));
+    QCOMPARE(proxy.rowCount(), 1);
+    proxy.setNameFilter(QStringLiteral("ŁODZI"));
+    QCOMPARE(proxy.rowCount(), 1);
+    // Te same trigramy w innej kolejności nie są trafieniem.
+    proxy.setNameFilter(QStringLiteral("dzilo"));
+    QCOMPARE(proxy.rowCount(), 0);
+    // Krótkie zapytanie omija indeks.
+    proxy.setNameFilter(QStringLiteral("xl"));
+    QCOMPARE(proxy.rowCount(), 2);
+
+    // Edycja opisu trafia do indeksu bez przeładowania modelu.
+    proxy.setNameFilter(QStringLiteral("gwarancja"));
+    QCOMPARE(proxy.rowCount(), 0);
+    QVERIFY2(repository.updateDescription(itemId, QStringLiteral("Gwarancja do 1990"), &errorMessage),
+             qPrintable(errorMessage));
+    QVERIFY2(model.refreshItems({itemId}, &errorMessage), qPrintable(errorMessage));
+    QCOMPARE(proxy.rowCount(), 1);
+    model.removeItems({itemId});
+    QCOMPARE(proxy.rowCount(), 0);
+}
+
+void RepositoryTests::itemSearchService_queriesFullTextIndex()
+{
+    // Indeks jest opcjonalny i domyślnie wyłączony (prefiksy słów zamiast podciągów).
+    QSettings settings(QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation)
+                           + QStringLiteral("/inwentaryzacja.ini"),
+                       QSettings::IniFormat);
+    settings.setValue(QStringLiteral("search/fulltext"), true);
+    settings.sync();
+    const auto restoreSettings = qScopeGuard([&settings]()
+                                             {
+        settings.remove(QStringLiteral("search/fulltext"));
+        settings.sync(); });
+    QVERIFY(ensureDatabaseSchema(m_db));
+
+    const ItemSearchService searchService(m_db);
+    if (!searchService.isAvailable())
+        QSKIP("SQLite bez FTS5 — lista szuka w pamięci.");
+
+    ItemRepository repository(m_db);
+    QString errorMessage;
+    ItemRecordData repaired = createSampleItem();
+    repaired.description = QStringLiteral("Zasilacz sprawdzony, główna płyta wymieniona");
+    QString repairedId;
+    QVERIFY2(repository.saveItem(repaired, {}, &repairedId, &errorMessage), qPrintable(errorMessage));
+    QString otherId;
+    QVERIFY2(repository.saveItem(createSampleItem(), {}, &otherId, &errorMessage), qPrintable(errorMessage));
+
+    // Prefiks słowa, bez polskich znaków i wielkości liter.
+    QStringList itemIds;
+    QVERIFY2(searchService.search(QStringLiteral("GLOWN zasil"), &itemIds, &errorMessage), qPrintable(errorMessage));
+    QCOMPARE(itemIds, QStringList({repairedId}));
+    QVERIFY(!searchService.search(QStringLiteral(" -- "), &itemIds, &errorMessage));
+    QVERIFY(errorMessage.isEmpty());
+
+    // Triggery utrzymują indeks przy edycji i usunięciu.
+    QVERIFY2(repository.updateDescription(otherId, QStringLiteral("Zasilacz do wymiany"), &errorMessage),
+             qPrintable(errorMessage));
+    QVERIFY2(searchService.search(QStringLiteral("zasilacz"), &itemIds, &errorMessage), qPrintable(errorMessage));
+    QCOMPARE(itemIds.size(), 2);
+    QVERIFY2(repository.deleteItem(repairedId, &errorMessage), qPrintable(errorMessage));
+    QVERIFY2(searchService.search(QStringLiteral("zasilacz"), &itemIds, &errorMessage), qPrintable(errorMessage));
+    QCOMPARE(itemIds, QStringList({otherId}));
+
+    ItemTableModel model(m_db);
+    QVERIFY2(model.reload(&errorMessage), qPrintable(errorMessage));
+    ItemFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+    // Tak jak wynik ItemFilterScheduler: ranking z indeksu, bez bitów policzonych w tle.
+    const auto applyFullText = [&proxy](const QString &text, const QStringList &rankedItemIds)
+    {
+        ItemFilterState state = proxy.filterState();
+        state.searchText = text;
+        ItemRowFilter::FullTextRanks ranks;
+        for (int rank = 0; rank < rankedItemIds.size(); ++rank)
+            ranks.insert(rankedItemIds[rank], rank);
+        proxy.applyFilterState(state, &ranks, QBitArray(), 0);
+    };
+    applyFullText(QStringLiteral("zasilacz"), itemIds);
+    QCOMPARE(proxy.rowCount(), 1);
+    QVERIFY(proxy.hasFullTextMatches());
+    // Producent nie jest w indeksie bazy — dopasowanie po słowniku w pamięci, słowo po słowie.
+    applyFullText(QStringLiteral("atari"), {});
+    QCOMPARE(proxy.rowCount(), 1);
+    applyFullText(QStringLiteral("atari wymiany"), {});
+    QCOMPARE(proxy.rowCount(), 1);
+    applyFullText(QStringLiteral("atari commodore"), {});
+    QCOMPARE(proxy.rowCount(), 0);
+    applyFullText(QStringLiteral("commodore"), {});
+    QCOMPARE(proxy.rowCount(), 0);
+    proxy.setNameFilter(QString());
+    QCOMPARE(proxy.rowCount(), 1);
+
+    // Wyłączenie opcji usuwa triggery i tabelę — zapis nie zależy już od FTS5.
+    settings.setValue(QStringLiteral("search/fulltext"), false);
+    settings.sync();
+    QVERIFY(ensureDatabaseSchema(m_db));
+    QSqlQuery query(m_db);
+    QVERIFY(query.exec(QStringLiteral("SELECT COUNT(*) FROM sqlite_master WHERE name LIKE 'eksponaty_fts%'")));
+    QVERIFY(query.next());
+    QCOMPARE(query.value(0).toInt(), 0);
+    QVERIFY2(repository.saveItem(createSampleItem(), {}, nullptr, &errorMessage), qPrintable(errorMessage));
+}
+
+void RepositoryTests::itemTableModel_fetchesPagesByKeyset()
+{
+    ItemRepository repository(m_db);
+    QString errorMessage;
+    const QStringList names = {QStringLiteral("Eksponat D"), QStringLiteral("Eksponat A"),
+                               QStringLiteral("Eksponat C"), QStringLiteral("Eksponat B"),
+                               QStringLiteral("Eksponat E")};
+    for (const QString &name : names) {
+        ItemRecordData item = createSampleItem();
+        item.name = name;
+        item.hasOriginalPackaging = name != QStringLiteral("Eksponat B");
+        QVERIFY2(repository.saveItem(item, {}, nullptr, &errorMessage), qPrintable(errorMessage));
+    }
+
+    ItemTableModel model(m_db);
+    model.setPageSize(2);
+    QVERIFY2(model.reload(&errorMessage), qPrintable(errorMessage));
+    QCOMPARE(model.rowCount(), 2);
+    QCOMPARE(model.totalRowCount(), 5);
+    QCOMPARE(model.itemName(0), QStringLiteral("Eksponat A"));
+    QVERIFY(model.canFetchMore(QModelIndex()));
+
+    // Przy stronicowaniu sortuje baza: ORDER BY kolumna, id i klucz (kolumna, id) < (?, ?).
+    model.sort(ItemTableModel::NameColumn, Qt::DescendingOrder);
+    QCOMPARE(model.sortColumn(), int(ItemTableModel::NameColumn));
+    QCOMPARE(model.rowCount(), 2);
+    QCOMPARE(model.itemName(0), QStringLiteral("Eksponat E"));
+    QCOMPARE(model.itemName(1), QStringLiteral("Eksponat D"));
+    model.fetchMore(QModelIndex());
+    QCOMPARE(model.itemName(2), QStringLiteral("Eksponat C"));
+
+    // Równe klucze (ten sam rok) rozstrzyga id — każdy rekord dokładnie raz.
+    model.sort(ItemTableModel::ProductionYearColumn, Qt::AscendingOrder);
+    while (model.canFetchMore(QModelIndex()))
+        model.fetchMore(QModelIndex());
+    QCOMPARE(model.rowCount(), 5);
+    QStringList seenIds;
+    for (int row = 0; row < model.rowCount(); ++row)
+        seenIds.append(model.itemId(row));
+    seenIds.removeDuplicates();
+    QCOMPARE(seenIds.size(), 5);
+
+    // Bez sortowania — znów porządek (name, id) od pierwszej strony.
+    model.sort(-1);
+    QCOMPARE(model.sortColumn(), -1);
+    QCOMPARE(model.rowCount(), 2);
+    QCOMPARE(model.itemName(0), QStringLiteral("Eksponat A"));
+
+    // Rekord dodany w trakcie przewijania nie pojawia się drugi raz z własną stroną.
+    ItemRecordData added = createSampleItem();
+    added.name = QStringLiteral("Eksponat BB");
+    QString addedId;
+    QVERIFY2(repository.saveItem(added, {}, &addedId, &errorMessage), qPrintable(errorMessage));
+    QVERIFY2(model.refreshItems({addedId}, &errorMessage), qPrintable(errorMessage));
+    QCOMPARE(model.totalRowCount(), 6);
+
+    while (model.canFetchMore(QModelIndex()))
+        model.fetchMore(QModelIndex());
+    QCOMPARE(model.rowCount(), 6);
+    QCOMPARE(model.itemName(3), QStringLiteral("Eksponat C"));
+    QCOMPARE(model.itemName(5), QStringLiteral("Eksponat E"));
+
+    model.setRowFilter(QStringLiteral("has_original_packaging = ?"), {1});
+    QVERIFY2(model.reload(&errorMessage), qPrintable(errorMessage));
+    QCOMPARE(model.totalRowCount(), 5);
+    while (model.canFetchMore(QModelIndex()))
+        model.fetchMore(QModelIndex());
+    QCOMPARE(model.rowCount(), 5);
+    QVERIFY(model.rowForItemId(addedId) >= 0);
+}
+
+void RepositoryTests::itemQueryBuilder_pushesFiltersIntoSql()
+{
+    ItemRepository repository(m_db);
+    QString errorMessage;
+    QVERIFY2(repository.saveItem(createSampleItem(), {}, nullptr, &errorMessage), qPrintable(errorMessage));
+
+    ItemRecordData withoutDescription = createSampleItem();
+    withoutDescription.description.clear();
+    withoutDescription.hasOriginalPackaging = false;
+    QVERIFY2(repository.saveItem(withoutDescription, {}, nullptr, &errorMessage), qPrintable(errorMessage));
+
+    ItemRecordData commodore = createSampleItem();
+    commodore.vendorId = lookupId(QStringLiteral("vendors"), QStringLiteral("Commodore"));
+    QVERIFY2(repository.saveItem(commodore, {}, nullptr, &errorMessage), qPrintable(errorMessage));
+
+    ItemTableModel model(m_db);
+    QVERIFY2(model.reload(&errorMessage), qPrintable(errorMessage));
+    QCOMPARE(model.rowCount(), 3);
+
+    ItemQueryBuilder atariWithPackaging;
+    atariWithPackaging.restrictDictionary(ItemTableModel::VendorDictionary,
+                                          model.dictionaryUuids(ItemTableModel::VendorDictionary,
+                                                                QStringLiteral("Atari")));
+    atariWithPackaging.setOriginalPackagingOnly(true);
+    QVERIFY(atariWithPackaging.whereSql().contains(QStringLiteral("vendor_id IN (?)")));
+    model.setRowFilter(atariWithPackaging.whereSql(), atariWithPackaging.bindValues());
+    QVERIFY2(model.reload(&errorMessage), qPrintable(errorMessage));
+    QCOMPARE(model.rowCount(), 1);
+    QCOMPARE(model.totalRowCount(), 1);
+
+    ItemQueryBuilder emptyDescription;
+    emptyDescription.setWithoutDescriptionOnly(true);
+    model.setRowFilter(emptyDescription.whereSql(), emptyDescription.bindValues());
+    QVERIFY2(model.reload(&errorMessage), qPrintable(errorMessage));
+    QCOMPARE(model.rowCount(), 1);
+
+    ItemQueryBuilder unknownName;
+    unknownName.restrictDictionary(ItemTableModel::TypeDictionary, {});
+    model.setRowFilter(unknownName.whereSql(), unknownName.bindValues());
+    QVERIFY2(model.reload(&errorMessage), qPrintable(errorMessage));
+    QCOMPARE(model.rowCount(), 0);
+
+    // „Szukaj” w trybie stronicowanym: podciąg pól eksponatu albo nazwy producenta/modelu.
+    const auto searchRowCount = [&model, &errorMessage](const QString &text)
+    {
+        ItemQueryBuilder search;
+        search.setSearchText(text);
+        model.setRowFilter(search.whereSql(), search.bindValues());
+        return model.reload(&errorMessage) ? model.rowCount() : -1;
+    };
+    QCOMPARE(searchRowCount(QStringLiteral(" modor ")), 1);
+    QCOMPARE(searchRowCount(QStringLiteral("ser-0")), 3);
+    QCOMPARE(searchRowCount(QStringLiteral("800XL")), 3);
+    // Znaki wieloznaczne LIKE są dosłowne.
+    QCOMPARE(searchRowCount(QStringLiteral("_")), 0);
+    QCOMPARE(searchRowCount(QStringLiteral("%")), 0);
+
+    // Liczniki combo boxa: filtr własnego słownika pomijany, pozostałe obowiązują.
+    ItemQueryBuilder facets;
+    facets.restrictDictionary(ItemTableModel::VendorDictionary,
+                              model.dictionaryUuids(ItemTableModel::VendorDictionary, QStringLiteral("Atari")));
+    facets.setOriginalPackagingOnly(true);
+    QVariantList facetBindValues;
+    const QString vendorFacetSql = facets.facetCountSql(ItemTableModel::VendorDictionary, &facetBindValues);
+    QVERIFY(!vendorFacetSql.contains(QStringLiteral("vendor_id IN")));
+    QVERIFY(facetBindValues.isEmpty());
+    QSqlQuery facetQuery(m_db);
+    QVERIFY(facetQuery.prepare(vendorFacetSql));
+    QVERIFY2(facetQuery.exec(), qPrintable(facetQuery.lastError().text()));
+    QHash<QString, int> vendorCounts;
+    while (facetQuery.next())
+        vendorCounts.insert(facetQuery.value(0).toString(), facetQuery.value(1).toInt());
+    QCOMPARE(vendorCounts.value(lookupId(QStringLiteral("vendors"), QStringLiteral("Atari"))), 1);
+    QCOMPARE(vendorCounts.value(lookupId(QStringLiteral("vendors"), QStringLiteral("Commodore"))), 1);
+
+    facetBindValues.clear();
+    QVERIFY(facets.facetCountSql(ItemTableModel::TypeDictionary, &facetBindValues)
+                .contains(QStringLiteral("vendor_id IN (?)")));
+    QCOMPARE(facetBindValues.size(), 1);
+
+    model.setRowFilter(ItemQueryBuilder().whereSql(), {});
+    QVERIFY2(model.reload(&errorMessage), qPrintable(errorMessage));
+    QCOMPARE(model.rowCount(), 3);
+}
+
+void RepositoryTests::itemTableModel_sortsByDictionaryRanks()
+{
+    // Mała litera — zwykłe porównanie QString postawiłoby „amiga” za „Sinclair”.
+    QSqlQuery insertVendor(m_db);
+    QVERIFY(insertVendor.exec(QStringLiteral("INSERT INTO vendors(id, name) VALUES('vendor-amiga', 'amiga')")));
+
+    ItemRepository repository(m_db);
+    QString errorMessage;
+    const QStringList vendors = {QStringLiteral("Sinclair"), QStringLiteral("Atari"), QStringLiteral("amiga"),
+                                 QStringLiteral("Commodore"), QStringLiteral("Atari")};
+    for (int i = 0; i < vendors.size(); ++i) {
+        ItemRecordData item = createSampleItem();
+        item.name = QStringLiteral("Eksponat %1").arg(i);
+        item.vendorId = lookupId(QStringLiteral("vendors"), vendors[i]);
+        item.productionYear = 1990 - i;
+        QVERIFY2(repository.saveItem(item, {}, nullptr, &errorMessage), qPrintable(errorMessage));
+    }
+
+    ItemTableModel model(m_db);
+    QVERIFY2(model.reload(&errorMessage), qPrintable(errorMessage));
+    model.sort(ItemTableModel::NameColumn);
+    const QPersistentModelIndex commodore = model.index(3, ItemTableModel::NameColumn);
+    QCOMPARE(model.itemName(commodore.row()), QStringLiteral("Eksponat 3"));
+
+    model.sort(ItemTableModel::VendorColumn);
+    QStringList sortedVendors;
+    for (int row = 0; row < model.rowCount(); ++row)
+        sortedVendors.append(model.data(model.index(row, ItemTableModel::VendorColumn)).toString());
+    QCOMPARE(sortedVendors, QStringList({QStringLiteral("amiga"), QStringLiteral("Atari"), QStringLiteral("Atari"),
+                                         QStringLiteral("Commodore"), QStringLiteral("Sinclair")}));
+    // Sortowanie stabilne — równe klucze w kolejności poprzedniego sortowania.
+    QCOMPARE(model.itemName(1), QStringLiteral("Eksponat 1"));
+    QCOMPARE(model.itemName(2), QStringLiteral("Eksponat 4"));
+    QCOMPARE(model.rowForItemId(model.itemId(3)), 3);
+    QCOMPARE(commodore.row(), 3);
+    QCOMPARE(model.itemName(commodore.row()), QStringLiteral("Eksponat 3"));
+
+    model.sort(ItemTableModel::ProductionYearColumn, Qt::DescendingOrder);
+    QCOMPARE(model.itemName(0), QStringLiteral("Eksponat 0"));
+    QCOMPARE(model.itemName(4), QStringLiteral("Eksponat 4"));
+
+    // Proxy oddaje sortowanie modelowi; po reload() kolejność jest odtwarzana.
+    ItemFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+    proxy.sort(ItemTableModel::VendorColumn, Qt::DescendingOrder);
+    QCOMPARE(proxy.sortColumn(), -1);
+    QCOMPARE(proxy.data(proxy.index(0, ItemTableModel::VendorColumn)).toString(), QStringLiteral("Sinclair"));
+    QVERIFY2(model.reload(&errorMessage), qPrintable(errorMessage));
+    QCOMPARE(proxy.data(proxy.index(4, ItemTableModel::VendorColumn)).toString(), QStringLiteral("amiga"));
+
+    // refreshItems() wstawia nowy i przesuwa zmieniony wiersz wg aktywnego sortowania.
+    ItemRecordData atari = createSampleItem();
+    atari.name = QStringLiteral("Eksponat 5");
+    atari.vendorId = lookupId(QStringLiteral("vendors"), QStringLiteral("Atari"));
+    QString atariId;
+    QVERIFY2(repository.saveItem(atari, {}, &atariId, &errorMessage), qPrintable(errorMessage));
+    const QString sinclairId = model.itemId(0);
+    QSqlQuery updateVendor(m_db);
+    updateVendor.prepare(QStringLiteral("UPDATE eksponaty SET vendor_id = :vendor_id WHERE id = :id"));
+    updateVendor.bindValue(QStringLiteral(":vendor_id"), QStringLiteral("vendor-amiga"));
+    updateVendor.bindValue(QStringLiteral(":id"), sinclairId);
+    QVERIFY2(updateVendor.exec(), qPrintable(updateVendor.lastError().text()));
+
+    const QPersistentModelIndex sinclair = model.index(0, ItemTableModel::NameColumn);
+    QVERIFY2(model.refreshItems({atariId, sinclairId}, &errorMessage), qPrintable(errorMessage));
+    sortedVendors.clear();
+    for (int row = 0; row < model.rowCount(); ++row)
+        sortedVendors.append(model.data(model.index(row, ItemTableModel::VendorColumn)).toString());
+    QCOMPARE(sortedVendors, QStringList({QStringLiteral("Commodore"), QStringLiteral("Atari"), QStringLiteral("Atari"),
+                                         QStringLiteral("Atari"), QStringLiteral("amiga"), QStringLiteral("amiga")}));
+    QCOMPARE(model.itemId(3), atariId);
+    QCOMPARE(sinclair.row(), 5);
+    QCOMPARE(model.rowForItemId(sinclairId), 5);
+}
+
+void RepositoryTests::itemFilterScheduler_coalescesAndFiltersInBackground()
+{
+    ItemRepository repository(m_db);
+    QString errorMessage;
+    QVERIFY2(repository.saveItem(createSampleItem(), {}, nullptr, &errorMessage), qPrintable(errorMessage));
+
+    ItemRecordData commodore = createSampleItem();
+    commodore.name = QStringLiteral("Commodore komputer");
+    commodore.vendorId = lookupId(QStringLiteral("vendors"), QStringLiteral("Commodore"));
+    QVERIFY2(repository.saveItem(commodore, {}, nullptr, &errorMessage), qPrintable(errorMessage));
+
+    ItemTableModel model(m_db);
+    QVERIFY2(model.reload(&errorMessage), qPrintable(errorMessage));
+    ItemFilterProxyModel proxy;
+    proxy.setSourceModel(&model);
+    ItemFilterScheduler scheduler(&model, &proxy);
+    QSignalSpy aboutToFilterSpy(&scheduler, &ItemFilterScheduler::aboutToFilter);
+    QSignalSpy filteredSpy(&scheduler, &ItemFilterScheduler::filtered);
+
+    // Kilka zmian w jednym obiegu pętli zdarzeń — jedno filtrowanie, dla ostatniego stanu.
+    ItemFilterState state;
+    state.searchText = QStringLiteral("atari");
+    scheduler.schedule(state);
+    state.searchText.clear();
+    state.dictionaryNames[ItemTableModel::VendorDictionary] = QStringLiteral("Commodore");
+    scheduler.schedule(state);
+    QVERIFY(scheduler.isBusy());
+    QCOMPARE(proxy.rowCount(), 2);
+
+    QTRY_COMPARE(filteredSpy.count(), 1);
+    QCOMPARE(aboutToFilterSpy.count(), 1);
+    QVERIFY(!scheduler.isBusy());
+    QCOMPARE(proxy.filterState(), state);
+    QCOMPARE(proxy.rowCount(), 1);
+    QCOMPARE(proxy.data(proxy.index(0, ItemTableModel::NameColumn)).toString(),
+             QStringLiteral("Commodore komputer"));
+
+    const int atari = model.findDictionaryName(ItemTableModel::VendorDictionary, QStringLiteral("Atari"));
+    const auto facets = filteredSpy.at(0).at(1).value<ItemFilterProxyModel::FacetCounts>();
+    QCOMPARE(facets[ItemTableModel::VendorDictionary].value(atari), 1);
+
+    // Ten sam stan przy niezmienionym modelu nie filtruje ponownie.
+    scheduler.schedule(state);
+    QTRY_VERIFY(!scheduler.isBusy());
+    QCOMPARE(filteredSpy.count(), 1);
+
+    // Nowy wiersz zmienia rewizję modelu — ten sam stan trzeba policzyć od nowa.
+    ItemRecordData secondCommodore = commodore;
+    secondCommodore.name = QStringLiteral("Drugi Commodore");
+    QVERIFY2(repository.saveItem(secondCommodore, {}, nullptr, &errorMessage), qPrintable(errorMessage));
+    QVERIFY2(model.reload(&errorMessage), qPrintable(errorMessage));
+    scheduler.schedule(state);
+    QTRY_COMPARE(filteredSpy.count(), 2);
+    QCOMPARE(proxy.rowCount(), 2);
+
+    // flush() filtruje od razu, bez pętli zdarzeń.
+    state = ItemFilterState();
+    state.searchText = QStringLiteral("drugi");
+    scheduler.schedule(state, 10000);
+    scheduler.flush();
+    QCOMPARE(filteredSpy.count(), 3);
+    QVERIFY(!scheduler.isBusy());
+    QCOMPARE(proxy.rowCount(), 1);
+
+    // Proxy bez schedulera — ten sam stan, dopasowanie w wątku GUI.
+    ItemFilterProxyModel directProxy;
+    directProxy.setSourceModel(&model);
+    directProxy.setFilterState(state);
+    QCOMPARE(directProxy.rowCount(), 1);
+}
+
 void RepositoryTests::itemList_restoresSavedFilters()
 {
     QSqlDatabase::removeDatabase(QStringLiteral("default_connection"));
@@ -928,6 +2517,79 @@ void RepositoryTests::itemList_restoresSavedFilters()
         QCOMPARE(vendorCombo->currentText(), QStringLiteral("Wszystkie"));
     }
 
+    PreparedStatementCache::instance().release(QStringLiteral("default_connection"));
+    listDb.close();
+    listDb = QSqlDatabase();
+    QSqlDatabase::removeDatabase(QStringLiteral("default_connection"));
+}
+
+void RepositoryTests::itemList_keepsOtherComboValuesWithSqlFilters()
+{
+    QSqlDatabase::removeDatabase(QStringLiteral("default_connection"));
+
+    QSettings settings(QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation)
+                           + QStringLiteral("/inwentaryzacja.ini"),
+                       QSettings::IniFormat);
+    settings.clear();
+    settings.setValue(QStringLiteral("itemList/sql_filters"), true);
+    settings.sync();
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString dbPath = tempDir.filePath(QStringLiteral("itemlist-sql-filters.sqlite"));
+    QVERIFY(setupDatabase(QStringLiteral("SQLite3"), dbPath));
+
+    QSqlDatabase listDb = QSqlDatabase::database(QStringLiteral("default_connection"));
+    QVERIFY(listDb.isOpen());
+
+    ItemRepository repository(listDb);
+    QString errorMessage;
+    auto lookupIdInDb = [&listDb](const QString &tableName, const QString &name)
+    {
+        QSqlQuery query(listDb);
+        query.prepare(QStringLiteral("SELECT id FROM %1 WHERE name = :name").arg(tableName));
+        query.bindValue(QStringLiteral(":name"), name);
+        if (!query.exec() || !query.next())
+            return QString();
+        return query.value(0).toString();
+    };
+
+    ItemRecordData item;
+    item.name = QStringLiteral("Komputer Atari");
+    item.statusId = lookupIdInDb(QStringLiteral("statuses"), QStringLiteral("Sprawny"));
+    item.typeId = lookupIdInDb(QStringLiteral("types"), QStringLiteral("Komputer"));
+    item.vendorId = lookupIdInDb(QStringLiteral("vendors"), QStringLiteral("Atari"));
+    item.modelId = lookupIdInDb(QStringLiteral("models"), QStringLiteral("Atari 800XL"));
+    item.storagePlaceId = lookupIdInDb(QStringLiteral("storage_places"), QStringLiteral("Magazyn 1"));
+    QVERIFY2(repository.saveItem(item, {}, nullptr, &errorMessage), qPrintable(errorMessage));
+
+    item.name = QStringLiteral("Konsola Atari");
+    item.typeId = lookupIdInDb(QStringLiteral("types"), QStringLiteral("Konsola"));
+    QVERIFY2(repository.saveItem(item, {}, nullptr, &errorMessage), qPrintable(errorMessage));
+
+    {
+        itemList window;
+
+        auto *typeCombo = window.findChild<QComboBox *>(QStringLiteral("filterTypeComboBox"));
+        auto *vendorCombo = window.findChild<QComboBox *>(QStringLiteral("filterVendorComboBox"));
+        QVERIFY(typeCombo);
+        QVERIFY(vendorCombo);
+
+        QTRY_VERIFY(typeCombo->findText(QStringLiteral("Komputer")) >= 0);
+        typeCombo->setCurrentIndex(typeCombo->findText(QStringLiteral("Komputer")));
+
+        // Model ma już tylko komputer, a combo typu nadal proponuje pozostałe typy.
+        QTRY_COMPARE(vendorCombo->itemData(vendorCombo->findText(QStringLiteral("Atari")), Qt::UserRole + 1)
+                         .toInt(),
+                     1);
+        QCOMPARE(typeCombo->currentText(), QStringLiteral("Komputer"));
+        QVERIFY(typeCombo->findText(QStringLiteral("Konsola")) >= 0);
+        window.close();
+    }
+
+    settings.clear();
+    settings.sync();
+    PreparedStatementCache::instance().release(QStringLiteral("default_connection"));
     listDb.close();
     listDb = QSqlDatabase();
     QSqlDatabase::removeDatabase(QStringLiteral("default_connection"));